@@ -6,6 +6,9 @@ echo.
 REM The buildable app is the rtos\ project (rtos.cpp + minux_system.cpp + rtos.rc).
 REM The root main.cpp set does NOT compile and is intentionally not used here.
 
+REM Application sources, relative to rtos\
+set APP_SOURCES=rtos.cpp minux_system.cpp minux_collector.cpp core\minux_procdiff.cpp core\minux_procview.cpp core\minux_procsampler.cpp core\minux_backend_win32.cpp core\minux_monitor.cpp core\minux_history.cpp core\minux_codec.cpp core\minux_recording.cpp core\minux_export.cpp core\minux_cpusampler.cpp core\minux_cadence.cpp core\minux_timerwheel.cpp minux_backbuffer.cpp minux_gdicache.cpp core\minux_pixels.cpp core\minux_effects.cpp core\minux_lod.cpp core\minux_format.cpp core\minux_names.cpp core\minux_proctable.cpp core\minux_topk.cpp core\minux_proctree.cpp core\minux_filter.cpp core\minux_netrates.cpp core\minux_netconfig.cpp
+
 REM Check for Visual Studio Build Tools
 where msbuild >nul 2>&1
 if %ERRORLEVEL%==0 (
@@ -39,9 +42,9 @@ if %ERRORLEVEL%==0 (
     REM rtos.cpp uses wWinMain, so -municode is required (else 'undefined reference to WinMain').
     g++ -std=c++17 -O2 -municode -mwindows -static-libgcc -static-libstdc++ ^
         -DUNICODE -D_UNICODE -DWINVER=0x0A00 -D_WIN32_WINNT=0x0A00 -DNOMINMAX ^
-        rtos.cpp minux_system.cpp ..\build\rtos_res.o -o ..\build\MinuxRTOS.exe ^
-        -luser32 -lgdi32 -ldwmapi -lcomctl32 -luxtheme -lshell32 ^
-        -lpsapi -lpdh -liphlpapi -ladvapi32 -lole32
+        %APP_SOURCES% ..\build\rtos_res.o -o ..\build\MinuxRTOS.exe ^
+        -luser32 -lgdi32 -ldwmapi -lcomctl32 -luxtheme -lshell32 -lcomdlg32 ^
+        -lpsapi -liphlpapi -ladvapi32 -lole32
     popd
 
     if exist build\MinuxRTOS.exe (
@@ -71,9 +74,9 @@ if %ERRORLEVEL%==0 (
     clang++ -std=c++17 -O2 -target x86_64-pc-windows-gnu -municode -mwindows ^
         -static-libgcc -static-libstdc++ ^
         -DUNICODE -D_UNICODE -DWINVER=0x0A00 -D_WIN32_WINNT=0x0A00 -DNOMINMAX ^
-        rtos.cpp minux_system.cpp ..\build\rtos_res.o -o ..\build\MinuxRTOS.exe ^
-        -luser32 -lgdi32 -ldwmapi -lcomctl32 -luxtheme -lshell32 ^
-        -lpsapi -lpdh -liphlpapi -ladvapi32 -lole32
+        %APP_SOURCES% ..\build\rtos_res.o -o ..\build\MinuxRTOS.exe ^
+        -luser32 -lgdi32 -ldwmapi -lcomctl32 -luxtheme -lshell32 -lcomdlg32 ^
+        -lpsapi -liphlpapi -ladvapi32 -lole32
     popd
 
     if exist build\MinuxRTOS.exe (
@@ -108,7 +108,8 @@ Write-Host "Configuration: $Configuration" -ForegroundColor Green
 
 # The buildable app lives in the rtos\ project (rtos.cpp + minux_system.cpp + rtos.rc).
 # The root main.cpp / minux_system.cpp set does NOT compile, so it is intentionally unused.
-$sourceFiles = @("rtos\rtos.cpp", "rtos\minux_system.cpp")
+$appSources  = @("rtos.cpp", "minux_system.cpp", "minux_collector.cpp", "core\minux_procdiff.cpp", "core\minux_procview.cpp", "core\minux_procsampler.cpp", "core\minux_backend_win32.cpp", "core\minux_monitor.cpp", "core\minux_history.cpp", "core\minux_codec.cpp", "core\minux_recording.cpp", "core\minux_export.cpp", "core\minux_cpusampler.cpp", "core\minux_cadence.cpp", "core\minux_timerwheel.cpp", "minux_backbuffer.cpp", "minux_gdicache.cpp", "core\minux_pixels.cpp", "core\minux_effects.cpp", "core\minux_lod.cpp", "core\minux_format.cpp", "core\minux_names.cpp", "core\minux_proctable.cpp", "core\minux_topk.cpp", "core\minux_proctree.cpp", "core\minux_filter.cpp", "core\minux_netrates.cpp", "core\minux_netconfig.cpp")
+$sourceFiles = $appSources | ForEach-Object { "rtos\$_" }
 
 # Verify source files exist
 foreach ($file in $sourceFiles) {
@@ -167,8 +168,8 @@ switch ($Compiler) {
 
         $opt     = if ($Configuration -eq "Debug") { @("-O0", "-g") } else { @("-O2") }
         $defines = @("-DUNICODE", "-D_UNICODE", "-DWINVER=0x0A00", "-D_WIN32_WINNT=0x0A00", "-DNOMINMAX")
-        $libs    = @("-luser32", "-lgdi32", "-ldwmapi", "-lcomctl32", "-luxtheme", "-lshell32",
-                     "-lpsapi", "-lpdh", "-liphlpapi", "-ladvapi32", "-lole32")
+        $libs    = @("-luser32", "-lgdi32", "-ldwmapi", "-lcomctl32", "-luxtheme", "-lshell32", "-lcomdlg32",
+                     "-lpsapi", "-liphlpapi", "-ladvapi32", "-lole32")
 
         # Build runs from inside rtos\ so the .rc's relative #includes and icon paths resolve.
         Push-Location "rtos"
@@ -190,7 +191,7 @@ switch ($Compiler) {
                 $gccArgs = @("-std=c++17") + $opt +
                     @("-municode", "-mwindows", "-static-libgcc", "-static-libstdc++") +
                     $defines +
-                    @("rtos.cpp", "minux_system.cpp", "..\build\rtos_res.o", "-o", "..\build\MinuxRTOS.exe") +
+                    $appSources + @("..\build\rtos_res.o", "-o", "..\build\MinuxRTOS.exe") +
                     $libs
                 if ($Verbose) { $gccArgs = @("-v") + $gccArgs }
 
@@ -208,8 +209,8 @@ switch ($Compiler) {
 
         $opt     = if ($Configuration -eq "Debug") { @("-O0", "-g") } else { @("-O2") }
         $defines = @("-DUNICODE", "-D_UNICODE", "-DWINVER=0x0A00", "-D_WIN32_WINNT=0x0A00", "-DNOMINMAX")
-        $libs    = @("-luser32", "-lgdi32", "-ldwmapi", "-lcomctl32", "-luxtheme", "-lshell32",
-                     "-lpsapi", "-lpdh", "-liphlpapi", "-ladvapi32", "-lole32")
+        $libs    = @("-luser32", "-lgdi32", "-ldwmapi", "-lcomctl32", "-luxtheme", "-lshell32", "-lcomdlg32",
+                     "-lpsapi", "-liphlpapi", "-ladvapi32", "-lole32")
 
         # Targets the MinGW (windows-gnu) runtime so -municode / -mwindows / windres .o all apply,
         # matching the verified g++ path. Requires clang configured with a MinGW sysroot.
@@ -231,7 +232,7 @@ switch ($Compiler) {
                     @("-target", "x86_64-pc-windows-gnu", "-municode", "-mwindows",
                       "-static-libgcc", "-static-libstdc++") +
                     $defines +
-                    @("rtos.cpp", "minux_system.cpp", "..\build\rtos_res.o", "-o", "..\build\MinuxRTOS.exe") +
+                    $appSources + @("..\build\rtos_res.o", "-o", "..\build\MinuxRTOS.exe") +
                     $libs
                 if ($Verbose) { $clangArgs = @("-v") + $clangArgs }
 
@@ -0,0 +1,71 @@
+#!/bin/sh
+# Minux RTOS Control Center - Headless Build Script
+# Builds the platform-neutral core and its benchmarks with g++/clang++ so they
+# can be profiled on Linux build boxes. The GUI itself is Windows-only; use
+# build.bat or build.ps1 for the application.
+#
+# Usage: ./build.sh [core|bench|run|clean]
+#   core   build the monitoring core into build/libminux_core.a
+#   bench  build the core and the benchmarks into build/ (default)
+#   run    build, then run every benchmark
+#   clean  remove the headless build outputs
+
+set -e
+cd "$(dirname "$0")"
+
+CXX="${CXX:-g++}"
+CXXFLAGS="${CXXFLAGS:--std=c++17 -O2 -Wall}"
+AR="${AR:-ar}"
+
+# Core sources, relative to rtos/. Platform backends are guarded by #ifdef,
+# so the ones for other platforms compile to empty objects.
+CORE_SOURCES="core/minux_procdiff.cpp core/minux_procview.cpp core/minux_monitor.cpp core/minux_backend_linux.cpp core/minux_backend_win32.cpp core/minux_procsampler.cpp core/minux_cpusampler.cpp core/minux_history.cpp core/minux_codec.cpp core/minux_recording.cpp core/minux_export.cpp core/minux_cadence.cpp core/minux_timerwheel.cpp core/minux_pixels.cpp core/minux_effects.cpp core/minux_lod.cpp core/minux_format.cpp core/minux_names.cpp core/minux_proctable.cpp core/minux_topk.cpp core/minux_proctree.cpp core/minux_filter.cpp core/minux_netrates.cpp core/minux_netconfig.cpp"
+
+# Benchmarks: rtos/bench/<name>_bench.cpp -> build/<name>_bench
+BENCHES="procview sampling history codec recording export cadence timerwheel pixels effects lod format names table topk tree filter netrates netconfig"
+
+build_core() {
+    mkdir -p build/obj
+    objects=""
+    for source in $CORE_SOURCES; do
+        object="build/obj/$(basename "$source" .cpp).o"
+        (cd rtos && $CXX $CXXFLAGS -c "$source" -o "../$object")
+        objects="$objects $object"
+    done
+    rm -f build/libminux_core.a
+    $AR rcs build/libminux_core.a $objects
+    echo "Built build/libminux_core.a"
+}
+
+build_benches() {
+    build_core
+    for bench in $BENCHES; do
+        echo "Building build/${bench}_bench..."
+        (cd rtos && $CXX $CXXFLAGS "bench/${bench}_bench.cpp" ../build/libminux_core.a -o "../build/${bench}_bench")
+    done
+}
+
+case "${1:-bench}" in
+    core)
+        build_core
+        ;;
+    bench)
+        build_benches
+        ;;
+    run)
+        build_benches
+        for bench in $BENCHES; do
+            "./build/${bench}_bench"
+        done
+        ;;
+    clean)
+        for bench in $BENCHES; do
+            rm -f "build/${bench}_bench"
+        done
+        rm -rf build/obj build/libminux_core.a
+        ;;
+    *)
+        echo "Usage: $0 [core|bench|run|clean]"
+        exit 1
+        ;;
+esac
@@ -13,6 +13,18 @@
 #define IDC_RTOS                        109
 #define IDR_MAINFRAME                   128
 #define ID_FILE_NEWSESSION              32771
+#define IDM_OPEN_RECORDING              32772
+#define IDM_RECORD                      32773
+#define IDM_RETURN_TO_LIVE              32774
+#define IDM_PLAYBACK_FASTER             32775
+#define IDM_PLAYBACK_SLOWER             32776
+#define IDM_PLAYBACK_BACK               32777
+#define IDM_PLAYBACK_FORWARD            32778
+#define IDM_PROCESS_TREE                32779
+#define IDM_TREE_EXPAND_ALL             32780
+#define IDM_TREE_COLLAPSE_ALL           32781
+#define IDM_FIND_PROCESS                32782
+#define IDM_EXPORT                      32783
 #define IDC_STATIC                      -1
 
 // Next default values for new objects
@@ -21,7 +33,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NO_MFC                     1
 #define _APS_NEXT_RESOURCE_VALUE        129
-#define _APS_NEXT_COMMAND_VALUE         32772
+#define _APS_NEXT_COMMAND_VALUE         32784
 #define _APS_NEXT_CONTROL_VALUE         1000
 #define _APS_NEXT_SYMED_VALUE           110
 #endif
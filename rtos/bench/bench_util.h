@@ -0,0 +1,104 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <cwchar>
+#include <vector>
+#include "../core/minux_types.h"
+#include "../core/minux_names.h"
+
+// Minux Benchmark Helpers
+// Timing and synthetic snapshot generation shared by the headless benchmarks.
+
+// Monotonic stopwatch
+class BenchTimer {
+public:
+    BenchTimer() : m_start(std::chrono::steady_clock::now()) {}
+    void Restart() { m_start = std::chrono::steady_clock::now(); }
+    double ElapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Small deterministic PRNG (xorshift64*) so runs are comparable
+class BenchRandom {
+public:
+    explicit BenchRandom(uint64_t seed = 0x2545F4914F6CDD1DULL) : m_state(seed) {}
+    uint64_t Next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+    uint32_t Below(uint32_t bound) { return (uint32_t)(Next() % bound); }
+private:
+    uint64_t m_state;
+};
+
+// Synthetic process snapshot resembling a busy machine
+inline void MakeSyntheticProcesses(std::vector<ProcessInfo>& processes, size_t count, BenchRandom& random) {
+    static const wchar_t* names[] = {
+        L"minux-kernel.exe", L"minux-scheduler.exe", L"minux-driver-mgr.exe", L"minux-fs-service.exe",
+        L"minux-net-stack.exe", L"minux-ui-compositor.exe", L"minux-power-mgr.exe", L"minux-security.exe",
+        L"svchost.exe", L"explorer.exe", L"chrome.exe", L"code.exe"
+    };
+
+    processes.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        ProcessInfo& info = processes[i];
+        info = ProcessInfo();
+        info.processId = (uint32_t)(4 + i * 4);
+        info.nameId = InternName(names[random.Below(sizeof(names) / sizeof(names[0]))]);
+        info.workingSetSize = (uint64_t)(random.Below(512 * 1024) + 64) * 1024;
+        info.cpuUsage = random.Below(2500);
+        info.threadCount = random.Below(64) + 1;
+        info.creationTime = ((uint64_t)(0x01D9 + (i >> 16)) << 32) | (uint32_t)random.Next();
+        info.parentProcessId = i ? processes[random.Below((uint32_t)i)].processId : 0;
+    }
+}
+
+// Perturb a snapshot the way one refresh tick would: a few percent of rows change
+inline void TickSyntheticProcesses(std::vector<ProcessInfo>& processes, BenchRandom& random, uint32_t changePercent) {
+    for (ProcessInfo& info : processes) {
+        if (random.Below(100) < changePercent) {
+            info.workingSetSize += (uint64_t)random.Below(64) * 4096;
+            info.cpuUsage = random.Below(2500);
+        }
+    }
+}
+
+inline void PrintBenchHeader(const char* title) {
+    printf("\n%s\n", title);
+    for (const char* p = title; *p; p++) putchar('=');
+    putchar('\n');
+}
+
+// Heap allocation counter, for benches that prove a path never allocates.
+// Define MINUX_BENCH_COUNT_ALLOCATIONS before including this header; each
+// bench is a single translation unit, so the replacement operators are
+// defined exactly once per program.
+#ifdef MINUX_BENCH_COUNT_ALLOCATIONS
+static size_t g_allocations = 0;
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"    // free() pairs with the malloc() below
+#endif
+
+void* operator new(size_t size) {
+    g_allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+#endif
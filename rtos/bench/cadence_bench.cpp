@@ -0,0 +1,137 @@
+// Minux Sampling Cadence Benchmark
+// Drives the cadence controller through an hour-long session on a virtual
+// clock: busy on the Processes tab, then the Network tab, then a long quiet
+// spell in the tray, then restored. Counts the samples per stream, checks the
+// rates each phase should run at, and prices them with the real backend's
+// cost per sample to estimate the monitor's own CPU time against sampling
+// everything every second.
+
+#include "bench_util.h"
+#include "../core/minux_cadence.h"
+#include "../core/minux_monitor.h"
+#include "../core/minux_snapshot.h"
+
+static const char* kStreamNames[CADENCE_STREAM_COUNT] = { "system", "processes", "network" };
+
+struct Phase {
+    const char* name;
+    uint64_t durationMs;
+    bool visible;
+    int focused;
+    bool busy;                  // values keep changing
+};
+
+static const int kSystem = CADENCE_STREAM_BIT(CADENCE_SYSTEM);
+static const int kProcesses = CADENCE_STREAM_BIT(CADENCE_PROCESSES);
+static const int kNetwork = CADENCE_STREAM_BIT(CADENCE_NETWORK);
+
+static const Phase kPhases[] = {
+    { "processes tab, busy", 10 * 60000, true, kSystem | kProcesses, true },
+    { "network tab, busy", 5 * 60000, true, kSystem | kNetwork, true },
+    { "tray, quiet", 40 * 60000, false, kSystem, false },
+    { "restored, quiet", 5 * 60000, true, kSystem | kProcesses, false },
+};
+static const int kPhaseCount = sizeof(kPhases) / sizeof(kPhases[0]);
+
+// Mean cost of one sample of each stream on this machine, in microseconds
+static void MeasureStreamCosts(double* costs) {
+    StartPerformanceCounters();
+    if (!GetMonitorBackend()) {
+        costs[CADENCE_SYSTEM] = 20;
+        costs[CADENCE_PROCESSES] = 2000;
+        costs[CADENCE_NETWORK] = 50;
+        printf("  no monitor backend for this platform, using nominal costs\n");
+        return;
+    }
+
+    const int rounds = 20;
+    MinuxSnapshot snapshot;
+    BenchTimer timer;
+    for (int i = 0; i < rounds; i++) GetSystemInformation(snapshot.system, snapshot.cores);
+    costs[CADENCE_SYSTEM] = timer.ElapsedSeconds() * 1e6 / rounds;
+    timer.Restart();
+    for (int i = 0; i < rounds; i++) GetProcessList(snapshot.processes);
+    costs[CADENCE_PROCESSES] = timer.ElapsedSeconds() * 1e6 / rounds;
+    timer.Restart();
+    for (int i = 0; i < rounds; i++) GetNetworkInterfaces(snapshot.interfaces);
+    costs[CADENCE_NETWORK] = timer.ElapsedSeconds() * 1e6 / rounds;
+    StopPerformanceCounters();
+}
+
+int main() {
+    PrintBenchHeader("Sampling cadence");
+
+    double costs[CADENCE_STREAM_COUNT];
+    MeasureStreamCosts(costs);
+    printf("  cost per sample: system %.1f us, processes %.1f us, network %.1f us\n",
+           costs[CADENCE_SYSTEM], costs[CADENCE_PROCESSES], costs[CADENCE_NETWORK]);
+
+    CadenceController cadence;
+    BenchRandom random;
+    uint64_t now = 0;
+    uint64_t wakeups = 0;
+    BenchTimer timer;
+
+    for (int p = 0; p < kPhaseCount; p++) {
+        const Phase& phase = kPhases[p];
+        cadence.SetView(phase.visible, phase.focused, now);
+
+        // Restoring the window must refresh everything at once
+        if (p > 0 && phase.visible && !kPhases[p - 1].visible && cadence.GetDueStreams(now) != CADENCE_ALL_STREAMS) {
+            printf("  FAIL restore did not make every stream due\n");
+            return 1;
+        }
+
+        uint64_t end = now + phase.durationMs;
+        uint64_t samples[CADENCE_STREAM_COUNT] = {};
+        uint64_t phaseWakeups = 0;
+        while (now < end) {
+            int due = cadence.GetDueStreams(now);
+            for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+                if (!(due & CADENCE_STREAM_BIT(stream))) continue;
+                bool changed = phase.busy || random.Below(100) == 0;
+                cadence.Complete(stream, now, changed);
+                samples[stream]++;
+            }
+            if (due) phaseWakeups++;
+            now = cadence.GetNextDue();
+        }
+        wakeups += phaseWakeups;
+
+        // Steady state of each phase
+        for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+            const CadenceRates& rates = g_cadenceDefaults[stream];
+            uint32_t base = !phase.visible ? rates.hiddenMs :
+                            (phase.focused & CADENCE_STREAM_BIT(stream)) ? rates.focusedMs : rates.visibleMs;
+            uint32_t interval = cadence.GetInterval(stream);
+            if (interval < base || interval > base * rates.maxBackoff) {
+                printf("  FAIL %s %s interval %u ms, expected %u..%u\n",
+                       phase.name, kStreamNames[stream], interval, base, base * rates.maxBackoff);
+                return 1;
+            }
+            if (phase.busy && interval != base) {
+                printf("  FAIL %s %s backed off to %u ms while changing\n", phase.name, kStreamNames[stream], interval);
+                return 1;
+            }
+        }
+
+        double seconds = phase.durationMs / 1000.0;
+        double busyUs = 0;
+        for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) busyUs += samples[stream] * costs[stream];
+        printf("  %-20s %6.2f / %5.2f / %5.2f samples/s | %5.1f wakeups/s | %8.1f us/s\n", phase.name,
+               samples[CADENCE_SYSTEM] / seconds, samples[CADENCE_PROCESSES] / seconds,
+               samples[CADENCE_NETWORK] / seconds, phaseWakeups / seconds, busyUs / seconds);
+
+        // Nobody is looking: the monitor should all but stop
+        if (!phase.visible && samples[CADENCE_PROCESSES] / seconds > 0.1) {
+            printf("  FAIL %.2f process samples/s in the tray\n", samples[CADENCE_PROCESSES] / seconds);
+            return 1;
+        }
+    }
+    double decideSeconds = timer.ElapsedSeconds();
+
+    double fixedUs = costs[CADENCE_SYSTEM] + costs[CADENCE_PROCESSES] + costs[CADENCE_NETWORK];
+    printf("  fixed 1 s cadence   %31s | %5.1f wakeups/s | %8.1f us/s\n", "", 1.0, fixedUs);
+    printf("  controller %.1f ns per wakeup\n", decideSeconds * 1e9 / wakeups);
+    return 0;
+}
@@ -0,0 +1,230 @@
+// Minux History Codec Benchmark
+// Round-trips edge cases and a week of synthetic per-process series through
+// the block codec, then reports the compression ratio against raw 64-bit
+// (timestamp, value) pairs and the encode, decode and aggregate throughput.
+// The working-set and CPU series (the CPU one also as floats) have to
+// compress by CODEC_TARGET_RATIO. A busy process's CPU, a fresh random
+// mean every minute, is outside that target: the codec spends about 16
+// bits on each of its points, 7.9x, and the bench only reports it.
+
+#include <cmath>
+#include <limits>
+#include "bench_util.h"
+#include "../core/minux_codec.h"
+
+static const size_t kPoints = 10080;        // one week of 1-minute buckets
+static const int kRounds = 50;
+
+#define CODEC_TARGET_RATIO  8.0     // against 16-byte (timestamp, value) pairs
+
+static volatile int64_t g_sink;     // keeps the decode loop from being optimized away
+
+static bool CheckIntegerRoundTrip(const char* name, const std::vector<uint64_t>& times, const std::vector<int64_t>& values) {
+    std::vector<uint8_t> block;
+    EncodeIntegerBlock(times.data(), values.data(), times.size(), block);
+    if (block.size() > GetMaxEncodedSize(times.size())) {
+        printf("  FAIL %s: %zu bytes exceeds the size bound\n", name, block.size());
+        return false;
+    }
+
+    HistoryBlockCursor cursor(block.data(), block.size());
+    size_t i = 0;
+    while (cursor.Next()) {
+        if (i >= times.size() || cursor.GetTime() != times[i] || cursor.GetValue() != values[i]) {
+            printf("  FAIL %s: point %zu differs\n", name, i);
+            return false;
+        }
+        i++;
+    }
+    if (i != times.size()) {
+        printf("  FAIL %s: decoded %zu of %zu points\n", name, i, times.size());
+        return false;
+    }
+    return true;
+}
+
+static bool CheckFloatRoundTrip(const char* name, const std::vector<uint64_t>& times, const std::vector<float>& values) {
+    std::vector<uint8_t> block;
+    EncodeFloatBlock(times.data(), values.data(), times.size(), block);
+
+    HistoryBlockCursor cursor(block.data(), block.size());
+    size_t i = 0;
+    while (cursor.Next()) {
+        if (i >= times.size()) {
+            printf("  FAIL %s: decoded more than %zu points\n", name, times.size());
+            return false;
+        }
+        float value = cursor.GetFloat();
+        bool same = std::isnan(values[i]) ? std::isnan(value) : value == values[i];
+        if (cursor.GetTime() != times[i] || !same) {
+            printf("  FAIL %s: point %zu differs\n", name, i);
+            return false;
+        }
+        i++;
+    }
+    if (i != times.size()) {
+        printf("  FAIL %s: decoded %zu of %zu points\n", name, i, times.size());
+        return false;
+    }
+    return true;
+}
+
+static bool RunEdgeCases() {
+    bool ok = true;
+    std::vector<uint64_t> times;
+    std::vector<int64_t> values;
+    ok &= CheckIntegerRoundTrip("empty", times, values);
+
+    times.push_back(1700000000000ULL);
+    values.push_back(-5);
+    ok &= CheckIntegerRoundTrip("single point", times, values);
+
+    // Irregular timestamps, extreme values and wrapping deltas
+    const int64_t extremes[] = {
+        std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(), 0, -1, 1,
+        std::numeric_limits<int64_t>::min(), 123456789, 4096, 8192, -4096
+    };
+    uint64_t time = times[0];
+    for (size_t i = 0; i < sizeof(extremes) / sizeof(extremes[0]); i++) {
+        time += (i % 3 == 0) ? 1000 : (i % 3 == 1 ? 1 : 86400000ULL * 365);
+        times.push_back(time);
+        values.push_back(extremes[i]);
+    }
+    ok &= CheckIntegerRoundTrip("extremes", times, values);
+
+    std::vector<float> floats;
+    for (size_t i = 0; i < times.size(); i++) floats.push_back((float)i * 0.37f);
+    floats[2] = std::numeric_limits<float>::quiet_NaN();
+    floats[3] = -0.0f;
+    floats[4] = std::numeric_limits<float>::infinity();
+    ok &= CheckFloatRoundTrip("float specials", times, floats);
+
+    // A truncated block must stop cleanly instead of reading past the end
+    std::vector<uint8_t> block;
+    EncodeIntegerBlock(times.data(), values.data(), times.size(), block);
+    HistoryBlockCursor cursor(block.data(), block.size() / 2);
+    size_t decoded = 0;
+    while (cursor.Next()) decoded++;
+    if (decoded >= times.size()) {
+        printf("  FAIL truncated block decoded %zu points\n", decoded);
+        ok = false;
+    }
+    return ok;
+}
+
+// Working set: page-granular, changing on a few percent of samples
+static void MakeWorkingSet(std::vector<uint64_t>& times, std::vector<int64_t>& values, BenchRandom& random) {
+    int64_t workingSet = 48LL * 1024 * 1024;
+    for (size_t i = 0; i < kPoints; i++) {
+        times.push_back(1700000000000ULL + i * 60000);
+        if (random.Below(100) < 8) workingSet += ((int64_t)random.Below(512) - 240) * 4096;
+        values.push_back(workingSet);
+    }
+}
+
+// CPU in hundredths of a percent of a busy process: a new minute mean every sample
+static void MakeBusyCpu(std::vector<uint64_t>& times, std::vector<int64_t>& values, BenchRandom& random) {
+    for (size_t i = 0; i < kPoints; i++) {
+        times.push_back(1700000000000ULL + i * 60000);
+        values.push_back(1200 + (int64_t)random.Below(600) - 300);
+    }
+}
+
+// CPU in hundredths of a percent: mostly idle with occasional bursts
+static void MakeCpu(std::vector<uint64_t>& times, std::vector<int64_t>& values, BenchRandom& random) {
+    int64_t cpu = 0;
+    for (size_t i = 0; i < kPoints; i++) {
+        times.push_back(1700000000000ULL + i * 60000);
+        uint32_t roll = random.Below(100);
+        if (roll < 5) cpu = random.Below(2500);
+        else if (roll < 15) cpu = 0;
+        values.push_back(cpu);
+    }
+}
+
+// 'targetRatio' 0 reports the ratio without checking it
+static bool RunSeries(const char* name, const std::vector<uint64_t>& times, const std::vector<int64_t>& values,
+                      double targetRatio) {
+    if (!CheckIntegerRoundTrip(name, times, values)) return false;
+
+    std::vector<uint8_t> block;
+    block.reserve(GetMaxEncodedSize(kPoints));
+    BenchTimer timer;
+    for (int round = 0; round < kRounds; round++) {
+        EncodeIntegerBlock(times.data(), values.data(), times.size(), block);
+    }
+    double encodeSeconds = timer.ElapsedSeconds();
+
+    timer.Restart();
+    int64_t checksum = 0;
+    for (int round = 0; round < kRounds; round++) {
+        HistoryBlockCursor cursor(block.data(), block.size());
+        while (cursor.Next()) checksum += cursor.GetValue();
+    }
+    double decodeSeconds = timer.ElapsedSeconds();
+    g_sink = checksum;
+
+    timer.Restart();
+    HistoryAggregate aggregate;
+    for (int round = 0; round < kRounds; round++) {
+        AggregateHistoryBlock(block.data(), block.size(), times[kPoints / 4], times[kPoints * 3 / 4], aggregate);
+    }
+    double aggregateSeconds = timer.ElapsedSeconds();
+
+    double expectedSum = 0;
+    for (size_t i = kPoints / 4; i <= kPoints * 3 / 4; i++) expectedSum += (double)values[i];
+    if (aggregate.count != kPoints / 2 + 1 || aggregate.sum != expectedSum) {
+        printf("  FAIL %s: aggregate of %u points, sum %.0f, expected %.0f\n", name, aggregate.count, aggregate.sum, expectedSum);
+        return false;
+    }
+
+    double rawBytes = (double)kPoints * 16;
+    double points = (double)kPoints * kRounds;
+    double ratio = rawBytes / block.size();
+    printf("  %-11s | %6zu bytes | %5.1fx | %6.2f bits/point | encode %6.1f Mpt/s | decode %6.1f Mpt/s | aggregate %6.1f Mpt/s%s\n",
+           name, block.size(), ratio, block.size() * 8.0 / kPoints,
+           points / encodeSeconds / 1e6, points / decodeSeconds / 1e6, points / aggregateSeconds / 1e6,
+           targetRatio > 0 ? "" : " (outside the target)");
+    if (ratio < targetRatio) {
+        printf("  FAIL %s: %.1fx, below the %.0fx target\n", name, ratio, targetRatio);
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("History block codec");
+    if (!RunEdgeCases()) return 1;
+    printf("  edge cases round-trip\n");
+    printf("  %zu points per block, ratio against 16-byte (timestamp, value) pairs\n", kPoints);
+
+    BenchRandom random;
+    std::vector<uint64_t> times;
+    std::vector<int64_t> values;
+    MakeWorkingSet(times, values, random);
+    if (!RunSeries("working set", times, values, CODEC_TARGET_RATIO)) return 1;
+
+    times.clear();
+    values.clear();
+    MakeCpu(times, values, random);
+    if (!RunSeries("cpu", times, values, CODEC_TARGET_RATIO)) return 1;
+
+    std::vector<int64_t> busyValues;
+    std::vector<uint64_t> busyTimes;
+    MakeBusyCpu(busyTimes, busyValues, random);
+    if (!RunSeries("busy cpu", busyTimes, busyValues, 0)) return 1;
+
+    // Float series as the in-memory history holds them
+    std::vector<float> floats;
+    for (size_t i = 0; i < kPoints; i++) floats.push_back(values[i] / 100.0f);
+    if (!CheckFloatRoundTrip("cpu float", times, floats)) return 1;
+    std::vector<uint8_t> block;
+    EncodeFloatBlock(times.data(), floats.data(), kPoints, block);
+    double ratio = kPoints * 16.0 / block.size();
+    printf("  %-11s | %6zu bytes | %5.1fx | %6.2f bits/point\n", "cpu float", block.size(), ratio, block.size() * 8.0 / kPoints);
+    if (ratio < CODEC_TARGET_RATIO) {
+        printf("  FAIL cpu float: %.1fx, below the %.0fx target\n", ratio, CODEC_TARGET_RATIO);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,305 @@
+// Minux Effects Benchmark
+// Checks the SIMD box blurs against the scalar reference on clipped, odd
+// sized regions and radii up to the clamp, and that blurring keeps a flat
+// surface flat and premultiplied pixels valid, and that shadows stretched
+// from sliced textures match the whole shape blurred, and that reused glass
+// matches glass blurred afresh. Then times box and Gaussian blurs at 600x400
+// and 4K, where the cost should not grow with the radius, and composites the
+// main window's effects (glass title bar, shadows under the buttons and the
+// panel, a glow on the hovered button): after a full first frame builds the
+// shadow textures and the glass, the hover moves every frame and only its
+// update region is repainted. Those frames have to fit in
+// EFFECTS_FRAME_BUDGET_US at both sizes and add up to a full repaint.
+
+#include <cstring>
+#include "bench_util.h"
+#include "../core/minux_effects.h"
+
+static void FillRandom(PixelImage& image, BenchRandom& random) {
+    for (uint32_t& pixel : image.pixels) {
+        uint32_t alpha = random.Below(4) == 0 ? 255 : random.Below(256);
+        pixel = PixelPremultiply((alpha << 24) | (uint32_t)(random.Next() & 0xFFFFFF));
+    }
+}
+
+static bool CheckBlurs(PixelKernelSet best) {
+    BenchRandom random(7);
+    std::vector<uint32_t> scratch;
+    PixelImage source, reference, candidate;
+    source.Resize(157, 93);
+
+    for (int round = 0; round < 60; round++) {
+        FillRandom(source, random);
+        PixelRect rect;
+        rect.left = (int)random.Below(60) - 10;
+        rect.top = (int)random.Below(40) - 10;
+        rect.right = rect.left + 1 + (int)random.Below(170);
+        rect.bottom = rect.top + 1 + (int)random.Below(100);
+        int radius = round == 0 ? 200 : round == 1 ? EFFECTS_MAX_BOX_RADIUS : (int)random.Below(40);
+        bool gaussian = random.Below(3) == 0;
+
+        SetPixelKernels(PIXEL_KERNELS_SCALAR);
+        reference = source;
+        PixelSurface referenceSurface = reference.GetSurface();
+        if (gaussian) PixelGaussianBlur(referenceSurface, rect, radius / 2.0f, scratch);
+        else PixelBoxBlur(referenceSurface, rect, radius, scratch);
+
+        for (uint32_t pixel : reference.pixels) {
+            uint32_t alpha = pixel >> 24;
+            if (((pixel >> 16) & 0xFF) > alpha || ((pixel >> 8) & 0xFF) > alpha || (pixel & 0xFF) > alpha) {
+                printf("  FAIL blur produced invalid premultiplied pixel %08X\n", pixel);
+                return false;
+            }
+        }
+
+        for (int set = PIXEL_KERNELS_SSE2; set <= best; set++) {
+            SetPixelKernels((PixelKernelSet)set);
+            candidate = source;
+            PixelSurface candidateSurface = candidate.GetSurface();
+            if (gaussian) PixelGaussianBlur(candidateSurface, rect, radius / 2.0f, scratch);
+            else PixelBoxBlur(candidateSurface, rect, radius, scratch);
+            if (candidate.pixels != reference.pixels) {
+                printf("  FAIL %s %s blur radius %d differs from scalar\n", GetPixelKernelName((PixelKernelSet)set),
+                       gaussian ? "Gaussian" : "box", radius);
+                return false;
+            }
+        }
+    }
+
+    // A flat surface stays flat at every radius
+    SetPixelKernels(best);
+    PixelImage flat;
+    flat.Resize(64, 48);
+    PixelSurface flatSurface = flat.GetSurface();
+    uint32_t color = PixelPremultiply(PIXEL_ARGB(200, 41, 128, 185));
+    PixelFill(flatSurface, PixelRect{ 0, 0, 64, 48 }, color);
+    for (int radius = 1; radius <= 50; radius += 7) {
+        PixelBoxBlur(flatSurface, PixelRect{ 0, 0, 64, 48 }, radius, scratch);
+        for (uint32_t pixel : flat.pixels) {
+            if (pixel != color) {
+                printf("  FAIL flat surface changed to %08X at radius %d\n", pixel, radius);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Shadows stretched from a sliced texture match blurring the whole shape
+static bool CheckShadows() {
+    BenchRandom random(11);
+    std::vector<uint32_t> scratch;
+    PixelImage background, drawn, expected, texture;
+    background.Resize(420, 300);
+    FillRandom(background, random);
+
+    for (int round = 0; round < 40; round++) {
+        int blur = (int)random.Below(12), corner = (int)random.Below(20);
+        PixelRect rect;
+        rect.left = (int)random.Below(200) - 30;
+        rect.top = (int)random.Below(150) - 30;
+        rect.right = rect.left + 1 + (int)random.Below(300);
+        rect.bottom = rect.top + 1 + (int)random.Below(200);
+        uint32_t color = PixelPremultiply(PIXEL_ARGB(random.Below(256), random.Below(256), random.Below(256), random.Below(256)));
+
+        EffectsCompositor effects;
+        drawn = background;
+        effects.DrawShadow(drawn.GetSurface(), rect, corner, blur, 3, 5, color);
+
+        int pad = 3 * blur, width = rect.right - rect.left, height = rect.bottom - rect.top;
+        texture.Resize(width + 2 * pad, height + 2 * pad);
+        PixelSurface textureSurface = texture.GetSurface();
+        PixelBlendRoundRect(textureSurface, PixelRect{ pad, pad, pad + width, pad + height }, corner, color);
+        PixelGaussianBlur(textureSurface, PixelRect{ 0, 0, texture.width, texture.height }, (float)blur, scratch);
+        expected = background;
+        PixelBlendImage(expected.GetSurface(), rect.left + 3 - pad, rect.top + 5 - pad, textureSurface);
+
+        if (drawn.pixels != expected.pixels) {
+            printf("  FAIL %dx%d shadow, corner %d, blur %d differs from the unsliced texture\n",
+                   width, height, corner, blur);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Glass copied back while the content is unchanged matches glass blurred again
+static bool CheckGlass() {
+    BenchRandom random(13);
+    PixelImage background, fresh, reused;
+    background.Resize(300, 200);
+    FillRandom(background, random);
+    PixelRect rect = { -20, 10, 250, 90 };
+    uint32_t tint = PixelPremultiply(PIXEL_ARGB(120, 52, 73, 94));
+
+    EffectsCompositor plain, cached;
+    for (int version = 1; version <= 3; version++) {
+        if (version == 3) FillRandom(background, random);
+        fresh = background;
+        plain.DrawGlass(fresh.GetSurface(), rect, 7.0f, tint);
+        reused = background;
+        cached.DrawGlass(reused.GetSurface(), rect, 7.0f, tint, version < 3 ? 1 : 2);
+        if (reused.pixels != fresh.pixels) {
+            printf("  FAIL glass differs from a fresh blur in round %d\n", version);
+            return false;
+        }
+    }
+    if (cached.GetStats().glassReuses != 1 || plain.GetStats().glassReuses != 0) {
+        printf("  FAIL glass reused %llu times, expected once\n", (unsigned long long)cached.GetStats().glassReuses);
+        return false;
+    }
+    return true;
+}
+
+static void MeasureBlurs(int width, int height, PixelKernelSet best) {
+    PixelImage image;
+    image.Resize(width, height);
+    BenchRandom random(5);
+    FillRandom(image, random);
+    PixelSurface surface = image.GetSurface();
+    PixelRect all = { 0, 0, width, height };
+    std::vector<uint32_t> scratch;
+    int rounds = (int)(20e6 / ((double)width * height)) + 1;
+
+    printf("  %dx%d, ms per blur:\n", width, height);
+    static const struct { const char* name; int radius; float sigma; } kBlurs[] = {
+        { "box r=4", 4, 0 }, { "box r=32", 32, 0 }, { "Gaussian s=8", 0, 8 },
+    };
+    for (const auto& blur : kBlurs) {
+        printf("    %-14s", blur.name);
+        double scalarMs = 0;
+        for (int set = PIXEL_KERNELS_SCALAR; set <= best; set++) {
+            SetPixelKernels((PixelKernelSet)set);
+            BenchTimer timer;
+            for (int i = 0; i < rounds; i++) {
+                if (blur.sigma > 0) PixelGaussianBlur(surface, all, blur.sigma, scratch);
+                else PixelBoxBlur(surface, all, blur.radius, scratch);
+            }
+            double ms = timer.ElapsedSeconds() * 1e3 / rounds;
+            if (set == PIXEL_KERNELS_SCALAR) scalarMs = ms;
+            printf(set == PIXEL_KERNELS_SCALAR ? " %s %8.3f" : " | %s %8.3f (%.1fx)",
+                   GetPixelKernelName((PixelKernelSet)set), ms, scalarMs / ms);
+        }
+        putchar('\n');
+    }
+}
+
+static PixelRect GetButtonRect(float scale, int button) {
+    return PixelRect{ (int)((10 + 105 * button) * scale), (int)(50 * scale),
+                      (int)((110 + 105 * button) * scale), (int)(85 * scale) };
+}
+
+// The main window's effects with its 600x400 layout scaled by 'scale'; the
+// background never changes, so the glass content version stays the same
+static void DrawWindowEffects(EffectsCompositor& effects, const PixelSurface& surface, float scale, int hovered) {
+    auto at = [scale](int value) { return (int)(value * scale); };
+    uint32_t shadow = PixelPremultiply(PIXEL_ARGB(110, 0, 0, 0));
+    uint32_t glow = PixelPremultiply(PIXEL_ARGB(160, 41, 128, 185));
+    uint32_t tint = PixelPremultiply(PIXEL_ARGB(120, 52, 73, 94));
+
+    effects.DrawGlass(surface, PixelRect{ 0, 0, surface.width, at(40) }, 6.0f * scale, tint, 1);
+    effects.DrawShadow(surface, PixelRect{ at(10), at(100), at(580), at(300) }, at(4), at(6), 0, at(3), shadow);
+    for (int button = 0; button < 5; button++) {
+        PixelRect rect = GetButtonRect(scale, button);
+        effects.DrawShadow(surface, rect, at(8), at(4), 0, at(2), shadow);
+        if (button == hovered) effects.DrawGlow(surface, rect, at(8), at(6), at(2), glow);
+    }
+}
+
+// What moving the hover from one button to another invalidates: both glows
+static PixelRect GetHoverDirtyRect(float scale, int from, int to) {
+    int reach = (int)(2 * scale) + 3 * (int)(6 * scale);
+    PixelRect a = GetButtonRect(scale, from), b = GetButtonRect(scale, to);
+    PixelRect dirty = { (a.left < b.left ? a.left : b.left) - reach, a.top - reach,
+                        (a.right > b.right ? a.right : b.right) + reach, a.bottom + reach };
+    return dirty;
+}
+
+// Paints the window once, then moves the hover every frame and repaints only
+// what that invalidates, as WM_PAINT does with the back buffer's update region
+static bool MeasureFrames(int width, int height, float scale) {
+    PixelImage background, frame, expected;
+    background.Resize(width, height);
+    PixelSurface backgroundSurface = background.GetSurface();
+    PixelGradient(backgroundSurface, PixelRect{ 0, 0, width, height },
+                  PIXEL_ARGB(255, 52, 73, 94), PIXEL_ARGB(255, 44, 62, 80), true);
+
+    EffectsCompositor effects;
+    const int frames = 120;
+    uint64_t firstUs = 0, steadyUs = 0, worstUs = 0;
+    frame = background;
+    PixelSurface surface = frame.GetSurface();
+    effects.BeginFrame();
+    DrawWindowEffects(effects, surface, scale, 0);
+    effects.EndFrame();
+    firstUs = effects.GetStats().lastFrameUs;
+
+    for (int i = 1; i < frames; i++) {
+        PixelRect dirty = GetHoverDirtyRect(scale, (i - 1) % 5, i % 5);
+        PixelRect clip = { dirty.left > 0 ? dirty.left : 0, dirty.top > 0 ? dirty.top : 0,
+                           dirty.right < width ? dirty.right : width, dirty.bottom < height ? dirty.bottom : height };
+        for (int y = clip.top; y < clip.bottom; y++) {
+            memcpy(&frame.pixels[(size_t)y * width + clip.left], &background.pixels[(size_t)y * width + clip.left],
+                   (size_t)(clip.right - clip.left) * sizeof(uint32_t));
+        }
+        effects.BeginFrame(dirty);
+        DrawWindowEffects(effects, surface, scale, i % 5);
+        effects.EndFrame();
+        uint64_t us = effects.GetStats().lastFrameUs;
+        steadyUs += us;
+        if (us > worstUs) worstUs = us;
+    }
+
+    EffectsStats stats = effects.GetStats();
+    double averageUs = (double)steadyUs / (frames - 1);
+    printf("  %dx%d frame: first %.2f ms, then %.3f ms average, %.3f ms worst (budget %.1f ms); "
+           "%zu textures, %zu KB, %llu hits, %llu misses\n",
+           width, height, firstUs / 1000.0, averageUs / 1000.0, worstUs / 1000.0,
+           EFFECTS_FRAME_BUDGET_US / 1000.0, stats.cachedTextures, stats.cachedBytes / 1024,
+           (unsigned long long)stats.hits, (unsigned long long)stats.misses);
+
+    // Buttons share a size, so the panel shadow, the button shadow and the glow are all that is ever built
+    if (stats.misses != 3) {
+        printf("  FAIL %llu texture misses, expected 3\n", (unsigned long long)stats.misses);
+        return false;
+    }
+    if (stats.glassReuses != frames - 1) {
+        printf("  FAIL glass reused in %llu of %d frames\n", (unsigned long long)stats.glassReuses, frames - 1);
+        return false;
+    }
+
+    // The repainted regions add up to the window painted in one go
+    EffectsCompositor fresh;
+    expected = background;
+    fresh.BeginFrame();
+    DrawWindowEffects(fresh, expected.GetSurface(), scale, (frames - 1) % 5);
+    fresh.EndFrame();
+    if (frame.pixels != expected.pixels) {
+        printf("  FAIL the repainted regions differ from a full repaint\n");
+        return false;
+    }
+    if (averageUs > EFFECTS_FRAME_BUDGET_US) {
+        printf("  FAIL steady frames average %.0f us, over the %d us budget\n", averageUs, EFFECTS_FRAME_BUDGET_US);
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Effects compositor");
+
+    PixelKernelSet best = GetBestPixelKernels();
+    printf("  kernel sets up to %s\n", GetPixelKernelName(best));
+    if (!CheckBlurs(best)) return 1;
+    SetPixelKernels(best);
+    if (!CheckShadows()) return 1;
+    if (!CheckGlass()) return 1;
+
+    MeasureBlurs(600, 400, best);
+    MeasureBlurs(3840, 2160, best);
+
+    SetPixelKernels(best);
+    if (!MeasureFrames(600, 400, 1.0f)) return 1;
+    if (!MeasureFrames(3840, 2160, 5.4f)) return 1;     // the layout at 4K height
+    return 0;
+}
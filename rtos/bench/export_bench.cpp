@@ -0,0 +1,190 @@
+// Minux Export Benchmark
+// Streams synthetic snapshots through the CSV, NDJSON and binary exporters
+// into a discarding sink and reports rows/s and MB/s. Checks the exact text
+// of known rows, including quoting, escaping and UTF-8, and that steady-state
+// export never allocates.
+
+#include <cstring>
+#include <string>
+#define MINUX_BENCH_COUNT_ALLOCATIONS     // counts into g_allocations
+#include "bench_util.h"
+#include "../core/minux_export.h"
+
+static const size_t kProcesses = 1000;
+static const size_t kInterfaces = 4;
+static const int kSnapshots = 200;
+
+// Keeps only a checksum, as a pipe or socket would take the bytes away
+class DiscardSink : public ExportSink {
+public:
+    DiscardSink() : m_bytes(0), m_checksum(0) {}
+    bool Write(const char* data, size_t size) override {
+        m_bytes += size;
+        m_checksum += (unsigned char)data[size - 1];
+        return true;
+    }
+    uint64_t m_bytes;
+    uint64_t m_checksum;
+};
+
+static bool CheckText(const char* name, SnapshotExporter& exporter, const char* expected) {
+    std::string text(exporter.GetData(), exporter.GetSize());
+    if (text != expected) {
+        printf("  FAIL %s:\n    got      %s\n    expected %s\n", name, text.c_str(), expected);
+        return false;
+    }
+    return true;
+}
+
+static bool RunFormatChecks() {
+    MinuxSnapshot snapshot;
+    snapshot.timestamp = 1700000000123ULL;
+    snapshot.processes.resize(1);
+    ProcessInfo& process = snapshot.processes[0];
+    process = ProcessInfo();
+    process.processId = 4242;
+    process.nameId = InternName(L"we\"ird,name\u00e9\U0001F680\t\\");
+    process.workingSetSize = 123456789012ULL;
+    process.cpuUsage = 1205;
+    process.threadCount = 17;
+    process.creationTime = 18446744073709551615ULL;
+
+    snapshot.interfaces.resize(1);
+    NetworkInfo& network = snapshot.interfaces[0];
+    network = NetworkInfo();
+    swprintf(network.adapterName, 256, L"eth0");
+    swprintf(network.ipAddress, 16, L"10.0.0.1");
+    swprintf(network.macAddress, 18, L"02:00:00:00:00:01");
+    network.bytesReceived = 123456789012345ULL;
+    network.bytesSent = 0;
+    network.packetsReceived = 7;
+    network.packetsSent = 100;
+    network.errorsReceived = 3;
+    network.dropsSent = 12;
+    network.bytesReceivedPerSecond = 3125000000ULL;     // 25 Gbit/s
+    network.bytesSentPerSecond = 42;
+    network.packetsReceivedPerSecond = 5;
+    network.packetsSentPerSecond = 900;
+    network.rateIntervalMs = 1000;
+    network.isConnected = true;
+
+    SnapshotExporter csv(EXPORT_CSV);
+    csv.Write(snapshot);
+    if (!CheckText("csv", csv,
+        "kind,timestamp,pid,name,working_set,cpu,threads,creation_time\n"
+        "process,1700000000123,4242,\"we\"\"ird,name\xC3\xA9\xF0\x9F\x9A\x80\t\\\",123456789012,12.05,17,18446744073709551615\n"
+        "kind,timestamp,adapter,ip,mac,bytes_received,bytes_sent,packets_received,packets_sent,"
+        "errors_received,errors_sent,drops_received,drops_sent,bytes_received_per_second,bytes_sent_per_second,"
+        "packets_received_per_second,packets_sent_per_second,rate_interval_ms,connected\n"
+        "interface,1700000000123,eth0,10.0.0.1,02:00:00:00:00:01,123456789012345,0,7,100,3,0,0,12,3125000000,42,5,900,1000,1\n")) return false;
+
+    // Headers appear only once per kind
+    csv.Reset();
+    snapshot.processes[0].cpuUsage = 7;
+    csv.Write(snapshot, EXPORT_PROCESSES);
+    if (!CheckText("csv repeat", csv,
+        "process,1700000000123,4242,\"we\"\"ird,name\xC3\xA9\xF0\x9F\x9A\x80\t\\\",123456789012,0.07,17,18446744073709551615\n")) return false;
+
+    SnapshotExporter json(EXPORT_NDJSON);
+    json.Write(snapshot);
+    if (!CheckText("ndjson", json,
+        "{\"kind\":\"process\",\"timestamp\":1700000000123,\"pid\":4242,"
+        "\"name\":\"we\\\"ird,name\xC3\xA9\xF0\x9F\x9A\x80\\t\\\\\",\"working_set\":123456789012,"
+        "\"cpu\":0.07,\"threads\":17,\"creation_time\":18446744073709551615}\n"
+        "{\"kind\":\"interface\",\"timestamp\":1700000000123,\"adapter\":\"eth0\",\"ip\":\"10.0.0.1\","
+        "\"mac\":\"02:00:00:00:00:01\",\"bytes_received\":123456789012345,\"bytes_sent\":0,"
+        "\"packets_received\":7,\"packets_sent\":100,\"errors_received\":3,\"errors_sent\":0,"
+        "\"drops_received\":0,\"drops_sent\":12,\"bytes_received_per_second\":3125000000,"
+        "\"bytes_sent_per_second\":42,\"packets_received_per_second\":5,\"packets_sent_per_second\":900,"
+        "\"rate_interval_ms\":1000,\"connected\":true}\n")) return false;
+
+    // Binary: walk the records by their length prefixes
+    SnapshotExporter binary(EXPORT_BINARY);
+    binary.Write(snapshot);
+    const unsigned char* data = (const unsigned char*)binary.GetData();
+    size_t size = binary.GetSize();
+    uint32_t first = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+    size_t nameLength = data[4 + 1 + 8 + 4] | (data[4 + 1 + 8 + 5] << 8);
+    if (data[4] != EXPORT_KIND_PROCESS || nameLength != 19 || first != 1 + 8 + 4 + 2 + nameLength + 8 + 4 + 4 + 8 ||
+        4 + first >= size || data[4 + first + 4] != EXPORT_KIND_INTERFACE) {
+        printf("  FAIL binary record layout\n");
+        return false;
+    }
+    const unsigned char* record = data + 4 + first;
+    uint32_t second = record[0] | (record[1] << 8) | (record[2] << 16) | ((uint32_t)record[3] << 24);
+    const unsigned char* interval = record + 4 + second - 1 - 4;      // before the connected byte
+    if (second != 1 + 8 + (2 + 4) + (2 + 8) + (2 + 17) + 12 * 8 + 4 + 1 || 4 + first + 4 + second != size ||
+        (interval[0] | (interval[1] << 8)) != 1000) {
+        printf("  FAIL binary interface record layout\n");
+        return false;
+    }
+    return true;
+}
+
+static bool RunThroughput(const char* name, ExportFormat format, const std::vector<MinuxSnapshot>& snapshots) {
+    DiscardSink sink;
+    SnapshotExporter exporter(format, &sink);
+
+    // First pass sizes the buffer; the measured passes must not allocate
+    exporter.Write(snapshots[0]);
+    exporter.Flush();
+    size_t allocationsBefore = g_allocations;
+
+    BenchTimer timer;
+    for (int i = 0; i < kSnapshots; i++) exporter.Write(snapshots[i % snapshots.size()]);
+    exporter.Flush();
+    double seconds = timer.ElapsedSeconds();
+    size_t allocations = g_allocations - allocationsBefore;
+
+    uint64_t rows = (uint64_t)kSnapshots * (kProcesses + kInterfaces);
+    if (exporter.GetRowCount() != rows + kProcesses + kInterfaces || sink.m_bytes != exporter.GetByteCount()) {
+        printf("  FAIL %s: %llu rows, %llu of %llu bytes reached the sink\n", name,
+               (unsigned long long)exporter.GetRowCount(), (unsigned long long)sink.m_bytes,
+               (unsigned long long)exporter.GetByteCount());
+        return false;
+    }
+    if (allocations != 0) {
+        printf("  FAIL %s: %zu allocations while exporting\n", name, allocations);
+        return false;
+    }
+
+    double bytes = (double)sink.m_bytes * kSnapshots / (kSnapshots + 1);
+    printf("  %-7s | %6.1f bytes/row | %7.2f M rows/s | %7.1f MB/s | 0 allocations\n",
+           name, bytes / rows, rows / seconds / 1e6, bytes / seconds / 1048576.0);
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Snapshot export");
+    if (!RunFormatChecks()) return 1;
+    printf("  csv, ndjson and binary rows match their expected bytes\n");
+
+    // A few distinct snapshots so the loop does not format identical memory
+    BenchRandom random;
+    std::vector<MinuxSnapshot> snapshots(8);
+    std::vector<ProcessInfo> processes;
+    MakeSyntheticProcesses(processes, kProcesses, random);
+    for (size_t i = 0; i < snapshots.size(); i++) {
+        TickSyntheticProcesses(processes, random, 10);
+        snapshots[i].timestamp = 1700000000000ULL + i * 1000;
+        snapshots[i].sequence = i;
+        snapshots[i].processes = processes;
+        snapshots[i].interfaces.resize(kInterfaces);
+        for (size_t n = 0; n < kInterfaces; n++) {
+            NetworkInfo& info = snapshots[i].interfaces[n];
+            info = NetworkInfo();
+            swprintf(info.adapterName, 256, L"Ethernet Adapter %zu", n);
+            swprintf(info.ipAddress, 16, L"192.168.1.%zu", n + 10);
+            swprintf(info.macAddress, 18, L"02:00:00:00:00:%02zu", n);
+            info.bytesReceived = random.Below(1u << 31);
+            info.bytesSent = random.Below(1u << 31);
+            info.isConnected = true;
+        }
+    }
+    printf("  %d snapshots of %zu processes and %zu interfaces\n", kSnapshots, kProcesses, kInterfaces);
+
+    if (!RunThroughput("csv", EXPORT_CSV, snapshots)) return 1;
+    if (!RunThroughput("ndjson", EXPORT_NDJSON, snapshots)) return 1;
+    if (!RunThroughput("binary", EXPORT_BINARY, snapshots)) return 1;
+    return 0;
+}
@@ -0,0 +1,211 @@
+// Minux Process Filter Benchmark
+// Checks parsed queries against a plain reference evaluation over 100k
+// synthetic processes with 20k distinct names, and the SSE2 substring
+// search against the scalar one over the whole name pool. Then measures
+// what the filter box costs: searching the pool with each kernel, one
+// filter pass per snapshot next to diffing that snapshot, and the list
+// model's work for each keystroke while a query is typed.
+
+#include <algorithm>
+#include <cwctype>
+#include "bench_util.h"
+#include "../core/minux_filter.h"
+#include "../core/minux_procdiff.h"
+#include "../core/minux_procview.h"
+
+#define FILTER_BENCH_PROCESSES  100000
+#define FILTER_BENCH_NAMES      20000
+#define FILTER_BENCH_TICKS      50
+
+static std::wstring Lower(const wchar_t* text) {
+    std::wstring lower;
+    for (; *text; text++) lower.push_back((wchar_t)towlower((wint_t)*text));
+    return lower;
+}
+
+static bool ReferenceGlob(const wchar_t* text, const wchar_t* pattern) {
+    if (*pattern == L'\0') return *text == L'\0';
+    if (*pattern == L'*') return ReferenceGlob(text, pattern + 1) || (*text && ReferenceGlob(text + 1, pattern));
+    return *text && (*pattern == L'?' || *pattern == *text) && ReferenceGlob(text + 1, pattern + 1);
+}
+
+// One query written out by hand: name terms plus inclusive ranges
+struct ReferenceQuery {
+    const wchar_t* text;
+    const wchar_t* contains;        // NULL for none
+    const wchar_t* glob;            // NULL for none
+    uint64_t memoryLow, memoryHigh;
+    uint64_t cpuLow, cpuHigh;
+    uint64_t threadsLow, threadsHigh;
+};
+
+static bool ReferenceMatches(const ReferenceQuery& query, const ProcessInfo& info) {
+    std::wstring name = Lower(GetName(info.nameId));
+    if (query.contains && name.find(query.contains) == std::wstring::npos) return false;
+    if (query.glob && !ReferenceGlob(name.c_str(), query.glob)) return false;
+    return info.workingSetSize >= query.memoryLow && info.workingSetSize <= query.memoryHigh &&
+           info.cpuUsage >= query.cpuLow && info.cpuUsage <= query.cpuHigh &&
+           info.threadCount >= query.threadsLow && info.threadCount <= query.threadsHigh;
+}
+
+static void MakeProcesses(std::vector<ProcessInfo>& processes, BenchRandom& random) {
+    static const wchar_t* words[] = { L"Host", L"Render", L"Chrome", L"Indexer", L"Sync", L"Audio", L"Update", L"Net" };
+    MakeSyntheticProcesses(processes, FILTER_BENCH_PROCESSES, random);
+    wchar_t name[64];
+    for (ProcessInfo& info : processes) {
+        if (random.Below(10) < 3) continue;         // keep one of the common names
+        uint32_t id = random.Below(FILTER_BENCH_NAMES);
+        swprintf(name, 64, L"svc-%ls-%u.EXE", words[id % 8], id);
+        info.nameId = InternName(name);
+    }
+}
+
+static bool CheckQueries(const std::vector<ProcessInfo>& processes) {
+    const uint64_t all = UINT64_MAX;
+    const ReferenceQuery queries[] = {
+        { L"chrome",                    L"chrome", NULL, 0, all, 0, all, 0, all },
+        { L"CHROME mem>200MB",          L"chrome", NULL, (200ULL << 20) + 1, all, 0, all, 0, all },
+        { L"cpu>=5 threads<10",         NULL, NULL, 0, all, 500, all, 0, 9 },
+        { L"svc-*-12?.exe",             NULL, L"svc-*-12?.exe", 0, all, 0, all, 0, all },
+        { L"ost-1 mem<=0.5gb cpu<2.5",  L"ost-1", NULL, 0, 512ULL << 20, 0, 249, 0, all },
+        { L"name=xe threads=7",         L"xe", NULL, 0, all, 0, all, 7, 7 },
+        { L"minux- mem:1024",           L"minux-", NULL, 1ULL << 30, 1ULL << 30, 0, all, 0, all },
+        { L"x.exe",                     L"x.exe", NULL, 0, all, 0, all, 0, all },
+        { L"cpu>5 cpu<5",               NULL, NULL, 1, 0, 0, all, 0, all },
+    };
+
+    ProcessFilter filter;
+    std::vector<uint32_t> rows;
+    for (const ReferenceQuery& query : queries) {
+        if (!filter.SetQuery(query.text)) {
+            printf("  FAIL query \"%ls\" does not parse\n", query.text);
+            return false;
+        }
+        filter.Apply(processes, rows);
+        size_t next = 0;
+        for (size_t i = 0; i < processes.size(); i++) {
+            bool expected = ReferenceMatches(query, processes[i]);
+            bool listed = next < rows.size() && rows[next] == i;
+            if (listed) next++;
+            if (expected != listed) {
+                printf("  FAIL query \"%ls\" %s %ls (row %zu)\n", query.text, listed ? "accepts" : "rejects",
+                       GetName(processes[i].nameId), i);
+                return false;
+            }
+        }
+    }
+
+    // Malformed terms are reported where they start and leave the filter alone
+    const wchar_t* bad[] = { L"chrome size>5", L"mem>lots", L"threads>1.5", L"cpu>5 mem>2XB", L"name<foo" };
+    const size_t offsets[] = { 7, 0, 0, 6, 0 };
+    for (int i = 0; i < 5; i++) {
+        size_t offset = (size_t)-1;
+        if (filter.SetQuery(bad[i], &offset) || offset != offsets[i]) {
+            printf("  FAIL \"%ls\" should fail at %zu, got %zu\n", bad[i], offsets[i], offset);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Both kernels must agree on every pooled name, terms at the start, middle and end included
+static bool CheckKernels(double& simdSeconds, double& scalarSeconds) {
+    const wchar_t* terms[] = { L"chrome", L"svc", L"EXE", L"render-1", L"x", L"-42.e", L"host-19999.exe", L"zz" };
+    size_t names = GetInternedNameCount();
+    std::vector<uint8_t> verdicts[2];
+    simdSeconds = scalarSeconds = 0;
+    for (const wchar_t* term : terms) {
+        for (int simd = 0; simd < 2; simd++) {
+            SetFilterSimd(simd != 0);
+            ProcessFilter filter;
+            filter.SetQuery(term);
+            ProcessInfo info = ProcessInfo();
+            verdicts[simd].assign(names + 1, 0);
+            BenchTimer timer;
+            for (NameId id = 1; id <= names; id++) {
+                info.nameId = id;
+                verdicts[simd][id] = filter.Matches(info);
+            }
+            (simd ? simdSeconds : scalarSeconds) += timer.ElapsedSeconds();
+        }
+        if (verdicts[0] != verdicts[1]) {
+            printf("  FAIL SSE2 and scalar search disagree on \"%ls\"\n", term);
+            return false;
+        }
+    }
+    SetFilterSimd(true);
+    simdSeconds /= 8;
+    scalarSeconds /= 8;
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Process filter");
+    BenchRandom random(23);
+    std::vector<ProcessInfo> processes;
+    MakeProcesses(processes, random);
+    printf("  %d processes, %zu interned names\n", FILTER_BENCH_PROCESSES, GetInternedNameCount());
+
+    if (!CheckQueries(processes)) return 1;
+    double simdSeconds, scalarSeconds;
+    if (!CheckKernels(simdSeconds, scalarSeconds)) return 1;
+    printf("  search the name pool: %s %6.2f ms, scalar %6.2f ms\n",
+           IsFilterSimdAvailable() ? "SSE2" : "(no SIMD)", simdSeconds * 1e3, scalarSeconds * 1e3);
+
+    // Per snapshot: a filter pass over the records, next to the diff a change-driven filter would need
+    ProcessFilter filter;
+    filter.SetQuery(L"svc mem>100MB cpu>1");
+    ProcessDiffEngine diff;
+    std::vector<ProcessChange> changes;
+    std::vector<uint32_t> rows;
+    std::vector<ProcessInfo> snapshot = processes;
+    diff.Diff(snapshot, changes);
+    double filterSeconds = 0, diffSeconds = 0;
+    for (int tick = 0; tick < FILTER_BENCH_TICKS; tick++) {
+        TickSyntheticProcesses(snapshot, random, 5);
+        BenchTimer timer;
+        filter.Apply(snapshot, rows);
+        filterSeconds += timer.ElapsedSeconds();
+        timer.Restart();
+        diff.Diff(snapshot, changes);
+        diffSeconds += timer.ElapsedSeconds();
+    }
+    printf("  per snapshot: filter pass %6.2f ms (%zu matches), diff alone %6.2f ms\n",
+           filterSeconds * 1e3 / FILTER_BENCH_TICKS, rows.size(), diffSeconds * 1e3 / FILTER_BENCH_TICKS);
+
+    // Per keystroke: the list model filters, ranks its window and formats the visible rows.
+    // No ranked prefix from the collector, so every keystroke selects the window itself.
+    const wchar_t* typed = L"chrome mem>200MB";
+    ProcessTableModel model;
+    model.SetProcesses(&processes, 0);
+    model.SetWindow(0, 19);
+    model.PrepareRows(0, 19);       // the unfiltered list was on screen before typing started
+    wchar_t query[64], buffer[MINUX_MAX_NAME];
+    double worst = 0, total = 0;
+    size_t keys = wcslen(typed);
+    for (size_t length = 1; length <= keys; length++) {
+        wcsncpy(query, typed, length);
+        query[length] = L'\0';
+        BenchTimer timer;
+        model.SetFilter(query);
+        model.SetWindow(0, 19);
+        model.PrepareRows(0, 19);
+        for (size_t row = 0; row < 20 && row < model.GetRowCount(); row++) {
+            for (int column = 0; column < PROCESS_COLUMN_COUNT; column++) model.CopyCellText(row, column, buffer, MINUX_MAX_NAME);
+        }
+        double seconds = timer.ElapsedSeconds();
+        worst = std::max(worst, seconds);
+        total += seconds;
+    }
+
+    // Typing narrowed the query all the way: the result equals a fresh pass
+    filter.SetQuery(typed);
+    filter.Apply(processes, rows);
+    if (model.GetRowCount() != rows.size()) {
+        printf("  FAIL typed query shows %zu rows, a fresh pass finds %zu\n", model.GetRowCount(), rows.size());
+        return 1;
+    }
+    printf("  typing \"%ls\" at %d rows: %6.2f ms per keystroke, worst %6.2f ms\n",
+           typed, FILTER_BENCH_PROCESSES, total * 1e3 / keys, worst * 1e3);
+    return 0;
+}
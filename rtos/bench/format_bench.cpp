@@ -0,0 +1,193 @@
+// Minux Number Formatting Benchmark
+// Checks the table-driven formatters against swprintf on random and edge
+// values (rounding ties included), then refreshes a 100k-cell table of PIDs,
+// megabytes and CPU percentages the way the process list does: once with
+// swprintf, once with the formatters, and once through per-cell caches while
+// 5% of the values change each tick.
+
+#include <cstring>
+#include "bench_util.h"
+#include "../core/minux_format.h"
+
+#define FORMAT_BENCH_ROWS    33334          // three numeric cells a row: 100k cells
+#define FORMAT_BENCH_TICKS   20
+
+static bool Expect(const wchar_t* got, size_t length, const wchar_t* want, const char* what, uint64_t value) {
+    if (wcscmp(got, want) == 0 && length == wcslen(want)) return true;
+    printf("  FAIL %s of %llu: \"%ls\" (length %zu), expected \"%ls\"\n", what, (unsigned long long)value, got, length, want);
+    return false;
+}
+
+// swprintf rendering of FormatByteSize's units, for comparison; a value
+// that rounds up to 1024 of a unit moves to the next one
+static void ReferenceByteSize(uint64_t bytes, wchar_t* out) {
+    if (bytes < (1ULL << 10)) {
+        swprintf(out, 32, L"%llu B", (unsigned long long)bytes);
+        return;
+    }
+    if (bytes < (1ULL << 20)) {
+        swprintf(out, 32, L"%.0f KB", bytes / 1024.0);
+        if (wcstod(out, NULL) < 1024) return;
+    }
+    if (bytes < (1ULL << 30)) {
+        swprintf(out, 32, L"%.1f MB", bytes / (1024.0 * 1024.0));
+        if (wcstod(out, NULL) < 1024) return;
+    }
+    if (bytes < (1ULL << 40)) {
+        swprintf(out, 32, L"%.2f GB", bytes / (1024.0 * 1024.0 * 1024.0));
+        if (wcstod(out, NULL) < 1024) return;
+    }
+    swprintf(out, 32, L"%.2f TB", (double)(bytes >> 10) / (1024.0 * 1024.0 * 1024.0));
+}
+
+static bool CheckValue(uint64_t value) {
+    wchar_t got[FORMAT_MAX_TEXT], want[32];
+    size_t length;
+
+    length = FormatUnsigned(value, got);
+    swprintf(want, 32, L"%llu", (unsigned long long)value);
+    if (!Expect(got, length, want, "FormatUnsigned", value)) return false;
+
+    // Bytes below 2^53 divide exactly in a double, so swprintf rounds the true quotient
+    uint64_t bytes = value & ((1ULL << 53) - 1);
+    length = FormatMegabytes(bytes, got);
+    swprintf(want, 32, L"%.1f", bytes / (1024.0 * 1024.0));
+    if (!Expect(got, length, want, "FormatMegabytes", bytes)) return false;
+
+    uint32_t hundredths = (uint32_t)value;
+    length = FormatHundredths(hundredths, got);
+    swprintf(want, 32, L"%.2f", hundredths / 100.0);
+    if (!Expect(got, length, want, "FormatHundredths", hundredths)) return false;
+
+    for (int decimals = 1; decimals <= 9; decimals++) {
+        uint64_t power = 1;
+        for (int i = 0; i < decimals; i++) power *= 10;
+        length = FormatFixed(value, decimals, got);
+        swprintf(want, 32, L"%llu.%0*llu", (unsigned long long)(value / power), decimals, (unsigned long long)(value % power));
+        if (!Expect(got, length, want, "FormatFixed", value)) return false;
+    }
+
+    length = FormatByteSize(bytes, got);
+    ReferenceByteSize(bytes, want);
+    return Expect(got, length, want, "FormatByteSize", bytes);
+}
+
+static bool CheckFormatters(BenchRandom& random) {
+    static const uint64_t edges[] = {
+        0, 1, 9, 10, 99, 100, 999, 1000, 1023, 1024, 4294967295ULL, 18446744073709551615ULL,
+        1ULL << 18, 3ULL << 18, 5ULL << 18, 7ULL << 18,                    // 0.25, 0.75, 1.25, 1.75 MB: ties
+        (1ULL << 20) - 1, 1ULL << 20, (1ULL << 30) - 1, 1ULL << 30, (1ULL << 40) - 1, 1ULL << 40,
+        (1ULL << 30) + (5ULL << 20) + (1ULL << 19)                           // 1.005... GB
+    };
+    for (uint64_t value : edges) {
+        if (!CheckValue(value)) return false;
+    }
+
+    // Values that round up to 1024 of a unit carry into the next one
+    static const struct { uint64_t bytes; const wchar_t* text; } carries[] = {
+        { 1048063, L"1023 KB" }, { 1048064, L"1.0 MB" }, { 1048575, L"1.0 MB" },
+        { 1073689395, L"1023.9 MB" }, { 1073689396, L"1.00 GB" }, { 1073741823, L"1.00 GB" },
+        { 1099506259066ULL, L"1023.99 GB" }, { 1099506259067ULL, L"1.00 TB" }, { (1ULL << 40) - 1, L"1.00 TB" }
+    };
+    for (const auto& carry : carries) {
+        wchar_t got[FORMAT_MAX_TEXT];
+        size_t length = FormatByteSize(carry.bytes, got);
+        if (!Expect(got, length, carry.text, "FormatByteSize", carry.bytes)) return false;
+    }
+    for (int i = 0; i < 200000; i++) {
+        uint64_t value = random.Next() >> random.Below(64);                 // every magnitude
+        if (i % 4 == 0) value = (value >> 18) << 18;                         // quarter-megabyte multiples hit ties
+        if (!CheckValue(value)) return false;
+    }
+    return true;
+}
+
+struct BenchRow {
+    uint32_t pid;
+    uint64_t bytes;
+    uint32_t cpu;
+};
+
+struct CellRow {
+    FormatCell pid;
+    FormatCell memory;
+    FormatCell cpu;
+};
+
+static void TickRows(std::vector<BenchRow>& rows, BenchRandom& random) {
+    for (BenchRow& row : rows) {
+        if (random.Below(100) < 5) {
+            row.bytes += (uint64_t)random.Below(64) * 4096;
+            row.cpu = random.Below(2500);
+        }
+    }
+}
+
+int main() {
+    PrintBenchHeader("Number formatting");
+
+    BenchRandom random(18);
+    if (!CheckFormatters(random)) return 1;
+    printf("  formatters match swprintf on 200k random and edge values\n");
+
+    std::vector<BenchRow> rows(FORMAT_BENCH_ROWS);
+    for (size_t i = 0; i < rows.size(); i++) {
+        rows[i].pid = (uint32_t)(4 + i * 4);
+        rows[i].bytes = (uint64_t)(random.Below(512 * 1024) + 64) * 1024;
+        rows[i].cpu = random.Below(2500);
+    }
+    std::vector<CellRow> cells(rows.size());
+    memset(cells.data(), 0, cells.size() * sizeof(CellRow));
+
+    double printfSeconds = 0, tableSeconds = 0, cachedSeconds = 0;
+    size_t checksum[3] = { 0, 0, 0 };
+    wchar_t text[FORMAT_MAX_TEXT];
+    for (int tick = 0; tick < FORMAT_BENCH_TICKS; tick++) {
+        TickRows(rows, random);
+
+        BenchTimer timer;
+        for (const BenchRow& row : rows) {
+            checksum[0] += swprintf(text, FORMAT_MAX_TEXT, L"%u", row.pid);
+            checksum[0] += swprintf(text, FORMAT_MAX_TEXT, L"%.1f", row.bytes / (1024.0 * 1024.0));
+            checksum[0] += swprintf(text, FORMAT_MAX_TEXT, L"%.2f", row.cpu / 100.0);
+        }
+        printfSeconds += timer.ElapsedSeconds();
+
+        timer.Restart();
+        for (const BenchRow& row : rows) {
+            checksum[1] += FormatUnsigned(row.pid, text);
+            checksum[1] += FormatMegabytes(row.bytes, text);
+            checksum[1] += FormatHundredths(row.cpu, text);
+        }
+        tableSeconds += timer.ElapsedSeconds();
+
+        timer.Restart();
+        for (size_t i = 0; i < rows.size(); i++) {
+            CellRow& cell = cells[i];
+            FormatCellText(cell.pid, rows[i].pid, FormatUnsigned);
+            FormatCellText(cell.memory, rows[i].bytes, FormatMegabytes);
+            FormatCellText(cell.cpu, rows[i].cpu, FormatHundredths);
+            checksum[2] += cell.pid.length + cell.memory.length + cell.cpu.length;
+        }
+        cachedSeconds += timer.ElapsedSeconds();
+    }
+
+    if (checksum[0] != checksum[1] || checksum[1] != checksum[2]) {
+        printf("  FAIL text lengths differ: swprintf %zu, table %zu, cached %zu\n", checksum[0], checksum[1], checksum[2]);
+        return 1;
+    }
+
+    double cellsPerRun = (double)rows.size() * 3 * FORMAT_BENCH_TICKS;
+    printf("  %zu cells, %d refreshes, 5%% of rows changing per refresh\n", rows.size() * 3, FORMAT_BENCH_TICKS);
+    printf("  swprintf:         %6.1f ns/cell, %7.2f ms per refresh\n",
+           printfSeconds * 1e9 / cellsPerRun, printfSeconds * 1e3 / FORMAT_BENCH_TICKS);
+    printf("  table formatters: %6.1f ns/cell, %7.2f ms per refresh (%.1fx)\n",
+           tableSeconds * 1e9 / cellsPerRun, tableSeconds * 1e3 / FORMAT_BENCH_TICKS, printfSeconds / tableSeconds);
+    printf("  cached cells:     %6.1f ns/cell, %7.2f ms per refresh (%.1fx)\n",
+           cachedSeconds * 1e9 / cellsPerRun, cachedSeconds * 1e3 / FORMAT_BENCH_TICKS, printfSeconds / cachedSeconds);
+    if (tableSeconds > printfSeconds) {
+        printf("  FAIL table formatters slower than swprintf\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+// Minux History Store Benchmark
+// Appends eight simulated days of snapshots (one every 5 s) to a history
+// store and reports the append cost. Verifies that memory stays constant,
+// that appends never allocate and that the coarse tiers hold the right means.
+// Repeats the days at a backed-off tray cadence (one every 50 s) and checks
+// that every tier still spans its fixed interval, with gaps where no sample fell.
+// Times the 100 ms system-only appends of a focused window against full ones.
+
+#include <cmath>
+#define MINUX_BENCH_COUNT_ALLOCATIONS     // counts into g_allocations
+#include "bench_util.h"
+#include "../core/minux_history.h"
+
+static const size_t kProcesses = 300;
+static const size_t kInterfaces = 4;
+static const uint64_t kStepMs = 5000;
+static const uint64_t kTrayStepMs = 50000;
+static const uint64_t kDays = 8;
+static const uint64_t kStartMs = 1700000000000ULL;     // minute-aligned
+
+// System CPU is constant within each minute so every tier's mean is known
+static uint32_t CpuForTime(uint64_t timestamp) {
+    return (uint32_t)((timestamp / 60000) % 100);
+}
+
+// Spans, gaps and bucket means of every tier after samples every 'stepMs'
+static bool CheckTiers(const HistoryStore& history, uint64_t stepMs) {
+    bool ok = true;
+    for (int tier = 0; tier < HISTORY_TIER_COUNT; tier++) {
+        uint64_t interval = g_historyTiers[tier].intervalMs;
+        size_t count = history.GetPointCount(tier);
+        uint64_t span = history.GetTime(tier, count - 1) - history.GetTime(tier, 0);
+        printf("  %2llu s samples, tier %4.0f s | %5zu points | %6.2f h span\n", (unsigned long long)(stepMs / 1000),
+               interval / 1000.0, count, span / 3600000.0);
+        if (count != g_historyTiers[tier].capacity || span != interval * (count - 1)) {
+            printf("  FAIL tier %d holds %zu points over %llu ms\n", tier, count, (unsigned long long)span);
+            ok = false;
+        }
+
+        // Every complete bucket must hold the mean of its samples, or a gap if none fell in it
+        int series = HistorySystemSeries(HISTORY_SYSTEM_CPU);
+        for (size_t point = 0; point + 1 < count; point++) {
+            uint64_t time = history.GetTime(tier, point);
+            bool sampled = interval >= stepMs || (time - kStartMs) % stepMs == 0;
+            float value = history.GetValue(tier, series, point);
+            float expected = (float)CpuForTime(time);
+            if (time != history.GetTime(tier, 0) + point * interval || sampled == std::isnan(value) ||
+                (sampled && value != expected)) {
+                printf("  FAIL tier %d point %zu at %llu: %.2f, expected %.2f\n", tier, point,
+                       (unsigned long long)time, value, sampled ? expected : NAN);
+                ok = false;
+                break;
+            }
+        }
+    }
+    return ok;
+}
+
+int main() {
+    PrintBenchHeader("Tiered history store");
+
+    HistoryStore* history = new HistoryStore();
+    size_t memoryBefore = history->GetMemoryBytes();
+    printf("  %d series, %zu bytes\n", HISTORY_SERIES_COUNT, memoryBefore);
+
+    BenchRandom random;
+    MinuxSnapshot snapshot;
+    MakeSyntheticProcesses(snapshot.processes, kProcesses, random);
+    snapshot.processes[0].cpuUsage = 9000;     // one long-lived busy process
+    snapshot.interfaces.resize(kInterfaces);
+    for (size_t i = 0; i < kInterfaces; i++) {
+        snapshot.interfaces[i] = NetworkInfo();
+        swprintf(snapshot.interfaces[i].adapterName, 256, L"eth%zu", i);
+    }
+
+    uint64_t appends = kDays * 24 * 3600 * 1000 / kStepMs;
+    size_t allocationsBefore = g_allocations;
+    double seconds = 0;
+    for (uint64_t i = 0; i < appends; i++) {
+        snapshot.timestamp = kStartMs + i * kStepMs;
+        snapshot.system.cpuUsage = CpuForTime(snapshot.timestamp);
+        snapshot.system.memoryUsage = 50;
+        snapshot.system.processCount = (uint32_t)kProcesses;
+        TickSyntheticProcesses(snapshot.processes, random, 5);
+        snapshot.processes[0].cpuUsage = 9000;
+        for (NetworkInfo& info : snapshot.interfaces) {
+            info.bytesReceived += 5000;
+            info.packetsReceived += 50;
+            info.bytesReceivedPerSecond = 1000;     // as the sampler would rate 5000 bytes in 5 s
+            info.packetsReceivedPerSecond = 10;
+            info.rateIntervalMs = (uint32_t)kStepMs;
+        }
+
+        BenchTimer timer;
+        history->Append(snapshot);
+        seconds += timer.ElapsedSeconds();
+    }
+    size_t allocations = g_allocations - allocationsBefore;
+
+    printf("  %llu appends, %zu processes | %7.1f ns/append | %zu allocations\n",
+           (unsigned long long)appends, kProcesses, seconds * 1e9 / appends, allocations);
+
+    bool ok = true;
+    if (allocations != 0) {
+        printf("  FAIL appends allocated\n");
+        ok = false;
+    }
+    if (history->GetMemoryBytes() != memoryBefore) {
+        printf("  FAIL memory grew from %zu to %zu bytes\n", memoryBefore, history->GetMemoryBytes());
+        ok = false;
+    }
+
+    if (!CheckTiers(*history, kStepMs)) ok = false;
+
+    int interfaceSlot = history->FindInterfaceSlot(L"eth0");
+    float rate = interfaceSlot < 0 ? 0 : history->GetValue(HISTORY_TIER_1MIN,
+        HistoryInterfaceSeries(interfaceSlot, HISTORY_INTERFACE_RX_BYTES), 0);
+    if (std::fabs(rate - 1000.0f) > 0.01f) {
+        printf("  FAIL eth0 receive rate %.2f bytes/s, expected 1000\n", rate);
+        ok = false;
+    }
+
+    int processSlot = history->FindProcessSlot(MakeProcessKey(snapshot.processes[0]));
+    uint64_t times[64];
+    float values[64];
+    size_t copied = processSlot < 0 ? 0 : history->CopySeries(HISTORY_TIER_1MIN,
+        HistoryProcessSeries(processSlot, HISTORY_PROCESS_CPU), 0, times, values, 64);
+    if (copied != 64 || values[63] != 90.0f) {
+        printf("  FAIL busy process history: slot %d, %zu points\n", processSlot, copied);
+        ok = false;
+    }
+
+    // Recycled slots leave compressed 1-minute history behind
+    size_t archived = 0;
+    for (const ProcessInfo& info : snapshot.processes) {
+        HistoryAggregate aggregate;
+        ProcessKey key = MakeProcessKey(info);
+        if (!history->AggregateArchivedProcess(key, HISTORY_PROCESS_WORKINGSET, 0, ~0ULL, aggregate)) continue;
+        if (aggregate.count == 0 || aggregate.min <= 0) {
+            printf("  FAIL archived working set of pid %u: %u points\n", info.processId, aggregate.count);
+            ok = false;
+            break;
+        }
+        archived++;
+    }
+    printf("  %zu archived process records, %zu of the current processes\n", history->GetArchivedProcessCount(), archived);
+    if (archived == 0) {
+        printf("  FAIL nothing archived\n");
+        ok = false;
+    }
+
+    // A focused window samples the system every 100 ms; processes here every 5 s
+    uint64_t focusedStart = kStartMs + appends * kStepMs;
+    double fullSeconds = 0, systemSeconds = 0;
+    size_t fullAppends = 0, systemAppends = 0;
+    allocationsBefore = g_allocations;
+    for (uint64_t tick = 0; tick < 10 * 600; tick++) {
+        snapshot.timestamp = focusedStart + tick * 100;
+        bool full = tick % 50 == 0;
+        BenchTimer timer;
+        history->Append(snapshot, full ? HISTORY_SAMPLE_ALL : HISTORY_SAMPLE_SYSTEM);
+        (full ? fullSeconds : systemSeconds) += timer.ElapsedSeconds();
+        (full ? fullAppends : systemAppends)++;
+    }
+    printf("  100 ms system ticks: %7.1f ns/append, full samples %7.1f ns/append, %zu allocations\n",
+           systemSeconds * 1e9 / systemAppends, fullSeconds * 1e9 / fullAppends, g_allocations - allocationsBefore);
+    if (g_allocations != allocationsBefore) {
+        printf("  FAIL system-only appends allocated\n");
+        ok = false;
+    }
+
+    // Carried-over processes are not averaged in again: 1 s buckets without a process sample stay empty
+    copied = processSlot < 0 ? 0 : history->CopySeries(HISTORY_TIER_1S,
+        HistoryProcessSeries(processSlot, HISTORY_PROCESS_CPU), 0, times, values, 64);
+    for (size_t point = 0; point < copied; point++) {
+        bool sampled = (times[point] - focusedStart) % 5000 == 0;
+        if (sampled ? values[point] != 90.0f : !std::isnan(values[point])) {
+            printf("  FAIL busy process at %llu: %.2f\n", (unsigned long long)times[point], values[point]);
+            ok = false;
+            break;
+        }
+    }
+    if (copied != 64) {
+        printf("  FAIL busy process has %zu 1 s points\n", copied);
+        ok = false;
+    }
+
+    delete history;
+
+    // A hidden window backs the system stream off; the tiers must not stretch
+    HistoryStore* tray = new HistoryStore();
+    for (uint64_t i = 0; i < kDays * 24 * 3600 * 1000 / kTrayStepMs; i++) {
+        snapshot.timestamp = kStartMs + i * kTrayStepMs;
+        snapshot.system.cpuUsage = CpuForTime(snapshot.timestamp);
+        tray->Append(snapshot);
+    }
+    if (!CheckTiers(*tray, kTrayStepMs)) ok = false;
+    delete tray;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Minux Level-of-Detail Benchmark
+// Fills a series with 7 days of one-second samples (with jitter, gaps and
+// repeated timestamps) and checks that rendering any range matches a
+// brute-force pass over the same samples, including after the ring has
+// wrapped. Then times appends and a pinch-zoom / swipe-pan session over the
+// whole week at the main window's graph width and at 4K, against a 60 fps
+// frame, next to drawing the same ranges straight from the samples.
+
+#include <algorithm>
+#include <cmath>
+#include "bench_util.h"
+#include "../core/minux_lod.h"
+
+#define LOD_BENCH_DAYS       7
+#define LOD_BENCH_FRAME_US   16667          // 60 fps
+
+struct Sample {
+    uint64_t time;
+    float value;
+};
+
+// CPU-like load: a slow daily swell, noise and the odd spike; samples are a second apart, give or take
+static void MakeSamples(std::vector<Sample>& samples, size_t count, BenchRandom& random) {
+    samples.resize(count);
+    uint64_t time = 1700000000000ULL;
+    for (size_t i = 0; i < count; i++) {
+        double day = std::sin((double)i * 2 * 3.14159265 / 86400);
+        float value = (float)(30 + 20 * day + random.Below(1000) / 100.0);
+        if (random.Below(500) == 0) value = 100;
+        samples[i].time = time;
+        samples[i].value = value;
+        uint32_t step = random.Below(40) == 0 ? 0 : 900 + random.Below(200);     // some share a timestamp
+        if (random.Below(20000) == 0) step = 3600 * 1000;                           // machine asleep
+        time += step;
+    }
+}
+
+// What Render should produce: each node of the level it picked lands in the column of its first sample
+static bool CheckRender(const LodSeries& series, const std::vector<Sample>& samples, size_t firstRetained,
+                        uint64_t from, uint64_t to, int columns) {
+    std::vector<LodColumn> rendered(columns), expected(columns);
+    int level = series.Render(from, to, columns, rendered.data());
+
+    size_t begin = firstRetained, end = samples.size();
+    while (begin < end && samples[begin].time < from) begin++;
+    while (end > begin && samples[end - 1].time > to) end--;
+    if (begin == end) {
+        for (const LodColumn& column : rendered) {
+            if (column.count) {
+                printf("  FAIL samples rendered for an empty range\n");
+                return false;
+            }
+        }
+        return level == -1;
+    }
+
+    std::vector<double> sums(columns, 0.0);
+    uint64_t span = to - from + 1;
+    for (size_t i = begin; i < end; i++) {
+        size_t nodeFirst = (i >> level) << level;
+        size_t anchor = nodeFirst > begin ? nodeFirst : begin;
+        LodColumn& column = expected[(samples[anchor].time - from) * columns / span];
+        float value = samples[i].value;
+        if (column.count == 0 || value < column.min) column.min = value;
+        if (column.count == 0 || value > column.max) column.max = value;
+        column.count++;
+        sums[&column - expected.data()] += value;
+    }
+
+    for (int i = 0; i < columns; i++) {
+        const LodColumn& got = rendered[i];
+        const LodColumn& want = expected[i];
+        double average = want.count ? sums[i] / want.count : 0;
+        if (got.count != want.count || (want.count && (got.min != want.min || got.max != want.max ||
+                                                       std::fabs(got.average - average) > 1e-3 * (1 + std::fabs(average))))) {
+            printf("  FAIL column %d of %d at level %d: count %u/%u, min %g/%g, max %g/%g, average %g/%g\n",
+                   i, columns, level, got.count, want.count, got.min, want.min, got.max, want.max, got.average, average);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool CheckSeries(const std::vector<Sample>& samples, uint32_t capacity, int rounds, BenchRandom& random) {
+    LodSeries series(capacity);
+    for (const Sample& sample : samples) series.Append(sample.time, sample.value);
+    size_t firstRetained = samples.size() - series.GetSampleCount();
+    if (series.GetFirstTime() != samples[firstRetained].time || series.GetLastTime() != samples.back().time) {
+        printf("  FAIL retained range does not match the newest %zu samples\n", series.GetSampleCount());
+        return false;
+    }
+
+    uint64_t first = samples.front().time, last = samples.back().time;
+    for (int round = 0; round < rounds; round++) {
+        uint64_t a = first - 5000 + random.Next() % (last - first + 10000);
+        uint64_t span = round % 4 == 0 ? random.Next() % 100000 : random.Next() % (last - first + 1);
+        int columns = round % 3 == 0 ? 1 + (int)random.Below(16) : 1 + (int)random.Below(4000);
+        if (!CheckRender(series, samples, firstRetained, a, a + span, columns)) return false;
+    }
+    return CheckRender(series, samples, firstRetained, first, last, 570);
+}
+
+int main() {
+    PrintBenchHeader("Level-of-detail history");
+
+    BenchRandom random(17);
+    std::vector<Sample> samples;
+    MakeSamples(samples, 86400 * LOD_BENCH_DAYS, random);
+
+    if (!CheckSeries(samples, LOD_DEFAULT_CAPACITY, 300, random)) return 1;
+    std::vector<Sample> small(samples.begin(), samples.begin() + 10007);
+    if (!CheckSeries(small, 4096, 300, random)) return 1;      // wrapped twice, capacity not a multiple of the count
+    if (!CheckSeries(small, 3001, 300, random)) return 1;      // wrapped three times, capacity not a power of two
+
+    // Appends: amortized over the week, then the worst single one (ring growth included) on a second fill
+    LodSeries series;
+    BenchTimer total;
+    for (const Sample& sample : samples) series.Append(sample.time, sample.value);
+    double amortizedNs = total.ElapsedSeconds() * 1e9 / samples.size();
+    LodSeries timed;
+    double worstUs = 0;
+    for (const Sample& sample : samples) {
+        BenchTimer timer;
+        timed.Append(sample.time, sample.value);
+        double us = timer.ElapsedSeconds() * 1e6;
+        if (us > worstUs) worstUs = us;
+    }
+    printf("  %zu samples (%d days): %.1f ns per append, %.1f us worst, %zu KB\n", samples.size(), LOD_BENCH_DAYS,
+           amortizedNs, worstUs, series.GetMemoryBytes() / 1024);
+    if (series.GetMemoryBytes() > (size_t)LOD_DEFAULT_CAPACITY * 25) {
+        printf("  FAIL a full week takes %zu bytes, more than 25 a sample\n", series.GetMemoryBytes());
+        return 1;
+    }
+
+    // Pinch out from a minute to the week and back while panning, as the graph would
+    uint64_t first = samples.front().time, last = samples.back().time;
+    static const int kWidths[] = { 570, 3840 };
+    for (int width : kWidths) {
+        std::vector<LodColumn> columns(width);
+        const int frames = 2000;
+        std::vector<double> frameUs(frames);
+        double totalUs = 0, naiveUs = 0;
+        uint64_t span = 60 * 1000, end = last;
+        float scale = 1.02f;
+        for (int frame = 0; frame < frames; frame++) {
+            if (span * scale > last - first || span * scale < 60 * 1000) scale = 1 / scale;
+            span = (uint64_t)(span * scale);
+            end -= (uint64_t)(span * 0.01);                     // swipe toward older samples
+            if (end < first + span) end = last;
+
+            BenchTimer timer;
+            series.Render(end - span, end, width, columns.data());
+            double us = timer.ElapsedSeconds() * 1e6;
+            totalUs += us;
+            frameUs[frame] = us;
+
+            // Every 100th frame, the same range drawn sample by sample
+            if (frame % 100 == 0) {
+                BenchTimer naive;
+                uint64_t range = span + 1;
+                for (LodColumn& column : columns) column = LodColumn{ 0, 0, 0, 0 };
+                for (const Sample& sample : samples) {
+                    if (sample.time < end - span || sample.time > end) continue;
+                    LodColumn& column = columns[(sample.time - (end - span)) * width / range];
+                    if (column.count == 0 || sample.value < column.min) column.min = sample.value;
+                    if (column.count == 0 || sample.value > column.max) column.max = sample.value;
+                    column.average += sample.value;
+                    column.count++;
+                }
+                naiveUs += naive.ElapsedSeconds() * 1e6;
+            }
+        }
+        // The scheduler can stall any one frame; the 99th percentile is what the graph feels like
+        std::sort(frameUs.begin(), frameUs.end());
+        double p99Us = frameUs[frames * 99 / 100];
+        printf("  %d columns: %.1f us per frame, %.1f us at p99, %.1f us worst (naive %.0f us); budget %d us\n",
+               width, totalUs / frames, p99Us, frameUs.back(), naiveUs / (frames / 100), LOD_BENCH_FRAME_US);
+        if (p99Us > LOD_BENCH_FRAME_US) {
+            printf("  FAIL p99 frame took %.0f us, over 60 fps\n", p99Us);
+            return 1;
+        }
+    }
+    return 0;
+}
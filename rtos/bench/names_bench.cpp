@@ -0,0 +1,157 @@
+// Minux Name Pool Benchmark
+// Checks that interning is stable (equal text, equal ID; different text,
+// different ID; text round-trips), then compares a 5,000-process snapshot
+// of ID records with the same snapshot holding MAX_PATH name buffers: size,
+// copy, sort by name and grouping by name. Also times the lookup a sampler
+// pays per process per tick.
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include "bench_util.h"
+
+#define NAMES_BENCH_PROCESSES   5000
+#define NAMES_BENCH_ROUNDS      200
+
+// The record as it was with the name stored inline
+struct InlineProcessInfo {
+    uint32_t processId;
+    wchar_t processName[MINUX_MAX_NAME];
+    uint64_t workingSetSize;
+    uint32_t cpuUsage;
+    uint32_t threadCount;
+    uint64_t creationTime;
+};
+
+static void MakePath(wchar_t* path, uint32_t index) {
+    swprintf(path, MINUX_MAX_NAME, L"C:\\Program Files\\Vendor %u\\bin\\service-%u.exe", index % 97, index);
+}
+
+static bool CheckPool(BenchRandom& random) {
+    if (InternName(L"") != NAME_ID_NONE || InternName(NULL) != NAME_ID_NONE || GetName(NAME_ID_NONE)[0] != L'\0') {
+        printf("  FAIL the empty name must be NAME_ID_NONE\n");
+        return false;
+    }
+
+    const uint32_t count = 20000;
+    std::vector<NameId> ids(count);
+    wchar_t path[MINUX_MAX_NAME];
+    for (uint32_t i = 0; i < count; i++) {
+        MakePath(path, i);
+        ids[i] = InternName(path);
+    }
+    std::vector<NameId> sorted(ids);
+    std::sort(sorted.begin(), sorted.end());
+    if (std::unique(sorted.begin(), sorted.end()) != sorted.end() || sorted[0] == NAME_ID_NONE) {
+        printf("  FAIL distinct names share an ID\n");
+        return false;
+    }
+    for (int i = 0; i < 100000; i++) {
+        uint32_t index = random.Below(count);
+        MakePath(path, index);
+        if (InternName(path) != ids[index] || wcscmp(GetName(ids[index]), path) != 0) {
+            printf("  FAIL name %u did not round-trip\n", index);
+            return false;
+        }
+    }
+
+    // Prefixes are different names; overlong names are cut at MINUX_MAX_NAME - 1
+    MakePath(path, 7);
+    if (InternName(path, wcslen(path) - 1) == ids[7]) {
+        printf("  FAIL a prefix interned as the full name\n");
+        return false;
+    }
+    std::vector<wchar_t> longName(MINUX_MAX_NAME * 2, L'x');
+    NameId longId = InternName(longName.data(), longName.size());
+    if (wcslen(GetName(longId)) != MINUX_MAX_NAME - 1 || InternName(longName.data(), MINUX_MAX_NAME - 1) != longId) {
+        printf("  FAIL overlong name not truncated\n");
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Process name pool");
+
+    BenchRandom random(19);
+    if (!CheckPool(random)) return 1;
+    printf("  %zu names interned, pool %zu KB\n", GetInternedNameCount(), GetNamePoolBytes() / 1024);
+
+    // The same machine both ways: a few hundred distinct executables across 5,000 processes
+    std::vector<ProcessInfo> processes(NAMES_BENCH_PROCESSES);
+    std::vector<InlineProcessInfo> inlineProcesses(NAMES_BENCH_PROCESSES);
+    std::vector<std::vector<wchar_t>> names(NAMES_BENCH_PROCESSES);
+    for (size_t i = 0; i < processes.size(); i++) {
+        wchar_t path[MINUX_MAX_NAME];
+        MakePath(path, random.Below(300));
+        names[i].assign(path, path + wcslen(path) + 1);
+
+        ProcessInfo& info = processes[i];
+        info = ProcessInfo();
+        info.processId = (uint32_t)(4 + i * 4);
+        info.nameId = InternName(path);
+        info.workingSetSize = (uint64_t)(random.Below(512 * 1024) + 64) * 1024;
+        info.cpuUsage = random.Below(2500);
+        info.threadCount = random.Below(64) + 1;
+        info.creationTime = random.Next();
+
+        InlineProcessInfo& legacy = inlineProcesses[i];
+        memset(&legacy, 0, sizeof(legacy));
+        legacy.processId = info.processId;
+        wcscpy(legacy.processName, path);
+        legacy.workingSetSize = info.workingSetSize;
+        legacy.cpuUsage = info.cpuUsage;
+        legacy.threadCount = info.threadCount;
+        legacy.creationTime = info.creationTime;
+    }
+
+    size_t idBytes = processes.size() * sizeof(ProcessInfo);
+    size_t inlineBytes = inlineProcesses.size() * sizeof(InlineProcessInfo);
+    printf("  %d-process snapshot: %zu KB with IDs (%zu bytes/record), %zu KB with inline names (%zu bytes/record)\n",
+           NAMES_BENCH_PROCESSES, idBytes / 1024, sizeof(ProcessInfo), inlineBytes / 1024, sizeof(InlineProcessInfo));
+
+    // Copy the snapshot, sort it by name, then count processes per name, as a grouped view would
+    double idSeconds = 0, inlineSeconds = 0;
+    size_t idGroups = 0, inlineGroups = 0;
+    for (int round = 0; round < NAMES_BENCH_ROUNDS; round++) {
+        BenchTimer timer;
+        std::vector<ProcessInfo> copy(processes);
+        std::sort(copy.begin(), copy.end(), [](const ProcessInfo& a, const ProcessInfo& b) { return a.nameId < b.nameId; });
+        std::unordered_map<NameId, uint32_t> groups;
+        for (const ProcessInfo& info : copy) groups[info.nameId]++;
+        idGroups = groups.size();
+        idSeconds += timer.ElapsedSeconds();
+
+        timer.Restart();
+        std::vector<InlineProcessInfo> inlineCopy(inlineProcesses);
+        std::sort(inlineCopy.begin(), inlineCopy.end(), [](const InlineProcessInfo& a, const InlineProcessInfo& b) {
+            return wcscmp(a.processName, b.processName) < 0;
+        });
+        size_t runs = 0;
+        for (size_t i = 0; i < inlineCopy.size(); i++) {
+            if (i == 0 || wcscmp(inlineCopy[i].processName, inlineCopy[i - 1].processName) != 0) runs++;
+        }
+        inlineGroups = runs;
+        inlineSeconds += timer.ElapsedSeconds();
+    }
+    printf("  copy + sort + group by name: %.1f us with IDs, %.1f us with inline names (%.1fx)\n",
+           idSeconds * 1e6 / NAMES_BENCH_ROUNDS, inlineSeconds * 1e6 / NAMES_BENCH_ROUNDS, inlineSeconds / idSeconds);
+
+    // What a sampler pays to turn each process's name into its ID every tick
+    BenchTimer timer;
+    uint64_t checksum = 0;
+    for (int round = 0; round < NAMES_BENCH_ROUNDS; round++) {
+        for (const std::vector<wchar_t>& name : names) checksum += InternName(name.data(), name.size() - 1);
+    }
+    printf("  InternName of a known name: %.1f ns\n", timer.ElapsedSeconds() * 1e9 / (NAMES_BENCH_ROUNDS * names.size()));
+
+    if (idGroups != inlineGroups || checksum == 0) {
+        printf("  FAIL grouping by ID found %zu names, by text %zu\n", idGroups, inlineGroups);
+        return 1;
+    }
+    if (idBytes * 10 > inlineBytes) {
+        printf("  FAIL ID snapshot is not an order of magnitude smaller\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+// Minux Interface Configuration Benchmark
+// Checks that the configuration cache enumerates once per change, then times
+// a steady-state network sample of the platform backend, which should read
+// counters only. On Linux, when the process may create a network namespace,
+// it adds, readdresses and removes a veth pair there and checks that every
+// change shows up in the next sample with exactly one rebuild, then checks
+// that a hundred veth pairs are all listed.
+
+#include "bench_util.h"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "../core/minux_backend.h"
+#include "../core/minux_netconfig.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#define NETCONFIG_BENCH_ROUNDS  1000
+#define NETCONFIG_BENCH_PAIRS   100         // veth pairs, 200 interfaces
+
+static bool CheckCache() {
+    InterfaceConfigCache cache;
+    if (!cache.TakeInvalidation() || cache.TakeInvalidation()) {
+        printf("  FAIL a new cache should ask for exactly one enumeration\n");
+        return false;
+    }
+    InterfaceConfig& config = cache.Add();
+    strcpy(config.systemName, "eth0");
+    swprintf(config.info.adapterName, 256, L"eth0");
+    cache.Add().key = 7;
+    if (cache.FindByName("eth0", 1) != &cache.GetEntry(0) || cache.FindByName("eth1", 0)) {
+        printf("  FAIL name lookup\n");
+        return false;
+    }
+
+    // Several notifications before the next sample make one rebuild
+    cache.Invalidate();
+    cache.Invalidate();
+    if (!cache.TakeInvalidation() || cache.TakeInvalidation() || cache.GetRebuildCount() != 2) {
+        printf("  FAIL %u rebuilds after two notifications; expected 2 in total\n", cache.GetRebuildCount());
+        return false;
+    }
+    return true;
+}
+
+// Sample once and return the interface with this name, or NULL
+static const NetworkInfo* SampleInterface(MonitorBackend* backend, std::vector<NetworkInfo>& interfaces, const wchar_t* name) {
+    if (!backend->SampleNetwork(interfaces)) return NULL;
+    for (const NetworkInfo& info : interfaces) {
+        if (wcscmp(info.adapterName, name) == 0) return &info;
+    }
+    return NULL;
+}
+
+static bool ExpectRebuilds(const char* step, MonitorBackend* backend, uint32_t expected) {
+    if (backend->GetNetworkConfigRebuilds() == expected) return true;
+    printf("  FAIL %s: %u configuration rebuilds, expected %u\n", step, backend->GetNetworkConfigRebuilds(), expected);
+    return false;
+}
+
+#ifdef __linux__
+// Adds and removes interfaces in a private network namespace; false on a failed check
+static bool CheckNamespace() {
+    if (unshare(CLONE_NEWNET) != 0) {
+        printf("  namespace checks skipped: cannot create a network namespace\n");
+        return true;
+    }
+
+    // Created inside the namespace, so its notification socket listens there
+    std::unique_ptr<MonitorBackend> backend(CreatePlatformBackend());
+    std::vector<NetworkInfo> interfaces;
+    backend->SampleNetwork(interfaces);
+    for (int i = 0; i < NETCONFIG_BENCH_ROUNDS; i++) backend->SampleNetwork(interfaces);
+    if (!ExpectRebuilds("idle", backend.get(), 1)) return false;
+
+    if (system("ip link add minux0 type veth peer name minux1 2>/dev/null") != 0) {
+        printf("  namespace checks skipped: cannot create a veth pair\n");
+        return true;
+    }
+    const NetworkInfo* info = SampleInterface(backend.get(), interfaces, L"minux0");
+    if (!info || !SampleInterface(backend.get(), interfaces, L"minux1")) {
+        printf("  FAIL the new veth pair is missing\n");
+        return false;
+    }
+    if (!ExpectRebuilds("added", backend.get(), 2)) return false;
+
+    if (system("ip addr add 10.77.0.1/24 dev minux0 && ip link set minux0 address 02:00:00:00:77:01") != 0) return false;
+    info = SampleInterface(backend.get(), interfaces, L"minux0");
+    if (!info || wcscmp(info->ipAddress, L"10.77.0.1") != 0 || wcscmp(info->macAddress, L"02-00-00-00-77-01") != 0 ||
+        !info->isConnected) {
+        printf("  FAIL minux0 is at %ls, %ls after the change\n", info ? info->ipAddress : L"-", info ? info->macAddress : L"-");
+        return false;
+    }
+    if (!ExpectRebuilds("readdressed", backend.get(), 3)) return false;
+
+    // Carrier changes reach the socket from deferred kernel work, up to a second later
+    if (system("ip link set minux0 up && ip link set minux1 up") != 0) return false;
+    usleep(1500 * 1000);
+    backend->SampleNetwork(interfaces);
+    uint32_t rebuilds = backend->GetNetworkConfigRebuilds();
+
+    // Traffic moves the counters without a rebuild
+    info = SampleInterface(backend.get(), interfaces, L"minux0");
+    uint64_t bytesSent = info ? info->bytesSent : 0;
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    int broadcast = 1;
+    setsockopt(sender, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+    struct sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(9);
+    inet_pton(AF_INET, "10.77.0.255", &target.sin_addr);
+    for (int i = 0; i < 10; i++) sendto(sender, "minux", 5, 0, (struct sockaddr*)&target, sizeof(target));
+    close(sender);
+    info = SampleInterface(backend.get(), interfaces, L"minux0");
+    if (!info || info->bytesSent <= bytesSent) {
+        printf("  FAIL minux0 sent %llu bytes after the broadcast, %llu before\n",
+               info ? (unsigned long long)info->bytesSent : 0ULL, (unsigned long long)bytesSent);
+        return false;
+    }
+    if (!ExpectRebuilds("traffic", backend.get(), rebuilds)) return false;
+
+    if (system("ip link del minux0") != 0) return false;
+    if (SampleInterface(backend.get(), interfaces, L"minux0") || SampleInterface(backend.get(), interfaces, L"minux1")) {
+        printf("  FAIL the removed veth pair is still listed\n");
+        return false;
+    }
+    if (!ExpectRebuilds("removed", backend.get(), rebuilds + 1)) return false;
+    printf("  namespace: veth pair added, readdressed and removed with one rebuild each\n");
+
+    // A container host: more interfaces than any fixed table would hold
+    char command[160];
+    snprintf(command, sizeof(command), "for i in $(seq 1 %d); do ip link add mx$i type veth peer name my$i || exit 1; done",
+             NETCONFIG_BENCH_PAIRS);
+    if (system(command) != 0) return false;
+    wchar_t last[16];
+    swprintf(last, 16, L"my%d", NETCONFIG_BENCH_PAIRS);
+    backend->SampleNetwork(interfaces);
+    if (interfaces.size() != NETCONFIG_BENCH_PAIRS * 2 + 1 || !SampleInterface(backend.get(), interfaces, last)) {
+        printf("  FAIL %zu interfaces listed with %d veth pairs and lo\n", interfaces.size(), NETCONFIG_BENCH_PAIRS);
+        return false;
+    }
+    printf("  namespace: all %zu interfaces listed\n", interfaces.size());
+    return true;
+}
+#endif
+
+int main() {
+    PrintBenchHeader("Interface configuration");
+    if (!CheckCache()) return 1;
+
+    std::unique_ptr<MonitorBackend> backend(CreatePlatformBackend());
+    if (backend) {
+        std::vector<NetworkInfo> interfaces;
+        backend->SampleNetwork(interfaces);
+        uint32_t rebuilds = backend->GetNetworkConfigRebuilds();
+        BenchTimer timer;
+        for (int i = 0; i < NETCONFIG_BENCH_ROUNDS; i++) backend->SampleNetwork(interfaces);
+        double seconds = timer.ElapsedSeconds();
+        printf("  %s backend: %6.1f us per sample of %zu interfaces, %u rebuilds in %d samples\n", backend->GetName(),
+               seconds * 1e6 / NETCONFIG_BENCH_ROUNDS, interfaces.size(),
+               backend->GetNetworkConfigRebuilds() - rebuilds, NETCONFIG_BENCH_ROUNDS);
+        backend.reset();
+    }
+
+#ifdef __linux__
+    if (!CheckNamespace()) return 1;
+#endif
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Minux Interface Rates Benchmark
+// Feeds the rate tracker a 25 GbE link for a minute of one-second samples
+// (its byte counter passes 2^32 in under two seconds) plus an idle link,
+// then reorders, resets, drops and brings back interfaces, checking the
+// rates after every step. Times the tracker at 64 interfaces and one live
+// sample of the platform backend's interfaces, rates included.
+
+#include "bench_util.h"
+#include "../core/minux_monitor.h"
+#include "../core/minux_netrates.h"
+
+#define NETRATES_BENCH_LINK     3125000000ULL       // bytes per second at 25 Gbit/s
+#define NETRATES_BENCH_ROUNDS   10000
+
+static NetworkInfo MakeInterface(const wchar_t* name, uint64_t bytesReceived, uint64_t packetsSent) {
+    NetworkInfo info = NetworkInfo();
+    swprintf(info.adapterName, 256, L"%ls", name);
+    info.bytesReceived = bytesReceived;
+    info.packetsSent = packetsSent;
+    return info;
+}
+
+static bool Expect(const char* step, const NetworkInfo& info, uint64_t bytesReceived, uint64_t packetsSent, uint32_t intervalMs) {
+    if (info.bytesReceivedPerSecond == bytesReceived && info.packetsSentPerSecond == packetsSent && info.rateIntervalMs == intervalMs) {
+        return true;
+    }
+    printf("  FAIL %s: %ls at %llu bytes/s, %llu packets/s over %u ms; expected %llu, %llu over %u ms\n", step,
+           info.adapterName, (unsigned long long)info.bytesReceivedPerSecond, (unsigned long long)info.packetsSentPerSecond,
+           info.rateIntervalMs, (unsigned long long)bytesReceived, (unsigned long long)packetsSent, intervalMs);
+    return false;
+}
+
+static bool CheckTracker() {
+    InterfaceRateTracker tracker;
+    std::vector<NetworkInfo> interfaces;
+    uint64_t now = 5000, received = 0;
+
+    // A saturated link and an idle one, sampled every second
+    for (int second = 0; second <= 60; second++) {
+        interfaces.clear();
+        interfaces.push_back(MakeInterface(L"Ethernet 25G", received, (uint64_t)second * 2000000));
+        interfaces.push_back(MakeInterface(L"Wi-Fi", 77, 3));
+        tracker.Update(interfaces, now);
+        uint32_t interval = second ? 1000 : 0;
+        if (!Expect("25 GbE", interfaces[0], second ? NETRATES_BENCH_LINK : 0, second ? 2000000 : 0, interval) ||
+            !Expect("idle", interfaces[1], 0, 0, interval)) return false;
+        received += NETRATES_BENCH_LINK;
+        now += 1000;
+    }
+    if (received < (40ULL << 32)) {       // wrapped a 32-bit counter 40 times
+        printf("  FAIL the counter only reached %llu bytes\n", (unsigned long long)received);
+        return false;
+    }
+
+    // Enumeration order changes; a sample 2.5 s later halves the link's rate
+    uint64_t lastReceived = received - NETRATES_BENCH_LINK;
+    interfaces.clear();
+    interfaces.push_back(MakeInterface(L"Wi-Fi", 77 + 5000, 3));
+    interfaces.push_back(MakeInterface(L"Ethernet 25G", lastReceived + NETRATES_BENCH_LINK / 2 * 5 / 2, 120000000));
+    now += 1500;
+    tracker.Update(interfaces, now);
+    if (!Expect("reordered", interfaces[0], 2000, 0, 2500) ||
+        !Expect("reordered", interfaces[1], NETRATES_BENCH_LINK / 2, 0, 2500)) return false;
+
+    // Two readings in the same millisecond keep the rates; a reset counts from zero
+    tracker.Update(interfaces, now);
+    if (!Expect("same time", interfaces[1], NETRATES_BENCH_LINK / 2, 0, 2500)) return false;
+    interfaces[1].bytesReceived = 4000;
+    now += 2000;
+    tracker.Update(interfaces, now);
+    if (!Expect("reset", interfaces[1], 2000, 0, 2000) || !Expect("reset", interfaces[0], 0, 0, 2000)) return false;
+
+    // An interface that leaves and comes back starts over
+    NetworkInfo wifi = interfaces[0];
+    interfaces.erase(interfaces.begin());
+    now += 1000;
+    tracker.Update(interfaces, now);
+    interfaces.push_back(wifi);
+    now += 1000;
+    tracker.Update(interfaces, now);
+    return Expect("returned", interfaces[1], 0, 0, 0);
+}
+
+int main() {
+    PrintBenchHeader("Interface rates");
+    if (!CheckTracker()) return 1;
+
+    // 64 interfaces in a fixed order, as a busy server reports them
+    InterfaceRateTracker tracker;
+    std::vector<NetworkInfo> interfaces(64);
+    for (size_t i = 0; i < interfaces.size(); i++) {
+        interfaces[i] = NetworkInfo();
+        swprintf(interfaces[i].adapterName, 256, L"vEthernet (switch %zu)", i);
+    }
+    BenchTimer timer;
+    for (int round = 0; round < NETRATES_BENCH_ROUNDS; round++) {
+        for (NetworkInfo& info : interfaces) info.bytesReceived += 1250000;
+        tracker.Update(interfaces, 1000 + (uint64_t)round * 1000);
+    }
+    double seconds = timer.ElapsedSeconds();
+    if (!Expect("64 interfaces", interfaces[63], 1250000, 0, 1000)) return 1;
+    printf("  tracker: %6.2f us per sample of %zu interfaces\n", seconds * 1e6 / NETRATES_BENCH_ROUNDS, interfaces.size());
+
+    StartPerformanceCounters();
+    if (GetMonitorBackend()) {
+        std::vector<NetworkInfo> live;
+        GetNetworkInterfaces(live);
+        timer.Restart();
+        const int rounds = 100;
+        for (int i = 0; i < rounds; i++) GetNetworkInterfaces(live);
+        printf("  %s backend: %6.1f us per sample of %zu interfaces\n", GetMonitorBackend()->GetName(),
+               timer.ElapsedSeconds() * 1e6 / rounds, live.size());
+        timer.Restart();
+        while (timer.ElapsedSeconds() < 0.002) {}      // readings within one millisecond share their rates
+        GetNetworkInterfaces(live);
+        for (const NetworkInfo& info : live) {
+            if (info.rateIntervalMs == 0) {
+                printf("  FAIL %ls has no rates on its second reading\n", info.adapterName);
+                return 1;
+            }
+        }
+    }
+    StopPerformanceCounters();
+    return 0;
+}
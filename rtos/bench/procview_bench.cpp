@@ -0,0 +1,80 @@
+// Minux Process Table Model Benchmark
+// Drives the owner-data list provider headlessly: each tick publishes a new
+// synthetic snapshot, checks the visible page for rows needing a repaint and
+// answers the LVN_GETDISPINFO requests a paint would issue.
+
+#include <cstring>
+#include "bench_util.h"
+#include "../core/minux_procview.h"
+
+static const size_t kVisibleRows = 20;      // rows on screen at 570x200 plus margin
+static const int kPaintsPerTick = 3;        // hover / scroll repaints between refreshes
+static const int kTicks = 200;
+
+// Text the classic LVS_REPORT path would have produced, for verification
+static bool VerifyRow(ProcessTableModel& model, const std::vector<ProcessInfo>& processes, size_t row) {
+    wchar_t expected[32];
+    swprintf(expected, 32, L"%u", processes[row].processId);
+    if (wcscmp(model.GetCellText(row, PROCESS_COLUMN_PID), expected) != 0) return false;
+    swprintf(expected, 32, L"%.1f", processes[row].workingSetSize / (1024.0 * 1024.0));
+    if (wcscmp(model.GetCellText(row, PROCESS_COLUMN_MEMORY), expected) != 0) return false;
+    return wcscmp(model.GetCellText(row, PROCESS_COLUMN_NAME), GetName(processes[row].nameId)) == 0;
+}
+
+static bool RunScenario(size_t processCount) {
+    BenchRandom random;
+    std::vector<ProcessInfo> snapshots[2];
+    MakeSyntheticProcesses(snapshots[0], processCount, random);
+    snapshots[1] = snapshots[0];
+
+    ProcessTableModel model;
+    wchar_t buffer[MINUX_MAX_NAME];
+    size_t repaintedRows = 0;
+    size_t cellRequests = 0;
+    double seconds = 0;
+
+    for (int tick = 0; tick < kTicks; tick++) {
+        // Build the next snapshot outside the timed region
+        std::vector<ProcessInfo>& next = snapshots[(tick + 1) & 1];
+        next = snapshots[tick & 1];
+        TickSyntheticProcesses(next, random, 5);
+        size_t top = (size_t)(tick * 7) % (processCount - kVisibleRows);
+
+        BenchTimer timer;
+        model.SetProcesses(&next);
+        for (size_t row = top; row < top + kVisibleRows; row++) {
+            if (!model.IsRowCurrent(row)) repaintedRows++;
+        }
+        model.PrepareRows(top, top + kVisibleRows - 1);
+        for (int paint = 0; paint < kPaintsPerTick; paint++) {
+            for (size_t row = top; row < top + kVisibleRows; row++) {
+                for (int column = 0; column < PROCESS_COLUMN_COUNT; column++) {
+                    model.CopyCellText(row, column, buffer, MINUX_MAX_NAME);
+                    cellRequests++;
+                }
+            }
+        }
+        seconds += timer.ElapsedSeconds();
+
+        if (!VerifyRow(model, next, top)) {
+            printf("  MISMATCH at %zu rows, tick %d, row %zu\n", processCount, tick, top);
+            return false;
+        }
+    }
+
+    printf("  %7zu rows | %8.2f us/tick | %6.1f ns/cell | %5.1f rows repainted/tick | model %zu bytes\n",
+           processCount, seconds * 1e6 / kTicks, seconds * 1e9 / cellRequests,
+           (double)repaintedRows / kTicks, sizeof(ProcessTableModel));
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Owner-data process list provider");
+    printf("  %zu visible rows, %d paints per tick, 5%% of processes change per tick\n", kVisibleRows, kPaintsPerTick);
+
+    const size_t counts[] = { 1000, 10000, 100000 };
+    for (size_t count : counts) {
+        if (!RunScenario(count)) return 1;
+    }
+    return 0;
+}
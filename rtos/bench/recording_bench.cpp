@@ -0,0 +1,230 @@
+// Minux Recording Benchmark
+// Records a few hours of synthetic 1-second snapshots across several small
+// segments, cuts the last segment short as a crash would, then reopens the
+// recording through the memory-mapped reader and checks seeking, round-trips
+// and recovery. Reports write and read throughput.
+
+#include <cstring>
+#include "bench_util.h"
+#include "../core/minux_recording.h"
+
+static const size_t kProcesses = 250;
+static const size_t kSnapshots = 4 * 3600;         // four hours at 1 s
+static const uint64_t kSegmentBytes = 16ULL * 1024 * 1024;
+static const uint64_t kStartTime = 1700000000000ULL;
+static const wchar_t* kPrefix = L"build/recording_bench";
+
+static void MakeSnapshot(MinuxSnapshot& snapshot, std::vector<ProcessInfo>& processes, size_t index, BenchRandom& random) {
+    TickSyntheticProcesses(processes, random, 5);
+    snapshot.timestamp = kStartTime + index * 1000;
+    snapshot.sequence = index;
+    snapshot.system = SystemInfo();
+    snapshot.system.cpuUsage = random.Below(100);
+    snapshot.system.memoryUsage = 40 + random.Below(20);
+    snapshot.system.processCount = (uint32_t)processes.size();
+    snapshot.system.threadCount = 3000;
+    snapshot.system.uptime = index * 1000;
+    swprintf(snapshot.system.computerName, MINUX_MAX_COMPUTER_NAME, L"MINUX-BENCH");
+    swprintf(snapshot.system.osVersion, 256, L"Minux RTOS \U0001F680 bench");
+    snapshot.processes = processes;
+
+    snapshot.cores.resize(16);
+    for (CpuCoreInfo& core : snapshot.cores) {
+        core.user = (uint16_t)random.Below(5000);
+        core.kernel = (uint16_t)random.Below(2000);
+        core.idle = (uint16_t)(10000 - core.user - core.kernel);
+    }
+
+    snapshot.interfaces.resize(2);
+    for (size_t i = 0; i < snapshot.interfaces.size(); i++) {
+        NetworkInfo& info = snapshot.interfaces[i];
+        info = NetworkInfo();
+        swprintf(info.adapterName, 256, L"eth%zu", i);
+        swprintf(info.ipAddress, 16, L"10.0.0.%zu", i + 1);
+        swprintf(info.macAddress, 18, L"02:00:00:00:00:%02zu", i);
+        info.bytesReceived = (5ULL << 32) + index * 1500 * (i + 1);     // past what 32 bits hold
+        info.bytesSent = index * 700;
+        info.packetsReceived = index;
+        info.packetsSent = index / 2;
+        info.errorsReceived = index / 100;
+        info.dropsSent = index / 50;
+        info.bytesReceivedPerSecond = 1500 * (i + 1);
+        info.bytesSentPerSecond = 700;
+        info.rateIntervalMs = 1000;
+        info.isConnected = true;
+    }
+}
+
+static bool SameSnapshot(const MinuxSnapshot& a, const MinuxSnapshot& b) {
+    if (a.timestamp != b.timestamp || a.sequence != b.sequence) return false;
+    if (a.system.cpuUsage != b.system.cpuUsage || a.system.uptime != b.system.uptime) return false;
+    if (wcscmp(a.system.computerName, b.system.computerName) != 0) return false;
+    if (wcscmp(a.system.osVersion, b.system.osVersion) != 0) return false;
+    if (a.processes.size() != b.processes.size() || a.interfaces.size() != b.interfaces.size()) return false;
+    if (a.cores.size() != b.cores.size()) return false;
+    for (size_t i = 0; i < a.cores.size(); i++) {
+        if (a.cores[i].user != b.cores[i].user || a.cores[i].kernel != b.cores[i].kernel ||
+            a.cores[i].idle != b.cores[i].idle) return false;
+    }
+    for (size_t i = 0; i < a.processes.size(); i++) {
+        const ProcessInfo& x = a.processes[i];
+        const ProcessInfo& y = b.processes[i];
+        if (x.processId != y.processId || x.workingSetSize != y.workingSetSize || x.cpuUsage != y.cpuUsage ||
+            x.threadCount != y.threadCount || x.creationTime != y.creationTime ||
+            x.parentProcessId != y.parentProcessId || x.nameId != y.nameId) return false;
+    }
+    for (size_t i = 0; i < a.interfaces.size(); i++) {
+        const NetworkInfo& x = a.interfaces[i];
+        const NetworkInfo& y = b.interfaces[i];
+        if (wcscmp(x.adapterName, y.adapterName) != 0 || wcscmp(x.ipAddress, y.ipAddress) != 0 ||
+            wcscmp(x.macAddress, y.macAddress) != 0 || x.bytesReceived != y.bytesReceived ||
+            x.packetsSent != y.packetsSent || x.errorsReceived != y.errorsReceived || x.dropsSent != y.dropsSent ||
+            x.bytesReceivedPerSecond != y.bytesReceivedPerSecond || x.bytesSentPerSecond != y.bytesSentPerSecond ||
+            x.rateIntervalMs != y.rateIntervalMs || x.isConnected != y.isConnected) return false;
+    }
+    return true;
+}
+
+static void SegmentPath(char* path, size_t size, uint32_t segment) {
+    snprintf(path, size, "build/recording_bench.%03u.mxr", segment);
+}
+
+static void RemoveSegments() {
+    char path[64];
+    for (uint32_t segment = 0; segment < 1000; segment++) {
+        SegmentPath(path, sizeof(path), segment);
+        if (remove(path) != 0) break;
+    }
+}
+
+// Simulate a crash: drop the index and leave a half-written record behind
+static bool CutLastSegment(uint32_t segment, long keepBytes) {
+    char path[64];
+    SegmentPath(path, sizeof(path), segment);
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    std::vector<char> data((size_t)keepBytes);
+    size_t read = fread(data.data(), 1, data.size(), file);
+    fclose(file);
+    if (read != data.size()) return false;
+
+    file = fopen(path, "wb");
+    if (!file) return false;
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Snapshot recording");
+    RemoveSegments();
+
+    BenchRandom random;
+    std::vector<ProcessInfo> processes;
+    MakeSyntheticProcesses(processes, kProcesses, random);
+
+    // The reference snapshots are regenerated from the same seed when checking
+    RecordingWriter writer;
+    if (!writer.Open(kPrefix, kSegmentBytes)) {
+        printf("  FAIL could not create %ls.000.mxr\n", kPrefix);
+        return 1;
+    }
+    MinuxSnapshot snapshot;
+    BenchTimer timer;
+    for (size_t i = 0; i < kSnapshots; i++) {
+        MakeSnapshot(snapshot, processes, i, random);
+        if (!writer.Append(snapshot)) {
+            printf("  FAIL append %zu\n", i);
+            return 1;
+        }
+    }
+    double writeSeconds = timer.ElapsedSeconds();
+    uint64_t bytesWritten = writer.GetBytesWritten();
+    writer.Close();
+    printf("  %zu snapshots of %zu processes: %.1f MB, %.0f bytes/snapshot\n",
+           kSnapshots, kProcesses, bytesWritten / 1048576.0, (double)bytesWritten / kSnapshots);
+    printf("  write  %8.1f snapshots/s (%.1f MB/s, flushed per record)\n",
+           kSnapshots / writeSeconds, bytesWritten / writeSeconds / 1048576.0);
+
+    // Open the closed recording through a middle segment
+    RecordingReader reader;
+    timer.Restart();
+    if (!reader.Open(L"build/recording_bench.001.mxr")) {
+        printf("  FAIL could not open the recording\n");
+        return 1;
+    }
+    double openSeconds = timer.ElapsedSeconds();
+    size_t segments = reader.GetSegmentCount();
+    if (segments < 3 || reader.GetRecordCount() != kSnapshots || reader.GetRecoveredSegmentCount() != 0) {
+        printf("  FAIL %zu segments, %zu records, %zu recovered\n",
+               segments, reader.GetRecordCount(), reader.GetRecoveredSegmentCount());
+        return 1;
+    }
+    printf("  open   %8.2f ms for %zu segments through their indexes\n", openSeconds * 1000, segments);
+
+    // Seek to exact and in-between timestamps
+    BenchRandom seeks(7);
+    for (int i = 0; i < 1000; i++) {
+        size_t target = seeks.Below((uint32_t)kSnapshots);
+        uint64_t time = kStartTime + target * 1000 - (i & 1 ? 500 : 0);
+        if (reader.Seek(time) != target) {
+            printf("  FAIL seek to %llu\n", (unsigned long long)time);
+            return 1;
+        }
+    }
+    if (reader.Seek(0) != 0 || reader.Seek(kStartTime + kSnapshots * 1000) != kSnapshots) {
+        printf("  FAIL seek outside the recording\n");
+        return 1;
+    }
+
+    // Every record round-trips
+    BenchRandom replay;
+    MakeSyntheticProcesses(processes, kProcesses, replay);
+    MinuxSnapshot expected, decoded;
+    timer.Restart();
+    for (size_t i = 0; i < kSnapshots; i++) {
+        MakeSnapshot(expected, processes, i, replay);
+        if (!reader.ReadRecord(i, decoded) || !SameSnapshot(expected, decoded)) {
+            printf("  FAIL record %zu differs\n", i);
+            return 1;
+        }
+    }
+    printf("  read   %8.1f snapshots/s (decode and compare)\n", kSnapshots / timer.ElapsedSeconds());
+    reader.Close();
+
+    // Crash recovery: the last segment loses its index and its last record is torn
+    uint32_t last = (uint32_t)segments - 1;
+    char path[64];
+    SegmentPath(path, sizeof(path), last);
+    FILE* file = fopen(path, "rb");
+    if (!file) return 1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+
+    // Keep about two thirds of the last segment; that cuts through a record
+    if (!CutLastSegment(last, size * 2 / 3)) {
+        printf("  FAIL could not cut %s\n", path);
+        return 1;
+    }
+    timer.Restart();
+    if (!reader.Open(L"build/recording_bench.000.mxr")) {
+        printf("  FAIL could not reopen the damaged recording\n");
+        return 1;
+    }
+    openSeconds = timer.ElapsedSeconds();
+    size_t recovered = reader.GetRecordCount();
+    if (reader.GetRecoveredSegmentCount() != 1 || recovered >= kSnapshots || recovered < kSnapshots / 2) {
+        printf("  FAIL recovered %zu segments, %zu records\n", reader.GetRecoveredSegmentCount(), recovered);
+        return 1;
+    }
+    if (!reader.ReadRecord(recovered - 1, decoded) || decoded.sequence != recovered - 1) {
+        printf("  FAIL last recovered record is damaged\n");
+        return 1;
+    }
+    printf("  crash  %zu of %zu records recovered by scanning (%.2f ms)\n", recovered, kSnapshots, openSeconds * 1000);
+
+    reader.Close();
+    RemoveSegments();
+    return 0;
+}
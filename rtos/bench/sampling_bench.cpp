@@ -0,0 +1,142 @@
+// Minux Sampling Pipeline Benchmark
+// Runs the real platform backend headlessly, the same sequence the collector
+// thread performs each tick, and times every stage. Also sanity-checks the
+// samples so a broken backend fails the run.
+
+#include <algorithm>
+#include <unistd.h>
+#include "bench_util.h"
+#include "../core/minux_monitor.h"
+#include "../core/minux_cpusampler.h"
+#include "../core/minux_procdiff.h"
+#include "../core/minux_snapshot.h"
+
+static const int kTicks = 50;
+static const size_t kSyntheticCores = 256;     // more than one Windows processor group
+
+// Stage timings accumulated over all ticks, in seconds
+struct StageTimes {
+    double system = 0;
+    double processes = 0;
+    double network = 0;
+    double diff = 0;
+};
+
+static bool CheckSnapshot(const MinuxSnapshot& snapshot) {
+    if (snapshot.system.memoryUsage > 100 || snapshot.system.cpuUsage > 100) {
+        printf("  BAD system percentages: cpu %u, memory %u\n", snapshot.system.cpuUsage, snapshot.system.memoryUsage);
+        return false;
+    }
+    for (size_t i = 0; i < snapshot.cores.size(); i++) {
+        const CpuCoreInfo& core = snapshot.cores[i];
+        if (core.user + core.kernel + core.idle != 10000) {
+            printf("  BAD core %zu shares: user %u, kernel %u, idle %u\n", i, core.user, core.kernel, core.idle);
+            return false;
+        }
+    }
+    if (snapshot.processes.empty()) {
+        printf("  BAD empty process list\n");
+        return false;
+    }
+
+    bool foundSelf = false;
+    uint32_t self = (uint32_t)getpid();
+    for (size_t i = 0; i < snapshot.processes.size(); i++) {
+        const ProcessInfo& info = snapshot.processes[i];
+        if (info.processId == self) foundSelf = true;
+        if (info.cpuUsage > 10000) {
+            printf("  BAD cpu %u for pid %u\n", info.cpuUsage, info.processId);
+            return false;
+        }
+        if (i > 0 && snapshot.processes[i - 1].workingSetSize < info.workingSetSize) {
+            printf("  BAD sort order at row %zu\n", i);
+            return false;
+        }
+    }
+    if (!foundSelf) {
+        printf("  BAD own pid %u missing from the process list\n", self);
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Sampling pipeline");
+
+    StartPerformanceCounters();
+    MonitorBackend* backend = GetMonitorBackend();
+    if (!backend) {
+        printf("  no monitor backend for this platform, skipped\n");
+        return 0;
+    }
+    printf("  backend %s, %d ticks\n", backend->GetName(), kTicks);
+
+    MinuxSnapshot snapshot;
+    ProcessDiffEngine diff;
+    std::vector<ProcessChange> changes;
+    StageTimes times;
+    size_t changeCount = 0;
+
+    for (int tick = 0; tick < kTicks; tick++) {
+        BenchTimer timer;
+        GetSystemInformation(snapshot.system, snapshot.cores);
+        times.system += timer.ElapsedSeconds();
+
+        timer.Restart();
+        GetProcessList(snapshot.processes);
+        times.processes += timer.ElapsedSeconds();
+
+        timer.Restart();
+        GetNetworkInterfaces(snapshot.interfaces);
+        times.network += timer.ElapsedSeconds();
+
+        timer.Restart();
+        diff.Diff(snapshot.processes, changes);
+        times.diff += timer.ElapsedSeconds();
+        if (tick > 0) changeCount += changes.size();
+
+        if (!CheckSnapshot(snapshot)) {
+            StopPerformanceCounters();
+            return 1;
+        }
+    }
+
+    // Tick deltas into shares for a large machine, without the OS read
+    CpuSampler sampler;
+    std::vector<CpuCoreInfo> cores;
+    BenchRandom random;
+    std::vector<CpuTicks>& ticks = sampler.GetTicks();
+    ticks.assign(kSyntheticCores, CpuTicks());
+    const int samplerRounds = 10000;
+    BenchTimer samplerTimer;
+    uint64_t busy = 0;
+    for (int round = 0; round < samplerRounds; round++) {
+        for (CpuTicks& core : ticks) {
+            core.user += random.Below(60);
+            core.kernel += random.Below(20);
+            core.idle += random.Below(100);
+        }
+        busy += sampler.Update(cores);
+    }
+    double samplerSeconds = samplerTimer.ElapsedSeconds();
+    if (cores.size() != kSyntheticCores || busy == 0) {
+        printf("  BAD cpu sampler: %zu cores\n", cores.size());
+        StopPerformanceCounters();
+        return 1;
+    }
+
+    double total = times.system + times.processes + times.network + times.diff;
+    printf("  %zu processes, %zu interfaces, %.1f changes/tick\n",
+           snapshot.processes.size(), snapshot.interfaces.size(), (double)changeCount / (kTicks - 1));
+    printf("  system    %9.1f us/tick | %zu logical processors\n", times.system * 1e6 / kTicks, snapshot.cores.size());
+    printf("  cpu shares %8.2f us/tick for %zu synthetic processors\n",
+           samplerSeconds * 1e6 / samplerRounds, kSyntheticCores);
+    printf("  processes %9.1f us/tick | %6.2f us/process\n",
+           times.processes * 1e6 / kTicks, times.processes * 1e6 / kTicks / snapshot.processes.size());
+    printf("  network   %9.1f us/tick\n", times.network * 1e6 / kTicks);
+    printf("  diff      %9.1f us/tick\n", times.diff * 1e6 / kTicks);
+    printf("  total     %9.1f us/tick\n", total * 1e6 / kTicks);
+
+    StopPerformanceCounters();
+    return 0;
+}
@@ -0,0 +1,184 @@
+// Minux Timer Wheel Benchmark
+// Runs the wheel on a virtual clock. First a randomized check: a large set of
+// one-shot tasks with mixed deadlines and slack, some cancelled, some
+// rescheduled, with the clock moved in random steps; every task must fire
+// exactly once, in expiry order, never early and never later than its slack.
+// Then the app's periodic jobs for an hour, counting how often the thread
+// wakes with and without slack. Reports schedule, cancel and advance costs.
+
+#include <algorithm>
+#include "bench_util.h"
+#include "../core/minux_timerwheel.h"
+
+static const size_t kTasks = 200000;
+static const uint64_t kHorizonMs = 48ULL * 3600 * 1000;    // deadlines reach level 4
+
+struct CheckTask : TimerTask {
+    uint64_t deadline = 0;
+    uint64_t slack = 0;
+    uint64_t firedAt = TIMER_NEVER;
+    int fireCount = 0;
+    bool cancelled = false;
+
+    void OnTimer(TimerWheel& wheel, uint64_t) override {
+        firedAt = wheel.GetTime() - 1;      // the tick being run
+        fireCount++;
+    }
+};
+
+// A periodic job that re-arms itself one period after its deadline
+struct PeriodicTask : TimerTask {
+    uint64_t period = 0;
+    uint64_t slack = 0;
+    uint64_t deadline = 0;
+    uint64_t runs = 0;
+
+    void OnTimer(TimerWheel& wheel, uint64_t now) override {
+        runs++;
+        deadline = std::max(deadline + period, now);
+        wheel.Schedule(this, deadline, slack);
+    }
+};
+
+static bool RunRandomCheck() {
+    BenchRandom random;
+    std::vector<CheckTask> tasks(kTasks);
+    TimerWheel wheel(1000);
+
+    BenchTimer timer;
+    for (CheckTask& task : tasks) {
+        task.deadline = 1000 + (random.Below(4) == 0 ? random.Below(5000) : random.Next() % kHorizonMs);
+        task.slack = random.Below(3) == 0 ? 0 : random.Below(2000);
+        wheel.Schedule(&task, task.deadline, task.slack);
+    }
+    double scheduleSeconds = timer.ElapsedSeconds();
+
+    timer.Restart();
+    for (size_t i = 0; i < kTasks; i += 5) {
+        wheel.Cancel(&tasks[i]);
+        tasks[i].cancelled = true;
+    }
+    double cancelSeconds = timer.ElapsedSeconds();
+
+    // Move a share of the tasks, which is a cancel and a schedule
+    for (size_t i = 1; i < kTasks; i += 7) {
+        CheckTask& task = tasks[i];
+        if (task.cancelled) continue;
+        task.deadline = 1000 + random.Next() % kHorizonMs;
+        wheel.Schedule(&task, task.deadline, task.slack);
+    }
+    size_t expected = kTasks - (kTasks + 4) / 5;
+    if (wheel.GetCount() != expected) {
+        printf("  FAIL %zu tasks scheduled, expected %zu\n", wheel.GetCount(), expected);
+        return false;
+    }
+
+    // Alternate between jumping to the next expiry and random steps
+    timer.Restart();
+    uint64_t now = 1000;
+    uint64_t steps = 0;
+    while (wheel.GetCount() > 0) {
+        uint64_t next = wheel.GetNextExpiry();
+        if (next < now) {
+            printf("  FAIL next expiry %llu is in the past (%llu)\n", (unsigned long long)next, (unsigned long long)now);
+            return false;
+        }
+        now = (steps & 1) ? next : now + random.Below(600000);
+        wheel.Advance(now);
+        steps++;
+    }
+    double advanceSeconds = timer.ElapsedSeconds();
+
+    size_t fired = 0;
+    for (CheckTask& task : tasks) {
+        if (task.cancelled) {
+            if (task.fireCount != 0) {
+                printf("  FAIL cancelled task fired\n");
+                return false;
+            }
+            continue;
+        }
+        if (task.fireCount != 1 || task.firedAt < task.deadline || task.firedAt > task.deadline + task.slack) {
+            printf("  FAIL task due %llu + %llu fired %d times, at %llu\n", (unsigned long long)task.deadline,
+                   (unsigned long long)task.slack, task.fireCount, (unsigned long long)task.firedAt);
+            return false;
+        }
+        fired++;
+    }
+
+    printf("  %zu tasks over %llu h: schedule %.1f ns, cancel %.1f ns, %.1f ns/task to advance (%llu steps)\n",
+           kTasks, (unsigned long long)(kHorizonMs / 3600000), scheduleSeconds * 1e9 / kTasks,
+           cancelSeconds * 1e9 / (kTasks / 5), advanceSeconds * 1e9 / fired, (unsigned long long)steps);
+    return true;
+}
+
+// Expiry order: tasks due at earlier ticks run first
+struct OrderTask : TimerTask {
+    std::vector<uint64_t>* log = NULL;
+    void OnTimer(TimerWheel& wheel, uint64_t) override { log->push_back(wheel.GetTime() - 1); }
+};
+
+static bool RunOrderCheck() {
+    BenchRandom random(11);
+    std::vector<OrderTask> tasks(20000);
+    std::vector<uint64_t> log;
+    TimerWheel wheel;
+    for (OrderTask& task : tasks) {
+        task.log = &log;
+        wheel.Schedule(&task, random.Below(10000000), random.Below(50));
+    }
+    wheel.Advance(20000000);
+    if (log.size() != tasks.size() || !std::is_sorted(log.begin(), log.end())) {
+        printf("  FAIL %zu of %zu tasks ran, or out of order\n", log.size(), tasks.size());
+        return false;
+    }
+    return true;
+}
+
+// Collector, history and export style jobs with random phases for one hour
+static uint64_t CountWakeups(bool withSlack, uint64_t* runs) {
+    static const uint64_t periods[] = { 100, 1000, 1000, 2000, 5000, 10000, 60000 };
+    const size_t count = sizeof(periods) / sizeof(periods[0]);
+    BenchRandom random(3);
+    std::vector<PeriodicTask> tasks(count);
+    TimerWheel wheel;
+    for (size_t i = 0; i < count; i++) {
+        PeriodicTask& task = tasks[i];
+        task.period = periods[i];
+        task.slack = withSlack ? periods[i] / 8 : 0;
+        task.deadline = random.Below((uint32_t)periods[i]);
+        wheel.Schedule(&task, task.deadline, task.slack);
+    }
+
+    uint64_t wakeups = 0;
+    for (;;) {
+        uint64_t next = wheel.GetNextExpiry();
+        if (next >= 3600000) break;
+        wheel.Advance(next);
+        wakeups++;
+    }
+    *runs = 0;
+    for (PeriodicTask& task : tasks) {
+        *runs += task.runs;
+        wheel.Cancel(&task);
+    }
+    return wakeups;
+}
+
+int main() {
+    PrintBenchHeader("Timer wheel");
+
+    if (!RunRandomCheck() || !RunOrderCheck()) return 1;
+
+    uint64_t exactRuns, slackRuns;
+    uint64_t exact = CountWakeups(false, &exactRuns);
+    uint64_t coalesced = CountWakeups(true, &slackRuns);
+    printf("  periodic jobs, 1 h: %llu runs in %llu wakeups exact, %llu runs in %llu wakeups with 1/8 period slack\n",
+           (unsigned long long)exactRuns, (unsigned long long)exact,
+           (unsigned long long)slackRuns, (unsigned long long)coalesced);
+    if (coalesced >= exact) {
+        printf("  FAIL slack did not reduce wakeups\n");
+        return 1;
+    }
+    return 0;
+}
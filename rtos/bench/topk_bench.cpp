@@ -0,0 +1,123 @@
+// Minux Top-K Benchmark
+// Ranks the heaviest processes of a changing snapshot tick after tick and
+// checks every selection against a stable sort. Compares the cost of
+// ranking K rows with the streaming selector against ordering every row
+// with the radix sort, for 1k, 10k and 100k processes, then drives the
+// process list model over unranked snapshots the way the view does: a
+// window of rows at the top, the odd scroll further down.
+
+#include <algorithm>
+#include "bench_util.h"
+#include "../core/minux_topk.h"
+#include "../core/minux_proctable.h"
+#include "../core/minux_procview.h"
+
+#define TOPK_BENCH_TICKS    200
+#define TOPK_BENCH_K        (20 + 64)       // visible rows plus the collector's headroom
+
+static bool CheckSelection(const std::vector<uint64_t>& keys, size_t k, const std::vector<uint32_t>& order) {
+    std::vector<uint32_t> expected(keys.size());
+    for (size_t i = 0; i < expected.size(); i++) expected[i] = (uint32_t)i;
+    std::stable_sort(expected.begin(), expected.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+    expected.resize(std::min(k, keys.size()));
+    return order == expected;
+}
+
+static bool RunSelection(size_t processCount) {
+    BenchRandom random(21 + processCount);
+    std::vector<ProcessInfo> processes;
+    MakeSyntheticProcesses(processes, processCount, random);
+
+    TopKSelector selector;
+    ProcessSorter sorter;
+    std::vector<uint64_t> keys(processCount), complement(processCount);
+    std::vector<uint32_t> order, sorted;
+    double selectSeconds = 0, sortSeconds = 0;
+    for (int tick = 0; tick < TOPK_BENCH_TICKS; tick++) {
+        TickSyntheticProcesses(processes, random, 5);
+        if (tick % 50 == 49) {
+            // A heavy process exits: the K-th key drops below last tick's threshold
+            std::max_element(processes.begin(), processes.end(), [](const ProcessInfo& a, const ProcessInfo& b) {
+                return a.workingSetSize < b.workingSetSize;
+            })->workingSetSize = 0;
+        }
+        for (size_t i = 0; i < processCount; i++) {
+            keys[i] = processes[i].workingSetSize;
+            complement[i] = ~keys[i];
+        }
+
+        BenchTimer timer;
+        selector.Select(keys.data(), processCount, TOPK_BENCH_K, order);
+        selectSeconds += timer.ElapsedSeconds();
+
+        timer.Restart();
+        sorter.SortKeys(complement.data(), processCount, sorted);
+        sortSeconds += timer.ElapsedSeconds();
+
+        if (!CheckSelection(keys, TOPK_BENCH_K, order) || !std::equal(order.begin(), order.end(), sorted.begin())) {
+            printf("  FAIL top %d of %zu differs from a stable sort at tick %d\n", TOPK_BENCH_K, processCount, tick);
+            return false;
+        }
+    }
+
+    printf("  %7zu rows | top %d: %8.1f us/tick | full radix sort: %8.1f us/tick | %zu full scans in %d ticks\n",
+           processCount, TOPK_BENCH_K, selectSeconds * 1e6 / TOPK_BENCH_TICKS, sortSeconds * 1e6 / TOPK_BENCH_TICKS,
+           selector.GetFallbackCount(), TOPK_BENCH_TICKS);
+    return true;
+}
+
+// The model over snapshots the collector did not rank, sorted by CPU: only the window is ordered
+static bool RunModel(size_t processCount) {
+    BenchRandom random(121 + processCount);
+    std::vector<ProcessInfo> snapshots[2];
+    MakeSyntheticProcesses(snapshots[0], processCount, random);
+
+    ProcessTableModel model;
+    model.SetSort(PROCESS_COLUMN_CPU, true);
+    wchar_t buffer[MINUX_MAX_NAME];
+    double seconds = 0;
+    for (int tick = 0; tick < TOPK_BENCH_TICKS; tick++) {
+        std::vector<ProcessInfo>& next = snapshots[(tick + 1) & 1];
+        next = snapshots[tick & 1];
+        TickSyntheticProcesses(next, random, 5);
+        size_t top = tick % 40 == 39 ? 500 : 0;      // now and then the user scrolls down a way
+
+        BenchTimer timer;
+        model.SetProcesses(&next, 0);
+        model.SetWindow(top, top + 19);
+        model.PrepareRows(top, top + 19);
+        for (size_t row = top; row < top + 20; row++) {
+            for (int column = 0; column < PROCESS_COLUMN_COUNT; column++) model.CopyCellText(row, column, buffer, MINUX_MAX_NAME);
+        }
+        seconds += timer.ElapsedSeconds();
+
+        // The window shows the CPU ranks top..top+19 exactly
+        std::vector<uint32_t> cpu(next.size());
+        for (size_t i = 0; i < next.size(); i++) cpu[i] = next[i].cpuUsage;
+        std::sort(cpu.begin(), cpu.end(), [](uint32_t a, uint32_t b) { return a > b; });
+        for (size_t row = top; row < top + 20; row++) {
+            wchar_t expected[FORMAT_MAX_TEXT];
+            FormatHundredths(cpu[row], expected);
+            if (wcscmp(model.GetCellText(row, PROCESS_COLUMN_CPU), expected) != 0) {
+                printf("  FAIL row %zu shows CPU %ls, rank %zu is %ls\n", row, model.GetCellText(row, PROCESS_COLUMN_CPU), row, expected);
+                return false;
+            }
+        }
+    }
+    printf("  %7zu rows | list model sorted by CPU, 20-row window: %8.1f us/tick\n", processCount, seconds * 1e6 / TOPK_BENCH_TICKS);
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Top-K ranking");
+    printf("  5%% of processes change per tick; the heaviest exits every 50 ticks\n");
+
+    const size_t counts[] = { 1000, 10000, 100000 };
+    for (size_t count : counts) {
+        if (!RunSelection(count)) return 1;
+    }
+    for (size_t count : counts) {
+        if (!RunModel(count)) return 1;
+    }
+    return 0;
+}
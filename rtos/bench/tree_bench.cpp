@@ -0,0 +1,261 @@
+// Minux Process Tree Benchmark
+// Runs a synthetic process population through spawns, exits (parents
+// included, so subtrees get re-rooted), metric changes and reshuffled
+// snapshot order, and checks after every tick that the incrementally kept
+// tree has the same parents and subtree totals as one built from scratch.
+// Times the incremental update against a rebuild at 10k and 100k
+// processes, then collapsing and expanding nodes of a 10k-node tree, alone
+// and through the process list model.
+
+#include <algorithm>
+#include <unordered_map>
+#include "bench_util.h"
+#include "../core/minux_proctree.h"
+#include "../core/minux_procview.h"
+
+#define TREE_BENCH_TICKS    200
+#define TREE_BENCH_TOGGLES  1000
+
+struct TreePopulation {
+    std::vector<ProcessInfo> processes;
+    uint32_t nextProcessId;
+    uint64_t nextCreationTime;
+};
+
+// Every process is started by an earlier one: a few service hosts own most of them
+static void Spawn(TreePopulation& population, BenchRandom& random) {
+    static const wchar_t* names[] = {
+        L"minux-fs-worker.exe", L"svchost.exe", L"chrome.exe", L"conhost.exe", L"code.exe", L"minux-net-stack.exe"
+    };
+    std::vector<ProcessInfo>& processes = population.processes;
+    ProcessInfo info = ProcessInfo();
+    info.processId = population.nextProcessId;
+    population.nextProcessId += 4;
+    info.nameId = InternName(names[random.Below(sizeof(names) / sizeof(names[0]))]);
+    info.workingSetSize = (uint64_t)(random.Below(256 * 1024) + 64) * 1024;
+    info.cpuUsage = random.Below(400);
+    info.threadCount = random.Below(32) + 1;
+    info.creationTime = population.nextCreationTime++;
+    if (!processes.empty()) {
+        uint32_t pick = random.Below(4) == 0 ? random.Below(std::min<uint32_t>(8, (uint32_t)processes.size()))
+                                             : random.Below((uint32_t)processes.size());
+        info.parentProcessId = processes[pick].processId;
+    }
+    if (random.Below(50) == 0) info.parentProcessId = 2;    // started by a process that is long gone
+    processes.push_back(info);
+}
+
+static void MakePopulation(TreePopulation& population, size_t count, BenchRandom& random) {
+    population.processes.clear();
+    population.nextProcessId = 8;
+    population.nextCreationTime = 1000;
+    for (size_t i = 0; i < count; i++) Spawn(population, random);
+}
+
+static void TickPopulation(TreePopulation& population, BenchRandom& random) {
+    std::vector<ProcessInfo>& processes = population.processes;
+    TickSyntheticProcesses(processes, random, 5);
+    for (ProcessInfo& info : processes) {
+        if (random.Below(100) == 0) info.threadCount = random.Below(32) + 1;
+    }
+
+    // Exits, hubs now and then, and as many spawns
+    size_t exits = processes.size() / 200 + 1;
+    for (size_t i = 0; i < exits; i++) {
+        size_t victim = random.Below(8) == 0 ? random.Below(8) : random.Below((uint32_t)processes.size());
+        processes[victim] = processes.back();
+        processes.pop_back();
+    }
+    for (size_t i = 0; i < exits; i++) Spawn(population, random);
+
+    // Enumeration order is not creation order: children can come before their parents
+    for (size_t i = 0; i < processes.size() / 100; i++) {
+        std::swap(processes[random.Below((uint32_t)processes.size())], processes[random.Below((uint32_t)processes.size())]);
+    }
+}
+
+// Parents and subtree totals built from scratch; PIDs are never reused here
+static bool CheckTree(const ProcessTree& tree, const std::vector<ProcessInfo>& processes) {
+    std::unordered_map<uint32_t, size_t> byProcessId;
+    for (size_t i = 0; i < processes.size(); i++) byProcessId[processes[i].processId] = i;
+
+    std::vector<size_t> byAge(processes.size());
+    for (size_t i = 0; i < byAge.size(); i++) byAge[i] = i;
+    std::sort(byAge.begin(), byAge.end(), [&processes](size_t a, size_t b) {
+        return processes[a].creationTime > processes[b].creationTime;
+    });
+
+    // Youngest first, so every child is summed before its parent passes the total on
+    std::vector<ProcessTreeTotals> totals(processes.size());
+    std::vector<ptrdiff_t> parents(processes.size(), -1);
+    for (size_t i = 0; i < processes.size(); i++) {
+        const ProcessInfo& info = processes[i];
+        ProcessTreeTotals own = { info.workingSetSize, info.cpuUsage, info.threadCount, 1 };
+        totals[i] = own;
+        auto found = byProcessId.find(info.parentProcessId);
+        if (found != byProcessId.end() && processes[found->second].creationTime <= info.creationTime) {
+            parents[i] = (ptrdiff_t)found->second;
+        }
+    }
+    for (size_t i : byAge) {
+        if (parents[i] < 0) continue;
+        ProcessTreeTotals& parent = totals[parents[i]];
+        parent.workingSetSize += totals[i].workingSetSize;
+        parent.cpuUsage += totals[i].cpuUsage;
+        parent.threadCount += totals[i].threadCount;
+        parent.processCount += totals[i].processCount;
+    }
+
+    for (size_t i = 0; i < processes.size(); i++) {
+        int node = tree.FindNode(MakeProcessKey(processes[i]));
+        if (node < 0) {
+            printf("  FAIL PID %u is missing from the tree\n", processes[i].processId);
+            return false;
+        }
+        int parent = tree.GetParent(node);
+        uint32_t parentId = parent < 0 ? 0 : tree.GetProcess(parent).processId;
+        uint32_t expectedId = parents[i] < 0 ? 0 : processes[parents[i]].processId;
+        const ProcessTreeTotals& a = tree.GetTotals(node);
+        const ProcessTreeTotals& b = totals[i];
+        if (parentId != expectedId) {
+            printf("  FAIL PID %u hangs under %u, expected %u\n", processes[i].processId, parentId, expectedId);
+            return false;
+        }
+        if (a.workingSetSize != b.workingSetSize || a.cpuUsage != b.cpuUsage || a.threadCount != b.threadCount ||
+            a.processCount != b.processCount) {
+            printf("  FAIL PID %u subtree totals differ from a recount (%u vs %u processes)\n",
+                   processes[i].processId, a.processCount, b.processCount);
+            return false;
+        }
+    }
+    if (tree.GetTotals().processCount != processes.size() || tree.GetProcessCount() != processes.size()) {
+        printf("  FAIL tree holds %u processes, snapshot %zu\n", tree.GetTotals().processCount, processes.size());
+        return false;
+    }
+    return true;
+}
+
+// Rows are a pre-order walk: each row sits one level below its parent's row
+static bool CheckRows(const ProcessTree& tree) {
+    const std::vector<int>& rows = tree.GetRows();
+    std::vector<int> path;
+    for (int node : rows) {
+        int depth = tree.GetDepth(node);
+        if (depth > (int)path.size()) {
+            printf("  FAIL row depth jumps from %zu to %d\n", path.size(), depth);
+            return false;
+        }
+        path.resize(depth);
+        int expected = path.empty() ? -1 : path.back();
+        if (tree.GetParent(node) != expected) {
+            printf("  FAIL row under the wrong parent row\n");
+            return false;
+        }
+        path.push_back(node);
+    }
+    return true;
+}
+
+static bool RunUpdates(size_t processCount) {
+    BenchRandom random(22 + processCount);
+    TreePopulation population;
+    MakePopulation(population, processCount, random);
+
+    ProcessTree tree, rebuilt;
+    tree.Update(population.processes);
+    double updateSeconds = 0, rebuildSeconds = 0;
+    for (int tick = 0; tick < TREE_BENCH_TICKS; tick++) {
+        TickPopulation(population, random);
+
+        BenchTimer timer;
+        tree.Update(population.processes);
+        updateSeconds += timer.ElapsedSeconds();
+
+        timer.Restart();
+        rebuilt.Clear();
+        rebuilt.Update(population.processes);
+        rebuildSeconds += timer.ElapsedSeconds();
+
+        if (!CheckTree(tree, population.processes) || !CheckRows(tree)) {
+            printf("  FAIL at tick %d with %zu processes\n", tick, processCount);
+            return false;
+        }
+        if (tree.GetRows().size() != population.processes.size()) {
+            printf("  FAIL %zu rows for %zu expanded processes\n", tree.GetRows().size(), population.processes.size());
+            return false;
+        }
+    }
+
+    printf("  %7zu processes | incremental update %8.1f us/tick | rebuild %8.1f us/tick\n",
+           processCount, updateSeconds * 1e6 / TREE_BENCH_TICKS, rebuildSeconds * 1e6 / TREE_BENCH_TICKS);
+    return true;
+}
+
+// Collapse and expand the biggest subtrees of a 10k-node tree, as clicks on the list would
+static bool RunToggles(size_t processCount) {
+    BenchRandom random(122 + processCount);
+    TreePopulation population;
+    MakePopulation(population, processCount, random);
+
+    ProcessTree tree;
+    tree.Update(population.processes);
+    std::vector<int> parents;
+    for (int node : tree.GetRows()) {
+        if (tree.HasChildren(node)) parents.push_back(node);
+    }
+
+    BenchTimer timer;
+    for (int i = 0; i < TREE_BENCH_TOGGLES; i++) {
+        int node = parents[random.Below((uint32_t)parents.size())];
+        tree.SetExpanded(node, !tree.IsExpanded(node));
+    }
+    double toggleSeconds = timer.ElapsedSeconds();
+    if (!CheckRows(tree)) return false;
+
+    timer.Restart();
+    tree.SetAllExpanded(false);
+    double collapseSeconds = timer.ElapsedSeconds();
+    size_t roots = tree.GetRows().size();
+    timer.Restart();
+    tree.SetAllExpanded(true);
+    double expandSeconds = timer.ElapsedSeconds();
+    if (tree.GetRows().size() != processCount || !CheckRows(tree)) {
+        printf("  FAIL expanding everything shows %zu of %zu processes\n", tree.GetRows().size(), processCount);
+        return false;
+    }
+
+    // Through the list model: a collapsed row shows its subtree's memory and size
+    ProcessTableModel model;
+    model.SetTreeMode(true);
+    model.SetProcesses(&population.processes, 0);
+    size_t row = 0;
+    while (!model.IsRowExpandable(row)) row++;
+    int node = model.GetTree().GetRows()[row];
+    const ProcessTreeTotals& totals = model.GetTree().GetTotals(node);
+    timer.Restart();
+    model.SetRowExpanded(row, false);
+    double modelSeconds = timer.ElapsedSeconds();
+
+    wchar_t expected[FORMAT_MAX_TEXT];
+    FormatMegabytes(totals.workingSetSize, expected);
+    if (model.GetRowCount() != processCount - totals.processCount + 1 ||
+        wcscmp(model.GetCellText(row, PROCESS_COLUMN_MEMORY), expected) != 0 || model.GetParentRow(row + 1) == (ptrdiff_t)row) {
+        printf("  FAIL collapsed row %zu shows %ls, subtree holds %ls\n", row, model.GetCellText(row, PROCESS_COLUMN_MEMORY), expected);
+        return false;
+    }
+
+    printf("  %7zu processes | collapse/expand one node %6.1f us | all collapsed %6.1f us (%zu roots), all expanded %6.1f us | "
+           "model collapse of a %u-process subtree %6.1f us\n",
+           processCount, toggleSeconds * 1e6 / TREE_BENCH_TOGGLES, collapseSeconds * 1e6, roots, expandSeconds * 1e6,
+           totals.processCount, modelSeconds * 1e6);
+    return true;
+}
+
+int main() {
+    PrintBenchHeader("Process tree");
+    printf("  per tick: 5%% of processes change, 0.5%% exit (hubs included) and as many spawn\n");
+
+    if (!RunUpdates(10000) || !RunUpdates(100000)) return 1;
+    if (!RunToggles(10000)) return 1;
+    return 0;
+}
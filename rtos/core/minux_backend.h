@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+
+// Minux Monitor Backend
+// One implementation per operating system fills the platform-neutral records.
+// A backend is used from a single thread (the collector); it may keep state
+// between calls, such as open handles, CPU baselines and read buffers.
+
+class MonitorBackend {
+public:
+    virtual ~MonitorBackend() {}
+
+    // Short identifier for logs and benchmarks, e.g. "win32" or "linux"
+    virtual const char* GetName() const = 0;
+
+    // Each call refills the output; vectors are cleared first and keep their capacity.
+    // SampleSystem also reports the share of every logical processor since the last call.
+    virtual bool SampleSystem(SystemInfo& info, std::vector<CpuCoreInfo>& cores) = 0;
+    virtual bool SampleProcesses(std::vector<ProcessInfo>& processes) = 0;
+    virtual bool SampleNetwork(std::vector<NetworkInfo>& interfaces) = 0;
+
+    // Times the interface configuration (names, addresses, MACs) was enumerated;
+    // backends that cache it between OS change notifications count each rebuild
+    virtual uint32_t GetNetworkConfigRebuilds() const { return 0; }
+};
+
+// Backend for the platform this build targets (NULL if there is none)
+MonitorBackend* CreatePlatformBackend();
@@ -0,0 +1,469 @@
+// Minux Linux Monitor Backend
+// Reads /proc. Every file goes through one reused read buffer and is
+// parsed in place, so a steady-state sample performs no per-field allocations.
+// Interface names, addresses and MACs are cached and re-read only after an
+// rtnetlink link or address message; a network sample otherwise reads just
+// /proc/net/dev.
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <unordered_map>
+#include "minux_backend.h"
+#include "minux_cpusampler.h"
+#include "minux_names.h"
+#include "minux_netconfig.h"
+
+// Decode UTF-8 into a NUL-terminated wide string, truncating to capacity
+static void Utf8ToWide(const char* text, size_t length, wchar_t* out, size_t capacity) {
+    size_t written = 0;
+    size_t i = 0;
+    while (i < length && written + 1 < capacity) {
+        unsigned char c = (unsigned char)text[i];
+        uint32_t codepoint = c;
+        int extra = 0;
+        if (c >= 0xF0) { codepoint = c & 0x07; extra = 3; }
+        else if (c >= 0xE0) { codepoint = c & 0x0F; extra = 2; }
+        else if (c >= 0xC0) { codepoint = c & 0x1F; extra = 1; }
+        i++;
+        while (extra-- > 0 && i < length && ((unsigned char)text[i] & 0xC0) == 0x80) {
+            codepoint = (codepoint << 6) | ((unsigned char)text[i++] & 0x3F);
+        }
+        out[written++] = (wchar_t)codepoint;
+    }
+    out[written] = L'\0';
+}
+
+static const char* SkipSpaces(const char* p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+static const char* SkipToken(const char* p) {
+    p = SkipSpaces(p);
+    while (*p && *p != ' ' && *p != '\t' && *p != '\n') p++;
+    return p;
+}
+
+static uint64_t ParseU64(const char*& p) {
+    p = SkipSpaces(p);
+    uint64_t value = 0;
+    while (*p >= '0' && *p <= '9') value = value * 10 + (uint64_t)(*p++ - '0');
+    return value;
+}
+
+// Value of a "Key:   1234 kB" line in /proc/meminfo style files
+static uint64_t FindKeyValue(const char* text, const char* key) {
+    size_t keyLength = strlen(key);
+    for (const char* line = text; line && *line; ) {
+        if (strncmp(line, key, keyLength) == 0 && line[keyLength] == ':') {
+            const char* p = line + keyLength + 1;
+            return ParseU64(p);
+        }
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+    return 0;
+}
+
+static uint64_t MonotonicNanoseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+class LinuxBackend : public MonitorBackend {
+public:
+    LinuxBackend();
+    ~LinuxBackend();
+
+    const char* GetName() const override { return "linux"; }
+    bool SampleSystem(SystemInfo& info, std::vector<CpuCoreInfo>& cores) override;
+    bool SampleProcesses(std::vector<ProcessInfo>& processes) override;
+    bool SampleNetwork(std::vector<NetworkInfo>& interfaces) override;
+    uint32_t GetNetworkConfigRebuilds() const override { return m_netConfig.GetRebuildCount(); }
+
+private:
+    struct CpuBaseline {
+        uint64_t startTime;     // clock ticks after boot; a change means the PID was reused
+        uint64_t cpuTicks;      // utime + stime at the last sample
+        uint64_t sampleTime;    // monotonic ns of the last sample
+        uint32_t generation;
+    };
+
+    struct InterfaceCounters {
+        char name[IFNAMSIZ];
+        uint64_t values[16];    // the /proc/net/dev fields after the name
+    };
+
+    const char* ReadFile(const char* path, size_t* length = NULL);
+    bool ParseProcessStat(uint32_t processId, uint64_t now, ProcessInfo& info);
+    bool DrainNetlink();
+    const InterfaceConfig& LoadInterfaceConfig(const char* name);
+
+    std::vector<char> m_buffer;     // grows to the largest file read, then stays
+    std::unordered_map<uint32_t, CpuBaseline> m_baselines;
+    std::vector<uint32_t> m_exited;
+    std::vector<InterfaceCounters> m_interfaceCounters;    // one per /proc/net/dev line; keeps its capacity
+    uint32_t m_generation;
+    CpuSampler m_cpuSampler;
+    uint64_t m_clockTicks;
+    uint64_t m_pageSize;
+    uint32_t m_cpuCount;
+    int m_socket;                   // for SIOCGIFADDR
+    int m_netlink;                  // rtnetlink link and IPv4 address notifications; -1 polls instead
+    InterfaceConfigCache m_netConfig;
+    wchar_t m_osVersion[256];
+};
+
+LinuxBackend::LinuxBackend()
+    : m_buffer(16384), m_generation(0) {
+    long ticks = sysconf(_SC_CLK_TCK);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    m_clockTicks = ticks > 0 ? (uint64_t)ticks : 100;
+    m_pageSize = pageSize > 0 ? (uint64_t)pageSize : 4096;
+    m_cpuCount = cpus > 0 ? (uint32_t)cpus : 1;
+    m_socket = socket(AF_INET, SOCK_DGRAM, 0);
+
+    // Without the notification socket every sample re-reads the configuration, as before
+    m_netlink = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (m_netlink >= 0) {
+        struct sockaddr_nl local;
+        memset(&local, 0, sizeof(local));
+        local.nl_family = AF_NETLINK;
+        local.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+        if (bind(m_netlink, (struct sockaddr*)&local, sizeof(local)) != 0) {
+            close(m_netlink);
+            m_netlink = -1;
+        }
+    }
+
+    struct utsname name;
+    if (uname(&name) == 0) {
+        char version[256];
+        snprintf(version, sizeof(version), "%s %s", name.sysname, name.release);
+        Utf8ToWide(version, strlen(version), m_osVersion, 256);
+    } else {
+        wcscpy(m_osVersion, L"Linux");
+    }
+}
+
+LinuxBackend::~LinuxBackend() {
+    if (m_socket >= 0) close(m_socket);
+    if (m_netlink >= 0) close(m_netlink);
+}
+
+// Read a whole (small) file into the shared buffer; NULL if it cannot be read
+const char* LinuxBackend::ReadFile(const char* path, size_t* length) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    size_t used = 0;
+    for (;;) {
+        if (used + 1 >= m_buffer.size()) m_buffer.resize(m_buffer.size() * 2);
+        ssize_t count = read(fd, &m_buffer[used], m_buffer.size() - used - 1);
+        if (count < 0) {
+            close(fd);
+            return NULL;
+        }
+        if (count == 0) break;
+        used += (size_t)count;
+    }
+    close(fd);
+
+    m_buffer[used] = '\0';
+    if (length) *length = used;
+    return &m_buffer[0];
+}
+
+// Get system information
+bool LinuxBackend::SampleSystem(SystemInfo& info, std::vector<CpuCoreInfo>& cores) {
+    info = SystemInfo();
+
+    // Per-processor "cpuN user nice system idle iowait irq softirq steal" lines of /proc/stat;
+    // offline processors have no line
+    const char* text = ReadFile("/proc/stat");
+    if (text) {
+        std::vector<CpuTicks>& ticks = m_cpuSampler.GetTicks();
+        ticks.clear();
+        for (const char* line = strchr(text, '\n'); line && strncmp(line + 1, "cpu", 3) == 0; line = strchr(line + 1, '\n')) {
+            const char* p = line + 4;
+            if (*p < '0' || *p > '9') break;
+            ParseU64(p);
+            uint64_t fields[8] = {0};
+            for (int i = 0; i < 8; i++) fields[i] = ParseU64(p);
+
+            CpuTicks core;
+            core.user = fields[0] + fields[1];
+            core.kernel = fields[2] + fields[5] + fields[6] + fields[7];
+            core.idle = fields[3] + fields[4];
+            ticks.push_back(core);
+        }
+        info.cpuUsage = (m_cpuSampler.Update(cores) + 50) / 100;
+    }
+
+    // Memory load
+    text = ReadFile("/proc/meminfo");
+    if (text) {
+        uint64_t total = FindKeyValue(text, "MemTotal");
+        uint64_t available = FindKeyValue(text, "MemAvailable");
+        if (total > 0 && available <= total) {
+            info.memoryUsage = (uint32_t)((total - available) * 100 / total);
+        }
+    }
+
+    // Thread count: the "running/total" field of /proc/loadavg counts scheduling entities
+    text = ReadFile("/proc/loadavg");
+    if (text) {
+        const char* p = strchr(text, '/');
+        if (p) {
+            p++;
+            info.threadCount = (uint32_t)ParseU64(p);
+        }
+    }
+
+    // Process count: numeric entries of /proc
+    DIR* dir = opendir("/proc");
+    if (dir) {
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] >= '1' && entry->d_name[0] <= '9') info.processCount++;
+        }
+        closedir(dir);
+    }
+
+    // Uptime
+    text = ReadFile("/proc/uptime");
+    if (text) {
+        const char* p = text;
+        uint64_t seconds = ParseU64(p);
+        uint64_t hundredths = 0;
+        if (*p == '.') {
+            p++;
+            hundredths = ParseU64(p);
+        }
+        info.uptime = seconds * 1000 + hundredths * 10;
+    }
+
+    // Computer name and OS version
+    char hostName[MINUX_MAX_COMPUTER_NAME];
+    if (gethostname(hostName, sizeof(hostName)) == 0) {
+        hostName[sizeof(hostName) - 1] = '\0';
+        Utf8ToWide(hostName, strlen(hostName), info.computerName, MINUX_MAX_COMPUTER_NAME);
+    }
+    wcscpy(info.osVersion, m_osVersion);
+
+    return true;
+}
+
+// Parse /proc/<pid>/stat into the record; false if the process is gone
+bool LinuxBackend::ParseProcessStat(uint32_t processId, uint64_t now, ProcessInfo& info) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%u/stat", processId);
+    size_t length = 0;
+    const char* text = ReadFile(path, &length);
+    if (!text) return false;
+
+    // The command name may contain spaces and parentheses: it ends at the last ')'
+    const char* nameStart = strchr(text, '(');
+    const char* nameEnd = strrchr(text, ')');
+    if (!nameStart || !nameEnd || nameEnd < nameStart) return false;
+    wchar_t name[MINUX_MAX_NAME];
+    Utf8ToWide(nameStart + 1, (size_t)(nameEnd - nameStart - 1), name, MINUX_MAX_NAME);
+    info.nameId = InternName(name);
+
+    // Fields after the name, numbered from 3 (state) as in proc(5)
+    uint64_t parentId = 0, utime = 0, stime = 0, threads = 0, startTime = 0, rss = 0;
+    const char* p = nameEnd + 1;
+    for (int field = 3; field <= 24 && *p; field++) {
+        switch (field) {
+        case 4:  parentId = ParseU64(p); break;
+        case 14: utime = ParseU64(p); break;
+        case 15: stime = ParseU64(p); break;
+        case 20: threads = ParseU64(p); break;
+        case 22: startTime = ParseU64(p); break;
+        case 24: rss = ParseU64(p); break;
+        default: p = SkipToken(p); break;
+        }
+    }
+
+    info.processId = processId;
+    info.threadCount = (uint32_t)threads;
+    info.creationTime = startTime;
+    info.parentProcessId = (uint32_t)parentId;
+    info.workingSetSize = rss * m_pageSize;
+
+    // CPU usage from the utime+stime delta, normalized by online processors
+    uint64_t cpuTicks = utime + stime;
+    CpuBaseline& baseline = m_baselines[processId];
+    if (baseline.generation != 0 && baseline.startTime == startTime &&
+        now > baseline.sampleTime && cpuTicks >= baseline.cpuTicks) {
+        uint64_t busyNs = (cpuTicks - baseline.cpuTicks) * 1000000000ULL / m_clockTicks;
+        uint64_t usage = busyNs * 10000 / ((now - baseline.sampleTime) * m_cpuCount);
+        info.cpuUsage = (uint32_t)(usage > 10000 ? 10000 : usage);
+    }
+    baseline.startTime = startTime;
+    baseline.cpuTicks = cpuTicks;
+    baseline.sampleTime = now;
+    baseline.generation = m_generation;
+    return true;
+}
+
+// Get process list
+bool LinuxBackend::SampleProcesses(std::vector<ProcessInfo>& processes) {
+    processes.clear();
+    if (++m_generation == 0) m_generation = 1;
+
+    DIR* dir = opendir("/proc");
+    if (!dir) return false;
+
+    uint64_t now = MonotonicNanoseconds();
+    while (struct dirent* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (name[0] < '1' || name[0] > '9') continue;
+        const char* p = name;
+        uint32_t processId = (uint32_t)ParseU64(p);
+        if (*p != '\0') continue;
+
+        ProcessInfo info = {};
+        if (ParseProcessStat(processId, now, info)) processes.push_back(info);
+    }
+    closedir(dir);
+
+    // Forget baselines of processes that have exited
+    m_exited.clear();
+    for (const auto& entry : m_baselines) {
+        if (entry.second.generation != m_generation) m_exited.push_back(entry.first);
+    }
+    for (uint32_t processId : m_exited) m_baselines.erase(processId);
+
+    return true;
+}
+
+// Read every queued rtnetlink message; true if any arrived. The messages
+// themselves are not parsed: any link or address change re-reads the cache.
+bool LinuxBackend::DrainNetlink() {
+    char message[8192];
+    bool changed = false;
+    for (;;) {
+        ssize_t count = recv(m_netlink, message, sizeof(message), MSG_DONTWAIT);
+        if (count > 0) {
+            changed = true;
+        } else if (count < 0 && errno == ENOBUFS) {
+            changed = true;             // the queue overflowed; some changes were lost
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return changed;
+        }
+    }
+}
+
+// MAC and IPv4 address through SIOCGIFHWADDR and SIOCGIFADDR, added to the cache.
+// The ioctls answer for the caller's network namespace, which /sys need not be.
+const InterfaceConfig& LinuxBackend::LoadInterfaceConfig(const char* name) {
+    InterfaceConfig& config = m_netConfig.Add();
+    size_t nameLength = strlen(name);                   // shorter than IFNAMSIZ
+    memcpy(config.systemName, name, nameLength + 1);
+    NetworkInfo& info = config.info;
+    Utf8ToWide(name, nameLength, info.adapterName, 256);
+
+    char address[INET_ADDRSTRLEN] = "0.0.0.0";
+    if (m_socket >= 0) {
+        struct ifreq request;
+        memset(&request, 0, sizeof(request));
+        memcpy(request.ifr_name, name, nameLength);
+
+        // MAC address as AA-BB-CC-DD-EE-FF, matching the Win32 backend
+        if (ioctl(m_socket, SIOCGIFHWADDR, &request) == 0) {
+            const unsigned char* mac = (const unsigned char*)request.ifr_hwaddr.sa_data;
+            swprintf(info.macAddress, 18, L"%02X-%02X-%02X-%02X-%02X-%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        }
+
+        // IPv4 address
+        if (ioctl(m_socket, SIOCGIFADDR, &request) == 0) {
+            struct sockaddr_in* sin = (struct sockaddr_in*)&request.ifr_addr;
+            inet_ntop(AF_INET, &sin->sin_addr, address, sizeof(address));
+        }
+    }
+    Utf8ToWide(address, strlen(address), info.ipAddress, 16);
+    info.isConnected = strcmp(address, "0.0.0.0") != 0;
+    return config;
+}
+
+// Get network interfaces: counters from /proc/net/dev, the rest from the configuration cache
+bool LinuxBackend::SampleNetwork(std::vector<NetworkInfo>& interfaces) {
+    interfaces.clear();
+
+    // Drained before the counters are read, so an interface the counters
+    // already list is never matched against configuration older than it
+    if (m_netlink < 0 || DrainNetlink()) m_netConfig.Invalidate();
+    if (m_netConfig.TakeInvalidation()) m_netConfig.Clear();
+
+    const char* text = ReadFile("/proc/net/dev");
+    if (!text) return false;
+
+    // Copy the lines out of the shared buffer; the rest of the sample reads no files
+    std::vector<InterfaceCounters>& counters = m_interfaceCounters;
+    counters.clear();
+
+    const char* line = strchr(text, '\n');                  // skip the two header lines
+    if (line) line = strchr(line + 1, '\n');
+    while (line && *++line) {
+        const char* colon = strchr(line, ':');
+        const char* end = strchr(line, '\n');
+        if (!colon || (end && colon > end)) break;
+
+        counters.push_back(InterfaceCounters());
+        InterfaceCounters& entry = counters.back();
+        const char* nameStart = SkipSpaces(line);
+        size_t nameLength = (size_t)(colon - nameStart);
+        if (nameLength >= IFNAMSIZ) nameLength = IFNAMSIZ - 1;
+        memcpy(entry.name, nameStart, nameLength);
+        entry.name[nameLength] = '\0';
+
+        const char* p = colon + 1;
+        for (int i = 0; i < 16; i++) entry.values[i] = ParseU64(p);
+        line = end;
+    }
+
+    for (size_t i = 0; i < counters.size(); i++) {
+        // An interface with no entry appeared since the cache was filled; look it up now
+        const InterfaceConfig* config = m_netConfig.FindByName(counters[i].name, i);
+        if (!config) config = &LoadInterfaceConfig(counters[i].name);
+
+        NetworkInfo info = {};
+        ApplyInterfaceConfig(*config, info);
+        const uint64_t* values = counters[i].values;       // receive fields, then transmit from 8
+        info.bytesReceived = values[0];
+        info.packetsReceived = values[1];
+        info.errorsReceived = values[2];
+        info.dropsReceived = values[3];
+        info.bytesSent = values[8];
+        info.packetsSent = values[9];
+        info.errorsSent = values[10];
+        info.dropsSent = values[11];
+        interfaces.push_back(info);
+    }
+
+    return true;
+}
+
+MonitorBackend* CreatePlatformBackend() {
+    return new LinuxBackend();
+}
+#endif
@@ -0,0 +1,295 @@
+// Minux Win32 Monitor Backend
+// Per-processor CPU times from ntdll, PSAPI/toolhelp for processes, IP Helper for adapters.
+// Adapter names, addresses and MACs are cached and enumerated again only after an
+// IP interface or unicast address change callback; samples in between read counters.
+
+#ifdef _WIN32
+#include <winsock2.h>  // before windows.h; IP_ADAPTER_ADDRESSES carries socket addresses
+#include <windows.h>
+#include <winternl.h>  // For RTL_OSVERSIONINFOW
+#include <psapi.h>
+#include <iphlpapi.h>
+#include <cwchar>
+#include "minux_backend.h"
+#include "minux_procsampler.h"
+#include "minux_cpusampler.h"
+#include "minux_netconfig.h"
+
+#pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "iphlpapi.lib")
+
+// Raw per-processor times (100 ns units); KernelTime includes IdleTime
+typedef struct {
+    LARGE_INTEGER IdleTime;
+    LARGE_INTEGER KernelTime;
+    LARGE_INTEGER UserTime;
+    LARGE_INTEGER DpcTime;
+    LARGE_INTEGER InterruptTime;
+    ULONG InterruptCount;
+} ProcessorPerformanceInfo;
+
+#define SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION_CLASS 8
+
+// The Ex form takes a processor group; the plain form only sees the caller's group (64 processors)
+typedef NTSTATUS (WINAPI* NtQuerySystemInformationPtr)(ULONG, PVOID, ULONG, PULONG);
+typedef NTSTATUS (WINAPI* NtQuerySystemInformationExPtr)(ULONG, PVOID, ULONG, PVOID, ULONG, PULONG);
+
+class Win32Backend : public MonitorBackend {
+public:
+    Win32Backend();
+    ~Win32Backend();
+
+    const char* GetName() const override { return "win32"; }
+    bool SampleSystem(SystemInfo& info, std::vector<CpuCoreInfo>& cores) override;
+    bool SampleProcesses(std::vector<ProcessInfo>& processes) override;
+    bool SampleNetwork(std::vector<NetworkInfo>& interfaces) override;
+    uint32_t GetNetworkConfigRebuilds() const override { return m_netConfig.GetRebuildCount(); }
+
+private:
+    bool SampleProcessorTimes();
+    bool LoadInterfaceConfigs();
+    static VOID NETIOAPI_API_ OnInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW row, MIB_NOTIFICATION_TYPE type);
+    static VOID NETIOAPI_API_ OnAddressChange(PVOID context, PMIB_UNICASTIPADDRESS_ROW row, MIB_NOTIFICATION_TYPE type);
+
+    NtQuerySystemInformationPtr m_queryInformation;
+    NtQuerySystemInformationExPtr m_queryInformationEx;
+    WORD m_groupCount;
+    std::vector<ProcessorPerformanceInfo> m_processorTimes;    // every group, back to back
+    std::vector<BYTE> m_adapterBuffer;      // IP_ADAPTER_ADDRESSES list; grows to the largest, then stays
+    InterfaceConfigCache m_netConfig;
+    HANDLE m_interfaceNotification;         // NULL if registration failed; then every sample enumerates
+    HANDLE m_addressNotification;
+    CpuSampler m_cpuSampler;
+    ProcessSampler m_processSampler;
+};
+
+// Resolve the ntdll entry points and size the buffer for every active processor
+Win32Backend::Win32Backend()
+    : m_queryInformation(NULL), m_queryInformationEx(NULL), m_groupCount(1),
+      m_interfaceNotification(NULL), m_addressNotification(NULL) {
+    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
+    if (hNtdll) {
+        m_queryInformation = (NtQuerySystemInformationPtr)GetProcAddress(hNtdll, "NtQuerySystemInformation");
+        m_queryInformationEx = (NtQuerySystemInformationExPtr)GetProcAddress(hNtdll, "NtQuerySystemInformationEx");
+    }
+
+    DWORD processors = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    if (m_queryInformationEx) {
+        m_groupCount = GetActiveProcessorGroupCount();
+    } else {
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        processors = systemInfo.dwNumberOfProcessors;
+    }
+    m_processorTimes.resize(processors ? processors : 1);
+
+    // Baseline, so the first SampleSystem already reports real shares
+    std::vector<CpuCoreInfo> cores;
+    if (SampleProcessorTimes()) m_cpuSampler.Update(cores);
+
+    // Callbacks run on a system thread and only mark the adapter cache stale
+    if (NotifyIpInterfaceChange(AF_UNSPEC, OnInterfaceChange, this, FALSE, &m_interfaceNotification) != NO_ERROR) {
+        m_interfaceNotification = NULL;
+    }
+    if (NotifyUnicastIpAddressChange(AF_INET, OnAddressChange, this, FALSE, &m_addressNotification) != NO_ERROR) {
+        m_addressNotification = NULL;
+    }
+}
+
+// Cancelling waits for a callback already running, so none outlives the backend
+Win32Backend::~Win32Backend() {
+    if (m_interfaceNotification) CancelMibChangeNotify2(m_interfaceNotification);
+    if (m_addressNotification) CancelMibChangeNotify2(m_addressNotification);
+}
+
+VOID NETIOAPI_API_ Win32Backend::OnInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW, MIB_NOTIFICATION_TYPE) {
+    ((Win32Backend*)context)->m_netConfig.Invalidate();
+}
+
+VOID NETIOAPI_API_ Win32Backend::OnAddressChange(PVOID context, PMIB_UNICASTIPADDRESS_ROW, MIB_NOTIFICATION_TYPE) {
+    ((Win32Backend*)context)->m_netConfig.Invalidate();
+}
+
+// Read the raw times of every logical processor, one processor group at a time
+bool Win32Backend::SampleProcessorTimes() {
+    std::vector<CpuTicks>& ticks = m_cpuSampler.GetTicks();
+    ticks.clear();
+
+    ULONG filled = 0;
+    for (WORD group = 0; group < m_groupCount; group++) {
+        ULONG available = (ULONG)((m_processorTimes.size() - filled) * sizeof(ProcessorPerformanceInfo));
+        ULONG returned = 0;
+        NTSTATUS status;
+        if (m_queryInformationEx) {
+            USHORT groupNumber = group;
+            status = m_queryInformationEx(SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION_CLASS, &groupNumber, sizeof(groupNumber),
+                                          &m_processorTimes[filled], available, &returned);
+        } else if (m_queryInformation) {
+            status = m_queryInformation(SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION_CLASS,
+                                        &m_processorTimes[filled], available, &returned);
+        } else {
+            return false;
+        }
+        if (status < 0) return false;
+        filled += returned / sizeof(ProcessorPerformanceInfo);
+        if (filled >= m_processorTimes.size()) break;
+    }
+
+    for (ULONG i = 0; i < filled; i++) {
+        const ProcessorPerformanceInfo& times = m_processorTimes[i];
+        uint64_t idle = (uint64_t)times.IdleTime.QuadPart;
+        uint64_t kernel = (uint64_t)times.KernelTime.QuadPart;
+        CpuTicks core;
+        core.user = (uint64_t)times.UserTime.QuadPart;
+        core.kernel = kernel > idle ? kernel - idle : 0;
+        core.idle = idle;
+        ticks.push_back(core);
+    }
+    return filled > 0;
+}
+
+// Get system information
+bool Win32Backend::SampleSystem(SystemInfo& info, std::vector<CpuCoreInfo>& cores) {
+    info = SystemInfo();
+
+    // CPU usage from the per-processor time deltas
+    if (SampleProcessorTimes()) {
+        info.cpuUsage = (m_cpuSampler.Update(cores) + 50) / 100;
+    }
+
+    // Get memory usage
+    MEMORYSTATUSEX memStatus = {0};
+    memStatus.dwLength = sizeof(memStatus);
+    if (GlobalMemoryStatusEx(&memStatus)) {
+        info.memoryUsage = memStatus.dwMemoryLoad;
+    }
+
+    // Get process and thread count
+    PERFORMANCE_INFORMATION perfInfo = {0};
+    perfInfo.cb = sizeof(perfInfo);
+    if (GetPerformanceInfo(&perfInfo, sizeof(perfInfo))) {
+        info.processCount = perfInfo.ProcessCount;
+        info.threadCount = perfInfo.ThreadCount;
+    }
+
+    // Get uptime
+    info.uptime = GetTickCount64();
+
+    // Get computer name
+    DWORD nameSize = sizeof(info.computerName)/sizeof(wchar_t);
+    GetComputerNameW(info.computerName, &nameSize);
+
+    // Get OS version using RtlGetVersion (recommended replacement for GetVersionEx)
+    typedef NTSTATUS (WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
+    HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
+    if (hMod) {
+        RtlGetVersionPtr fxPtr = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
+        if (fxPtr) {
+            RTL_OSVERSIONINFOW rovi = {0};
+            rovi.dwOSVersionInfoSize = sizeof(rovi);
+            if (fxPtr(&rovi) == 0) {
+                swprintf_s(info.osVersion, L"Windows %d.%d Build %d",
+                         rovi.dwMajorVersion, rovi.dwMinorVersion, rovi.dwBuildNumber);
+            }
+        }
+    }
+
+    // Fallback to generic version if RtlGetVersion fails
+    if (wcslen(info.osVersion) == 0) {
+        wcscpy_s(info.osVersion, L"Windows 10+");
+    }
+
+    return true;
+}
+
+// Get process list
+bool Win32Backend::SampleProcesses(std::vector<ProcessInfo>& processes) {
+    m_processSampler.Sample(processes);
+    return true;
+}
+
+// Enumerate the adapters into the configuration cache
+bool Win32Backend::LoadInterfaceConfigs() {
+    m_netConfig.Clear();
+
+    const ULONG flags = GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER;
+    if (m_adapterBuffer.empty()) m_adapterBuffer.resize(16 * 1024);
+    ULONG size = (ULONG)m_adapterBuffer.size();
+    ULONG result = ERROR_BUFFER_OVERFLOW;
+    for (int attempt = 0; attempt < 3 && result == ERROR_BUFFER_OVERFLOW; attempt++) {
+        if (size > m_adapterBuffer.size()) m_adapterBuffer.resize(size);
+        result = GetAdaptersAddresses(AF_UNSPEC, flags, NULL, (IP_ADAPTER_ADDRESSES*)m_adapterBuffer.data(), &size);
+    }
+    if (result != NO_ERROR) return false;
+
+    for (IP_ADAPTER_ADDRESSES* adapter = (IP_ADAPTER_ADDRESSES*)m_adapterBuffer.data(); adapter; adapter = adapter->Next) {
+        if (adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK) continue;
+
+        InterfaceConfig& config = m_netConfig.Add();
+        config.key = adapter->Luid.Value;
+        NetworkInfo& info = config.info;
+        wcsncpy_s(info.adapterName, adapter->FriendlyName ? adapter->FriendlyName : L"", _TRUNCATE);
+
+        // First IPv4 address
+        wcscpy_s(info.ipAddress, L"0.0.0.0");
+        for (IP_ADAPTER_UNICAST_ADDRESS* address = adapter->FirstUnicastAddress; address; address = address->Next) {
+            if (address->Address.lpSockaddr->sa_family != AF_INET) continue;
+            const BYTE* octets = (const BYTE*)&((SOCKADDR_IN*)address->Address.lpSockaddr)->sin_addr;
+            swprintf_s(info.ipAddress, L"%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+            break;
+        }
+
+        // Format MAC address
+        const BYTE* mac = adapter->PhysicalAddress;
+        if (adapter->PhysicalAddressLength >= 6) {
+            swprintf_s(info.macAddress, L"%02X-%02X-%02X-%02X-%02X-%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        }
+
+        info.isConnected = (wcscmp(info.ipAddress, L"0.0.0.0") != 0);
+    }
+    return true;
+}
+
+// Get network interfaces: configuration from the cache, 64-bit counters from the interface table
+bool Win32Backend::SampleNetwork(std::vector<NetworkInfo>& interfaces) {
+    interfaces.clear();
+
+    // Taken before enumerating, so a change reported meanwhile enumerates again next time
+    bool polling = !m_interfaceNotification || !m_addressNotification;
+    if (polling) m_netConfig.Invalidate();
+    if (m_netConfig.TakeInvalidation() && !LoadInterfaceConfigs()) {
+        m_netConfig.Invalidate();
+        return false;
+    }
+
+    // One row per interface into the same buffer; GetIfTable2 would allocate the whole table every call
+    MIB_IF_ROW2 row;
+    for (size_t i = 0; i < m_netConfig.GetCount(); i++) {
+        const InterfaceConfig& config = m_netConfig.GetEntry(i);
+        ZeroMemory(&row, sizeof(row));
+        row.InterfaceLuid.Value = config.key;
+        if (GetIfEntry2(&row) != NO_ERROR) {
+            m_netConfig.Invalidate();       // removed before its notification arrived
+            continue;
+        }
+
+        NetworkInfo info = {0};
+        ApplyInterfaceConfig(config, info);
+        info.bytesReceived = row.InOctets;
+        info.bytesSent = row.OutOctets;
+        info.packetsReceived = row.InUcastPkts + row.InNUcastPkts;
+        info.packetsSent = row.OutUcastPkts + row.OutNUcastPkts;
+        info.errorsReceived = row.InErrors;
+        info.errorsSent = row.OutErrors;
+        info.dropsReceived = row.InDiscards;
+        info.dropsSent = row.OutDiscards;
+        interfaces.push_back(info);
+    }
+
+    return true;
+}
+
+MonitorBackend* CreatePlatformBackend() {
+    return new Win32Backend();
+}
+#endif
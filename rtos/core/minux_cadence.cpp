@@ -0,0 +1,112 @@
+#include "minux_cadence.h"
+
+// focused / visible / hidden (ms), back-off limit
+const CadenceRates g_cadenceDefaults[CADENCE_STREAM_COUNT] = {
+    {  100,  100,  5000, 10 },      // system: the CPU and memory bars are always on screen
+    { 1000, 2000, 10000,  4 },      // processes: the most expensive stream
+    { 1000, 5000, 10000,  4 },      // network
+};
+
+// CPU movement below this is noise: percent for the system, hundredths for a process
+#define CADENCE_SYSTEM_CPU_NOISE  2
+#define CADENCE_PROCESS_CPU_NOISE 100
+
+// Upper bound of any interval, so a misconfigured table cannot stall a stream
+#define CADENCE_MAX_INTERVAL_MS 60000
+
+CadenceController::CadenceController(const CadenceRates* rates)
+    : m_visible(true), m_focused(0) {
+    for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+        m_rates[stream] = rates[stream];
+        if (m_rates[stream].maxBackoff < 1) m_rates[stream].maxBackoff = 1;
+        m_nextDue[stream] = 0;
+        m_backoff[stream] = 1;
+    }
+}
+
+uint32_t CadenceController::GetBaseInterval(int stream) const {
+    const CadenceRates& rates = m_rates[stream];
+    if (!m_visible) return rates.hiddenMs;
+    return (m_focused & CADENCE_STREAM_BIT(stream)) ? rates.focusedMs : rates.visibleMs;
+}
+
+uint32_t CadenceController::GetInterval(int stream) const {
+    uint64_t interval = (uint64_t)GetBaseInterval(stream) * m_backoff[stream];
+    return (uint32_t)(interval < CADENCE_MAX_INTERVAL_MS ? interval : CADENCE_MAX_INTERVAL_MS);
+}
+
+void CadenceController::SetView(bool visible, int focusedStreams, uint64_t now) {
+    if (visible == m_visible && focusedStreams == m_focused) return;
+
+    bool becameVisible = visible && !m_visible;
+    m_visible = visible;
+    m_focused = focusedStreams;
+
+    // Bring every stream onto its new rate; on restore, refresh at once
+    for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+        if (m_nextDue[stream] == 0) continue;
+        if (becameVisible) {
+            m_backoff[stream] = 1;
+            m_nextDue[stream] = now;
+            continue;
+        }
+        uint64_t limit = now + GetInterval(stream);
+        if (m_nextDue[stream] > limit) m_nextDue[stream] = limit;
+    }
+}
+
+int CadenceController::GetDueStreams(uint64_t now) const {
+    int due = 0;
+    for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+        if (m_nextDue[stream] <= now) due |= CADENCE_STREAM_BIT(stream);
+    }
+    return due;
+}
+
+void CadenceController::Complete(int stream, uint64_t now, bool changed) {
+    if (changed) {
+        m_backoff[stream] = 1;
+    } else if (m_backoff[stream] < m_rates[stream].maxBackoff) {
+        m_backoff[stream] *= 2;
+        if (m_backoff[stream] > m_rates[stream].maxBackoff) m_backoff[stream] = m_rates[stream].maxBackoff;
+    }
+    m_nextDue[stream] = now + GetInterval(stream);
+}
+
+uint64_t CadenceController::GetNextDue() const {
+    uint64_t next = m_nextDue[0];
+    for (int stream = 1; stream < CADENCE_STREAM_COUNT; stream++) {
+        if (m_nextDue[stream] < next) next = m_nextDue[stream];
+    }
+    return next;
+}
+
+static uint32_t Distance(uint32_t a, uint32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+bool HasSystemChanged(const SystemInfo& previous, const SystemInfo& current) {
+    return Distance(previous.cpuUsage, current.cpuUsage) >= CADENCE_SYSTEM_CPU_NOISE ||
+           previous.memoryUsage != current.memoryUsage ||
+           previous.processCount != current.processCount;
+}
+
+// The ranked head of the list is by working set and the rest keeps sampling order,
+// so any start, exit or reorder at the top moves a pid
+bool HaveProcessesChanged(const std::vector<ProcessInfo>& previous, const std::vector<ProcessInfo>& current) {
+    if (previous.size() != current.size()) return true;
+    for (size_t i = 0; i < current.size(); i++) {
+        if (previous[i].processId != current[i].processId) return true;
+        if (Distance(previous[i].cpuUsage, current[i].cpuUsage) >= CADENCE_PROCESS_CPU_NOISE) return true;
+    }
+    return false;
+}
+
+bool HaveInterfacesChanged(const std::vector<NetworkInfo>& previous, const std::vector<NetworkInfo>& current) {
+    if (previous.size() != current.size()) return true;
+    for (size_t i = 0; i < current.size(); i++) {
+        if (previous[i].bytesReceived != current[i].bytesReceived || previous[i].bytesSent != current[i].bytesSent ||
+            previous[i].isConnected != current[i].isConnected) return true;
+    }
+    return false;
+}
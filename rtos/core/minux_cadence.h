@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+
+// Minux Sampling Cadence
+// Decides when each part of a snapshot is sampled again. Every stream has
+// its own interval, chosen by whether the window is visible and whether the
+// active view shows that stream. A stream whose value stopped changing backs
+// off (doubling up to a limit) and snaps back on the first change, so a
+// hidden, quiet machine is barely sampled at all.
+
+enum CadenceStream {
+    CADENCE_SYSTEM,             // CPU, per-core shares, memory
+    CADENCE_PROCESSES,
+    CADENCE_NETWORK,
+    CADENCE_STREAM_COUNT
+};
+
+#define CADENCE_STREAM_BIT(stream) (1 << (stream))
+#define CADENCE_ALL_STREAMS        ((1 << CADENCE_STREAM_COUNT) - 1)
+
+struct CadenceRates {
+    uint32_t focusedMs;         // visible and shown by the active view
+    uint32_t visibleMs;         // visible, other view
+    uint32_t hiddenMs;          // minimized or in the tray
+    uint32_t maxBackoff;        // interval multiplier limit while the value is steady
+};
+
+extern const CadenceRates g_cadenceDefaults[CADENCE_STREAM_COUNT];
+
+class CadenceController {
+public:
+    explicit CadenceController(const CadenceRates* rates = g_cadenceDefaults);
+
+    // Window state; 'focusedStreams' is a mask of the streams the active view shows.
+    // A change makes the affected streams due at their new rate right away.
+    void SetView(bool visible, int focusedStreams, uint64_t now);
+
+    // Mask of the streams due at 'now' (ms on a monotonic clock)
+    int GetDueStreams(uint64_t now) const;
+
+    // Record a finished sample; 'changed' says whether its value moved
+    void Complete(int stream, uint64_t now, bool changed);
+
+    // Time of the next due stream
+    uint64_t GetNextDue() const;
+
+    // Time a stream is due again; 0 before its first sample
+    uint64_t GetDueTime(int stream) const { return m_nextDue[stream]; }
+
+    // Current interval of a stream, including back-off
+    uint32_t GetInterval(int stream) const;
+
+private:
+    uint32_t GetBaseInterval(int stream) const;
+
+    CadenceRates m_rates[CADENCE_STREAM_COUNT];
+    bool m_visible;
+    int m_focused;
+    uint64_t m_nextDue[CADENCE_STREAM_COUNT];   // 0 until the first sample
+    uint32_t m_backoff[CADENCE_STREAM_COUNT];   // current multiplier, 1 while changing
+};
+
+// Whether a fresh sample differs enough from the previous one to keep its
+// stream at the base rate. Small CPU jitter does not count as a change.
+bool HasSystemChanged(const SystemInfo& previous, const SystemInfo& current);
+bool HaveProcessesChanged(const std::vector<ProcessInfo>& previous, const std::vector<ProcessInfo>& current);
+bool HaveInterfacesChanged(const std::vector<NetworkInfo>& previous, const std::vector<NetworkInfo>& current);
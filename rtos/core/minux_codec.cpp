@@ -0,0 +1,313 @@
+#include "minux_codec.h"
+#include <cmath>
+#include <cstring>
+
+// LSB-first bit writer appending to a byte vector
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : m_out(out), m_accumulator(0), m_bits(0) {}
+
+    // Append the low 'count' bits of 'value' (count 1..32)
+    void Write(uint64_t value, int count) {
+        m_accumulator |= (value & ((1ULL << count) - 1)) << m_bits;
+        m_bits += count;
+        while (m_bits >= 8) {
+            m_out.push_back((uint8_t)m_accumulator);
+            m_accumulator >>= 8;
+            m_bits -= 8;
+        }
+    }
+
+    void Write64(uint64_t value) {
+        Write(value & 0xFFFFFFFF, 32);
+        Write(value >> 32, 32);
+    }
+
+    void Flush() {
+        if (m_bits > 0) m_out.push_back((uint8_t)m_accumulator);
+        m_accumulator = 0;
+        m_bits = 0;
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_accumulator;
+    int m_bits;
+};
+
+static inline uint64_t ZigZag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t UnZigZag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static inline int CountLeadingZeros32(uint32_t value) {
+    int count = 0;
+    while (count < 32 && !(value & 0x80000000u)) {
+        value <<= 1;
+        count++;
+    }
+    return count;
+}
+
+static inline int CountTrailingZeros64(uint64_t value) {
+    int count = 0;
+    while (count < 64 && !(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+}
+
+// Timestamp delta-of-delta: '0' | '10'+7 | '110'+12 | '1110'+20 | '1111'+64 bits
+static void WriteTimeCode(BitWriter& writer, uint64_t code) {
+    if (code == 0) {
+        writer.Write(0, 1);
+    } else if (code < (1u << 7)) {
+        writer.Write(0x1, 2);
+        writer.Write(code, 7);
+    } else if (code < (1u << 12)) {
+        writer.Write(0x3, 3);
+        writer.Write(code, 12);
+    } else if (code < (1u << 20)) {
+        writer.Write(0x7, 4);
+        writer.Write(code, 20);
+    } else {
+        writer.Write(0xF, 4);
+        writer.Write64(code);
+    }
+}
+
+// Integer delta: '0' | '10'+6 | '110'+13 | '1110'+24 | '1111'+64 bits
+static void WriteValueCode(BitWriter& writer, uint64_t code) {
+    if (code == 0) {
+        writer.Write(0, 1);
+    } else if (code < (1u << 6)) {
+        writer.Write(0x1, 2);
+        writer.Write(code, 6);
+    } else if (code < (1u << 13)) {
+        writer.Write(0x3, 3);
+        writer.Write(code, 13);
+    } else if (code < (1u << 24)) {
+        writer.Write(0x7, 4);
+        writer.Write(code, 24);
+    } else {
+        writer.Write(0xF, 4);
+        writer.Write64(code);
+    }
+}
+
+static void WriteHeader(std::vector<uint8_t>& block, int kind, int shift, size_t count) {
+    block.push_back((uint8_t)kind);
+    block.push_back((uint8_t)shift);
+    for (int i = 0; i < 4; i++) block.push_back((uint8_t)(count >> (i * 8)));
+}
+
+size_t GetMaxEncodedSize(size_t count) {
+    // First point: 64-bit time and value; then at most 68 bits each for time and value
+    return CODEC_HEADER_BYTES + 16 + count * 17 + 1;
+}
+
+void EncodeIntegerBlock(const uint64_t* times, const int64_t* values, size_t count, std::vector<uint8_t>& block) {
+    block.clear();
+
+    // Deltas that share trailing zero bits (e.g. page-sized working sets) drop them
+    uint64_t deltaBits = 0;
+    for (size_t i = 1; i < count; i++) deltaBits |= (uint64_t)values[i] - (uint64_t)values[i - 1];
+    int shift = deltaBits ? CountTrailingZeros64(deltaBits) : 0;
+
+    WriteHeader(block, CODEC_BLOCK_INTEGER, shift, count);
+    if (count == 0) return;
+
+    BitWriter writer(block);
+    writer.Write64(times[0]);
+    writer.Write64((uint64_t)values[0]);
+
+    int64_t previousDelta = 0;
+    for (size_t i = 1; i < count; i++) {
+        int64_t delta = (int64_t)(times[i] - times[i - 1]);
+        WriteTimeCode(writer, ZigZag(delta - previousDelta));
+        previousDelta = delta;
+
+        int64_t valueDelta = (int64_t)((uint64_t)values[i] - (uint64_t)values[i - 1]);
+        WriteValueCode(writer, ZigZag(valueDelta >> shift));
+    }
+    writer.Flush();
+}
+
+void EncodeFloatBlock(const uint64_t* times, const float* values, size_t count, std::vector<uint8_t>& block) {
+    block.clear();
+    WriteHeader(block, CODEC_BLOCK_FLOAT, 0, count);
+    if (count == 0) return;
+
+    BitWriter writer(block);
+    uint32_t previous;
+    memcpy(&previous, &values[0], sizeof(previous));
+    writer.Write64(times[0]);
+    writer.Write(previous, 32);
+
+    int64_t previousDelta = 0;
+    int windowLeading = -1, windowLength = 0;
+    for (size_t i = 1; i < count; i++) {
+        int64_t delta = (int64_t)(times[i] - times[i - 1]);
+        WriteTimeCode(writer, ZigZag(delta - previousDelta));
+        previousDelta = delta;
+
+        // XOR with the previous value: '0' same | '10' inside the last window | '11' new window
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        uint32_t x = bits ^ previous;
+        previous = bits;
+        if (x == 0) {
+            writer.Write(0, 1);
+            continue;
+        }
+
+        int leading = CountLeadingZeros32(x);
+        int trailing = (int)CountTrailingZeros64(x);
+        if (windowLeading >= 0 && leading >= windowLeading && trailing >= 32 - windowLeading - windowLength) {
+            writer.Write(0x1, 2);
+            writer.Write(x >> (32 - windowLeading - windowLength), windowLength);
+        } else {
+            windowLeading = leading;
+            windowLength = 32 - leading - trailing;
+            writer.Write(0x3, 2);
+            writer.Write((uint64_t)windowLeading, 5);
+            writer.Write((uint64_t)(windowLength - 1), 5);
+            writer.Write(x >> trailing, windowLength);
+        }
+    }
+    writer.Flush();
+}
+
+HistoryBlockCursor::HistoryBlockCursor(const uint8_t* block, size_t size)
+    : m_pos(block), m_end(block + size), m_accumulator(0), m_bits(0), m_error(false),
+      m_kind(0), m_shift(0), m_count(0), m_index(0),
+      m_time(0), m_delta(0), m_value(0), m_leading(-1), m_length(0) {
+    if (size < CODEC_HEADER_BYTES) return;
+    if (block[0] != CODEC_BLOCK_INTEGER && block[0] != CODEC_BLOCK_FLOAT) return;
+    if (block[1] >= 64) return;
+
+    m_kind = block[0];
+    m_shift = block[1];
+    m_count = (uint32_t)block[2] | ((uint32_t)block[3] << 8) | ((uint32_t)block[4] << 16) | ((uint32_t)block[5] << 24);
+    m_pos = block + CODEC_HEADER_BYTES;
+}
+
+void HistoryBlockCursor::Refill() {
+    while (m_bits <= 56 && m_pos < m_end) {
+        m_accumulator |= (uint64_t)*m_pos++ << m_bits;
+        m_bits += 8;
+    }
+}
+
+bool HistoryBlockCursor::ReadBit() {
+    if (m_bits == 0) {
+        Refill();
+        if (m_bits == 0) {
+            m_error = true;
+            return false;
+        }
+    }
+    bool bit = (m_accumulator & 1) != 0;
+    m_accumulator >>= 1;
+    m_bits--;
+    return bit;
+}
+
+uint64_t HistoryBlockCursor::ReadBits(int count) {
+    if (count > 32) {
+        uint64_t low = ReadBits(32);
+        return low | (ReadBits(count - 32) << 32);
+    }
+    if (count == 0) return 0;
+    if (m_bits < count) {
+        Refill();
+        if (m_bits < count) {
+            m_error = true;
+            return 0;
+        }
+    }
+    uint64_t value = m_accumulator & ((1ULL << count) - 1);
+    m_accumulator >>= count;
+    m_bits -= count;
+    return value;
+}
+
+bool HistoryBlockCursor::Next() {
+    if (m_kind == 0 || m_error || m_index >= m_count) return false;
+
+    if (m_index == 0) {
+        m_time = ReadBits(64);
+        m_value = m_kind == CODEC_BLOCK_INTEGER ? ReadBits(64) : ReadBits(32);
+    } else {
+        // Timestamp delta-of-delta
+        uint64_t code;
+        if (!ReadBit()) code = 0;
+        else if (!ReadBit()) code = ReadBits(7);
+        else if (!ReadBit()) code = ReadBits(12);
+        else if (!ReadBit()) code = ReadBits(20);
+        else code = ReadBits(64);
+        m_delta += UnZigZag(code);
+        m_time += (uint64_t)m_delta;
+
+        if (m_kind == CODEC_BLOCK_INTEGER) {
+            if (!ReadBit()) code = 0;
+            else if (!ReadBit()) code = ReadBits(6);
+            else if (!ReadBit()) code = ReadBits(13);
+            else if (!ReadBit()) code = ReadBits(24);
+            else code = ReadBits(64);
+            m_value += (uint64_t)UnZigZag(code) << m_shift;
+        } else if (ReadBit()) {
+            if (ReadBit()) {
+                m_leading = (int)ReadBits(5);
+                m_length = (int)ReadBits(5) + 1;
+            } else if (m_leading < 0) {
+                m_error = true;
+            }
+            if (m_leading + m_length > 32) m_error = true;
+            if (!m_error) m_value ^= ReadBits(m_length) << (32 - m_leading - m_length);
+        }
+    }
+
+    if (m_error) return false;
+    m_index++;
+    return true;
+}
+
+float HistoryBlockCursor::GetFloat() const {
+    uint32_t bits = (uint32_t)m_value;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool AggregateHistoryBlock(const uint8_t* block, size_t size, uint64_t from, uint64_t to, HistoryAggregate& aggregate) {
+    memset(&aggregate, 0, sizeof(aggregate));
+    HistoryBlockCursor cursor(block, size);
+    if (!cursor.IsValid()) return false;
+
+    bool isFloat = cursor.GetKind() == CODEC_BLOCK_FLOAT;
+    uint32_t decoded = 0;
+    while (cursor.Next()) {
+        decoded++;
+        uint64_t time = cursor.GetTime();
+        if (time < from) continue;
+        if (time > to) return true;     // timestamps only grow
+
+        double value = isFloat ? (double)cursor.GetFloat() : (double)cursor.GetValue();
+        if (std::isnan(value)) continue;
+        if (aggregate.count == 0) {
+            aggregate.min = aggregate.max = value;
+            aggregate.firstTime = time;
+        }
+        if (value < aggregate.min) aggregate.min = value;
+        if (value > aggregate.max) aggregate.max = value;
+        aggregate.sum += value;
+        aggregate.lastTime = time;
+        aggregate.count++;
+    }
+    return decoded == cursor.GetCount();
+}
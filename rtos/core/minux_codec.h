@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+
+// Minux History Codec
+// Compresses sealed history blocks: timestamps as delta-of-delta, integer
+// values as zig-zag deltas and float values as XOR against the previous
+// value (Gorilla style). Both are written with short prefix codes into a bit
+// stream, so a regular timestamp or an unchanged value costs a single bit.
+// Blocks are decoded with a streaming cursor; nothing is inflated up front.
+
+// Block kinds
+#define CODEC_BLOCK_INTEGER     1
+#define CODEC_BLOCK_FLOAT       2
+
+#define CODEC_HEADER_BYTES      6   // kind, value shift, point count
+
+// Worst-case encoded size, for reserving output buffers up front
+size_t GetMaxEncodedSize(size_t count);
+
+// Encode a whole block into 'block' (cleared first, capacity reused).
+// Timestamps must not decrease.
+void EncodeIntegerBlock(const uint64_t* times, const int64_t* values, size_t count, std::vector<uint8_t>& block);
+void EncodeFloatBlock(const uint64_t* times, const float* values, size_t count, std::vector<uint8_t>& block);
+
+// Streaming decoder over one encoded block
+class HistoryBlockCursor {
+public:
+    HistoryBlockCursor(const uint8_t* block, size_t size);
+
+    bool IsValid() const { return m_kind != 0; }
+    int GetKind() const { return m_kind; }
+    uint32_t GetCount() const { return m_count; }
+
+    // Advance to the next point; false at the end or on a damaged block
+    bool Next();
+
+    uint64_t GetTime() const { return m_time; }
+    int64_t GetValue() const { return (int64_t)m_value; }      // integer blocks
+    float GetFloat() const;                                     // float blocks
+
+private:
+    bool ReadBit();
+    uint64_t ReadBits(int count);       // 0..64
+    void Refill();
+
+    const uint8_t* m_pos;
+    const uint8_t* m_end;
+    uint64_t m_accumulator;
+    int m_bits;
+    bool m_error;
+
+    int m_kind;
+    int m_shift;
+    uint32_t m_count;
+    uint32_t m_index;
+
+    uint64_t m_time;
+    int64_t m_delta;
+    uint64_t m_value;               // integer value, or float bits
+    int m_leading;                  // XOR window of the previous float
+    int m_length;
+};
+
+// Summary of the points of a block inside [from, to]
+struct HistoryAggregate {
+    uint32_t count;
+    double sum;
+    double min;
+    double max;
+    uint64_t firstTime;
+    uint64_t lastTime;
+};
+
+// Scan a block without materializing it; false if the block is damaged
+bool AggregateHistoryBlock(const uint8_t* block, size_t size, uint64_t from, uint64_t to, HistoryAggregate& aggregate);
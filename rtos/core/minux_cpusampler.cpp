@@ -0,0 +1,59 @@
+#include "minux_cpusampler.h"
+
+CpuSampler::CpuSampler() {
+}
+
+// Rounded share of 'part' in 'total', in hundredths of a percent
+static inline uint32_t Share(uint64_t part, uint64_t total) {
+    return (uint32_t)((part * 10000 + total / 2) / total);
+}
+
+// Counters never run backwards; treat a reset (e.g. a processor coming back online) as no time
+static inline uint64_t Delta(uint64_t now, uint64_t before) {
+    return now > before ? now - before : 0;
+}
+
+uint32_t CpuSampler::Update(std::vector<CpuCoreInfo>& cores) {
+    size_t count = m_ticks.size();
+    cores.resize(count);
+
+    if (m_previous.size() != count) {
+        for (CpuCoreInfo& core : cores) {
+            core.user = 0;
+            core.kernel = 0;
+            core.idle = 10000;
+        }
+        m_previous = m_ticks;
+        return 0;
+    }
+
+    uint64_t busyTotal = 0, allTotal = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t user = Delta(m_ticks[i].user, m_previous[i].user);
+        uint64_t kernel = Delta(m_ticks[i].kernel, m_previous[i].kernel);
+        uint64_t idle = Delta(m_ticks[i].idle, m_previous[i].idle);
+        uint64_t total = user + kernel + idle;
+        busyTotal += user + kernel;
+        allTotal += total;
+
+        CpuCoreInfo& core = cores[i];
+        if (total == 0) {
+            core.user = 0;
+            core.kernel = 0;
+            core.idle = 10000;
+            continue;
+        }
+
+        // Idle takes the rounding remainder so the three shares always add up to 100%
+        uint32_t userShare = Share(user, total);
+        uint32_t kernelShare = Share(kernel, total);
+        if (userShare + kernelShare > 10000) kernelShare = 10000 - userShare;
+        core.user = (uint16_t)userShare;
+        core.kernel = (uint16_t)kernelShare;
+        core.idle = (uint16_t)(10000 - userShare - kernelShare);
+    }
+
+    m_previous.swap(m_ticks);
+    m_ticks.resize(count);
+    return allTotal ? Share(busyTotal, allTotal) : 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+
+// Minux CPU Sampler
+// Turns cumulative per-processor time counters into user/kernel/idle shares
+// of the interval since the previous sample. Backends read the raw counters
+// (NtQuerySystemInformation on Windows, /proc/stat on Linux) in any unit;
+// only the deltas matter. Buffers are reused, so a steady-state sample does
+// not allocate.
+
+// Cumulative counters of one logical processor
+struct CpuTicks {
+    uint64_t user;
+    uint64_t kernel;            // excluding idle time
+    uint64_t idle;
+};
+
+class CpuSampler {
+public:
+    CpuSampler();
+
+    // Buffer for the backend to fill with one entry per logical processor
+    std::vector<CpuTicks>& GetTicks() { return m_ticks; }
+
+    // Compare GetTicks() with the previous sample. Returns the busy share of
+    // all processors in hundredths of a percent; the first sample, or one
+    // after the processor count changed, reports every core idle.
+    uint32_t Update(std::vector<CpuCoreInfo>& cores);
+
+private:
+    std::vector<CpuTicks> m_ticks;
+    std::vector<CpuTicks> m_previous;
+};
@@ -0,0 +1,589 @@
+#include "minux_effects.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#ifdef MINUX_PIXELS_X86
+#include <immintrin.h>
+#endif
+
+// Running-sum box blur, one kernel set's worth. Sums live in 16-bit lanes:
+// 255 * (2 * 127 + 2) still fits, and (sum + half) * mul >> 16 is the
+// rounded average for any window of up to 255 pixels. Columns vectorize
+// across neighbouring pixels of a row; rows run four at a time, turning 4x4
+// blocks around in registers so each lane follows one row.
+struct BlurKernels {
+    // Blur the rows of a width x height region from src into dst
+    void (*boxRows)(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                    int width, int height, int radius);
+    // Blur the columns of a width x height region from src into dst; 'sums' holds 4 * width entries
+    void (*boxColumns)(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                       int width, int height, int radius, uint16_t* sums);
+};
+
+static inline int ClampIndex(int index, int count) {
+    return index < 0 ? 0 : index >= count ? count - 1 : index;
+}
+
+static inline uint32_t GetBlurMultiplier(int radius) {
+    uint32_t taps = 2 * radius + 1;
+    return (65536 + taps / 2) / taps;
+}
+
+static inline uint32_t AveragePixel(const uint32_t* sum, uint32_t multiplier, uint32_t half) {
+    uint32_t out = 0;
+    for (int channel = 0; channel < 4; channel++) out |= (((sum[channel] + half) * multiplier) >> 16) << (channel * 8);
+    return out;
+}
+
+static inline void AddPixel(uint32_t* sum, uint32_t pixel) {
+    for (int channel = 0; channel < 4; channel++) sum[channel] += (pixel >> (channel * 8)) & 0xFF;
+}
+
+static inline void SubtractPixel(uint32_t* sum, uint32_t pixel) {
+    for (int channel = 0; channel < 4; channel++) sum[channel] -= (pixel >> (channel * 8)) & 0xFF;
+}
+
+static void BoxRowScalar(const uint32_t* src, uint32_t* dst, int width, int radius) {
+    uint32_t multiplier = GetBlurMultiplier(radius), half = radius;
+    uint32_t sum[4] = { 0, 0, 0, 0 };
+    for (int i = -radius; i <= radius; i++) AddPixel(sum, src[ClampIndex(i, width)]);
+    for (int x = 0; x < width; x++) {
+        dst[x] = AveragePixel(sum, multiplier, half);
+        SubtractPixel(sum, src[ClampIndex(x - radius, width)]);
+        AddPixel(sum, src[ClampIndex(x + radius + 1, width)]);
+    }
+}
+
+static void BoxRowsScalar(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                          int width, int height, int radius) {
+    for (int y = 0; y < height; y++) BoxRowScalar(src + (size_t)y * srcStride, dst + (size_t)y * dstStride, width, radius);
+}
+
+// Column sums for columns first..width-1, four 16-bit entries per column
+static void AddColumnsScalar(uint16_t* sums, const uint32_t* row, int first, int width) {
+    for (int x = first; x < width; x++) {
+        for (int channel = 0; channel < 4; channel++) sums[x * 4 + channel] += (row[x] >> (channel * 8)) & 0xFF;
+    }
+}
+
+static void StepColumnsScalar(uint16_t* sums, const uint32_t* leaving, const uint32_t* entering, uint32_t* out,
+                              int first, int width, uint32_t multiplier, uint32_t half) {
+    for (int x = first; x < width; x++) {
+        uint16_t* sum = sums + x * 4;
+        uint32_t pixel = 0;
+        for (int channel = 0; channel < 4; channel++) {
+            pixel |= (((sum[channel] + half) * multiplier) >> 16) << (channel * 8);
+            sum[channel] = (uint16_t)(sum[channel] - ((leaving[x] >> (channel * 8)) & 0xFF) +
+                                      ((entering[x] >> (channel * 8)) & 0xFF));
+        }
+        out[x] = pixel;
+    }
+}
+
+static void BoxColumnsScalar(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                             int width, int height, int radius, uint16_t* sums) {
+    uint32_t multiplier = GetBlurMultiplier(radius), half = radius;
+    memset(sums, 0, (size_t)width * 4 * sizeof(uint16_t));
+    for (int i = -radius; i <= radius; i++) AddColumnsScalar(sums, src + (size_t)ClampIndex(i, height) * srcStride, 0, width);
+    for (int y = 0; y < height; y++) {
+        StepColumnsScalar(sums, src + (size_t)ClampIndex(y - radius, height) * srcStride,
+                          src + (size_t)ClampIndex(y + radius + 1, height) * srcStride,
+                          dst + (size_t)y * dstStride, 0, width, multiplier, half);
+    }
+}
+
+static const BlurKernels g_scalarBlur = { BoxRowsScalar, BoxColumnsScalar };
+
+#ifdef MINUX_PIXELS_X86
+#define TRANSPOSE_4X4(a, b, c, d) do {                                          \
+        __m128i t0 = _mm_unpacklo_epi32(a, b), t1 = _mm_unpacklo_epi32(c, d);  \
+        __m128i t2 = _mm_unpackhi_epi32(a, b), t3 = _mm_unpackhi_epi32(c, d);  \
+        a = _mm_unpacklo_epi64(t0, t1);                                         \
+        b = _mm_unpackhi_epi64(t0, t1);                                         \
+        c = _mm_unpacklo_epi64(t2, t3);                                         \
+        d = _mm_unpackhi_epi64(t2, t3);                                         \
+    } while (0)
+
+// Pixel x of each of the four rows, one row per lane
+MINUX_TARGET_SSE2 static inline __m128i LoadColumn(const uint32_t* const* rows, int x, int width) {
+    x = ClampIndex(x, width);
+    return _mm_setr_epi32((int)rows[0][x], (int)rows[1][x], (int)rows[2][x], (int)rows[3][x]);
+}
+
+// Pixels x..x+3 of each of the four rows, as four columns
+MINUX_TARGET_SSE2 static inline void LoadColumns(const uint32_t* const* rows, int x, int width, __m128i* columns) {
+    if (x >= 0 && x + 4 <= width) {
+        columns[0] = _mm_loadu_si128((const __m128i*)(rows[0] + x));
+        columns[1] = _mm_loadu_si128((const __m128i*)(rows[1] + x));
+        columns[2] = _mm_loadu_si128((const __m128i*)(rows[2] + x));
+        columns[3] = _mm_loadu_si128((const __m128i*)(rows[3] + x));
+        TRANSPOSE_4X4(columns[0], columns[1], columns[2], columns[3]);
+        return;
+    }
+    for (int k = 0; k < 4; k++) columns[k] = LoadColumn(rows, x + k, width);
+}
+
+// Rows four at a time: the sums of rows 0-1 and 2-3 in two registers, one 16-bit lane per channel
+MINUX_TARGET_SSE2 static void BoxRowsSse2(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                                          int width, int height, int radius) {
+    __m128i multiplier = _mm_set1_epi16((short)GetBlurMultiplier(radius));
+    __m128i half = _mm_set1_epi16((short)radius);
+    __m128i zero = _mm_setzero_si128();
+    int groupHeight = height & ~3;
+
+    for (int y = 0; y < groupHeight; y += 4) {
+        const uint32_t* rows[4];
+        uint32_t* outs[4];
+        for (int k = 0; k < 4; k++) {
+            rows[k] = src + (size_t)(y + k) * srcStride;
+            outs[k] = dst + (size_t)(y + k) * dstStride;
+        }
+
+        __m128i low = zero, high = zero;
+        for (int i = -radius; i <= radius; i++) {
+            __m128i column = LoadColumn(rows, i, width);
+            low = _mm_add_epi16(low, _mm_unpacklo_epi8(column, zero));
+            high = _mm_add_epi16(high, _mm_unpackhi_epi8(column, zero));
+        }
+
+        for (int x = 0; x < width; x += 4) {
+            __m128i leaving[4], entering[4], out[4];
+            LoadColumns(rows, x - radius, width, leaving);
+            LoadColumns(rows, x + radius + 1, width, entering);
+            for (int k = 0; k < 4; k++) {
+                __m128i averageLow = _mm_mulhi_epu16(_mm_add_epi16(low, half), multiplier);
+                __m128i averageHigh = _mm_mulhi_epu16(_mm_add_epi16(high, half), multiplier);
+                out[k] = _mm_packus_epi16(averageLow, averageHigh);
+                low = _mm_add_epi16(_mm_sub_epi16(low, _mm_unpacklo_epi8(leaving[k], zero)),
+                                    _mm_unpacklo_epi8(entering[k], zero));
+                high = _mm_add_epi16(_mm_sub_epi16(high, _mm_unpackhi_epi8(leaving[k], zero)),
+                                     _mm_unpackhi_epi8(entering[k], zero));
+            }
+            TRANSPOSE_4X4(out[0], out[1], out[2], out[3]);
+            if (x + 4 <= width) {
+                for (int k = 0; k < 4; k++) _mm_storeu_si128((__m128i*)(outs[k] + x), out[k]);
+            } else {
+                uint32_t last[4];
+                for (int k = 0; k < 4; k++) {
+                    _mm_storeu_si128((__m128i*)last, out[k]);
+                    memcpy(outs[k] + x, last, (size_t)(width - x) * sizeof(uint32_t));
+                }
+            }
+        }
+    }
+    for (int y = groupHeight; y < height; y++) {
+        BoxRowScalar(src + (size_t)y * srcStride, dst + (size_t)y * dstStride, width, radius);
+    }
+}
+
+// Columns: four pixels per step, each pixel's sums in four 16-bit lanes
+MINUX_TARGET_SSE2 static void BoxColumnsSse2(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                                             int width, int height, int radius, uint16_t* sums) {
+    __m128i multiplier = _mm_set1_epi16((short)GetBlurMultiplier(radius));
+    __m128i half = _mm_set1_epi16((short)radius);
+    __m128i zero = _mm_setzero_si128();
+    int vectorWidth = width & ~3;
+    memset(sums, 0, (size_t)width * 4 * sizeof(uint16_t));
+
+    for (int i = -radius; i <= radius; i++) {
+        const uint32_t* row = src + (size_t)ClampIndex(i, height) * srcStride;
+        for (int x = 0; x < vectorWidth; x += 4) {
+            __m128i pixels = _mm_loadu_si128((const __m128i*)(row + x));
+            __m128i* sum = (__m128i*)(sums + x * 4);
+            _mm_storeu_si128(sum, _mm_add_epi16(_mm_loadu_si128(sum), _mm_unpacklo_epi8(pixels, zero)));
+            _mm_storeu_si128(sum + 1, _mm_add_epi16(_mm_loadu_si128(sum + 1), _mm_unpackhi_epi8(pixels, zero)));
+        }
+        AddColumnsScalar(sums, row, vectorWidth, width);
+    }
+
+    uint32_t scalarMultiplier = GetBlurMultiplier(radius);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* leaving = src + (size_t)ClampIndex(y - radius, height) * srcStride;
+        const uint32_t* entering = src + (size_t)ClampIndex(y + radius + 1, height) * srcStride;
+        uint32_t* out = dst + (size_t)y * dstStride;
+        for (int x = 0; x < vectorWidth; x += 4) {
+            __m128i* sum = (__m128i*)(sums + x * 4);
+            __m128i low = _mm_loadu_si128(sum), high = _mm_loadu_si128(sum + 1);
+            __m128i averageLow = _mm_mulhi_epu16(_mm_add_epi16(low, half), multiplier);
+            __m128i averageHigh = _mm_mulhi_epu16(_mm_add_epi16(high, half), multiplier);
+            _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(averageLow, averageHigh));
+
+            __m128i gone = _mm_loadu_si128((const __m128i*)(leaving + x));
+            __m128i come = _mm_loadu_si128((const __m128i*)(entering + x));
+            low = _mm_add_epi16(_mm_sub_epi16(low, _mm_unpacklo_epi8(gone, zero)), _mm_unpacklo_epi8(come, zero));
+            high = _mm_add_epi16(_mm_sub_epi16(high, _mm_unpackhi_epi8(gone, zero)), _mm_unpackhi_epi8(come, zero));
+            _mm_storeu_si128(sum, low);
+            _mm_storeu_si128(sum + 1, high);
+        }
+        StepColumnsScalar(sums, leaving, entering, out, vectorWidth, width, scalarMultiplier, radius);
+    }
+}
+
+static const BlurKernels g_sse2Blur = { BoxRowsSse2, BoxColumnsSse2 };
+
+// Columns: eight pixels per step. Unpacking works per 128-bit lane, so the
+// sums of a group are kept in that shuffled order, and packing undoes it.
+MINUX_TARGET_AVX2 static void BoxColumnsAvx2(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                                             int width, int height, int radius, uint16_t* sums) {
+    __m256i multiplier = _mm256_set1_epi16((short)GetBlurMultiplier(radius));
+    __m256i half = _mm256_set1_epi16((short)radius);
+    __m256i zero = _mm256_setzero_si256();
+    int vectorWidth = width & ~7;
+    memset(sums, 0, (size_t)width * 4 * sizeof(uint16_t));
+
+    for (int i = -radius; i <= radius; i++) {
+        const uint32_t* row = src + (size_t)ClampIndex(i, height) * srcStride;
+        for (int x = 0; x < vectorWidth; x += 8) {
+            __m256i pixels = _mm256_loadu_si256((const __m256i*)(row + x));
+            __m256i* sum = (__m256i*)(sums + x * 4);
+            _mm256_storeu_si256(sum, _mm256_add_epi16(_mm256_loadu_si256(sum), _mm256_unpacklo_epi8(pixels, zero)));
+            _mm256_storeu_si256(sum + 1, _mm256_add_epi16(_mm256_loadu_si256(sum + 1), _mm256_unpackhi_epi8(pixels, zero)));
+        }
+        AddColumnsScalar(sums, row, vectorWidth, width);
+    }
+
+    uint32_t scalarMultiplier = GetBlurMultiplier(radius);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* leaving = src + (size_t)ClampIndex(y - radius, height) * srcStride;
+        const uint32_t* entering = src + (size_t)ClampIndex(y + radius + 1, height) * srcStride;
+        uint32_t* out = dst + (size_t)y * dstStride;
+        for (int x = 0; x < vectorWidth; x += 8) {
+            __m256i* sum = (__m256i*)(sums + x * 4);
+            __m256i low = _mm256_loadu_si256(sum), high = _mm256_loadu_si256(sum + 1);
+            __m256i averageLow = _mm256_mulhi_epu16(_mm256_add_epi16(low, half), multiplier);
+            __m256i averageHigh = _mm256_mulhi_epu16(_mm256_add_epi16(high, half), multiplier);
+            _mm256_storeu_si256((__m256i*)(out + x), _mm256_packus_epi16(averageLow, averageHigh));
+
+            __m256i gone = _mm256_loadu_si256((const __m256i*)(leaving + x));
+            __m256i come = _mm256_loadu_si256((const __m256i*)(entering + x));
+            low = _mm256_add_epi16(_mm256_sub_epi16(low, _mm256_unpacklo_epi8(gone, zero)), _mm256_unpacklo_epi8(come, zero));
+            high = _mm256_add_epi16(_mm256_sub_epi16(high, _mm256_unpackhi_epi8(gone, zero)), _mm256_unpackhi_epi8(come, zero));
+            _mm256_storeu_si256(sum, low);
+            _mm256_storeu_si256(sum + 1, high);
+        }
+        StepColumnsScalar(sums, leaving, entering, out, vectorWidth, width, scalarMultiplier, radius);
+    }
+}
+
+// Rows keep the SSE2 kernel: an 8x8 turn costs more than the wider sums save
+static const BlurKernels g_avx2Blur = { BoxRowsSse2, BoxColumnsAvx2 };
+#endif
+
+// Follows the pixel kernel set, so SetPixelKernels switches both
+static const BlurKernels* GetBlurKernels() {
+#ifdef MINUX_PIXELS_X86
+    switch (GetPixelKernels()) {
+    case PIXEL_KERNELS_AVX2: return &g_avx2Blur;
+    case PIXEL_KERNELS_SSE2: return &g_sse2Blur;
+    default: break;
+    }
+#endif
+    return &g_scalarBlur;
+}
+
+// 'rect' cut to the surface; false when nothing is left
+static bool ClipToSurface(const PixelSurface& surface, const PixelRect& rect, PixelRect* clip) {
+    clip->left = rect.left > 0 ? rect.left : 0;
+    clip->top = rect.top > 0 ? rect.top : 0;
+    clip->right = rect.right < surface.width ? rect.right : surface.width;
+    clip->bottom = rect.bottom < surface.height ? rect.bottom : surface.height;
+    return clip->left < clip->right && clip->top < clip->bottom;
+}
+
+// Box passes over 'rect' with each radius in turn: rows into scratch, then columns back
+static void BlurPasses(const PixelSurface& surface, const PixelRect& rect, const int* radii, int count,
+                       std::vector<uint32_t>& scratch) {
+    PixelRect clip;
+    if (count == 0 || !ClipToSurface(surface, rect, &clip)) return;
+
+    int width = clip.right - clip.left, height = clip.bottom - clip.top;
+    size_t area = (size_t)width * height;
+    size_t sumWords = ((size_t)width * 4 * sizeof(uint16_t) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    if (scratch.size() < area + sumWords) scratch.resize(area + sumWords);
+    uint16_t* sums = (uint16_t*)(scratch.data() + area);
+    const BlurKernels* kernels = GetBlurKernels();
+    uint32_t* origin = surface.pixels + (size_t)clip.top * surface.stride + clip.left;
+
+    for (int pass = 0; pass < count; pass++) {
+        kernels->boxRows(origin, surface.stride, scratch.data(), width, width, height, radii[pass]);
+        kernels->boxColumns(scratch.data(), width, origin, surface.stride, width, height, radii[pass], sums);
+    }
+}
+
+void PixelBoxBlur(const PixelSurface& surface, const PixelRect& rect, int radius, std::vector<uint32_t>& scratch) {
+    if (radius <= 0) return;
+    if (radius > EFFECTS_MAX_BOX_RADIUS) radius = EFFECTS_MAX_BOX_RADIUS;
+    BlurPasses(surface, rect, &radius, 1, scratch);
+}
+
+// Box radii whose three passes have the variance of a Gaussian of 'sigma' (odd widths wl and wl + 2)
+static int GetGaussianBoxes(float sigma, int* radii) {
+    const int passes = 3;
+    float ideal = std::sqrt(12 * sigma * sigma / passes + 1);
+    int lower = (int)ideal;
+    if (lower % 2 == 0) lower--;
+    int upper = lower + 2;
+    int lowerPasses = (int)std::lround((12 * sigma * sigma - passes * lower * lower - 4 * passes * lower - 3 * passes) /
+                                       (-4.0f * lower - 4));
+    int count = 0;
+    for (int pass = 0; pass < passes; pass++) {
+        int radius = ((pass < lowerPasses ? lower : upper) - 1) / 2;
+        if (radius > EFFECTS_MAX_BOX_RADIUS) radius = EFFECTS_MAX_BOX_RADIUS;
+        if (radius > 0) radii[count++] = radius;
+    }
+    return count;
+}
+
+void PixelGaussianBlur(const PixelSurface& surface, const PixelRect& rect, float sigma, std::vector<uint32_t>& scratch) {
+    if (sigma <= 0) return;
+    int radii[3];
+    BlurPasses(surface, rect, radii, GetGaussianBoxes(sigma, radii), scratch);
+}
+
+void PixelImage::Resize(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    pixels.assign((size_t)newWidth * newHeight, 0);
+}
+
+PixelSurface PixelImage::GetSurface() {
+    PixelSurface surface = { pixels.data(), width, height, width };
+    return surface;
+}
+
+static uint64_t GetMicroseconds() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+EffectsCompositor::EffectsCompositor(size_t cacheBytes, uint64_t budgetUs)
+    : m_cacheBytes(cacheBytes), m_cachedBytes(0), m_useClock(0), m_hits(0), m_misses(0), m_evictions(0),
+      m_glassReuses(0), m_budgetUs(budgetUs), m_frameStart(0), m_frameClip(), m_frameClipped(false), m_lastFrameUs(0),
+      m_framesOverBudget(0) {
+    m_glass.rect = PixelRect();
+    m_glass.sigma = 0;
+    m_glass.tint = 0;
+    m_glass.contentVersion = 0;
+}
+
+void EffectsCompositor::Evict(size_t incomingBytes) {
+    while (!m_textures.empty() && m_cachedBytes + incomingBytes > m_cacheBytes) {
+        auto oldest = m_textures.begin();
+        for (auto it = m_textures.begin(); it != m_textures.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        m_cachedBytes -= oldest->second.image.pixels.size() * sizeof(uint32_t);
+        m_textures.erase(oldest);
+        m_evictions++;
+    }
+}
+
+// How far a Gaussian blur of 'blur' can carry a pixel: the sum of its box radii
+static int GetBlurReach(int blur) {
+    int radii[3];
+    int count = GetGaussianBoxes((float)blur, radii), reach = 0;
+    for (int pass = 0; pass < count; pass++) reach += radii[pass];
+    return reach;
+}
+
+// Shape length kept in a texture: two corners, twice the blur reach and the one
+// middle row or column that repeats along the rest of a longer element
+static int GetSlicedLength(int length, int cornerRadius, int reach) {
+    int sliced = 2 * cornerRadius + 2 * reach + 1;
+    return length < sliced ? length : sliced;
+}
+
+EffectsCompositor::Texture& EffectsCompositor::GetTexture(const TextureKey& key) {
+    auto it = m_textures.find(key);
+    if (it != m_textures.end()) {
+        m_hits++;
+        it->second.lastUse = ++m_useClock;
+        return it->second;
+    }
+
+    m_misses++;
+    int pad = 3 * key.blur;
+    size_t bytes = (size_t)(key.width + 2 * pad) * (key.height + 2 * pad) * sizeof(uint32_t);
+    Evict(bytes);
+
+    Texture& texture = m_textures[key];
+    texture.lastUse = ++m_useClock;
+    texture.image.Resize(key.width + 2 * pad, key.height + 2 * pad);
+    PixelSurface surface = texture.image.GetSurface();
+    PixelRect shape = { pad, pad, pad + key.width, pad + key.height };
+    PixelBlendRoundRect(surface, shape, key.cornerRadius, key.color);
+    PixelGaussianBlur(surface, PixelRect{ 0, 0, surface.width, surface.height }, (float)key.blur, m_scratch);
+    m_cachedBytes += bytes;
+    return texture;
+}
+
+// A run of output pixels taken from the texture: its own pixels, or one repeated row or column
+struct TextureSpan {
+    int offset;                 // into the drawn area
+    int length;
+    int source;                 // first texture row or column
+    bool repeat;
+};
+
+// Stretch a texture 'middle' pixels short of 'length' by repeating that row or column
+static int GetTextureSpans(int length, int textureLength, int middle, TextureSpan* spans) {
+    if (length == textureLength) {
+        spans[0] = TextureSpan{ 0, length, 0, false };
+        return 1;
+    }
+    int repeats = length - textureLength + 1;
+    spans[0] = TextureSpan{ 0, middle, 0, false };
+    spans[1] = TextureSpan{ middle, repeats, middle, true };
+    spans[2] = TextureSpan{ middle + repeats, textureLength - middle - 1, middle + 1, false };
+    return 3;
+}
+
+static void BlendSlicedTexture(const PixelSurface& surface, int x, int y, int width, int height,
+                               PixelImage& image, int middleX, int middleY) {
+    TextureSpan columns[3], rows[3];
+    int columnCount = GetTextureSpans(width, image.width, middleX, columns);
+    int rowCount = GetTextureSpans(height, image.height, middleY, rows);
+    PixelSurface texture = image.GetSurface();
+
+    for (int r = 0; r < rowCount; r++) {
+        const TextureSpan& row = rows[r];
+        for (int c = 0; c < columnCount; c++) {
+            const TextureSpan& column = columns[c];
+            if (row.length <= 0 || column.length <= 0) continue;
+            const uint32_t* corner = texture.pixels + (size_t)row.source * texture.stride + column.source;
+            int left = x + column.offset, top = y + row.offset;
+            if (row.repeat && column.repeat) {
+                // Inside of the shape: one colour
+                PixelBlendFill(surface, PixelRect{ left, top, left + column.length, top + row.length }, *corner);
+            } else if (column.repeat) {
+                // Top and bottom edges: each texture row is one colour along the run
+                for (int i = 0; i < row.length; i++) {
+                    PixelBlendFill(surface, PixelRect{ left, top + i, left + column.length, top + i + 1 },
+                                   corner[(size_t)i * texture.stride]);
+                }
+            } else {
+                PixelSurface piece = { (uint32_t*)corner, column.length, row.repeat ? 1 : row.length, texture.stride };
+                int copies = row.repeat ? row.length : 1;
+                for (int i = 0; i < copies; i++) PixelBlendImage(surface, left, top + i, piece);
+            }
+        }
+    }
+}
+
+void EffectsCompositor::DrawShadow(const PixelSurface& surface, const PixelRect& rect, int cornerRadius, int blur,
+                                   int offsetX, int offsetY, uint32_t color) {
+    int width = rect.right - rect.left, height = rect.bottom - rect.top;
+    if (width <= 0 || height <= 0) return;
+    if (blur < 0) blur = 0;
+    if (cornerRadius < 0) cornerRadius = 0;
+
+    // Long elements share a texture cut to their corners and edges
+    int reach = GetBlurReach(blur), pad = 3 * blur;
+    TextureKey key = { GetSlicedLength(width, cornerRadius, reach), GetSlicedLength(height, cornerRadius, reach),
+                       cornerRadius, blur, color };
+    PixelSurface target;
+    int originX, originY;
+    if (!GetFrameSurface(surface, &target, &originX, &originY)) return;
+    Texture& texture = GetTexture(key);
+    int middle = pad + cornerRadius + reach;
+    BlendSlicedTexture(target, rect.left + offsetX - pad - originX, rect.top + offsetY - pad - originY,
+                       width + 2 * pad, height + 2 * pad, texture.image, middle, middle);
+}
+
+void EffectsCompositor::DrawGlow(const PixelSurface& surface, const PixelRect& rect, int cornerRadius, int blur,
+                                 int spread, uint32_t color) {
+    PixelRect grown = { rect.left - spread, rect.top - spread, rect.right + spread, rect.bottom + spread };
+    DrawShadow(surface, grown, cornerRadius + spread, blur, 0, 0, color);
+}
+
+// A width x height block from one surface to the other
+static void CopyBlock(const PixelSurface& to, int toX, int toY, const PixelSurface& from, int fromX, int fromY,
+                      int width, int height) {
+    for (int y = 0; y < height; y++) {
+        memcpy(to.pixels + (size_t)(toY + y) * to.stride + toX, from.pixels + (size_t)(fromY + y) * from.stride + fromX,
+               (size_t)width * sizeof(uint32_t));
+    }
+}
+
+void EffectsCompositor::DrawGlass(const PixelSurface& surface, const PixelRect& rect, float sigma, uint32_t tint,
+                                  uint64_t contentVersion) {
+    PixelRect clip;
+    if (!ClipToSurface(surface, rect, &clip)) return;
+    int width = clip.right - clip.left, height = clip.bottom - clip.top;
+    Glass& glass = m_glass;
+    PixelSurface image = glass.image.GetSurface();
+    if (contentVersion != 0 && contentVersion == glass.contentVersion && sigma == glass.sigma && tint == glass.tint &&
+        memcmp(&clip, &glass.rect, sizeof(clip)) == 0) {
+        m_glassReuses++;
+    } else {
+        // Blurred aside, so a clipped frame still reads all of the glass and writes only its part
+        if (glass.image.width != width || glass.image.height != height) glass.image.Resize(width, height);
+        image = glass.image.GetSurface();
+        CopyBlock(image, 0, 0, surface, clip.left, clip.top, width, height);
+        PixelGaussianBlur(image, PixelRect{ 0, 0, width, height }, sigma, m_scratch);
+        PixelBlendFill(image, PixelRect{ 0, 0, width, height }, tint);
+        glass.rect = clip;
+        glass.sigma = sigma;
+        glass.tint = tint;
+        glass.contentVersion = contentVersion;
+    }
+
+    PixelSurface target;
+    int originX, originY;
+    PixelRect part;
+    if (!GetFrameSurface(surface, &target, &originX, &originY)) return;
+    PixelRect shifted = { clip.left - originX, clip.top - originY, clip.right - originX, clip.bottom - originY };
+    if (!ClipToSurface(target, shifted, &part)) return;
+    CopyBlock(target, part.left, part.top, image, part.left - shifted.left, part.top - shifted.top,
+              part.right - part.left, part.bottom - part.top);
+}
+
+// 'surface' cut to the frame's dirty rect, and where that view starts
+bool EffectsCompositor::GetFrameSurface(const PixelSurface& surface, PixelSurface* view, int* originX, int* originY) const {
+    *view = surface;
+    *originX = 0;
+    *originY = 0;
+    if (!m_frameClipped) return true;
+    PixelRect clip;
+    if (!ClipToSurface(surface, m_frameClip, &clip)) return false;
+    view->pixels = surface.pixels + (size_t)clip.top * surface.stride + clip.left;
+    view->width = clip.right - clip.left;
+    view->height = clip.bottom - clip.top;
+    *originX = clip.left;
+    *originY = clip.top;
+    return true;
+}
+
+void EffectsCompositor::BeginFrame() {
+    m_frameClipped = false;
+    m_frameStart = GetMicroseconds();
+}
+
+void EffectsCompositor::BeginFrame(const PixelRect& dirty) {
+    m_frameClip = dirty;
+    m_frameClipped = true;
+    m_frameStart = GetMicroseconds();
+}
+
+bool EffectsCompositor::EndFrame() {
+    m_lastFrameUs = GetMicroseconds() - m_frameStart;
+    m_frameClipped = false;
+    if (m_lastFrameUs <= m_budgetUs) return true;
+    m_framesOverBudget++;
+    return false;
+}
+
+EffectsStats EffectsCompositor::GetStats() const {
+    EffectsStats stats = { m_hits, m_misses, m_evictions, m_cachedBytes, m_textures.size(), m_glassReuses,
+                           m_lastFrameUs, m_framesOverBudget };
+    return stats;
+}
+
+void EffectsCompositor::Clear() {
+    m_textures.clear();
+    m_cachedBytes = 0;
+    m_glass.image = PixelImage();
+    m_glass.contentVersion = 0;
+    std::vector<uint32_t>().swap(m_scratch);
+}
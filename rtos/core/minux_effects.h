@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "minux_pixels.h"
+
+// Minux Effects
+// Blur, drop shadow and outer glow on premultiplied BGRA surfaces, built on
+// the pixel kernels.
+//
+// Box blurs keep a running sum per channel, so their cost does not depend on
+// the radius; three box passes approximate a Gaussian. Rows are blurred as
+// the columns of a transposed copy, so every pass runs four (SSE2) or eight
+// (AVX2) pixels at a time, and all kernel sets produce the same bytes as the
+// scalar reference.
+//
+// A shadow or glow is the element's shape, blurred. The compositor renders
+// one per (size, corner, blur, colour) into a cache, so steady frames only
+// blend ready-made textures. Past its corners and blur a shape's rows and
+// columns repeat, so a texture keeps only those and longer elements stretch
+// it: texture size, and the cache, do not grow with the window. Frosted
+// glass blurs whatever lies under it, so it cannot come from that cache;
+// instead the compositor keeps the last glass result and copies it back
+// while the caller reports the content underneath unchanged. A frame can be
+// clipped to the window's update region, so repainting a hovered button
+// does not composite the whole window again. Frame time is measured against
+// a budget that callers and the effects bench can check.
+
+#define EFFECTS_MAX_BOX_RADIUS   127                    // running sums stay in 16 bits
+#define EFFECTS_CACHE_BYTES      (8 * 1024 * 1024)      // shadow and glow textures
+#define EFFECTS_FRAME_BUDGET_US  4000                   // a quarter of a 60 Hz frame
+
+// Average each pixel with its neighbours up to 'radius' away, edges clamped
+void PixelBoxBlur(const PixelSurface& surface, const PixelRect& rect, int radius, std::vector<uint32_t>& scratch);
+
+// Three box passes sized to approximate a Gaussian of standard deviation 'sigma'
+void PixelGaussianBlur(const PixelSurface& surface, const PixelRect& rect, float sigma, std::vector<uint32_t>& scratch);
+
+// An owned surface
+struct PixelImage {
+    std::vector<uint32_t> pixels;
+    int width = 0;
+    int height = 0;
+
+    void Resize(int newWidth, int newHeight);
+    PixelSurface GetSurface();
+};
+
+struct EffectsStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t cachedBytes;
+    size_t cachedTextures;
+    uint64_t glassReuses;       // glass copied back instead of blurred
+    uint64_t lastFrameUs;       // between the last BeginFrame and EndFrame
+    uint64_t framesOverBudget;
+};
+
+class EffectsCompositor {
+public:
+    explicit EffectsCompositor(size_t cacheBytes = EFFECTS_CACHE_BYTES, uint64_t budgetUs = EFFECTS_FRAME_BUDGET_US);
+
+    EffectsCompositor(const EffectsCompositor&) = delete;
+    EffectsCompositor& operator=(const EffectsCompositor&) = delete;
+
+    // Soft shadow of a rounded rectangle, moved by offsetX, offsetY
+    void DrawShadow(const PixelSurface& surface, const PixelRect& rect, int cornerRadius, int blur,
+                    int offsetX, int offsetY, uint32_t color);
+
+    // Halo around a rounded rectangle, grown by 'spread' before blurring
+    void DrawGlow(const PixelSurface& surface, const PixelRect& rect, int cornerRadius, int blur,
+                  int spread, uint32_t color);
+
+    // Frosted glass: blur what is already under 'rect', then tint it. A
+    // nonzero 'contentVersion' names what lies underneath; while it, the rect,
+    // sigma and tint match the last call, the last result is copied back. A
+    // new version blurs all of 'rect' as it is, even in a clipped frame.
+    void DrawGlass(const PixelSurface& surface, const PixelRect& rect, float sigma, uint32_t tint,
+                   uint64_t contentVersion = 0);
+
+    // Time the effects of one frame; EndFrame returns false when it went over budget.
+    // A frame begun with a dirty rect repaints only that update region: until
+    // EndFrame, effects leave every pixel outside it alone.
+    void BeginFrame();
+    void BeginFrame(const PixelRect& dirty);
+    bool EndFrame();
+
+    EffectsStats GetStats() const;
+    void Clear();
+
+private:
+    struct TextureKey {
+        int width;
+        int height;
+        int cornerRadius;
+        int blur;
+        uint32_t color;
+
+        bool operator==(const TextureKey& other) const {
+            return width == other.width && height == other.height && cornerRadius == other.cornerRadius &&
+                   blur == other.blur && color == other.color;
+        }
+    };
+
+    struct TextureKeyHash {
+        size_t operator()(const TextureKey& key) const {
+            size_t hash = (size_t)key.width * 0x9E3779B1u;
+            hash = (hash ^ (size_t)key.height) * 0x01000193u;
+            hash = (hash ^ (size_t)key.cornerRadius) * 0x01000193u;
+            hash = (hash ^ (size_t)key.blur) * 0x01000193u;
+            return (hash ^ key.color) * 0x01000193u;
+        }
+    };
+
+    struct Texture {
+        PixelImage image;
+        uint64_t lastUse;
+    };
+
+    // The last glass drawn, already blurred and tinted
+    struct Glass {
+        PixelImage image;
+        PixelRect rect;
+        float sigma;
+        uint32_t tint;
+        uint64_t contentVersion;
+    };
+
+    // Blurred rounded rectangle of the given (sliced) size, padded by 3 * blur on every side
+    Texture& GetTexture(const TextureKey& key);
+    void Evict(size_t incomingBytes);
+    bool GetFrameSurface(const PixelSurface& surface, PixelSurface* view, int* originX, int* originY) const;
+
+    std::unordered_map<TextureKey, Texture, TextureKeyHash> m_textures;
+    std::vector<uint32_t> m_scratch;
+    Glass m_glass;
+    size_t m_cacheBytes;
+    size_t m_cachedBytes;
+    uint64_t m_useClock;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_evictions;
+    uint64_t m_glassReuses;
+    uint64_t m_budgetUs;
+    uint64_t m_frameStart;
+    PixelRect m_frameClip;
+    bool m_frameClipped;
+    uint64_t m_lastFrameUs;
+    uint64_t m_framesOverBudget;
+};
@@ -0,0 +1,382 @@
+#include "minux_export.h"
+#include "minux_names.h"
+#include <cstring>
+
+// Upper bound of one formatted row: the longest strings fully escaped
+// (6 bytes per character in JSON) plus every number at full width.
+static const size_t kMaxRowBytes = 4096;
+
+static const char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Decimal without sprintf: two digits per step, written backwards into a scratch buffer
+static char* WriteUInt(char* p, uint64_t value) {
+    char scratch[20];
+    char* end = scratch + sizeof(scratch);
+    char* start = end;
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100) * 2;
+        value /= 100;
+        *--start = kDigitPairs[pair + 1];
+        *--start = kDigitPairs[pair];
+    }
+    if (value >= 10) {
+        *--start = kDigitPairs[value * 2 + 1];
+        *--start = kDigitPairs[value * 2];
+    } else {
+        *--start = (char)('0' + value);
+    }
+    memcpy(p, start, (size_t)(end - start));
+    return p + (end - start);
+}
+
+// Hundredths as a fixed two-decimal number (CPU %)
+static char* WriteHundredths(char* p, uint32_t value) {
+    p = WriteUInt(p, value / 100);
+    unsigned pair = (value % 100) * 2;
+    *p++ = '.';
+    *p++ = kDigitPairs[pair];
+    *p++ = kDigitPairs[pair + 1];
+    return p;
+}
+
+template <size_t N>
+static inline char* WriteLiteral(char* p, const char (&text)[N]) {
+    memcpy(p, text, N - 1);
+    return p + N - 1;
+}
+
+// Next code point of a bounded wide string; wchar_t is UTF-16 on Windows and UTF-32 elsewhere
+static inline uint32_t NextCodePoint(const wchar_t*& text, const wchar_t* end) {
+    uint32_t codepoint = (uint32_t)*text++;
+    if (sizeof(wchar_t) == 2 && codepoint >= 0xD800 && codepoint < 0xDC00 && text < end) {
+        uint32_t low = (uint32_t)*text;
+        if (low >= 0xDC00 && low < 0xE000) {
+            text++;
+            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+    }
+    if (codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint < 0xE000)) codepoint = 0xFFFD;
+    return codepoint;
+}
+
+static inline char* WriteUtf8(char* p, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        *p++ = (char)codepoint;
+    } else if (codepoint < 0x800) {
+        *p++ = (char)(0xC0 | (codepoint >> 6));
+        *p++ = (char)(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        *p++ = (char)(0xE0 | (codepoint >> 12));
+        *p++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        *p++ = (char)(0x80 | (codepoint & 0x3F));
+    } else {
+        *p++ = (char)(0xF0 | (codepoint >> 18));
+        *p++ = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        *p++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        *p++ = (char)(0x80 | (codepoint & 0x3F));
+    }
+    return p;
+}
+
+static inline const wchar_t* StringEnd(const wchar_t* text, size_t capacity) {
+    const wchar_t* end = text;
+    while (end < text + capacity && *end) end++;
+    return end;
+}
+
+// CSV field, quoted only when it holds a separator, quote or line break
+static char* WriteCsvString(char* p, const wchar_t* text, size_t capacity) {
+    const wchar_t* end = StringEnd(text, capacity);
+    bool quote = false;
+    for (const wchar_t* c = text; c < end; c++) {
+        if (*c == L',' || *c == L'"' || *c == L'\n' || *c == L'\r') {
+            quote = true;
+            break;
+        }
+    }
+
+    if (quote) *p++ = '"';
+    while (text < end) {
+        uint32_t codepoint = NextCodePoint(text, end);
+        if (codepoint == '"') *p++ = '"';
+        p = WriteUtf8(p, codepoint);
+    }
+    if (quote) *p++ = '"';
+    return p;
+}
+
+// JSON string with quotes; control characters, quote and backslash escaped
+static char* WriteJsonString(char* p, const wchar_t* text, size_t capacity) {
+    static const char hex[] = "0123456789abcdef";
+    const wchar_t* end = StringEnd(text, capacity);
+    *p++ = '"';
+    while (text < end) {
+        uint32_t codepoint = NextCodePoint(text, end);
+        if (codepoint == '"' || codepoint == '\\') {
+            *p++ = '\\';
+            *p++ = (char)codepoint;
+        } else if (codepoint < 0x20) {
+            *p++ = '\\';
+            switch (codepoint) {
+            case '\n': *p++ = 'n'; break;
+            case '\r': *p++ = 'r'; break;
+            case '\t': *p++ = 't'; break;
+            default:
+                p = WriteLiteral(p, "u00");
+                *p++ = hex[codepoint >> 4];
+                *p++ = hex[codepoint & 0xF];
+                break;
+            }
+        } else {
+            p = WriteUtf8(p, codepoint);
+        }
+    }
+    *p++ = '"';
+    return p;
+}
+
+static inline char* Put8(char* p, uint8_t value) {
+    *p++ = (char)value;
+    return p;
+}
+
+static inline char* Put32(char* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) *p++ = (char)(value >> (i * 8));
+    return p;
+}
+
+static inline char* Put64(char* p, uint64_t value) {
+    for (int i = 0; i < 8; i++) *p++ = (char)(value >> (i * 8));
+    return p;
+}
+
+// u16 byte length plus UTF-8
+static char* PutString(char* p, const wchar_t* text, size_t capacity) {
+    const wchar_t* end = StringEnd(text, capacity);
+    char* start = p + 2;
+    char* out = start;
+    while (text < end) out = WriteUtf8(out, NextCodePoint(text, end));
+    size_t length = (size_t)(out - start);
+    p[0] = (char)length;
+    p[1] = (char)(length >> 8);
+    return out;
+}
+
+SnapshotExporter::SnapshotExporter(ExportFormat format, ExportSink* sink, size_t bufferBytes)
+    : m_format(format), m_sink(sink), m_size(0), m_failed(false),
+      m_processHeader(false), m_interfaceHeader(false), m_rows(0), m_bytes(0) {
+    m_buffer.resize(bufferBytes < kMaxRowBytes * 2 ? kMaxRowBytes * 2 : bufferBytes);
+}
+
+// Room for 'bytes' more; flushes to the sink, or grows the buffer when there is none
+char* SnapshotExporter::Reserve(size_t bytes) {
+    if (m_size + bytes > m_buffer.size()) {
+        if (m_sink) Flush();
+        if (m_size + bytes > m_buffer.size()) m_buffer.resize((m_size + bytes) * 2);
+    }
+    return m_buffer.data() + m_size;
+}
+
+bool SnapshotExporter::Flush() {
+    if (m_size == 0 || !m_sink) return !m_failed;
+    if (!m_failed && !m_sink->Write(m_buffer.data(), m_size)) m_failed = true;
+    m_bytes += m_size;
+    m_size = 0;
+    return !m_failed;
+}
+
+bool SnapshotExporter::Write(const MinuxSnapshot& snapshot, int rows) {
+    if (rows & EXPORT_PROCESSES) {
+        for (const ProcessInfo& info : snapshot.processes) WriteProcessRow(snapshot, info);
+    }
+    if (rows & EXPORT_INTERFACES) {
+        for (const NetworkInfo& info : snapshot.interfaces) WriteInterfaceRow(snapshot, info);
+    }
+    return !m_failed;
+}
+
+void SnapshotExporter::WriteProcessRow(const MinuxSnapshot& snapshot, const ProcessInfo& info) {
+    char* start = Reserve(kMaxRowBytes);
+    char* p = start;
+
+    switch (m_format) {
+    case EXPORT_CSV:
+        if (!m_processHeader) {
+            p = WriteLiteral(p, "kind,timestamp,pid,name,working_set,cpu,threads,creation_time\n");
+            m_processHeader = true;
+        }
+        p = WriteLiteral(p, "process,");
+        p = WriteUInt(p, snapshot.timestamp);
+        *p++ = ',';
+        p = WriteUInt(p, info.processId);
+        *p++ = ',';
+        p = WriteCsvString(p, GetName(info.nameId), MINUX_MAX_NAME);
+        *p++ = ',';
+        p = WriteUInt(p, info.workingSetSize);
+        *p++ = ',';
+        p = WriteHundredths(p, info.cpuUsage);
+        *p++ = ',';
+        p = WriteUInt(p, info.threadCount);
+        *p++ = ',';
+        p = WriteUInt(p, info.creationTime);
+        *p++ = '\n';
+        break;
+
+    case EXPORT_NDJSON:
+        p = WriteLiteral(p, "{\"kind\":\"process\",\"timestamp\":");
+        p = WriteUInt(p, snapshot.timestamp);
+        p = WriteLiteral(p, ",\"pid\":");
+        p = WriteUInt(p, info.processId);
+        p = WriteLiteral(p, ",\"name\":");
+        p = WriteJsonString(p, GetName(info.nameId), MINUX_MAX_NAME);
+        p = WriteLiteral(p, ",\"working_set\":");
+        p = WriteUInt(p, info.workingSetSize);
+        p = WriteLiteral(p, ",\"cpu\":");
+        p = WriteHundredths(p, info.cpuUsage);
+        p = WriteLiteral(p, ",\"threads\":");
+        p = WriteUInt(p, info.threadCount);
+        p = WriteLiteral(p, ",\"creation_time\":");
+        p = WriteUInt(p, info.creationTime);
+        p = WriteLiteral(p, "}\n");
+        break;
+
+    case EXPORT_BINARY:
+        p += 4;
+        p = Put8(p, EXPORT_KIND_PROCESS);
+        p = Put64(p, snapshot.timestamp);
+        p = Put32(p, info.processId);
+        p = PutString(p, GetName(info.nameId), MINUX_MAX_NAME);
+        p = Put64(p, info.workingSetSize);
+        p = Put32(p, info.cpuUsage);
+        p = Put32(p, info.threadCount);
+        p = Put64(p, info.creationTime);
+        Put32(start, (uint32_t)(p - start - 4));
+        break;
+    }
+
+    m_size += (size_t)(p - start);
+    m_rows++;
+}
+
+void SnapshotExporter::WriteInterfaceRow(const MinuxSnapshot& snapshot, const NetworkInfo& info) {
+    char* start = Reserve(kMaxRowBytes);
+    char* p = start;
+
+    switch (m_format) {
+    case EXPORT_CSV:
+        if (!m_interfaceHeader) {
+            p = WriteLiteral(p, "kind,timestamp,adapter,ip,mac,bytes_received,bytes_sent,packets_received,packets_sent,"
+                                "errors_received,errors_sent,drops_received,drops_sent,"
+                                "bytes_received_per_second,bytes_sent_per_second,packets_received_per_second,"
+                                "packets_sent_per_second,rate_interval_ms,connected\n");
+            m_interfaceHeader = true;
+        }
+        p = WriteLiteral(p, "interface,");
+        p = WriteUInt(p, snapshot.timestamp);
+        *p++ = ',';
+        p = WriteCsvString(p, info.adapterName, 256);
+        *p++ = ',';
+        p = WriteCsvString(p, info.ipAddress, 16);
+        *p++ = ',';
+        p = WriteCsvString(p, info.macAddress, 18);
+        *p++ = ',';
+        p = WriteUInt(p, info.bytesReceived);
+        *p++ = ',';
+        p = WriteUInt(p, info.bytesSent);
+        *p++ = ',';
+        p = WriteUInt(p, info.packetsReceived);
+        *p++ = ',';
+        p = WriteUInt(p, info.packetsSent);
+        *p++ = ',';
+        p = WriteUInt(p, info.errorsReceived);
+        *p++ = ',';
+        p = WriteUInt(p, info.errorsSent);
+        *p++ = ',';
+        p = WriteUInt(p, info.dropsReceived);
+        *p++ = ',';
+        p = WriteUInt(p, info.dropsSent);
+        *p++ = ',';
+        p = WriteUInt(p, info.bytesReceivedPerSecond);
+        *p++ = ',';
+        p = WriteUInt(p, info.bytesSentPerSecond);
+        *p++ = ',';
+        p = WriteUInt(p, info.packetsReceivedPerSecond);
+        *p++ = ',';
+        p = WriteUInt(p, info.packetsSentPerSecond);
+        *p++ = ',';
+        p = WriteUInt(p, info.rateIntervalMs);
+        *p++ = ',';
+        *p++ = info.isConnected ? '1' : '0';
+        *p++ = '\n';
+        break;
+
+    case EXPORT_NDJSON:
+        p = WriteLiteral(p, "{\"kind\":\"interface\",\"timestamp\":");
+        p = WriteUInt(p, snapshot.timestamp);
+        p = WriteLiteral(p, ",\"adapter\":");
+        p = WriteJsonString(p, info.adapterName, 256);
+        p = WriteLiteral(p, ",\"ip\":");
+        p = WriteJsonString(p, info.ipAddress, 16);
+        p = WriteLiteral(p, ",\"mac\":");
+        p = WriteJsonString(p, info.macAddress, 18);
+        p = WriteLiteral(p, ",\"bytes_received\":");
+        p = WriteUInt(p, info.bytesReceived);
+        p = WriteLiteral(p, ",\"bytes_sent\":");
+        p = WriteUInt(p, info.bytesSent);
+        p = WriteLiteral(p, ",\"packets_received\":");
+        p = WriteUInt(p, info.packetsReceived);
+        p = WriteLiteral(p, ",\"packets_sent\":");
+        p = WriteUInt(p, info.packetsSent);
+        p = WriteLiteral(p, ",\"errors_received\":");
+        p = WriteUInt(p, info.errorsReceived);
+        p = WriteLiteral(p, ",\"errors_sent\":");
+        p = WriteUInt(p, info.errorsSent);
+        p = WriteLiteral(p, ",\"drops_received\":");
+        p = WriteUInt(p, info.dropsReceived);
+        p = WriteLiteral(p, ",\"drops_sent\":");
+        p = WriteUInt(p, info.dropsSent);
+        p = WriteLiteral(p, ",\"bytes_received_per_second\":");
+        p = WriteUInt(p, info.bytesReceivedPerSecond);
+        p = WriteLiteral(p, ",\"bytes_sent_per_second\":");
+        p = WriteUInt(p, info.bytesSentPerSecond);
+        p = WriteLiteral(p, ",\"packets_received_per_second\":");
+        p = WriteUInt(p, info.packetsReceivedPerSecond);
+        p = WriteLiteral(p, ",\"packets_sent_per_second\":");
+        p = WriteUInt(p, info.packetsSentPerSecond);
+        p = WriteLiteral(p, ",\"rate_interval_ms\":");
+        p = WriteUInt(p, info.rateIntervalMs);
+        if (info.isConnected) p = WriteLiteral(p, ",\"connected\":true}\n");
+        else p = WriteLiteral(p, ",\"connected\":false}\n");
+        break;
+
+    case EXPORT_BINARY:
+        p += 4;
+        p = Put8(p, EXPORT_KIND_INTERFACE);
+        p = Put64(p, snapshot.timestamp);
+        p = PutString(p, info.adapterName, 256);
+        p = PutString(p, info.ipAddress, 16);
+        p = PutString(p, info.macAddress, 18);
+        p = Put64(p, info.bytesReceived);
+        p = Put64(p, info.bytesSent);
+        p = Put64(p, info.packetsReceived);
+        p = Put64(p, info.packetsSent);
+        p = Put64(p, info.errorsReceived);
+        p = Put64(p, info.errorsSent);
+        p = Put64(p, info.dropsReceived);
+        p = Put64(p, info.dropsSent);
+        p = Put64(p, info.bytesReceivedPerSecond);
+        p = Put64(p, info.bytesSentPerSecond);
+        p = Put64(p, info.packetsReceivedPerSecond);
+        p = Put64(p, info.packetsSentPerSecond);
+        p = Put32(p, info.rateIntervalMs);
+        p = Put8(p, info.isConnected ? 1 : 0);
+        Put32(start, (uint32_t)(p - start - 4));
+        break;
+    }
+
+    m_size += (size_t)(p - start);
+    m_rows++;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+#include "minux_types.h"
+#include "minux_snapshot.h"
+
+// Minux Export
+// Streams snapshot rows as CSV, NDJSON or length-prefixed binary records.
+// Rows are formatted straight from snapshot memory into one reused buffer
+// that is handed to a sink whenever it fills; nothing is allocated once the
+// buffer exists. Text is written as UTF-8.
+//
+// CSV and NDJSON rows start with their kind ("process" or "interface"); CSV
+// writes a header row for each kind before its first row.
+// Binary records: u32 length of the rest, u8 kind, then the fields in
+// little-endian with strings as u16 byte length plus UTF-8:
+//   process:   u64 timestamp, u32 pid, name, u64 working set, u32 CPU
+//              (hundredths of a percent), u32 threads, u64 creation time
+//   interface: u64 timestamp, adapter, ip, mac; u64 bytes, packets, errors
+//              and drops, each received then sent; u64 bytes and packets per
+//              second, each received then sent; u32 rate interval in ms (0 on
+//              an interface's first reading, which has no rates yet); u8 connected
+
+enum ExportFormat {
+    EXPORT_CSV,
+    EXPORT_NDJSON,
+    EXPORT_BINARY
+};
+
+// Rows to export from each snapshot
+#define EXPORT_PROCESSES        0x1
+#define EXPORT_INTERFACES       0x2
+#define EXPORT_ALL              (EXPORT_PROCESSES | EXPORT_INTERFACES)
+
+// Binary record kinds
+#define EXPORT_KIND_PROCESS     1
+#define EXPORT_KIND_INTERFACE   2
+
+#define EXPORT_BUFFER_BYTES     (256 * 1024)
+
+// Destination of formatted bytes
+class ExportSink {
+public:
+    virtual ~ExportSink() {}
+    virtual bool Write(const char* data, size_t size) = 0;
+};
+
+// Writes to a FILE* owned by the caller
+class FileExportSink : public ExportSink {
+public:
+    explicit FileExportSink(FILE* file) : m_file(file) {}
+    bool Write(const char* data, size_t size) override {
+        return fwrite(data, 1, size, m_file) == size;
+    }
+
+private:
+    FILE* m_file;
+};
+
+class SnapshotExporter {
+public:
+    // Without a sink the buffer grows and the caller drains it with GetData/Reset
+    explicit SnapshotExporter(ExportFormat format, ExportSink* sink = NULL, size_t bufferBytes = EXPORT_BUFFER_BYTES);
+
+    SnapshotExporter(const SnapshotExporter&) = delete;
+    SnapshotExporter& operator=(const SnapshotExporter&) = delete;
+
+    // Append the selected rows of a snapshot; false once the sink has failed
+    bool Write(const MinuxSnapshot& snapshot, int rows = EXPORT_ALL);
+
+    // Hand buffered bytes to the sink
+    bool Flush();
+
+    // Buffered bytes when there is no sink
+    const char* GetData() const { return m_buffer.data(); }
+    size_t GetSize() const { return m_size; }
+    void Reset() { m_size = 0; }
+
+    uint64_t GetRowCount() const { return m_rows; }
+    uint64_t GetByteCount() const { return m_bytes + m_size; }
+
+private:
+    char* Reserve(size_t bytes);
+    void WriteProcessRow(const MinuxSnapshot& snapshot, const ProcessInfo& info);
+    void WriteInterfaceRow(const MinuxSnapshot& snapshot, const NetworkInfo& info);
+
+    ExportFormat m_format;
+    ExportSink* m_sink;
+    std::vector<char> m_buffer;
+    size_t m_size;
+    bool m_failed;
+    bool m_processHeader;       // CSV header rows already written
+    bool m_interfaceHeader;
+    uint64_t m_rows;
+    uint64_t m_bytes;           // handed to the sink
+};
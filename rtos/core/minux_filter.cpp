@@ -0,0 +1,432 @@
+#include "minux_filter.h"
+#include "minux_names.h"
+#include <cwctype>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MINUX_FILTER_X86 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MINUX_FILTER_SSE2
+#else
+#define MINUX_FILTER_SSE2 __attribute__((target("sse2")))
+#endif
+#endif
+
+enum FilterOperator {
+    FILTER_LESS,
+    FILTER_LESS_EQUAL,
+    FILTER_GREATER,
+    FILTER_GREATER_EQUAL,
+    FILTER_EQUAL
+};
+
+// Lower case; ASCII without a table or locale call
+static inline wchar_t FoldChar(wchar_t c) {
+    if ((unsigned)c < 128) return (unsigned)(c - L'A') < 26 ? (wchar_t)(c + 32) : c;
+    return (wchar_t)towlower((wint_t)c);
+}
+
+static bool EqualsFolded(const wchar_t* text, const wchar_t* term, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (FoldChar(text[i]) != term[i]) return false;
+    }
+    return true;
+}
+
+static bool ContainsScalar(const wchar_t* text, size_t length, const std::wstring& term) {
+    size_t n = term.size();
+    if (n > length) return false;
+    for (size_t i = 0; i + n <= length; i++) {
+        if (FoldChar(text[i]) == term[0] && EqualsFolded(text + i, term.data(), n)) return true;
+    }
+    return false;
+}
+
+#ifdef MINUX_FILTER_X86
+MINUX_FILTER_SSE2 static inline __m128i SplatChar(wchar_t c) {
+    return sizeof(wchar_t) == 2 ? _mm_set1_epi16((short)c) : _mm_set1_epi32((int)c);
+}
+
+MINUX_FILTER_SSE2 static inline __m128i EqualChars(__m128i a, __m128i b) {
+    return sizeof(wchar_t) == 2 ? _mm_cmpeq_epi16(a, b) : _mm_cmpeq_epi32(a, b);
+}
+
+static inline unsigned LowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// Lanes where the term's first character lines up with a match of its last
+// character are candidates; only those are compared in full
+MINUX_FILTER_SSE2 static bool ContainsSse2(const wchar_t* text, size_t length, const std::wstring& term) {
+    const size_t lanes = 16 / sizeof(wchar_t);
+    const unsigned laneBits = (1u << sizeof(wchar_t)) - 1;
+    size_t n = term.size();
+    if (n > length) return false;
+
+    // Both cases of a letter are compared; other folds than ASCII take the scalar path
+    wchar_t first = term[0], last = term[n - 1];
+    if ((unsigned)first >= 128 || (unsigned)last >= 128) return ContainsScalar(text, length, term);
+    __m128i firstLower = SplatChar(first), firstUpper = SplatChar((unsigned)(first - L'a') < 26 ? first - 32 : first);
+    __m128i lastLower = SplatChar(last), lastUpper = SplatChar((unsigned)(last - L'a') < 26 ? last - 32 : last);
+
+    size_t i = 0;
+    for (; i + n - 1 + lanes <= length; i += lanes) {
+        __m128i head = _mm_loadu_si128((const __m128i*)(text + i));
+        __m128i tail = _mm_loadu_si128((const __m128i*)(text + i + n - 1));
+        __m128i hits = _mm_and_si128(_mm_or_si128(EqualChars(head, firstLower), EqualChars(head, firstUpper)),
+                                     _mm_or_si128(EqualChars(tail, lastLower), EqualChars(tail, lastUpper)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hits);
+        while (mask) {
+            unsigned bit = LowestBit(mask);
+            if (EqualsFolded(text + i + bit / sizeof(wchar_t), term.data(), n)) return true;
+            mask &= ~(laneBits << bit);
+        }
+    }
+    for (; i + n <= length; i++) {
+        if (FoldChar(text[i]) == first && EqualsFolded(text + i, term.data(), n)) return true;
+    }
+    return false;
+}
+
+static bool CpuHasSse2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+#endif
+
+// Whole-name match; '*' spans any run of characters and '?' any one
+static bool GlobMatches(const wchar_t* text, size_t length, const std::wstring& pattern) {
+    size_t t = 0, p = 0, starPattern = std::wstring::npos, starText = 0;
+    while (t < length) {
+        if (p < pattern.size() && (pattern[p] == L'?' || pattern[p] == FoldChar(text[t]))) {
+            t++;
+            p++;
+        } else if (p < pattern.size() && pattern[p] == L'*') {
+            starPattern = p++;
+            starText = t;
+        } else if (starPattern != std::wstring::npos) {
+            p = starPattern + 1;
+            t = ++starText;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == L'*') p++;
+    return p == pattern.size();
+}
+
+static int g_filterSimd = -1;      // -1 until first use
+
+bool IsFilterSimdAvailable() {
+#ifdef MINUX_FILTER_X86
+    static const bool available = CpuHasSse2();
+    return available;
+#else
+    return false;
+#endif
+}
+
+void SetFilterSimd(bool enabled) {
+    g_filterSimd = enabled && IsFilterSimdAvailable() ? 1 : 0;
+}
+
+bool IsFilterSimdEnabled() {
+    if (g_filterSimd < 0) SetFilterSimd(true);
+    return g_filterSimd != 0;
+}
+
+static bool Contains(const wchar_t* text, size_t length, const std::wstring& term) {
+    if (term.empty()) return true;
+#ifdef MINUX_FILTER_X86
+    if (IsFilterSimdEnabled()) return ContainsSse2(text, length, term);
+#endif
+    return ContainsScalar(text, length, term);
+}
+
+// Digits with an optional fraction; the fraction is kept as fraction / scale
+static bool ParseNumber(const wchar_t*& p, const wchar_t* end, uint64_t& whole, uint64_t& fraction, uint64_t& scale) {
+    whole = 0;
+    fraction = 0;
+    scale = 1;
+    const wchar_t* start = p;
+    while (p < end && *p >= L'0' && *p <= L'9') {
+        if (whole > 100000000000000ULL) return false;
+        whole = whole * 10 + (uint64_t)(*p++ - L'0');
+    }
+    bool digits = p > start;
+    if (p < end && *p == L'.') {
+        p++;
+        while (p < end && *p >= L'0' && *p <= L'9') {
+            if (scale < 1000000000ULL) {
+                fraction = fraction * 10 + (uint64_t)(*p - L'0');
+                scale *= 10;
+            }
+            p++;
+            digits = true;
+        }
+    }
+    return digits;
+}
+
+// Case-insensitive whole match of [p, end) against a lower-case word
+static bool TextIs(const wchar_t* p, const wchar_t* end, const wchar_t* word) {
+    for (; p < end; p++, word++) {
+        if (*word == L'\0' || FoldChar(*p) != *word) return false;
+    }
+    return *word == L'\0';
+}
+
+static void Constrain(uint64_t& low, uint64_t& high, FilterOperator op, uint64_t value, bool& empty) {
+    switch (op) {
+    case FILTER_LESS:
+        if (value == 0) empty = true;
+        else if (value - 1 < high) high = value - 1;
+        break;
+    case FILTER_LESS_EQUAL:
+        if (value < high) high = value;
+        break;
+    case FILTER_GREATER:
+        if (value == UINT64_MAX) empty = true;
+        else if (value + 1 > low) low = value + 1;
+        break;
+    case FILTER_GREATER_EQUAL:
+        if (value > low) low = value;
+        break;
+    case FILTER_EQUAL:
+        if (value > low) low = value;
+        if (value < high) high = value;
+        break;
+    }
+    if (low > high) empty = true;
+}
+
+ProcessFilter::ProcessFilter() {
+    Clear();
+}
+
+void ProcessFilter::Clear() {
+    m_active = false;
+    m_narrowed = false;
+    m_empty = false;
+    for (int field = 0; field < FILTER_FIELD_COUNT; field++) {
+        m_low[field] = 0;
+        m_high[field] = UINT64_MAX;
+    }
+    m_names.clear();
+    m_verdicts.clear();
+    m_nameTests = 0;
+}
+
+bool ProcessFilter::ParseTerm(const wchar_t* term, size_t length) {
+    const wchar_t* end = term + length;
+    const wchar_t* op = term;
+    while (op < end && *op != L'<' && *op != L'>' && *op != L'=' && *op != L':') op++;
+
+    NameTerm name;
+    name.glob = false;
+    const wchar_t* nameText = term;
+    if (op < end) {
+        // field, comparison, value
+        int field;
+        if (TextIs(term, op, L"name")) field = -1;
+        else if (TextIs(term, op, L"mem") || TextIs(term, op, L"memory") || TextIs(term, op, L"ws")) field = FILTER_FIELD_MEMORY;
+        else if (TextIs(term, op, L"cpu")) field = FILTER_FIELD_CPU;
+        else if (TextIs(term, op, L"threads") || TextIs(term, op, L"thr")) field = FILTER_FIELD_THREADS;
+        else if (TextIs(term, op, L"pid")) field = FILTER_FIELD_PID;
+        else return false;
+
+        FilterOperator comparison;
+        const wchar_t* p = op + 1;
+        bool orEqual = p < end && *p == L'=';
+        switch (*op) {
+        case L'<': comparison = orEqual ? FILTER_LESS_EQUAL : FILTER_LESS; break;
+        case L'>': comparison = orEqual ? FILTER_GREATER_EQUAL : FILTER_GREATER; break;
+        default:   comparison = FILTER_EQUAL; break;
+        }
+        if (orEqual) p++;
+
+        if (field < 0) {
+            if (comparison != FILTER_EQUAL || p == end) return false;
+            nameText = p;
+        } else {
+            uint64_t whole, fraction, scale, value;
+            if (!ParseNumber(p, end, whole, fraction, scale)) return false;
+            if (field == FILTER_FIELD_MEMORY) {
+                uint64_t unit;
+                if (p == end || TextIs(p, end, L"m") || TextIs(p, end, L"mb")) unit = 1ULL << 20;
+                else if (TextIs(p, end, L"b")) unit = 1;
+                else if (TextIs(p, end, L"k") || TextIs(p, end, L"kb")) unit = 1ULL << 10;
+                else if (TextIs(p, end, L"g") || TextIs(p, end, L"gb")) unit = 1ULL << 30;
+                else if (TextIs(p, end, L"t") || TextIs(p, end, L"tb")) unit = 1ULL << 40;
+                else return false;
+                if (whole > UINT64_MAX / unit / 2) return false;
+                value = whole * unit + fraction * unit / scale;
+            } else if (field == FILTER_FIELD_CPU) {
+                if (p != end && !TextIs(p, end, L"%")) return false;
+                value = whole * 100 + fraction * 100 / scale;     // hundredths of a percent
+            } else {
+                if (p != end || scale != 1) return false;
+                value = whole;
+            }
+            Constrain(m_low[field], m_high[field], comparison, value, m_empty);
+            return true;
+        }
+    }
+
+    for (const wchar_t* p = nameText; p < end; p++) {
+        wchar_t c = FoldChar(*p);
+        if (c == L'*' || c == L'?') name.glob = true;
+        name.text.push_back(c);
+    }
+    m_names.push_back(name);
+    return true;
+}
+
+bool ProcessFilter::SetQuery(const wchar_t* text, size_t* errorOffset) {
+    ProcessFilter next;
+    next.m_active = false;
+    for (const wchar_t* p = text ? text : L""; *p; ) {
+        while (*p && iswspace((wint_t)*p)) p++;
+        const wchar_t* start = p;
+        while (*p && !iswspace((wint_t)*p)) p++;
+        if (p == start) break;
+        if (!next.ParseTerm(start, (size_t)(p - start))) {
+            if (errorOffset) *errorOffset = (size_t)(start - text);
+            return false;
+        }
+        next.m_active = true;
+    }
+
+    // Verdicts carry over: all of them for the same name terms, the rejections for narrower ones
+    bool sameNames = next.m_names.size() == m_names.size();
+    for (size_t i = 0; sameNames && i < m_names.size(); i++) {
+        sameNames = next.m_names[i].text == m_names[i].text;
+    }
+    m_narrowed = m_active && next.m_active && next.IsNarrowerThan(*this);
+    if (!sameNames) {
+        for (uint8_t& verdict : m_verdicts) {
+            if (!m_narrowed || verdict == 2) verdict = 0;
+        }
+    }
+
+    m_active = next.m_active;
+    m_empty = next.m_empty;
+    for (int field = 0; field < FILTER_FIELD_COUNT; field++) {
+        m_low[field] = next.m_low[field];
+        m_high[field] = next.m_high[field];
+    }
+    m_names.swap(next.m_names);
+    m_nameTests = 0;
+    return true;
+}
+
+bool ProcessFilter::IsNarrowerThan(const ProcessFilter& other) const {
+    if (!other.m_active || m_empty) return true;
+    if (!m_active || other.m_empty) return false;
+    for (int field = 0; field < FILTER_FIELD_COUNT; field++) {
+        if (m_low[field] < other.m_low[field] || m_high[field] > other.m_high[field]) return false;
+    }
+
+    // Each of the other's name terms is implied by one of ours
+    for (const NameTerm& wider : other.m_names) {
+        bool implied = false;
+        for (const NameTerm& term : m_names) {
+            if (term.glob == wider.glob &&
+                (term.text == wider.text || (!term.glob && term.text.find(wider.text) != std::wstring::npos))) {
+                implied = true;
+                break;
+            }
+        }
+        if (!implied) return false;
+    }
+    return true;
+}
+
+bool ProcessFilter::TestName(NameId id) const {
+    const wchar_t* text = GetName(id);
+    size_t length = GetNameLength(id);
+    for (const NameTerm& term : m_names) {
+        if (!(term.glob ? GlobMatches(text, length, term.text) : Contains(text, length, term.text))) return false;
+    }
+    return true;
+}
+
+// Each name is searched once per query; rows then look the verdict up
+uint8_t ProcessFilter::Verdict(NameId id) {
+    uint8_t verdict = m_verdicts[id];
+    if (verdict == 0) {
+        verdict = m_verdicts[id] = TestName(id) ? 2 : 1;
+        m_nameTests++;
+    }
+    return verdict;
+}
+
+// Room for a verdict on every name interned so far
+void ProcessFilter::ReserveVerdicts() {
+    size_t names = GetInternedNameCount() + 1;
+    if (m_verdicts.size() < names) m_verdicts.resize(names, m_names.empty() ? 2 : 0);
+}
+
+bool ProcessFilter::NameMatches(NameId id) {
+    if (m_names.empty()) return true;
+    if (id >= m_verdicts.size()) ReserveVerdicts();
+    return Verdict(id) == 2;
+}
+
+// value in [low, high] as one unsigned compare per field
+bool ProcessFilter::InRange(const ProcessInfo& info) const {
+    const uint64_t values[FILTER_FIELD_COUNT] = { info.workingSetSize, info.cpuUsage, info.threadCount, info.processId };
+    bool inside = true;
+    for (int field = 0; field < FILTER_FIELD_COUNT; field++) {
+        inside &= values[field] - m_low[field] <= m_high[field] - m_low[field];
+    }
+    return inside;
+}
+
+bool ProcessFilter::Matches(const ProcessInfo& info) {
+    if (!m_active) return true;
+    return !m_empty && InRange(info) && NameMatches(info.nameId);
+}
+
+// The row loops test ranges and look verdicts up without branching on either,
+// since at a few percent selectivity a branch per row mispredicts constantly
+void ProcessFilter::Apply(const std::vector<ProcessInfo>& processes, std::vector<uint32_t>& rows) {
+    size_t count = processes.size();
+    rows.resize(count);
+    size_t kept = 0;
+    if (!m_empty) {
+        ReserveVerdicts();
+        for (size_t i = 0; i < count; i++) {
+            const ProcessInfo& info = processes[i];
+            rows[kept] = (uint32_t)i;
+            kept += InRange(info) & (Verdict(info.nameId) == 2);
+        }
+    }
+    rows.resize(kept);
+}
+
+void ProcessFilter::Refine(const std::vector<ProcessInfo>& processes, std::vector<uint32_t>& rows) {
+    size_t kept = 0;
+    if (!m_empty) {
+        ReserveVerdicts();
+        for (uint32_t row : rows) {
+            if (row >= processes.size()) continue;
+            const ProcessInfo& info = processes[row];
+            rows[kept] = row;
+            kept += InRange(info) & (Verdict(info.nameId) == 2);
+        }
+    }
+    rows.resize(kept);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "minux_types.h"
+
+// Minux Process Filter
+// Query behind the process list's filter box. A query is a list of terms
+// separated by spaces, and a process must satisfy all of them:
+//
+//   chrome         name contains "chrome", ignoring case
+//   svc*.exe       name matches the pattern as a whole (* and ?)
+//   mem>200MB      working set; B, KB, MB (the default), GB or TB
+//   cpu>=5         CPU percent, decimals allowed
+//   threads<10     thread count
+//   pid=1234       process ID
+//
+// Comparisons are < <= > >= and = (or :). The comparisons on one field
+// fold into a single range, so testing a row is one subtract-and-compare
+// per field. Name terms are decided once per interned name, not per row:
+// the verdict is cached by NameId, and the substring search behind it
+// scans 128 bits of text at a time for the term's first and last
+// characters. A query that only narrows the previous one (another letter
+// typed, another predicate added) re-tests the previous matches only.
+
+// Numeric fields a query can constrain
+enum ProcessFilterField {
+    FILTER_FIELD_MEMORY,
+    FILTER_FIELD_CPU,
+    FILTER_FIELD_THREADS,
+    FILTER_FIELD_PID,
+    FILTER_FIELD_COUNT
+};
+
+class ProcessFilter {
+public:
+    ProcessFilter();
+
+    // Parse a query. On error the filter is left as it was and errorOffset
+    // (if given) is the index of the term that could not be read.
+    bool SetQuery(const wchar_t* text, size_t* errorOffset = NULL);
+    void Clear();
+
+    bool IsActive() const { return m_active; }
+
+    // True if every process this filter accepts is also accepted by 'other'
+    bool IsNarrowerThan(const ProcessFilter& other) const;
+
+    // The last SetQuery narrowed an active query, so Refine can stand in for Apply
+    bool LastQueryNarrowed() const { return m_narrowed; }
+
+    bool Matches(const ProcessInfo& info);
+
+    // rows = indices of the matching records, in snapshot order
+    void Apply(const std::vector<ProcessInfo>& processes, std::vector<uint32_t>& rows);
+
+    // Keep only the listed rows that still match, e.g. after a narrowing SetQuery on the same snapshot
+    void Refine(const std::vector<ProcessInfo>& processes, std::vector<uint32_t>& rows);
+
+    size_t GetNameTestCount() const { return m_nameTests; }     // names searched since the query was set
+
+private:
+    struct NameTerm {
+        std::wstring text;      // lower case
+        bool glob;
+    };
+
+    bool ParseTerm(const wchar_t* term, size_t length);
+    bool TestName(NameId id) const;
+    uint8_t Verdict(NameId id);
+    void ReserveVerdicts();
+    bool NameMatches(NameId id);
+    bool InRange(const ProcessInfo& info) const;
+
+    bool m_active;
+    bool m_narrowed;
+    bool m_empty;                           // a field's range is empty: nothing matches
+    uint64_t m_low[FILTER_FIELD_COUNT];
+    uint64_t m_high[FILTER_FIELD_COUNT];
+    std::vector<NameTerm> m_names;
+    std::vector<uint8_t> m_verdicts;        // by NameId: 0 unknown, 1 no, 2 yes
+    size_t m_nameTests;
+};
+
+// Substring search kernels: SSE2 on x86, scalar elsewhere or when turned off (bench)
+bool IsFilterSimdAvailable();
+void SetFilterSimd(bool enabled);
+bool IsFilterSimdEnabled();
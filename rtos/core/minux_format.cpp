@@ -0,0 +1,108 @@
+#include "minux_format.h"
+
+static const char kDigitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint64_t kPowersOfTen[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL
+};
+
+// Digits of 'value', at least 'minDigits' of them, ending just before 'end'; returns the first
+static wchar_t* WriteDigitsBackward(uint64_t value, int minDigits, wchar_t* end) {
+    wchar_t* p = end;
+    while (value >= 100) {
+        const char* pair = kDigitPairs + (value % 100) * 2;
+        value /= 100;
+        *--p = (wchar_t)pair[1];
+        *--p = (wchar_t)pair[0];
+    }
+    if (value >= 10) {
+        const char* pair = kDigitPairs + value * 2;
+        *--p = (wchar_t)pair[1];
+        *--p = (wchar_t)pair[0];
+    } else {
+        *--p = (wchar_t)(L'0' + value);
+    }
+    while (end - p < minDigits) *--p = L'0';
+    return p;
+}
+
+static size_t CopyBack(const wchar_t* first, const wchar_t* end, wchar_t* out) {
+    size_t length = (size_t)(end - first);
+    for (size_t i = 0; i < length; i++) out[i] = first[i];
+    out[length] = L'\0';
+    return length;
+}
+
+static size_t AppendText(wchar_t* out, size_t length, const wchar_t* text) {
+    while (*text) out[length++] = *text++;
+    out[length] = L'\0';
+    return length;
+}
+
+size_t FormatUnsigned(uint64_t value, wchar_t* out) {
+    wchar_t buffer[FORMAT_MAX_TEXT];
+    wchar_t* end = buffer + FORMAT_MAX_TEXT;
+    return CopyBack(WriteDigitsBackward(value, 1, end), end, out);
+}
+
+size_t FormatFixed(uint64_t value, int decimals, wchar_t* out) {
+    if (decimals <= 0) return FormatUnsigned(value, out);
+    if (decimals > 9) decimals = 9;
+
+    wchar_t buffer[FORMAT_MAX_TEXT];
+    wchar_t* end = buffer + FORMAT_MAX_TEXT;
+    uint64_t power = kPowersOfTen[decimals];
+    wchar_t* p = WriteDigitsBackward(value % power, decimals, end);
+    *--p = L'.';
+    p = WriteDigitsBackward(value / power, 1, p);
+    return CopyBack(p, end, out);
+}
+
+// value / divisor in units of 10^-decimals, ties to even
+static uint64_t RoundScaled(uint64_t value, uint64_t divisor, int decimals) {
+    uint64_t scaled = value * kPowersOfTen[decimals];
+    uint64_t quotient = scaled / divisor, remainder = scaled % divisor;
+    if (remainder > divisor - remainder || (remainder == divisor - remainder && (quotient & 1))) quotient++;
+    return quotient;
+}
+
+size_t FormatScaled(uint64_t value, uint64_t divisor, int decimals, wchar_t* out) {
+    if (divisor == 0) divisor = 1;
+    if (decimals < 0) decimals = 0;
+    if (decimals > 9) decimals = 9;
+    return FormatFixed(RoundScaled(value, divisor, decimals), decimals, out);
+}
+
+// A unit is used only while its rounded value stays below 1024 of it,
+// so 1048575 bytes is "1.0 MB" rather than "1024 KB"
+static bool RoundsBelowNextUnit(uint64_t bytes, uint64_t unit, int decimals) {
+    return RoundScaled(bytes, unit, decimals) < 1024 * kPowersOfTen[decimals];
+}
+
+size_t FormatByteSize(uint64_t bytes, wchar_t* out) {
+    if (bytes < (1ULL << 10)) return AppendText(out, FormatUnsigned(bytes, out), L" B");
+    if (bytes < (1ULL << 20) && RoundsBelowNextUnit(bytes, 1ULL << 10, 0)) {
+        return AppendText(out, FormatScaled(bytes, 1ULL << 10, 0, out), L" KB");
+    }
+    if (bytes < (1ULL << 30) && RoundsBelowNextUnit(bytes, 1ULL << 20, 1)) {
+        return AppendText(out, FormatScaled(bytes, 1ULL << 20, 1, out), L" MB");
+    }
+    if (bytes < (1ULL << 40) && RoundsBelowNextUnit(bytes, 1ULL << 30, 2)) {
+        return AppendText(out, FormatScaled(bytes, 1ULL << 30, 2, out), L" GB");
+    }
+    // Drop the low bits first so bytes * 100 cannot overflow
+    return AppendText(out, FormatScaled(bytes >> 10, 1ULL << 30, 2, out), L" TB");
+}
+
+size_t FormatMegabytes(uint64_t bytes, wchar_t* out) {
+    return FormatScaled(bytes, 1ULL << 20, 1, out);
+}
+
+size_t FormatHundredths(uint64_t hundredths, wchar_t* out) {
+    return FormatFixed(hundredths, 2, out);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Minux Number Formatting
+// Table-driven integer and fixed-point conversion straight to UTF-16 for the
+// list cells and status text that are rebuilt on every refresh. Output is
+// what swprintf produces for the same value ("%u", "%.1f" of bytes / 2^20,
+// "%.2f" of hundredths) at a fraction of the cost: digits come two at a
+// time from a 200-entry table and no locale or format string is parsed.
+//
+// FormatCell keeps one cell's text with the value it was made from, so a
+// refresh re-formats only the cells whose value actually moved.
+//
+// All functions write a terminated string and return its length.
+
+#define FORMAT_MAX_TEXT 24      // longest output of any formatter here, terminator included
+
+size_t FormatUnsigned(uint64_t value, wchar_t* out);
+
+// 'value' counts units of 10^-decimals: (1234, 2) -> "12.34"; decimals 0..9
+size_t FormatFixed(uint64_t value, int decimals, wchar_t* out);
+
+// value / divisor to 'decimals' places, rounded like printf (ties to even).
+// value * 10^decimals must fit in 64 bits.
+size_t FormatScaled(uint64_t value, uint64_t divisor, int decimals, wchar_t* out);
+
+// Byte counts with a unit: "980 B", "512 KB", "12.3 MB", "1.25 GB", "2.50 TB"
+// A value that rounds to 1024 of a unit takes the next one: 1048575 -> "1.0 MB"
+size_t FormatByteSize(uint64_t bytes, wchar_t* out);
+
+// Column formatters for the process list
+size_t FormatMegabytes(uint64_t bytes, wchar_t* out);          // "%.1f" of bytes / 2^20
+size_t FormatHundredths(uint64_t hundredths, wchar_t* out);    // "%.2f" of hundredths / 100
+
+typedef size_t (*FormatFunction)(uint64_t value, wchar_t* out);
+
+// One cached cell; zero-initialize, then always read it through FormatCellText
+// with the same formatter
+struct FormatCell {
+    uint64_t value;
+    uint8_t length;
+    bool valid;
+    wchar_t text[FORMAT_MAX_TEXT];
+};
+
+// The cell's text for 'value', re-formatted only when the value differs from the cached one
+inline const wchar_t* FormatCellText(FormatCell& cell, uint64_t value, FormatFunction format) {
+    if (!cell.valid || cell.value != value) {
+        cell.length = (uint8_t)format(value, cell.text);
+        cell.value = value;
+        cell.valid = true;
+    }
+    return cell.text;
+}
@@ -0,0 +1,451 @@
+#include "minux_history.h"
+#include <cmath>
+#include <cstring>
+#include <cwchar>
+#include <limits>
+
+const HistoryTierConfig g_historyTiers[HISTORY_TIER_COUNT] = {
+    { 1000, 900 },      // 15 minutes
+    { 10000, 2160 },    // 6 hours
+    { 60000, 10080 }    // 7 days
+};
+
+// Processes considered for a slot each sample: the busiest by CPU and by memory
+#define HISTORY_TOP_PROCESSES (HISTORY_PROCESS_SLOTS / 2)
+
+// Process samples a slot is kept after its owner leaves the top lists, so the
+// history of a briefly idle process is not recycled on the next tick
+#define HISTORY_PROCESS_GRACE 60
+
+// Open-addressing PID index over the process slots; a power of two, half full at most
+#define HISTORY_PROCESS_INDEX_SIZE (HISTORY_PROCESS_SLOTS * 2)
+
+static inline uint32_t HashProcessId(uint32_t processId) {
+    return (processId * 2654435761u) >> 24;
+}
+
+static const float kNoData = std::numeric_limits<float>::quiet_NaN();
+
+// Keep the indices of the 'limit' largest values in 'top' (descending), without allocating
+template <typename Value>
+static void InsertTop(uint32_t* top, Value* topValues, int& count, int limit, uint32_t index, Value value) {
+    if (count == limit && value <= topValues[count - 1]) return;
+    int position = count < limit ? count++ : limit - 1;
+    while (position > 0 && topValues[position - 1] < value) {
+        top[position] = top[position - 1];
+        topValues[position] = topValues[position - 1];
+        position--;
+    }
+    top[position] = index;
+    topValues[position] = value;
+}
+
+HistoryStore::HistoryStore() {
+    for (int tier = 0; tier < HISTORY_TIER_COUNT; tier++) {
+        TierState& state = m_tiers[tier];
+        uint32_t capacity = g_historyTiers[tier].capacity;
+        state.times.assign(capacity, 0);
+        state.values.assign((size_t)capacity * HISTORY_SERIES_COUNT, kNoData);
+        state.accumulators.resize(HISTORY_SERIES_COUNT);
+    }
+
+    uint32_t archivePoints = g_historyTiers[HISTORY_TIER_1MIN].capacity;
+    m_archive.resize(HISTORY_ARCHIVE_BYTES);
+    m_archiveTimes.resize(archivePoints);
+    m_archiveFloats.resize(archivePoints);
+    m_archiveValues.resize(archivePoints);
+    m_archiveBlock.reserve(GetMaxEncodedSize(archivePoints));
+    Clear();
+}
+
+void HistoryStore::Clear() {
+    for (TierState& state : m_tiers) {
+        state.head = 0;
+        state.count = 0;
+        state.openBucket = 0;
+        memset(state.accumulators.data(), 0, state.accumulators.size() * sizeof(Accumulator));
+    }
+    memset(m_interfaces, 0, sizeof(m_interfaces));
+    memset(m_processes, 0, sizeof(m_processes));
+    memset(m_processIndex, -1, sizeof(m_processIndex));
+    memset(m_archiveRecords, 0, sizeof(m_archiveRecords));
+    m_archiveHead = 0;
+    m_archiveNextRecord = 0;
+    m_interfaceSamples = 0;
+    m_processSamples = 0;
+    m_lastTimestamp = 0;
+}
+
+// Open a new bucket in every tier whose interval boundary was crossed. Buckets
+// skipped without a sample (slow cadence, sleep) stay in the ring as gaps, so
+// every tier keeps its fixed interval and spans interval * capacity.
+void HistoryStore::AdvanceTiers(uint64_t timestamp) {
+    for (int tier = 0; tier < HISTORY_TIER_COUNT; tier++) {
+        TierState& state = m_tiers[tier];
+        uint64_t interval = g_historyTiers[tier].intervalMs;
+        uint32_t capacity = g_historyTiers[tier].capacity;
+        uint64_t bucket = timestamp - timestamp % interval;
+        if (state.count != 0 && bucket == state.openBucket) continue;
+
+        if (state.count == 0) {
+            state.head = 0;
+            state.count = 1;
+        } else {
+            uint64_t steps = (bucket - state.openBucket) / interval;
+            if (steps > capacity) steps = capacity;
+            for (uint64_t step = 1; step <= steps; step++) {
+                state.head = (state.head + 1) % capacity;
+                if (state.count < capacity) state.count++;
+                if (step == steps) break;
+                state.times[state.head] = bucket - (steps - step) * interval;
+                for (int series = 0; series < HISTORY_SERIES_COUNT; series++) {
+                    state.values[(size_t)series * capacity + state.head] = kNoData;
+                }
+            }
+        }
+        state.times[state.head] = bucket;
+        state.openBucket = bucket;
+        memset(state.accumulators.data(), 0, state.accumulators.size() * sizeof(Accumulator));
+    }
+}
+
+void HistoryStore::Append(const MinuxSnapshot& snapshot, int parts) {
+    uint64_t timestamp = snapshot.timestamp;
+    if (timestamp < m_lastTimestamp) timestamp = m_lastTimestamp;     // clock stepped back
+    AdvanceTiers(timestamp);
+
+    for (int series = 0; series < HISTORY_SERIES_COUNT; series++) m_sample[series] = kNoData;
+
+    if (parts & HISTORY_SAMPLE_SYSTEM) {
+        m_sample[HistorySystemSeries(HISTORY_SYSTEM_CPU)] = (float)snapshot.system.cpuUsage;
+        m_sample[HistorySystemSeries(HISTORY_SYSTEM_MEMORY)] = (float)snapshot.system.memoryUsage;
+        m_sample[HistorySystemSeries(HISTORY_SYSTEM_PROCESSES)] = (float)snapshot.system.processCount;
+    }
+    m_lastTimestamp = timestamp;
+    if (parts & HISTORY_SAMPLE_INTERFACES) {
+        m_interfaceSamples++;
+        SampleInterfaces(snapshot);
+    }
+    if (parts & HISTORY_SAMPLE_PROCESSES) {
+        m_processSamples++;
+        SampleProcesses(snapshot);
+    }
+
+    // Average the sample into the open bucket of every tier
+    for (TierState& state : m_tiers) {
+        size_t capacity = state.times.size();
+        for (int series = 0; series < HISTORY_SERIES_COUNT; series++) {
+            Accumulator& accumulator = state.accumulators[series];
+            float value = m_sample[series];
+            if (!std::isnan(value)) {
+                accumulator.sum += value;
+                accumulator.count++;
+            }
+            state.values[series * capacity + state.head] =
+                accumulator.count ? (float)(accumulator.sum / accumulator.count) : kNoData;
+        }
+    }
+}
+
+// Interfaces carry their rates from when the counters were read; none on a first reading
+void HistoryStore::SampleInterfaces(const MinuxSnapshot& snapshot) {
+    for (const NetworkInfo& info : snapshot.interfaces) {
+        int slot = FindInterfaceSlot(info.adapterName);
+        if (slot < 0) slot = BindInterface(info.adapterName, m_lastTimestamp);
+        if (slot < 0) continue;
+
+        if (info.rateIntervalMs != 0) {
+            m_sample[HistoryInterfaceSeries(slot, HISTORY_INTERFACE_RX_BYTES)] = (float)info.bytesReceivedPerSecond;
+            m_sample[HistoryInterfaceSeries(slot, HISTORY_INTERFACE_TX_BYTES)] = (float)info.bytesSentPerSecond;
+            m_sample[HistoryInterfaceSeries(slot, HISTORY_INTERFACE_RX_PACKETS)] = (float)info.packetsReceivedPerSecond;
+            m_sample[HistoryInterfaceSeries(slot, HISTORY_INTERFACE_TX_PACKETS)] = (float)info.packetsSentPerSecond;
+        }
+        m_interfaces[slot].lastUsed = m_interfaceSamples;
+    }
+}
+
+// Slots go to the busiest processes by CPU and by working set, plus pinned ones
+void HistoryStore::SampleProcesses(const MinuxSnapshot& snapshot) {
+    const std::vector<ProcessInfo>& processes = snapshot.processes;
+
+    uint32_t topCpu[HISTORY_TOP_PROCESSES], topMemory[HISTORY_TOP_PROCESSES];
+    uint32_t topCpuValues[HISTORY_TOP_PROCESSES];
+    uint64_t topMemoryValues[HISTORY_TOP_PROCESSES];
+    int cpuCount = 0, memoryCount = 0;
+    for (uint32_t i = 0; i < (uint32_t)processes.size(); i++) {
+        InsertTop(topCpu, topCpuValues, cpuCount, HISTORY_TOP_PROCESSES, i, processes[i].cpuUsage);
+        InsertTop(topMemory, topMemoryValues, memoryCount, HISTORY_TOP_PROCESSES, i, processes[i].workingSetSize);
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        const uint32_t* top = pass == 0 ? topCpu : topMemory;
+        int count = pass == 0 ? cpuCount : memoryCount;
+        for (int i = 0; i < count; i++) {
+            ProcessKey key = MakeProcessKey(processes[top[i]]);
+            int slot = FindProcessSlot(key);
+            if (slot < 0) slot = BindProcess(key, m_lastTimestamp);
+            if (slot >= 0) m_processes[slot].lastUsed = m_processSamples;
+        }
+    }
+
+    // Record every tracked process that is present, candidate or not
+    for (const ProcessInfo& info : processes) {
+        uint32_t bucket = HashProcessId(info.processId) % HISTORY_PROCESS_INDEX_SIZE;
+        for (int slot; (slot = m_processIndex[bucket]) >= 0; bucket = (bucket + 1) % HISTORY_PROCESS_INDEX_SIZE) {
+            const ProcessSlot& state = m_processes[slot];
+            if (state.key.processId != info.processId) continue;
+            if (state.key.creationTime == info.creationTime) {
+                m_sample[HistoryProcessSeries(slot, HISTORY_PROCESS_CPU)] = info.cpuUsage / 100.0f;
+                m_sample[HistoryProcessSeries(slot, HISTORY_PROCESS_WORKINGSET)] = (float)info.workingSetSize;
+            }
+            break;
+        }
+    }
+}
+
+void HistoryStore::RebuildProcessIndex() {
+    memset(m_processIndex, -1, sizeof(m_processIndex));
+    for (int slot = 0; slot < HISTORY_PROCESS_SLOTS; slot++) {
+        if (!m_processes[slot].bound) continue;
+        uint32_t bucket = HashProcessId(m_processes[slot].key.processId) % HISTORY_PROCESS_INDEX_SIZE;
+        while (m_processIndex[bucket] >= 0) bucket = (bucket + 1) % HISTORY_PROCESS_INDEX_SIZE;
+        m_processIndex[bucket] = (int8_t)slot;
+    }
+}
+
+// Clear the open-bucket accumulators of a recycled slot
+void HistoryStore::ResetSlotSeries(int firstSeries, int seriesCount) {
+    for (TierState& state : m_tiers) {
+        memset(&state.accumulators[firstSeries], 0, seriesCount * sizeof(Accumulator));
+    }
+}
+
+int HistoryStore::BindInterface(const wchar_t* adapterName, uint64_t timestamp) {
+    int victim = -1;
+    for (int slot = 0; slot < HISTORY_INTERFACE_SLOTS; slot++) {
+        const InterfaceSlot& state = m_interfaces[slot];
+        if (!state.bound) {
+            victim = slot;
+            break;
+        }
+        if (state.lastUsed < m_interfaceSamples && (victim < 0 || state.lastUsed < m_interfaces[victim].lastUsed)) {
+            victim = slot;
+        }
+    }
+    if (victim < 0) return -1;
+
+    InterfaceSlot& state = m_interfaces[victim];
+    memset(&state, 0, sizeof(state));
+    state.bound = true;
+    size_t length = 0;
+    while (length < 255 && adapterName[length]) length++;
+    memcpy(state.adapterName, adapterName, length * sizeof(wchar_t));     // terminated by the memset
+    state.boundSince = timestamp;
+    ResetSlotSeries(HistoryInterfaceSeries(victim, 0), HISTORY_INTERFACE_FIELD_COUNT);
+    return victim;
+}
+
+int HistoryStore::BindProcess(const ProcessKey& key, uint64_t timestamp) {
+    int victim = -1;
+    for (int slot = 0; slot < HISTORY_PROCESS_SLOTS; slot++) {
+        const ProcessSlot& state = m_processes[slot];
+        if (!state.bound) {
+            victim = slot;
+            break;
+        }
+        if (!state.pinned && state.lastUsed + HISTORY_PROCESS_GRACE < m_processSamples &&
+            (victim < 0 || state.lastUsed < m_processes[victim].lastUsed)) {
+            victim = slot;
+        }
+    }
+    if (victim < 0) return -1;
+    if (m_processes[victim].bound) ArchiveProcessSlot(victim);
+
+    ProcessSlot& state = m_processes[victim];
+    state.bound = true;
+    state.pinned = false;
+    state.key = key;
+    state.boundSince = timestamp;
+    state.lastUsed = m_processSamples;
+    ResetSlotSeries(HistoryProcessSeries(victim, 0), HISTORY_PROCESS_FIELD_COUNT);
+    RebuildProcessIndex();
+    return victim;
+}
+
+// Seal the 1-minute series of a slot's current owner into the archive
+void HistoryStore::ArchiveProcessSlot(int slot) {
+    uint32_t sizes[HISTORY_PROCESS_FIELD_COUNT];
+    uint32_t total = 0;
+    uint32_t offset = m_archiveHead;
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int field = 0; field < HISTORY_PROCESS_FIELD_COUNT; field++) {
+            size_t copied = CopySeries(HISTORY_TIER_1MIN, HistoryProcessSeries(slot, field), 0,
+                                       m_archiveTimes.data(), m_archiveFloats.data(), m_archiveTimes.size());
+
+            // Back to integers, dropping gaps; CPU keeps hundredths of a percent
+            size_t count = 0;
+            for (size_t i = 0; i < copied; i++) {
+                float value = m_archiveFloats[i];
+                if (std::isnan(value)) continue;
+                m_archiveTimes[count] = m_archiveTimes[i];
+                m_archiveValues[count] = field == HISTORY_PROCESS_CPU ? (int64_t)std::lround(value * 100.0f) : (int64_t)value;
+                count++;
+            }
+            if (count == 0) return;     // nothing worth keeping
+            EncodeIntegerBlock(m_archiveTimes.data(), m_archiveValues.data(), count, m_archiveBlock);
+
+            // First pass measures, second pass writes
+            if (pass == 0) {
+                sizes[field] = (uint32_t)m_archiveBlock.size();
+                total += sizes[field];
+            } else {
+                memcpy(&m_archive[offset], m_archiveBlock.data(), m_archiveBlock.size());
+                offset += (uint32_t)m_archiveBlock.size();
+            }
+        }
+
+        if (pass == 0) {
+            if (total > m_archive.size()) return;
+            if (m_archiveHead + total > m_archive.size()) m_archiveHead = 0;
+            offset = m_archiveHead;
+
+            // Overwrite the records in the way
+            for (ArchiveRecord& record : m_archiveRecords) {
+                if (!record.valid) continue;
+                uint32_t recordEnd = record.offset;
+                for (int field = 0; field < HISTORY_PROCESS_FIELD_COUNT; field++) recordEnd += record.sizes[field];
+                if (record.offset < m_archiveHead + total && recordEnd > m_archiveHead) record.valid = false;
+            }
+        }
+    }
+
+    ArchiveRecord& record = m_archiveRecords[m_archiveNextRecord];
+    m_archiveNextRecord = (m_archiveNextRecord + 1) % HISTORY_ARCHIVE_RECORDS;
+    record.valid = true;
+    record.key = m_processes[slot].key;
+    record.offset = m_archiveHead;
+    memcpy(record.sizes, sizes, sizeof(sizes));
+    m_archiveHead += total;
+}
+
+// Newest record first: a process recycled more than once keeps its latest stretch
+const HistoryStore::ArchiveRecord* HistoryStore::FindArchiveRecord(const ProcessKey& key) const {
+    for (uint32_t i = 1; i <= HISTORY_ARCHIVE_RECORDS; i++) {
+        const ArchiveRecord& record = m_archiveRecords[(m_archiveNextRecord + HISTORY_ARCHIVE_RECORDS - i) % HISTORY_ARCHIVE_RECORDS];
+        if (record.valid && record.key == key) return &record;
+    }
+    return NULL;
+}
+
+bool HistoryStore::FindArchivedProcess(const ProcessKey& key, int field, const uint8_t** block, size_t* size) const {
+    const ArchiveRecord* record = FindArchiveRecord(key);
+    if (!record) return false;
+
+    uint32_t offset = record->offset;
+    for (int i = 0; i < field; i++) offset += record->sizes[i];
+    *block = &m_archive[offset];
+    *size = record->sizes[field];
+    return true;
+}
+
+bool HistoryStore::AggregateArchivedProcess(const ProcessKey& key, int field, uint64_t from, uint64_t to, HistoryAggregate& aggregate) const {
+    const uint8_t* block;
+    size_t size;
+    if (!FindArchivedProcess(key, field, &block, &size)) return false;
+    return AggregateHistoryBlock(block, size, from, to, aggregate);
+}
+
+size_t HistoryStore::GetArchivedProcessCount() const {
+    size_t count = 0;
+    for (const ArchiveRecord& record : m_archiveRecords) {
+        if (record.valid) count++;
+    }
+    return count;
+}
+
+int HistoryStore::FindInterfaceSlot(const wchar_t* adapterName) const {
+    for (int slot = 0; slot < HISTORY_INTERFACE_SLOTS; slot++) {
+        if (m_interfaces[slot].bound && wcsncmp(m_interfaces[slot].adapterName, adapterName, 255) == 0) return slot;
+    }
+    return -1;
+}
+
+int HistoryStore::FindProcessSlot(const ProcessKey& key) const {
+    for (int slot = 0; slot < HISTORY_PROCESS_SLOTS; slot++) {
+        if (m_processes[slot].bound && m_processes[slot].key == key) return slot;
+    }
+    return -1;
+}
+
+int HistoryStore::PinProcess(const ProcessKey& key) {
+    int slot = FindProcessSlot(key);
+    if (slot < 0) slot = BindProcess(key, m_lastTimestamp);
+    if (slot >= 0) m_processes[slot].pinned = true;
+    return slot;
+}
+
+void HistoryStore::UnpinProcess(const ProcessKey& key) {
+    int slot = FindProcessSlot(key);
+    if (slot >= 0) m_processes[slot].pinned = false;
+}
+
+size_t HistoryStore::GetPointCount(int tier) const {
+    return m_tiers[tier].count;
+}
+
+// Oldest point is index 0
+uint64_t HistoryStore::GetTime(int tier, size_t point) const {
+    const TierState& state = m_tiers[tier];
+    size_t capacity = state.times.size();
+    return state.times[(state.head + capacity - state.count + 1 + point) % capacity];
+}
+
+float HistoryStore::GetValue(int tier, int series, size_t point) const {
+    const TierState& state = m_tiers[tier];
+    size_t capacity = state.times.size();
+    return state.values[series * capacity + (state.head + capacity - state.count + 1 + point) % capacity];
+}
+
+uint64_t HistoryStore::GetSeriesBoundSince(int series) const {
+    int first = HistoryInterfaceSeries(0, 0);
+    int processFirst = HistoryProcessSeries(0, 0);
+    if (series < first) return 0;
+    if (series < processFirst) return m_interfaces[(series - first) / HISTORY_INTERFACE_FIELD_COUNT].boundSince;
+    return m_processes[(series - processFirst) / HISTORY_PROCESS_FIELD_COUNT].boundSince;
+}
+
+size_t HistoryStore::CopySeries(int tier, int series, uint64_t since, uint64_t* times, float* values, size_t capacity) const {
+    const TierState& state = m_tiers[tier];
+    uint64_t interval = g_historyTiers[tier].intervalMs;
+    uint64_t boundSince = GetSeriesBoundSince(series);
+
+    // Walk back from the newest point so a short buffer gets the most recent data
+    size_t copied = 0;
+    for (size_t point = state.count; point > 0 && copied < capacity; point--) {
+        uint64_t time = GetTime(tier, point - 1);
+        if (time <= since || time + interval <= boundSince) break;
+        copied++;
+    }
+
+    size_t first = state.count - copied;
+    for (size_t i = 0; i < copied; i++) {
+        times[i] = GetTime(tier, first + i);
+        values[i] = GetValue(tier, series, first + i);
+    }
+    return copied;
+}
+
+size_t HistoryStore::GetMemoryBytes() const {
+    size_t bytes = sizeof(*this);
+    for (const TierState& state : m_tiers) {
+        bytes += state.times.capacity() * sizeof(uint64_t);
+        bytes += state.values.capacity() * sizeof(float);
+        bytes += state.accumulators.capacity() * sizeof(Accumulator);
+    }
+    bytes += m_archive.capacity() + m_archiveBlock.capacity();
+    bytes += m_archiveTimes.capacity() * sizeof(uint64_t);
+    bytes += m_archiveFloats.capacity() * sizeof(float);
+    bytes += m_archiveValues.capacity() * sizeof(int64_t);
+    return bytes;
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+#include "minux_snapshot.h"
+#include "minux_procdiff.h"
+#include "minux_codec.h"
+
+// Minux History Store
+// Fixed-memory time-series history of every snapshot. Each tier is a ring of
+// time buckets with one shared time column and one value column per series;
+// a sample is averaged into the open bucket of every tier, so coarser tiers
+// downsample themselves as they go. Buckets no sample fell into are kept as
+// NaN gaps, so a tier always spans its interval times its capacity, whatever
+// the sampling cadence. When a process slot is recycled, its
+// 1-minute series are sealed into compressed blocks in a fixed-size archive.
+// All memory is allocated up front: Append is O(1) in the history length and
+// never allocates.
+
+// Resolution tiers
+enum HistoryTier {
+    HISTORY_TIER_1S,            // 1 s buckets, 15 minutes
+    HISTORY_TIER_10S,           // 10 s buckets, 6 hours
+    HISTORY_TIER_1MIN,          // 1 min buckets, 7 days
+    HISTORY_TIER_COUNT
+};
+
+struct HistoryTierConfig {
+    uint32_t intervalMs;
+    uint32_t capacity;          // buckets kept
+};
+
+extern const HistoryTierConfig g_historyTiers[HISTORY_TIER_COUNT];
+
+// Series fields
+enum HistorySystemField {
+    HISTORY_SYSTEM_CPU,         // percent
+    HISTORY_SYSTEM_MEMORY,      // percent
+    HISTORY_SYSTEM_PROCESSES,
+    HISTORY_SYSTEM_FIELD_COUNT
+};
+
+enum HistoryInterfaceField {
+    HISTORY_INTERFACE_RX_BYTES,     // per second
+    HISTORY_INTERFACE_TX_BYTES,
+    HISTORY_INTERFACE_RX_PACKETS,
+    HISTORY_INTERFACE_TX_PACKETS,
+    HISTORY_INTERFACE_FIELD_COUNT
+};
+
+enum HistoryProcessField {
+    HISTORY_PROCESS_CPU,        // percent of all logical processors
+    HISTORY_PROCESS_WORKINGSET, // bytes
+    HISTORY_PROCESS_FIELD_COUNT
+};
+
+// Parts of a snapshot Append takes; the rest was carried over from an
+// earlier snapshot and is not averaged in again
+#define HISTORY_SAMPLE_SYSTEM       0x1
+#define HISTORY_SAMPLE_INTERFACES   0x2
+#define HISTORY_SAMPLE_PROCESSES    0x4
+#define HISTORY_SAMPLE_ALL          (HISTORY_SAMPLE_SYSTEM | HISTORY_SAMPLE_INTERFACES | HISTORY_SAMPLE_PROCESSES)
+
+// Tracked interfaces and processes; slots are recycled least-recently-used
+#define HISTORY_INTERFACE_SLOTS 8
+#define HISTORY_PROCESS_SLOTS   32
+
+// Compressed archive of recycled process slots; oldest records are overwritten
+#define HISTORY_ARCHIVE_BYTES   (1024 * 1024)
+#define HISTORY_ARCHIVE_RECORDS 4096
+
+#define HISTORY_SERIES_COUNT (HISTORY_SYSTEM_FIELD_COUNT + \
+                              HISTORY_INTERFACE_SLOTS * HISTORY_INTERFACE_FIELD_COUNT + \
+                              HISTORY_PROCESS_SLOTS * HISTORY_PROCESS_FIELD_COUNT)
+
+// Series index helpers
+inline int HistorySystemSeries(int field) {
+    return field;
+}
+
+inline int HistoryInterfaceSeries(int slot, int field) {
+    return HISTORY_SYSTEM_FIELD_COUNT + slot * HISTORY_INTERFACE_FIELD_COUNT + field;
+}
+
+inline int HistoryProcessSeries(int slot, int field) {
+    return HISTORY_SYSTEM_FIELD_COUNT + HISTORY_INTERFACE_SLOTS * HISTORY_INTERFACE_FIELD_COUNT +
+           slot * HISTORY_PROCESS_FIELD_COUNT + field;
+}
+
+class HistoryStore {
+public:
+    HistoryStore();
+
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    // Record one snapshot; timestamps should not go backwards. Only the
+    // HISTORY_SAMPLE_* parts in 'parts' are sampled, so a snapshot that
+    // refreshed just the system figures costs O(series), not O(processes).
+    void Append(const MinuxSnapshot& snapshot, int parts = HISTORY_SAMPLE_ALL);
+
+    // Drop all samples and slot bindings (memory stays allocated)
+    void Clear();
+
+    // Points in a tier, oldest first. The newest bucket may still be filling.
+    size_t GetPointCount(int tier) const;
+    uint64_t GetTime(int tier, size_t point) const;            // bucket start, ms since the Unix epoch
+    float GetValue(int tier, int series, size_t point) const;  // NaN where there is no data
+
+    // Copy points newer than 'since' into caller buffers, oldest first.
+    // Points from before a slot was bound to its current owner are skipped.
+    size_t CopySeries(int tier, int series, uint64_t since, uint64_t* times, float* values, size_t capacity) const;
+
+    // Slot lookup; -1 if the interface or process is not tracked
+    int FindInterfaceSlot(const wchar_t* adapterName) const;
+    int FindProcessSlot(const ProcessKey& key) const;
+
+    // Pinned processes keep their slot (e.g. the selected row); returns the slot or -1
+    int PinProcess(const ProcessKey& key);
+    void UnpinProcess(const ProcessKey& key);
+
+    // Archived processes: 1-minute CPU (hundredths of a percent) and working set (bytes)
+    bool FindArchivedProcess(const ProcessKey& key, int field, const uint8_t** block, size_t* size) const;
+    bool AggregateArchivedProcess(const ProcessKey& key, int field, uint64_t from, uint64_t to, HistoryAggregate& aggregate) const;
+    size_t GetArchivedProcessCount() const;
+
+    // Total bytes held by the store; constant after construction
+    size_t GetMemoryBytes() const;
+
+private:
+    struct Accumulator {
+        double sum;
+        uint32_t count;
+    };
+
+    struct TierState {
+        std::vector<uint64_t> times;            // capacity
+        std::vector<float> values;              // series-major: series * capacity + bucket
+        std::vector<Accumulator> accumulators;  // open bucket, one per series
+        uint32_t head;                          // ring index of the open bucket
+        uint32_t count;
+        uint64_t openBucket;
+    };
+
+    struct InterfaceSlot {
+        bool bound;
+        wchar_t adapterName[256];
+        uint64_t boundSince;        // ms; earlier points belong to a previous owner
+        uint64_t lastUsed;          // interface sample number, for LRU recycling
+    };
+
+    struct ArchiveRecord {
+        bool valid;
+        ProcessKey key;
+        uint32_t offset;                                // into m_archive
+        uint32_t sizes[HISTORY_PROCESS_FIELD_COUNT];    // blocks stored back to back
+    };
+
+    struct ProcessSlot {
+        bool bound;
+        bool pinned;
+        ProcessKey key;
+        uint64_t boundSince;
+        uint64_t lastUsed;          // process sample number
+    };
+
+    void AdvanceTiers(uint64_t timestamp);
+    void SampleInterfaces(const MinuxSnapshot& snapshot);
+    void SampleProcesses(const MinuxSnapshot& snapshot);
+    int BindInterface(const wchar_t* adapterName, uint64_t timestamp);
+    int BindProcess(const ProcessKey& key, uint64_t timestamp);
+    void ResetSlotSeries(int firstSeries, int seriesCount);
+    void RebuildProcessIndex();
+    void ArchiveProcessSlot(int slot);
+    const ArchiveRecord* FindArchiveRecord(const ProcessKey& key) const;
+    uint64_t GetSeriesBoundSince(int series) const;
+
+    TierState m_tiers[HISTORY_TIER_COUNT];
+    InterfaceSlot m_interfaces[HISTORY_INTERFACE_SLOTS];
+    ProcessSlot m_processes[HISTORY_PROCESS_SLOTS];
+    int8_t m_processIndex[HISTORY_PROCESS_SLOTS * 2];  // PID hash -> slot, -1 empty; rebuilt on bind
+    float m_sample[HISTORY_SERIES_COUNT];       // values of the sample being appended
+
+    std::vector<uint8_t> m_archive;
+    ArchiveRecord m_archiveRecords[HISTORY_ARCHIVE_RECORDS];
+    uint32_t m_archiveHead;                     // next byte offset to write
+    uint32_t m_archiveNextRecord;
+    std::vector<uint64_t> m_archiveTimes;       // scratch for sealing one series
+    std::vector<float> m_archiveFloats;
+    std::vector<int64_t> m_archiveValues;
+    std::vector<uint8_t> m_archiveBlock;
+    uint64_t m_interfaceSamples;                // appends that sampled each part
+    uint64_t m_processSamples;
+    uint64_t m_lastTimestamp;
+};
@@ -0,0 +1,159 @@
+#include "minux_lod.h"
+
+// Append to a ring that is still filling, never reserving past its final
+// size; plain push_back would double a 7-day ring to 2^20 slots
+template <typename T>
+static void GrowRing(std::vector<T>& ring, uint64_t slots, const T& value) {
+    if (ring.size() == ring.capacity()) {
+        uint64_t wanted = ring.capacity() ? ring.capacity() * 2 : 16;
+        ring.reserve((size_t)(wanted < slots ? wanted : slots));
+    }
+    ring.push_back(value);
+}
+
+LodSeries::LodSeries(uint32_t capacity) : m_capacity(capacity < 2 ? 2 : capacity), m_total(0) {
+    int levels = 1;
+    while ((1ULL << levels) < m_capacity) levels++;
+    m_levelCount = levels;
+    m_levels.resize(levels);
+}
+
+// Nodes a level keeps: enough to cover every retained sample, plus the one
+// straddling the oldest, whatever the capacity
+uint64_t LodSeries::GetLevelSlots(int level) const {
+    return (m_capacity >> level) + 1;
+}
+
+void LodSeries::Append(uint64_t time, float value) {
+    if (value != value) return;
+
+    uint64_t slot = m_total % m_capacity;
+    if (slot == m_values.size()) {
+        GrowRing(m_times, m_capacity, time);
+        GrowRing(m_values, m_capacity, value);
+    } else {
+        m_times[slot] = time;
+        m_values[slot] = value;
+    }
+    m_total++;
+
+    // Carry completed runs upward; half the appends stop at level 1, a quarter at level 2...
+    for (int level = 1; level <= m_levelCount; level++) {
+        if (m_total & ((1ULL << level) - 1)) break;
+        uint64_t index = (m_total >> level) - 1;
+        Node left = GetNode(level - 1, 2 * index);
+        Node right = GetNode(level - 1, 2 * index + 1);
+        Node parent;
+        parent.min = left.min < right.min ? left.min : right.min;
+        parent.max = left.max > right.max ? left.max : right.max;
+        parent.average = (left.average + right.average) * 0.5f;
+
+        std::vector<Node>& nodes = m_levels[level - 1];
+        uint64_t nodeSlot = index % GetLevelSlots(level);
+        if (nodeSlot == nodes.size()) GrowRing(nodes, GetLevelSlots(level), parent);
+        else nodes[nodeSlot] = parent;
+    }
+}
+
+void LodSeries::Clear() {
+    m_times.clear();
+    m_values.clear();
+    for (std::vector<Node>& nodes : m_levels) nodes.clear();
+    m_total = 0;
+}
+
+size_t LodSeries::GetSampleCount() const {
+    return m_values.size();
+}
+
+uint64_t LodSeries::GetFirstTime() const {
+    return m_total ? GetSampleTime(m_total - m_values.size()) : 0;
+}
+
+uint64_t LodSeries::GetLastTime() const {
+    return m_total ? GetSampleTime(m_total - 1) : 0;
+}
+
+LodSeries::Node LodSeries::GetNode(int level, uint64_t index) const {
+    if (level == 0) {
+        float value = m_values[index % m_capacity];
+        Node node = { value, value, value };
+        return node;
+    }
+    return m_levels[level - 1][index % GetLevelSlots(level)];
+}
+
+uint64_t LodSeries::GetSampleTime(uint64_t index) const {
+    return m_times[index % m_capacity];
+}
+
+// First retained sample at or after 'time' ('after': strictly after); m_total if none
+uint64_t LodSeries::FindSample(uint64_t time, bool after) const {
+    uint64_t low = m_total - m_values.size(), high = m_total;
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        uint64_t sampleTime = GetSampleTime(middle);
+        if (sampleTime < time || (after && sampleTime == time)) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+// Columns accumulate the sum in 'average' until Render divides it
+void LodSeries::FoldNode(const Node& node, uint32_t count, LodColumn& column) const {
+    if (column.count == 0) {
+        column.min = node.min;
+        column.max = node.max;
+        column.average = node.average * count;
+    } else {
+        if (node.min < column.min) column.min = node.min;
+        if (node.max > column.max) column.max = node.max;
+        column.average += node.average * count;
+    }
+    column.count += count;
+}
+
+// Samples first..end-1 as the fewest aligned complete nodes, none above 'maxLevel'
+void LodSeries::FoldRange(uint64_t first, uint64_t end, int maxLevel, LodColumn& column) const {
+    while (first < end) {
+        int level = maxLevel;
+        while (level > 0 && ((first & ((1ULL << level) - 1)) != 0 || first + (1ULL << level) > end)) level--;
+        FoldNode(GetNode(level, first >> level), 1u << level, column);
+        first += 1ULL << level;
+    }
+}
+
+int LodSeries::Render(uint64_t from, uint64_t to, int columns, LodColumn* out) const {
+    for (int i = 0; i < columns; i++) out[i] = LodColumn{ 0, 0, 0, 0 };
+    if (columns <= 0 || to < from || m_total == 0) return -1;
+
+    uint64_t begin = FindSample(from, false), end = FindSample(to, true);
+    if (begin >= end) return -1;
+
+    // Coarsest level that still has at least one node per column
+    uint64_t count = end - begin;
+    int level = 0;
+    while (level < m_levelCount && (count >> (level + 1)) >= (uint64_t)columns) level++;
+
+    uint64_t span = to - from + 1;
+    uint64_t run = 1ULL << level;
+    for (uint64_t node = begin >> level; node <= (end - 1) >> level; node++) {
+        uint64_t first = node << level, last = first + run;
+        uint64_t clippedFirst = first > begin ? first : begin;
+        uint64_t clippedEnd = last < end ? last : end;
+        LodColumn& column = out[(GetSampleTime(clippedFirst) - from) * columns / span];
+        if (clippedFirst == first && clippedEnd == last) FoldNode(GetNode(level, node), (uint32_t)run, column);
+        else FoldRange(clippedFirst, clippedEnd, level, column);
+    }
+
+    for (int i = 0; i < columns; i++) {
+        if (out[i].count) out[i].average /= out[i].count;
+    }
+    return level;
+}
+
+size_t LodSeries::GetMemoryBytes() const {
+    size_t bytes = m_times.capacity() * sizeof(uint64_t) + m_values.capacity() * sizeof(float);
+    for (const std::vector<Node>& nodes : m_levels) bytes += nodes.capacity() * sizeof(Node);
+    return bytes;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minux Level-of-Detail Series
+// Full-resolution samples of one series with a min/max/average pyramid on
+// top, so a graph can show any time range at any width without touching
+// every sample. Level k summarizes runs of 2^k samples; when a sample
+// completes a run, the parent node is built from its two children and the
+// carry stops at the first incomplete level, so Append is amortized O(1).
+//
+// Render picks the level with one to two nodes per pixel column and walks
+// it once: O(columns), whether the range holds a minute or a week. Column
+// edges snap to that level's nodes, less than a column off; the partial
+// nodes at either end of the range are folded from finer levels, so no
+// sample outside the range leaks in.
+//
+// Samples live in rings that grow with use up to the capacity; the oldest
+// are overwritten after that. A full series costs about 24 bytes a sample:
+// 8 for the time, 4 for the value and about 12 for the pyramid.
+
+#define LOD_DEFAULT_CAPACITY (7 * 24 * 3600)    // 7 days at one sample a second, about 14.5 MB
+
+struct LodColumn {
+    float min;
+    float max;
+    float average;
+    uint32_t count;             // samples folded into the column, 0 where there are none
+};
+
+class LodSeries {
+public:
+    // Keeps the newest 'capacity' samples (at least 2)
+    explicit LodSeries(uint32_t capacity = LOD_DEFAULT_CAPACITY);
+
+    // Times are ms and must not go backwards; NaN (no data) is skipped
+    void Append(uint64_t time, float value);
+    void Clear();
+
+    // Retained samples, oldest first
+    size_t GetSampleCount() const;
+    uint64_t GetFirstTime() const;              // 0 when empty
+    uint64_t GetLastTime() const;
+
+    // Summarize samples with from <= time <= to into 'columns' equal slices of
+    // time. Returns the pyramid level used, or -1 when the range is empty.
+    int Render(uint64_t from, uint64_t to, int columns, LodColumn* out) const;
+
+    size_t GetMemoryBytes() const;
+
+private:
+    struct Node {
+        float min;
+        float max;
+        float average;
+    };
+
+    uint64_t GetLevelSlots(int level) const;
+    Node GetNode(int level, uint64_t index) const;
+    uint64_t GetSampleTime(uint64_t index) const;
+    uint64_t FindSample(uint64_t time, bool after) const;
+    void FoldNode(const Node& node, uint32_t count, LodColumn& column) const;
+    void FoldRange(uint64_t first, uint64_t end, int maxLevel, LodColumn& column) const;
+
+    uint64_t m_capacity;
+    int m_levelCount;                           // levels above the samples
+    std::vector<uint64_t> m_times;              // ring, sample index % m_capacity
+    std::vector<float> m_values;
+    std::vector<std::vector<Node>> m_levels;    // m_levels[k - 1]: runs of 2^k samples, ring of (capacity >> k) + 1
+    uint64_t m_total;                           // samples ever appended since Clear
+};
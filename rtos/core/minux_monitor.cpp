@@ -0,0 +1,122 @@
+#include "minux_monitor.h"
+#include <chrono>
+#include <memory>
+#include "minux_netrates.h"
+#include "minux_proctable.h"
+#include "minux_topk.h"
+
+static std::unique_ptr<MonitorBackend> g_backend;
+static InterfaceRateTracker g_interfaceRates;      // previous counter readings of the active backend
+
+#if !defined(_WIN32) && !defined(__linux__)
+// No backend for this platform; install one with SetMonitorBackend
+MonitorBackend* CreatePlatformBackend() {
+    return NULL;
+}
+#endif
+
+void StartPerformanceCounters() {
+    if (!g_backend) g_backend.reset(CreatePlatformBackend());
+}
+
+void StopPerformanceCounters() {
+    g_backend.reset();
+    g_interfaceRates.Clear();
+}
+
+void SetMonitorBackend(MonitorBackend* backend) {
+    g_backend.reset(backend);
+    g_interfaceRates.Clear();
+}
+
+MonitorBackend* GetMonitorBackend() {
+    return g_backend.get();
+}
+
+// Get system information and the share of every logical processor
+void GetSystemInformation(SystemInfo& info, std::vector<CpuCoreInfo>& cores) {
+    info = SystemInfo();
+    cores.clear();
+    if (g_backend) g_backend->SampleSystem(info, cores);
+}
+
+// Get system information
+SystemInfo GetSystemInformation() {
+    static std::vector<CpuCoreInfo> cores;     // single caller thread; keeps its capacity
+    SystemInfo info;
+    GetSystemInformation(info, cores);
+    return info;
+}
+
+// Single caller thread: the scratch keeps its capacity between samples
+static std::vector<ProcessInfo> g_sampled;
+static std::vector<uint64_t> g_sortKeys;
+static std::vector<uint32_t> g_sortOrder;
+static std::vector<uint8_t> g_picked;
+static ProcessSorter g_sorter;
+static TopKSelector g_topSelector;
+
+// Get process list into a caller-owned vector (reuses its capacity)
+void GetProcessList(std::vector<ProcessInfo>& processes) {
+    GetProcessList(processes, (size_t)-1);
+}
+
+size_t GetProcessList(std::vector<ProcessInfo>& processes, size_t topCount) {
+    processes.clear();
+    if (!g_backend) return 0;
+    g_sampled.clear();
+    g_backend->SampleProcesses(g_sampled);
+    size_t count = g_sampled.size();
+
+    // Whole list by memory usage (descending): radix-order the key column, then move each record once
+    if (topCount >= count) {
+        g_sortKeys.resize(count);
+        for (size_t i = 0; i < count; i++) g_sortKeys[i] = ~g_sampled[i].workingSetSize;
+        g_sorter.SortKeys(g_sortKeys.data(), count, g_sortOrder);
+        processes.resize(count);
+        for (size_t i = 0; i < count; i++) processes[i] = g_sampled[g_sortOrder[i]];
+        return count;
+    }
+
+    // Only the heaviest: select them, then append the others as sampled
+    g_sortKeys.resize(count);
+    for (size_t i = 0; i < count; i++) g_sortKeys[i] = g_sampled[i].workingSetSize;
+    g_topSelector.Select(g_sortKeys.data(), count, topCount, g_sortOrder);
+    g_picked.assign(count, 0);
+    processes.reserve(count);
+    for (uint32_t index : g_sortOrder) {
+        processes.push_back(g_sampled[index]);
+        g_picked[index] = 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!g_picked[i]) processes.push_back(g_sampled[i]);
+    }
+    return g_sortOrder.size();
+}
+
+// Get process list
+std::vector<ProcessInfo> GetProcessList() {
+    std::vector<ProcessInfo> processes;
+    GetProcessList(processes);
+    return processes;
+}
+
+static uint64_t GetMonotonicMs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Get network interfaces into a caller-owned vector, with rates since the previous call
+void GetNetworkInterfaces(std::vector<NetworkInfo>& interfaces) {
+    interfaces.clear();
+    if (g_backend && g_backend->SampleNetwork(interfaces)) {
+        g_interfaceRates.Update(interfaces, GetMonotonicMs());
+    }
+}
+
+// Get network interfaces
+std::vector<NetworkInfo> GetNetworkInterfaces() {
+    std::vector<NetworkInfo> interfaces;
+    GetNetworkInterfaces(interfaces);
+    return interfaces;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+#include "minux_backend.h"
+
+// Minux Monitor
+// Platform-neutral sampling entry points. Each call forwards to the active
+// backend, which is the platform backend unless one was installed with
+// SetMonitorBackend. Call from one thread at a time (the collector).
+
+// Backend lifetime
+void StartPerformanceCounters();                    // creates the platform backend if none is set
+void StopPerformanceCounters();                     // destroys the active backend
+void SetMonitorBackend(MonitorBackend* backend);    // takes ownership; NULL removes the backend
+MonitorBackend* GetMonitorBackend();
+
+// System monitoring functions
+SystemInfo GetSystemInformation();
+void GetSystemInformation(SystemInfo& info, std::vector<CpuCoreInfo>& cores);  // plus per-core shares
+std::vector<ProcessInfo> GetProcessList();
+void GetProcessList(std::vector<ProcessInfo>& processes);   // sorted by working set, descending
+// Only the 'topCount' largest working sets are ordered (descending) at the
+// front, the rest follow in sampling order; returns how many are ordered
+size_t GetProcessList(std::vector<ProcessInfo>& processes, size_t topCount);
+// Rates cover the time since the previous call; the first call has none
+std::vector<NetworkInfo> GetNetworkInterfaces();
+void GetNetworkInterfaces(std::vector<NetworkInfo>& interfaces);
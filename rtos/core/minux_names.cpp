@@ -0,0 +1,129 @@
+#include "minux_names.h"
+#include <atomic>
+#include <cwchar>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define NAME_PAGE_BITS      12                              // 4096 entries per directory page
+#define NAME_PAGE_SIZE      (1u << NAME_PAGE_BITS)
+#define NAME_PAGE_COUNT     (NAME_MAX_IDS / NAME_PAGE_SIZE)
+#define NAME_TEXT_CHUNK     65536                           // characters per text chunk
+
+struct NameEntry {
+    const wchar_t* text;
+    uint32_t length;
+    uint32_t hash;
+};
+
+// Directory pages are published once and never move, so GetName needs no lock
+static std::atomic<NameEntry*> g_namePages[NAME_PAGE_COUNT];
+static std::atomic<uint32_t> g_nameCount(1);                // ID 0 is the empty name
+
+// Everything below is only touched with g_nameLock held
+static std::mutex g_nameLock;
+static std::vector<std::unique_ptr<NameEntry[]>> g_namePageStore;
+static std::vector<std::unique_ptr<wchar_t[]>> g_nameText;
+static size_t g_nameTextUsed = NAME_TEXT_CHUNK;             // in the newest chunk
+static std::vector<uint32_t> g_nameTable;                   // open addressing, 0 = empty slot
+
+// FNV-1a over the UTF-16 units
+static uint32_t HashName(const wchar_t* name, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint32_t)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static const NameEntry& GetEntry(NameId id) {
+    return g_namePages[id >> NAME_PAGE_BITS].load(std::memory_order_acquire)[id & (NAME_PAGE_SIZE - 1)];
+}
+
+static const wchar_t* StoreText(const wchar_t* name, size_t length) {
+    if (g_nameTextUsed + length + 1 > NAME_TEXT_CHUNK) {
+        g_nameText.emplace_back(new wchar_t[NAME_TEXT_CHUNK]);
+        g_nameTextUsed = 0;
+    }
+    wchar_t* text = g_nameText.back().get() + g_nameTextUsed;
+    wmemcpy(text, name, length);
+    text[length] = L'\0';
+    g_nameTextUsed += length + 1;
+    return text;
+}
+
+static void GrowTable() {
+    std::vector<uint32_t> table(g_nameTable.empty() ? 1024 : g_nameTable.size() * 2, 0);
+    size_t mask = table.size() - 1;
+    uint32_t count = g_nameCount.load(std::memory_order_relaxed);
+    for (NameId id = 1; id < count; id++) {
+        size_t slot = GetEntry(id).hash & mask;
+        while (table[slot]) slot = (slot + 1) & mask;
+        table[slot] = id;
+    }
+    g_nameTable.swap(table);
+}
+
+NameId InternName(const wchar_t* name, size_t length) {
+    if (!name || length == 0) return NAME_ID_NONE;
+    if (length > MINUX_MAX_NAME - 1) length = MINUX_MAX_NAME - 1;
+    uint32_t hash = HashName(name, length);
+
+    std::lock_guard<std::mutex> lock(g_nameLock);
+    if (!g_nameTable.empty()) {
+        size_t mask = g_nameTable.size() - 1;
+        for (size_t slot = hash & mask; g_nameTable[slot]; slot = (slot + 1) & mask) {
+            const NameEntry& entry = GetEntry(g_nameTable[slot]);
+            if (entry.hash == hash && entry.length == length && wmemcmp(entry.text, name, length) == 0) {
+                return g_nameTable[slot];
+            }
+        }
+    }
+
+    NameId id = g_nameCount.load(std::memory_order_relaxed);
+    if (id >= NAME_MAX_IDS) return NAME_ID_NONE;
+    if ((size_t)id * 2 >= g_nameTable.size()) GrowTable();
+
+    uint32_t page = id >> NAME_PAGE_BITS;
+    if (!g_namePages[page].load(std::memory_order_relaxed)) {
+        g_namePageStore.emplace_back(new NameEntry[NAME_PAGE_SIZE]);
+        g_namePages[page].store(g_namePageStore.back().get(), std::memory_order_release);
+    }
+    NameEntry& entry = g_namePages[page].load(std::memory_order_relaxed)[id & (NAME_PAGE_SIZE - 1)];
+    entry.text = StoreText(name, length);
+    entry.length = (uint32_t)length;
+    entry.hash = hash;
+
+    size_t mask = g_nameTable.size() - 1;
+    size_t slot = hash & mask;
+    while (g_nameTable[slot]) slot = (slot + 1) & mask;
+    g_nameTable[slot] = id;
+    g_nameCount.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+NameId InternName(const wchar_t* name) {
+    return name ? InternName(name, wcslen(name)) : NAME_ID_NONE;
+}
+
+const wchar_t* GetName(NameId id) {
+    if (id == NAME_ID_NONE || id >= g_nameCount.load(std::memory_order_acquire)) return L"";
+    return GetEntry(id).text;
+}
+
+size_t GetNameLength(NameId id) {
+    if (id == NAME_ID_NONE || id >= g_nameCount.load(std::memory_order_acquire)) return 0;
+    return GetEntry(id).length;
+}
+
+size_t GetInternedNameCount() {
+    return g_nameCount.load(std::memory_order_acquire) - 1;
+}
+
+size_t GetNamePoolBytes() {
+    std::lock_guard<std::mutex> lock(g_nameLock);
+    return g_nameText.size() * NAME_TEXT_CHUNK * sizeof(wchar_t) +
+           g_namePageStore.size() * NAME_PAGE_SIZE * sizeof(NameEntry) +
+           g_nameTable.size() * sizeof(uint32_t);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include "minux_types.h"
+
+// Minux Name Pool
+// Process-wide intern table for executable names and paths. Snapshots store
+// a 32-bit NameId instead of a MAX_PATH buffer, so a process record is a few
+// dozen bytes, copies and sort swaps move no text, and "same name" is an
+// integer compare. Equal strings always get the same ID; text is kept for
+// the life of the process (names repeat across samples, so the pool only
+// grows with names never seen before).
+//
+// InternName may be called from any thread. GetName does not lock: an ID
+// is safe to resolve on any thread that received it through a snapshot or
+// other synchronized hand-off.
+
+#define NAME_ID_NONE    0                   // the empty name
+#define NAME_MAX_IDS    (1u << 22)          // later names intern as NAME_ID_NONE
+
+// Names longer than MINUX_MAX_NAME - 1 characters are truncated
+NameId InternName(const wchar_t* name, size_t length);
+NameId InternName(const wchar_t* name);
+
+// Terminated text of an ID; L"" for NAME_ID_NONE or an ID never issued
+const wchar_t* GetName(NameId id);
+size_t GetNameLength(NameId id);
+
+size_t GetInternedNameCount();
+size_t GetNamePoolBytes();                  // text, directory and hash table
@@ -0,0 +1,43 @@
+#include "minux_netconfig.h"
+#include <cstring>
+#include <cwchar>
+
+InterfaceConfigCache::InterfaceConfigCache() : m_stale(true), m_rebuilds(0) {
+}
+
+void InterfaceConfigCache::Invalidate() {
+    m_stale.store(true, std::memory_order_release);
+}
+
+// Cleared before the caller enumerates, so a change reported mid-enumeration
+// is picked up by the next sample rather than lost
+bool InterfaceConfigCache::TakeInvalidation() {
+    if (!m_stale.exchange(false, std::memory_order_acq_rel)) return false;
+    m_rebuilds++;
+    return true;
+}
+
+void InterfaceConfigCache::Clear() {
+    m_entries.clear();
+}
+
+InterfaceConfig& InterfaceConfigCache::Add() {
+    m_entries.push_back(InterfaceConfig());
+    return m_entries.back();
+}
+
+const InterfaceConfig* InterfaceConfigCache::FindByName(const char* systemName, size_t hint) const {
+    if (hint < m_entries.size() && strcmp(m_entries[hint].systemName, systemName) == 0) return &m_entries[hint];
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        if (strcmp(m_entries[i].systemName, systemName) == 0) return &m_entries[i];
+    }
+    return NULL;
+}
+
+void ApplyInterfaceConfig(const InterfaceConfig& config, NetworkInfo& info) {
+    const NetworkInfo& source = config.info;
+    memcpy(info.adapterName, source.adapterName, sizeof(info.adapterName));
+    memcpy(info.ipAddress, source.ipAddress, sizeof(info.ipAddress));
+    memcpy(info.macAddress, source.macAddress, sizeof(info.macAddress));
+    info.isConnected = source.isConnected;
+}
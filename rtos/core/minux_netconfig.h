@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include "minux_types.h"
+
+// Minux Interface Configuration Cache
+// Adapter names, addresses and MACs almost never change, so a backend keeps
+// them here and re-reads them only after the operating system reports a
+// change (an IP interface or address callback on Windows, an rtnetlink
+// message on Linux). Samples in between poll only the counters and copy the
+// configuration fields from the cache. Invalidate may be called from any
+// thread; everything else belongs to the sampling thread.
+
+struct InterfaceConfig {
+    uint64_t key;               // backend's interface identity: LUID on Windows
+    char systemName[32];        // kernel name on Linux, e.g. "eth0"; empty on Windows
+    NetworkInfo info;           // adapterName, ipAddress, macAddress and isConnected; no counters
+};
+
+class InterfaceConfigCache {
+public:
+    InterfaceConfigCache();
+
+    // The configuration changed; the next TakeInvalidation returns true
+    void Invalidate();
+
+    // True once after each Invalidate (and on first use): the caller clears
+    // the cache and enumerates the interfaces again
+    bool TakeInvalidation();
+
+    void Clear();
+    InterfaceConfig& Add();
+    size_t GetCount() const { return m_entries.size(); }
+    const InterfaceConfig& GetEntry(size_t index) const { return m_entries[index]; }
+
+    // Linux lookup by kernel name; interfaces usually keep their order, so 'hint' is tried first
+    const InterfaceConfig* FindByName(const char* systemName, size_t hint) const;
+
+    // Times the configuration was enumerated again
+    uint32_t GetRebuildCount() const { return m_rebuilds; }
+
+private:
+    std::atomic<bool> m_stale;
+    std::vector<InterfaceConfig> m_entries;
+    uint32_t m_rebuilds;
+};
+
+// Copy the cached configuration fields into a reading that has only counters
+void ApplyInterfaceConfig(const InterfaceConfig& config, NetworkInfo& info);
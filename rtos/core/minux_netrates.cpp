@@ -0,0 +1,76 @@
+#include "minux_netrates.h"
+#include <cwchar>
+
+static uint64_t CounterDelta(uint64_t previous, uint64_t current) {
+    return current >= previous ? current - previous : current;
+}
+
+static uint64_t PerSecond(uint64_t delta, uint64_t elapsedMs) {
+    // Round to nearest; delta * 1000 cannot overflow below 2^54 per interval
+    return (delta * 1000 + elapsedMs / 2) / elapsedMs;
+}
+
+void SetInterfaceRates(const NetworkInfo& previous, NetworkInfo& current, uint64_t elapsedMs) {
+    if (elapsedMs == 0) {
+        current.bytesReceivedPerSecond = previous.bytesReceivedPerSecond;
+        current.bytesSentPerSecond = previous.bytesSentPerSecond;
+        current.packetsReceivedPerSecond = previous.packetsReceivedPerSecond;
+        current.packetsSentPerSecond = previous.packetsSentPerSecond;
+        current.rateIntervalMs = previous.rateIntervalMs;
+        return;
+    }
+    current.bytesReceivedPerSecond = PerSecond(CounterDelta(previous.bytesReceived, current.bytesReceived), elapsedMs);
+    current.bytesSentPerSecond = PerSecond(CounterDelta(previous.bytesSent, current.bytesSent), elapsedMs);
+    current.packetsReceivedPerSecond = PerSecond(CounterDelta(previous.packetsReceived, current.packetsReceived), elapsedMs);
+    current.packetsSentPerSecond = PerSecond(CounterDelta(previous.packetsSent, current.packetsSent), elapsedMs);
+    current.rateIntervalMs = elapsedMs < UINT32_MAX ? (uint32_t)elapsedMs : UINT32_MAX;
+}
+
+InterfaceRateTracker::InterfaceRateTracker() : m_generation(0) {
+}
+
+void InterfaceRateTracker::Clear() {
+    m_baselines.clear();
+}
+
+// Interfaces usually come back in the same order, so the slot at 'hint' is tried first
+int InterfaceRateTracker::FindBaseline(const wchar_t* adapterName, size_t hint) const {
+    if (hint < m_baselines.size() && m_baselines[hint].adapterName == adapterName) return (int)hint;
+    for (size_t i = 0; i < m_baselines.size(); i++) {
+        if (m_baselines[i].adapterName == adapterName) return (int)i;
+    }
+    return -1;
+}
+
+void InterfaceRateTracker::Update(std::vector<NetworkInfo>& interfaces, uint64_t now) {
+    if (++m_generation == 0) m_generation = 1;
+    for (size_t i = 0; i < interfaces.size(); i++) {
+        NetworkInfo& info = interfaces[i];
+        int found = FindBaseline(info.adapterName, i);
+        if (found < 0) {
+            info.bytesReceivedPerSecond = info.bytesSentPerSecond = 0;
+            info.packetsReceivedPerSecond = info.packetsSentPerSecond = 0;
+            info.rateIntervalMs = 0;
+            Baseline baseline;
+            baseline.adapterName = info.adapterName;
+            m_baselines.push_back(baseline);
+            found = (int)m_baselines.size() - 1;
+        } else {
+            Baseline& baseline = m_baselines[found];
+            SetInterfaceRates(baseline.reading, info, now > baseline.time ? now - baseline.time : 0);
+        }
+        Baseline& baseline = m_baselines[found];
+        baseline.reading = info;
+        baseline.time = now;
+        baseline.generation = m_generation;
+    }
+
+    // Forget interfaces that went away; one that comes back starts without rates
+    size_t kept = 0;
+    for (size_t i = 0; i < m_baselines.size(); i++) {
+        if (m_baselines[i].generation != m_generation) continue;
+        if (kept != i) m_baselines[kept] = m_baselines[i];
+        kept++;
+    }
+    m_baselines.resize(kept);
+}
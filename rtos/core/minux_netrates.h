@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "minux_types.h"
+
+// Minux Interface Rates
+// Per-second byte and packet rates from the change in an interface's
+// counters between two readings. Rates are taken when the counters are
+// read, not when a snapshot is published, so a snapshot that carries an
+// unsampled interface over keeps a steady rate instead of a zero followed
+// by a spike. A counter that went backwards was reset (driver reload,
+// interface re-created) and is counted from zero.
+
+// Fill current's rate fields from 'previous', read 'elapsedMs' earlier
+void SetInterfaceRates(const NetworkInfo& previous, NetworkInfo& current, uint64_t elapsedMs);
+
+// Keeps each interface's last reading between samples, matched by adapter name
+class InterfaceRateTracker {
+public:
+    InterfaceRateTracker();
+
+    // Set the rates of a fresh reading taken at 'now' (ms on a monotonic clock)
+    void Update(std::vector<NetworkInfo>& interfaces, uint64_t now);
+    void Clear();
+
+private:
+    struct Baseline {
+        std::wstring adapterName;
+        NetworkInfo reading;
+        uint64_t time;
+        uint32_t generation;
+    };
+
+    int FindBaseline(const wchar_t* adapterName, size_t hint) const;
+
+    std::vector<Baseline> m_baselines;
+    uint32_t m_generation;
+};
@@ -0,0 +1,393 @@
+#include "minux_pixels.h"
+#include <cmath>
+#include <cstring>
+
+#ifdef MINUX_PIXELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Row operations one kernel set provides
+struct PixelKernels {
+    void (*fillRow)(uint32_t* row, int count, uint32_t color);
+    void (*blendRow)(uint32_t* row, int count, uint32_t color);
+    void (*blendImageRow)(uint32_t* row, int count, const uint32_t* source);
+    // Gradient columns first..first + count - 1; steps are 16.16 per column, B G R A
+    void (*gradientRow)(uint32_t* row, int count, int first, uint32_t from, const int32_t* steps);
+};
+
+// x * factor / 255, rounded to nearest, exact for 8-bit inputs
+static inline uint32_t MulDiv255(uint32_t value, uint32_t factor) {
+    uint32_t t = value * factor + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+// Premultiplied source-over; channels saturate like the SIMD adds do
+static inline uint32_t BlendPixel(uint32_t dst, uint32_t src) {
+    uint32_t inverse = 255 - (src >> 24);
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t value = ((src >> shift) & 0xFF) + MulDiv255((dst >> shift) & 0xFF, inverse);
+        out |= (value > 255 ? 255 : value) << shift;
+    }
+    return out;
+}
+
+static inline uint32_t GradientPixel(uint32_t from, const int32_t* steps, int x) {
+    uint32_t out = 0;
+    for (int channel = 0; channel < 4; channel++) {
+        int32_t value = (int32_t)((from >> (channel * 8)) & 0xFF) + ((steps[channel] * x) >> 16);
+        out |= (uint32_t)value << (channel * 8);
+    }
+    return out;
+}
+
+static void FillRowScalar(uint32_t* row, int count, uint32_t color) {
+    for (int i = 0; i < count; i++) row[i] = color;
+}
+
+static void BlendRowScalar(uint32_t* row, int count, uint32_t color) {
+    for (int i = 0; i < count; i++) row[i] = BlendPixel(row[i], color);
+}
+
+static void BlendImageRowScalar(uint32_t* row, int count, const uint32_t* source) {
+    for (int i = 0; i < count; i++) row[i] = BlendPixel(row[i], source[i]);
+}
+
+static void GradientRowScalar(uint32_t* row, int count, int first, uint32_t from, const int32_t* steps) {
+    for (int i = 0; i < count; i++) row[i] = GradientPixel(from, steps, first + i);
+}
+
+static const PixelKernels g_scalarKernels = { FillRowScalar, BlendRowScalar, BlendImageRowScalar, GradientRowScalar };
+
+#ifdef MINUX_PIXELS_X86
+MINUX_TARGET_SSE2 static void FillRowSse2(uint32_t* row, int count, uint32_t color) {
+    __m128i value = _mm_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i*)(row + i), value);
+    for (; i < count; i++) row[i] = color;
+}
+
+// Two pixels widened to 16 bits: dst * inverse / 255 with the scalar rounding
+MINUX_TARGET_SSE2 static inline __m128i ScaleSse2(__m128i pixels, __m128i inverse) {
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, inverse), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+MINUX_TARGET_SSE2 static void BlendRowSse2(uint32_t* row, int count, uint32_t color) {
+    __m128i source = _mm_set1_epi32((int)color);
+    __m128i inverse = _mm_set1_epi16((short)(255 - (color >> 24)));
+    __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i dst = _mm_loadu_si128((const __m128i*)(row + i));
+        __m128i low = ScaleSse2(_mm_unpacklo_epi8(dst, zero), inverse);
+        __m128i high = ScaleSse2(_mm_unpackhi_epi8(dst, zero), inverse);
+        _mm_storeu_si128((__m128i*)(row + i), _mm_adds_epu8(source, _mm_packus_epi16(low, high)));
+    }
+    for (; i < count; i++) row[i] = BlendPixel(row[i], color);
+}
+
+// Each pixel's inverse alpha is copied across its four 16-bit channel lanes
+MINUX_TARGET_SSE2 static inline __m128i InverseAlphaSse2(__m128i pixels) {
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+    return _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+}
+
+MINUX_TARGET_SSE2 static void BlendImageRowSse2(uint32_t* row, int count, const uint32_t* source) {
+    __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i src = _mm_loadu_si128((const __m128i*)(source + i));
+        __m128i dst = _mm_loadu_si128((const __m128i*)(row + i));
+        __m128i low = ScaleSse2(_mm_unpacklo_epi8(dst, zero), InverseAlphaSse2(_mm_unpacklo_epi8(src, zero)));
+        __m128i high = ScaleSse2(_mm_unpackhi_epi8(dst, zero), InverseAlphaSse2(_mm_unpackhi_epi8(src, zero)));
+        _mm_storeu_si128((__m128i*)(row + i), _mm_adds_epu8(src, _mm_packus_epi16(low, high)));
+    }
+    for (; i < count; i++) row[i] = BlendPixel(row[i], source[i]);
+}
+
+// Four pixels per step: one 32-bit lane per channel, packed down to bytes
+MINUX_TARGET_SSE2 static void GradientRowSse2(uint32_t* row, int count, int first, uint32_t from, const int32_t* steps) {
+    __m128i base = _mm_setr_epi32((int)(from & 0xFF), (int)((from >> 8) & 0xFF),
+                                  (int)((from >> 16) & 0xFF), (int)(from >> 24));
+    __m128i accumulators[4];
+    for (int k = 0; k < 4; k++) {
+        int x = first + k;
+        accumulators[k] = _mm_setr_epi32(steps[0] * x, steps[1] * x, steps[2] * x, steps[3] * x);
+    }
+    __m128i advance = _mm_setr_epi32(steps[0] * 4, steps[1] * 4, steps[2] * 4, steps[3] * 4);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i p0 = _mm_add_epi32(base, _mm_srai_epi32(accumulators[0], 16));
+        __m128i p1 = _mm_add_epi32(base, _mm_srai_epi32(accumulators[1], 16));
+        __m128i p2 = _mm_add_epi32(base, _mm_srai_epi32(accumulators[2], 16));
+        __m128i p3 = _mm_add_epi32(base, _mm_srai_epi32(accumulators[3], 16));
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+        _mm_storeu_si128((__m128i*)(row + i), packed);
+        for (int k = 0; k < 4; k++) accumulators[k] = _mm_add_epi32(accumulators[k], advance);
+    }
+    for (; i < count; i++) row[i] = GradientPixel(from, steps, first + i);
+}
+
+static const PixelKernels g_sse2Kernels = { FillRowSse2, BlendRowSse2, BlendImageRowSse2, GradientRowSse2 };
+
+MINUX_TARGET_AVX2 static void FillRowAvx2(uint32_t* row, int count, uint32_t color) {
+    __m256i value = _mm256_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) _mm256_storeu_si256((__m256i*)(row + i), value);
+    for (; i < count; i++) row[i] = color;
+}
+
+MINUX_TARGET_AVX2 static inline __m256i ScaleAvx2(__m256i pixels, __m256i inverse) {
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(pixels, inverse), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+// Unpack and pack both work within 128-bit lanes, so pixel order is kept
+MINUX_TARGET_AVX2 static void BlendRowAvx2(uint32_t* row, int count, uint32_t color) {
+    __m256i source = _mm256_set1_epi32((int)color);
+    __m256i inverse = _mm256_set1_epi16((short)(255 - (color >> 24)));
+    __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i dst = _mm256_loadu_si256((const __m256i*)(row + i));
+        __m256i low = ScaleAvx2(_mm256_unpacklo_epi8(dst, zero), inverse);
+        __m256i high = ScaleAvx2(_mm256_unpackhi_epi8(dst, zero), inverse);
+        _mm256_storeu_si256((__m256i*)(row + i), _mm256_adds_epu8(source, _mm256_packus_epi16(low, high)));
+    }
+    for (; i < count; i++) row[i] = BlendPixel(row[i], color);
+}
+
+MINUX_TARGET_AVX2 static inline __m256i InverseAlphaAvx2(__m256i pixels) {
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, 0xFF), 0xFF);
+    return _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+}
+
+MINUX_TARGET_AVX2 static void BlendImageRowAvx2(uint32_t* row, int count, const uint32_t* source) {
+    __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i src = _mm256_loadu_si256((const __m256i*)(source + i));
+        __m256i dst = _mm256_loadu_si256((const __m256i*)(row + i));
+        __m256i low = ScaleAvx2(_mm256_unpacklo_epi8(dst, zero), InverseAlphaAvx2(_mm256_unpacklo_epi8(src, zero)));
+        __m256i high = ScaleAvx2(_mm256_unpackhi_epi8(dst, zero), InverseAlphaAvx2(_mm256_unpackhi_epi8(src, zero)));
+        _mm256_storeu_si256((__m256i*)(row + i), _mm256_adds_epu8(src, _mm256_packus_epi16(low, high)));
+    }
+    for (; i < count; i++) row[i] = BlendPixel(row[i], source[i]);
+}
+
+// A gradient row is built once per rectangle and copied down, so it stays 128-bit
+static const PixelKernels g_avx2Kernels = { FillRowAvx2, BlendRowAvx2, BlendImageRowAvx2, GradientRowSse2 };
+
+static bool CpuHasSse2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool CpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+static const PixelKernels* GetKernelTable(PixelKernelSet set) {
+#ifdef MINUX_PIXELS_X86
+    if (set == PIXEL_KERNELS_AVX2) return &g_avx2Kernels;
+    if (set == PIXEL_KERNELS_SSE2) return &g_sse2Kernels;
+#endif
+    (void)set;
+    return &g_scalarKernels;
+}
+
+PixelKernelSet GetBestPixelKernels() {
+#ifdef MINUX_PIXELS_X86
+    static const PixelKernelSet best = CpuHasAvx2() ? PIXEL_KERNELS_AVX2 :
+                                       CpuHasSse2() ? PIXEL_KERNELS_SSE2 : PIXEL_KERNELS_SCALAR;
+    return best;
+#else
+    return PIXEL_KERNELS_SCALAR;
+#endif
+}
+
+// Chosen on first use rather than at static initialisation, so other globals can draw
+static PixelKernelSet g_pixelKernelSet;
+static const PixelKernels* g_pixelKernels = NULL;
+
+static const PixelKernels* GetKernels() {
+    if (!g_pixelKernels) {
+        g_pixelKernelSet = GetBestPixelKernels();
+        g_pixelKernels = GetKernelTable(g_pixelKernelSet);
+    }
+    return g_pixelKernels;
+}
+
+PixelKernelSet GetPixelKernels() {
+    GetKernels();
+    return g_pixelKernelSet;
+}
+
+void SetPixelKernels(PixelKernelSet set) {
+    if (set > GetBestPixelKernels()) set = GetBestPixelKernels();
+    g_pixelKernelSet = set;
+    g_pixelKernels = GetKernelTable(set);
+}
+
+const char* GetPixelKernelName(PixelKernelSet set) {
+    switch (set) {
+    case PIXEL_KERNELS_SSE2: return "SSE2";
+    case PIXEL_KERNELS_AVX2: return "AVX2";
+    default: return "scalar";
+    }
+}
+
+uint32_t PixelPremultiply(uint32_t argb) {
+    uint32_t alpha = argb >> 24;
+    return (alpha << 24) | (MulDiv255((argb >> 16) & 0xFF, alpha) << 16) |
+           (MulDiv255((argb >> 8) & 0xFF, alpha) << 8) | MulDiv255(argb & 0xFF, alpha);
+}
+
+static bool ClipToSurface(const PixelSurface& surface, const PixelRect& rect, PixelRect* clip) {
+    clip->left = rect.left > 0 ? rect.left : 0;
+    clip->top = rect.top > 0 ? rect.top : 0;
+    clip->right = rect.right < surface.width ? rect.right : surface.width;
+    clip->bottom = rect.bottom < surface.height ? rect.bottom : surface.height;
+    return clip->left < clip->right && clip->top < clip->bottom;
+}
+
+static inline uint32_t* GetRow(const PixelSurface& surface, int y) {
+    return surface.pixels + (size_t)y * surface.stride;
+}
+
+void PixelFill(const PixelSurface& surface, const PixelRect& rect, uint32_t color) {
+    PixelRect clip;
+    if (!ClipToSurface(surface, rect, &clip)) return;
+    for (int y = clip.top; y < clip.bottom; y++) {
+        GetKernels()->fillRow(GetRow(surface, y) + clip.left, clip.right - clip.left, color);
+    }
+}
+
+void PixelBlendFill(const PixelSurface& surface, const PixelRect& rect, uint32_t color) {
+    if ((color >> 24) == 255) {
+        PixelFill(surface, rect, color);
+        return;
+    }
+    if (color == 0) return;
+    PixelRect clip;
+    if (!ClipToSurface(surface, rect, &clip)) return;
+    for (int y = clip.top; y < clip.bottom; y++) {
+        GetKernels()->blendRow(GetRow(surface, y) + clip.left, clip.right - clip.left, color);
+    }
+}
+
+// Per-channel 16.16 increments from 'from' to 'to' over 'length' pixels
+static void GetGradientSteps(uint32_t from, uint32_t to, int length, int32_t* steps) {
+    for (int channel = 0; channel < 4; channel++) {
+        int32_t delta = (int32_t)((to >> (channel * 8)) & 0xFF) - (int32_t)((from >> (channel * 8)) & 0xFF);
+        steps[channel] = delta * 65536 / length;
+    }
+}
+
+void PixelGradient(const PixelSurface& surface, const PixelRect& rect, uint32_t from, uint32_t to, bool vertical) {
+    PixelRect clip;
+    if (!ClipToSurface(surface, rect, &clip)) return;
+    int32_t steps[4];
+    int count = clip.right - clip.left;
+
+    if (vertical) {
+        GetGradientSteps(from, to, rect.bottom - rect.top, steps);
+        for (int y = clip.top; y < clip.bottom; y++) {
+            GetKernels()->fillRow(GetRow(surface, y) + clip.left, count, GradientPixel(from, steps, y - rect.top));
+        }
+        return;
+    }
+
+    // Build the first row, then every other row is a copy of it
+    GetGradientSteps(from, to, rect.right - rect.left, steps);
+    uint32_t* first = GetRow(surface, clip.top) + clip.left;
+    GetKernels()->gradientRow(first, count, clip.left - rect.left, from, steps);
+    for (int y = clip.top + 1; y < clip.bottom; y++) {
+        memcpy(GetRow(surface, y) + clip.left, first, (size_t)count * sizeof(uint32_t));
+    }
+}
+
+// Share of a corner pixel inside the arc; dx and dy run from the arc centre to the pixel centre
+static uint32_t GetCornerCoverage(float dx, float dy, int radius) {
+    if (dx <= 0 && dy <= 0) return 255;
+    if (dx < 0) dx = 0;
+    if (dy < 0) dy = 0;
+    float coverage = radius + 0.5f - std::sqrt(dx * dx + dy * dy);
+    if (coverage <= 0) return 0;
+    if (coverage >= 1) return 255;
+    return (uint32_t)(coverage * 255 + 0.5f);
+}
+
+static inline void BlendCovered(uint32_t* pixel, uint32_t color, uint32_t coverage) {
+    if (coverage == 0) return;
+    if (coverage < 255) {
+        color = (MulDiv255(color >> 24, coverage) << 24) | (MulDiv255((color >> 16) & 0xFF, coverage) << 16) |
+                (MulDiv255((color >> 8) & 0xFF, coverage) << 8) | MulDiv255(color & 0xFF, coverage);
+    }
+    *pixel = BlendPixel(*pixel, color);
+}
+
+void PixelBlendRoundRect(const PixelSurface& surface, const PixelRect& rect, int radius, uint32_t color) {
+    int width = rect.right - rect.left, height = rect.bottom - rect.top;
+    if (radius > width / 2) radius = width / 2;
+    if (radius > height / 2) radius = height / 2;
+    if (radius <= 0) {
+        PixelBlendFill(surface, rect, color);
+        return;
+    }
+    PixelRect clip;
+    if (!ClipToSurface(surface, rect, &clip) || color == 0) return;
+
+    int leftArc = rect.left + radius, rightArc = rect.right - radius;
+    int spanLeft = clip.left > leftArc ? clip.left : leftArc;
+    int spanRight = clip.right < rightArc ? clip.right : rightArc;
+    for (int y = clip.top; y < clip.bottom; y++) {
+        uint32_t* row = GetRow(surface, y);
+        float dy = y < rect.top + radius ? (rect.top + radius) - (y + 0.5f) :
+                   y >= rect.bottom - radius ? (y + 0.5f) - (rect.bottom - radius) : -1.0f;
+        if (dy < 0) {
+            GetKernels()->blendRow(row + clip.left, clip.right - clip.left, color);
+            continue;
+        }
+
+        // Corner row: the arcs pixel by pixel, the straight middle with the row kernel
+        for (int x = clip.left; x < clip.right && x < leftArc; x++) {
+            BlendCovered(row + x, color, GetCornerCoverage(leftArc - (x + 0.5f), dy, radius));
+        }
+        if (spanLeft < spanRight) GetKernels()->blendRow(row + spanLeft, spanRight - spanLeft, color);
+        for (int x = clip.left > rightArc ? clip.left : rightArc; x < clip.right; x++) {
+            BlendCovered(row + x, color, GetCornerCoverage((x + 0.5f) - rightArc, dy, radius));
+        }
+    }
+}
+
+void PixelBlendImage(const PixelSurface& surface, int x, int y, const PixelSurface& image) {
+    PixelRect rect = { x, y, x + image.width, y + image.height };
+    PixelRect clip;
+    if (!ClipToSurface(surface, rect, &clip)) return;
+    for (int row = clip.top; row < clip.bottom; row++) {
+        const uint32_t* source = GetRow(image, row - y) + (clip.left - x);
+        GetKernels()->blendImageRow(GetRow(surface, row) + clip.left, clip.right - clip.left, source);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Minux Pixel Kernels
+// Software rendering of fills, gradients and alpha-blended rounded rectangles
+// into 32-bit premultiplied BGRA buffers, the layout of a top-down 32-bit
+// DIB section, so GDI only has to blit the finished pixels.
+//
+// Every row operation has a scalar reference and SSE2 and AVX2 versions on
+// x86; the widest one the CPU supports is picked on first use. All versions
+// produce the same bytes, which the pixel bench checks.
+
+// Kernel files build their SIMD paths per function, so the app needs no /arch flags
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MINUX_PIXELS_X86 1
+#ifdef _MSC_VER
+#define MINUX_TARGET_SSE2
+#define MINUX_TARGET_AVX2
+#else
+#define MINUX_TARGET_SSE2 __attribute__((target("sse2")))
+#define MINUX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// 0xAARRGGBB with colour channels already multiplied by alpha
+#define PIXEL_ARGB(a, r, g, b) (((uint32_t)(a) << 24) | ((uint32_t)(r) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(b))
+
+struct PixelSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int stride;                 // pixels from one row to the next
+};
+
+// Half-open, like a GDI RECT
+struct PixelRect {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+enum PixelKernelSet {
+    PIXEL_KERNELS_SCALAR,
+    PIXEL_KERNELS_SSE2,
+    PIXEL_KERNELS_AVX2
+};
+
+// Straight (non-premultiplied) colour to premultiplied, rounding to nearest
+uint32_t PixelPremultiply(uint32_t argb);
+
+// Widest kernel set the CPU supports, and the one in use
+PixelKernelSet GetBestPixelKernels();
+PixelKernelSet GetPixelKernels();
+
+// Force a kernel set (benches compare them); clamped to what the CPU supports
+void SetPixelKernels(PixelKernelSet set);
+const char* GetPixelKernelName(PixelKernelSet set);
+
+// Replace the pixels of 'rect' with 'color'
+void PixelFill(const PixelSurface& surface, const PixelRect& rect, uint32_t color);
+
+// Draw 'color' over the pixels of 'rect' (premultiplied source-over)
+void PixelBlendFill(const PixelSurface& surface, const PixelRect& rect, uint32_t color);
+
+// Replace 'rect' with a linear gradient from 'from' to 'to', top to bottom or left to right
+void PixelGradient(const PixelSurface& surface, const PixelRect& rect, uint32_t from, uint32_t to, bool vertical);
+
+// Draw 'color' over a rectangle with anti-aliased corners of 'radius' pixels
+void PixelBlendRoundRect(const PixelSurface& surface, const PixelRect& rect, int radius, uint32_t color);
+
+// Draw all of 'image' over 'surface' with its top-left corner at x, y
+void PixelBlendImage(const PixelSurface& surface, int x, int y, const PixelSurface& image);
@@ -0,0 +1,132 @@
+#include "minux_procdiff.h"
+
+// Mix PID and creation time into a well-spread table index
+static size_t HashProcessKey(const ProcessKey& key) {
+    uint64_t x = key.creationTime ^ ((uint64_t)key.processId * 0x9E3779B97F4A7C15ULL);
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+ProcessDiffEngine::ProcessDiffEngine() : m_count(0), m_generation(0) {
+}
+
+void ProcessDiffEngine::Reset() {
+    m_table.clear();
+    m_count = 0;
+    m_generation = 0;
+}
+
+// Slot holding the key, or the empty slot where it would be inserted
+size_t ProcessDiffEngine::FindSlot(const ProcessKey& key) const {
+    size_t mask = m_table.size() - 1;
+    size_t slot = HashProcessKey(key) & mask;
+    while (m_table[slot].generation != 0 && !(m_table[slot].key == key)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+void ProcessDiffEngine::EraseSlot(size_t slot) {
+    size_t mask = m_table.size() - 1;
+    size_t hole = slot;
+    size_t next = (hole + 1) & mask;
+    while (m_table[next].generation != 0) {
+        size_t home = HashProcessKey(m_table[next].key) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            m_table[hole] = m_table[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    m_table[hole].generation = 0;
+}
+
+void ProcessDiffEngine::Grow() {
+    std::vector<Entry> old;
+    old.swap(m_table);
+
+    Entry empty = {};
+    m_table.assign(old.empty() ? 64 : old.size() * 2, empty);
+    for (const Entry& entry : old) {
+        if (entry.generation != 0) {
+            m_table[FindSlot(entry.key)] = entry;
+        }
+    }
+}
+
+void ProcessDiffEngine::Diff(const std::vector<ProcessInfo>& current, std::vector<ProcessChange>& changes) {
+    changes.clear();
+    if (++m_generation == 0) m_generation = 1;
+
+    // Keep the load factor at or below 1/2 for short probe chains
+    while ((m_count + current.size()) * 2 > m_table.size()) {
+        Grow();
+    }
+
+    for (size_t i = 0; i < current.size(); i++) {
+        const ProcessInfo& info = current[i];
+        ProcessKey key = MakeProcessKey(info);
+        Entry& entry = m_table[FindSlot(key)];
+
+        if (entry.generation == 0) {
+            entry.key = key;
+            entry.workingSetSize = info.workingSetSize;
+            entry.cpuUsage = info.cpuUsage;
+            entry.threadCount = info.threadCount;
+            entry.generation = m_generation;
+            entry.tag = -1;
+            m_count++;
+
+            ProcessChange change = { PROCESS_ADDED, PROCESS_FIELD_ALL, key, (int)i, -1 };
+            changes.push_back(change);
+            continue;
+        }
+
+        // Duplicate key within one snapshot; keep the first record
+        if (entry.generation == m_generation) continue;
+        entry.generation = m_generation;
+
+        uint32_t fields = 0;
+        if (entry.workingSetSize != info.workingSetSize) fields |= PROCESS_FIELD_WORKINGSET;
+        if (entry.cpuUsage != info.cpuUsage) fields |= PROCESS_FIELD_CPU;
+        if (entry.threadCount != info.threadCount) fields |= PROCESS_FIELD_THREADS;
+
+        if (fields) {
+            entry.workingSetSize = info.workingSetSize;
+            entry.cpuUsage = info.cpuUsage;
+            entry.threadCount = info.threadCount;
+
+            ProcessChange change = { PROCESS_CHANGED, fields, key, (int)i, entry.tag };
+            changes.push_back(change);
+        }
+    }
+
+    // Anything not stamped with this generation has exited
+    m_removed.clear();
+    for (const Entry& entry : m_table) {
+        if (entry.generation != 0 && entry.generation != m_generation) {
+            ProcessChange change = { PROCESS_REMOVED, 0, entry.key, -1, entry.tag };
+            changes.push_back(change);
+            m_removed.push_back(entry.key);
+        }
+    }
+    for (const ProcessKey& key : m_removed) {
+        EraseSlot(FindSlot(key));
+        m_count--;
+    }
+}
+
+int ProcessDiffEngine::GetTag(const ProcessKey& key) const {
+    if (m_table.empty()) return -1;
+    const Entry& entry = m_table[FindSlot(key)];
+    return entry.generation != 0 ? entry.tag : -1;
+}
+
+void ProcessDiffEngine::SetTag(const ProcessKey& key, int tag) {
+    if (m_table.empty()) return;
+    Entry& entry = m_table[FindSlot(key)];
+    if (entry.generation != 0) entry.tag = tag;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+
+// Minux Process Diff Engine
+// Compares each process snapshot with the previous one and reports only the
+// records that were added, removed or changed. Processes are identified by
+// (PID, creation time) so a reused PID shows up as a remove plus an add.
+
+// Process identity
+struct ProcessKey {
+    uint32_t processId;
+    uint64_t creationTime;
+};
+
+inline bool operator==(const ProcessKey& a, const ProcessKey& b) {
+    return a.processId == b.processId && a.creationTime == b.creationTime;
+}
+
+inline ProcessKey MakeProcessKey(const ProcessInfo& info) {
+    ProcessKey key;
+    key.processId = info.processId;
+    key.creationTime = info.creationTime;
+    return key;
+}
+
+// Change kinds
+enum ProcessChangeType {
+    PROCESS_ADDED,
+    PROCESS_REMOVED,
+    PROCESS_CHANGED
+};
+
+// Changed field bits
+#define PROCESS_FIELD_WORKINGSET  0x1
+#define PROCESS_FIELD_CPU         0x2
+#define PROCESS_FIELD_THREADS     0x4
+#define PROCESS_FIELD_ALL         0x7
+
+// One diff record
+struct ProcessChange {
+    ProcessChangeType type;
+    uint32_t fields;    // PROCESS_FIELD_* bits; all bits for added records
+    ProcessKey key;
+    int index;          // index into the new snapshot, -1 for removed records
+    int tag;            // caller tag of the record (see SetTag), -1 for added records
+};
+
+class ProcessDiffEngine {
+public:
+    ProcessDiffEngine();
+
+    // Diff the new snapshot against the previous one. Removed records are
+    // reported last. The output vector is cleared first and reused as-is.
+    void Diff(const std::vector<ProcessInfo>& current, std::vector<ProcessChange>& changes);
+
+    // Forget all history so the next Diff reports every process as added
+    void Reset();
+
+    // Caller-owned tag per live record, e.g. the list view row it lives in
+    int GetTag(const ProcessKey& key) const;
+    void SetTag(const ProcessKey& key, int tag);
+
+    size_t Size() const { return m_count; }
+
+private:
+    struct Entry {
+        ProcessKey key;
+        uint64_t workingSetSize;
+        uint32_t cpuUsage;
+        uint32_t threadCount;
+        uint32_t generation;   // 0 marks an empty slot
+        int tag;
+    };
+
+    size_t FindSlot(const ProcessKey& key) const;
+    void EraseSlot(size_t slot);
+    void Grow();
+
+    std::vector<Entry> m_table;         // open addressing, linear probing, power-of-two size
+    std::vector<ProcessKey> m_removed;  // scratch list of keys to erase after a diff
+    size_t m_count;
+    uint32_t m_generation;
+};
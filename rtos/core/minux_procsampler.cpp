@@ -0,0 +1,144 @@
+#include "minux_procsampler.h"
+#include "minux_names.h"
+#ifdef _WIN32
+#include <tlhelp32.h>
+#include <psapi.h>
+
+#pragma comment(lib, "psapi.lib")
+
+// Passes to wait before retrying a process that refused OpenProcess
+#define PROCESS_RETRY_INTERVAL 30
+
+static ULONGLONG FileTimeToTicks(const FILETIME& ft) {
+    return ((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
+
+ProcessSampler::ProcessSampler() : m_generation(0) {
+    m_cpuCount = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    if (m_cpuCount == 0) m_cpuCount = 1;
+    QueryPerformanceFrequency(&m_frequency);
+}
+
+ProcessSampler::~ProcessSampler() {
+    Reset();
+}
+
+void ProcessSampler::Reset() {
+    for (auto& entry : m_cache) {
+        if (entry.second.handle) CloseHandle(entry.second.handle);
+    }
+    m_cache.clear();
+}
+
+size_t ProcessSampler::GetOpenHandleCount() const {
+    size_t count = 0;
+    for (const auto& entry : m_cache) {
+        if (entry.second.handle) count++;
+    }
+    return count;
+}
+
+// Open a long-lived handle; limited rights still allow CPU times for protected processes
+bool ProcessSampler::OpenCached(DWORD processId, CachedProcess& cached) {
+    cached.handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+    if (!cached.handle) {
+        cached.handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    }
+    if (!cached.handle) {
+        cached.retryGeneration = m_generation + PROCESS_RETRY_INTERVAL;
+        return false;
+    }
+
+    FILETIME createTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(cached.handle, &createTime, &exitTime, &kernelTime, &userTime)) {
+        cached.creationTime = FileTimeToTicks(createTime);
+    }
+    cached.sampleTime = 0;  // no CPU baseline yet
+    return true;
+}
+
+void ProcessSampler::SampleCached(CachedProcess& cached, ULONGLONG now, ProcessInfo& info) {
+    FILETIME createTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(cached.handle, &createTime, &exitTime, &kernelTime, &userTime)) {
+        ULONGLONG creationTime = FileTimeToTicks(createTime);
+        ULONGLONG cpuTime = FileTimeToTicks(kernelTime) + FileTimeToTicks(userTime);
+
+        // A different creation time means a new process behind the same PID: restart the baseline
+        if (creationTime != cached.creationTime) {
+            cached.creationTime = creationTime;
+            cached.sampleTime = 0;
+        }
+
+        if (cached.sampleTime != 0 && now > cached.sampleTime && cpuTime >= cached.cpuTime) {
+            ULONGLONG busy = (cpuTime - cached.cpuTime) * 10000;
+            ULONGLONG capacity = (now - cached.sampleTime) * m_cpuCount;
+            ULONGLONG usage = busy / capacity;
+            info.cpuUsage = (DWORD)(usage > 10000 ? 10000 : usage);
+        }
+        cached.cpuTime = cpuTime;
+        cached.sampleTime = now;
+        info.creationTime = creationTime;
+    }
+
+    PROCESS_MEMORY_COUNTERS pmc = {0};
+    if (GetProcessMemoryInfo(cached.handle, &pmc, sizeof(pmc))) {
+        info.workingSetSize = pmc.WorkingSetSize;
+    }
+}
+
+void ProcessSampler::Sample(std::vector<ProcessInfo>& processes) {
+    processes.clear();
+    m_generation++;
+
+    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (hSnapshot == INVALID_HANDLE_VALUE) return;
+
+    // Wall time in 100 ns units, the same unit as process times
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    ULONGLONG now = (ULONGLONG)(counter.QuadPart / m_frequency.QuadPart) * 10000000 +
+                    (ULONGLONG)(counter.QuadPart % m_frequency.QuadPart) * 10000000 / m_frequency.QuadPart;
+
+    PROCESSENTRY32W pe32 = {0};
+    pe32.dwSize = sizeof(pe32);
+
+    if (Process32FirstW(hSnapshot, &pe32)) {
+        do {
+            ProcessInfo info = {0};
+            info.processId = pe32.th32ProcessID;
+            info.nameId = InternName(pe32.szExeFile);
+            info.threadCount = pe32.cntThreads;
+            info.parentProcessId = pe32.th32ParentProcessID;
+
+            auto inserted = m_cache.emplace(pe32.th32ProcessID, CachedProcess());
+            CachedProcess& cached = inserted.first->second;
+            if (inserted.second) {
+                cached = CachedProcess();
+                OpenCached(pe32.th32ProcessID, cached);
+            } else if (!cached.handle && m_generation >= cached.retryGeneration) {
+                OpenCached(pe32.th32ProcessID, cached);
+            }
+            cached.generation = m_generation;
+
+            if (cached.handle) {
+                SampleCached(cached, now, info);
+            }
+
+            processes.push_back(info);
+        } while (Process32NextW(hSnapshot, &pe32));
+    }
+
+    CloseHandle(hSnapshot);
+
+    // Close handles of processes that have exited
+    m_exited.clear();
+    for (const auto& entry : m_cache) {
+        if (entry.second.generation != m_generation) m_exited.push_back(entry.first);
+    }
+    for (DWORD processId : m_exited) {
+        auto it = m_cache.find(processId);
+        if (it->second.handle) CloseHandle(it->second.handle);
+        m_cache.erase(it);
+    }
+}
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#include <unordered_map>
+#include <vector>
+#include "minux_types.h"
+
+// Minux Process Sampler (Win32 backend)
+// Enumerates processes and computes per-process CPU usage from kernel+user
+// time deltas. Process handles stay open across samples, so a steady-state
+// pass costs one GetProcessTimes and one GetProcessMemoryInfo per process
+// instead of an OpenProcess/CloseHandle pair. Not thread-safe; owned by the
+// collector thread.
+
+class ProcessSampler {
+public:
+    ProcessSampler();
+    ~ProcessSampler();
+
+    ProcessSampler(const ProcessSampler&) = delete;
+    ProcessSampler& operator=(const ProcessSampler&) = delete;
+
+    // Refill the vector with the current process list (reuses its capacity)
+    void Sample(std::vector<ProcessInfo>& processes);
+
+    // Close every cached handle
+    void Reset();
+
+    size_t GetOpenHandleCount() const;
+
+private:
+    struct CachedProcess {
+        HANDLE handle;              // NULL when OpenProcess was refused
+        ULONGLONG creationTime;     // FILETIME ticks; a change means the PID was reused
+        ULONGLONG cpuTime;          // kernel + user time at the last sample, 100 ns units
+        ULONGLONG sampleTime;       // wall time of the last sample, 100 ns units
+        DWORD generation;           // last pass that saw the PID
+        DWORD retryGeneration;      // next pass that may retry a refused OpenProcess
+    };
+
+    bool OpenCached(DWORD processId, CachedProcess& cached);
+    void SampleCached(CachedProcess& cached, ULONGLONG now, ProcessInfo& info);
+
+    std::unordered_map<DWORD, CachedProcess> m_cache;
+    std::vector<DWORD> m_exited;    // scratch list of PIDs to evict
+    DWORD m_generation;
+    DWORD m_cpuCount;
+    LARGE_INTEGER m_frequency;
+};
+#endif
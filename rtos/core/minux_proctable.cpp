@@ -0,0 +1,118 @@
+#include "minux_proctable.h"
+#include <cstring>
+
+void ProcessTable::Assign(const std::vector<ProcessInfo>& processes) {
+    size_t count = processes.size();
+    m_processIds.resize(count);
+    m_nameIds.resize(count);
+    m_workingSets.resize(count);
+    m_cpuUsages.resize(count);
+    m_threadCounts.resize(count);
+    m_creationTimes.resize(count);
+    m_parentProcessIds.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const ProcessInfo& info = processes[i];
+        m_processIds[i] = info.processId;
+        m_nameIds[i] = info.nameId;
+        m_workingSets[i] = info.workingSetSize;
+        m_cpuUsages[i] = info.cpuUsage;
+        m_threadCounts[i] = info.threadCount;
+        m_creationTimes[i] = info.creationTime;
+        m_parentProcessIds[i] = info.parentProcessId;
+    }
+}
+
+void ProcessTable::Clear() {
+    m_processIds.clear();
+    m_nameIds.clear();
+    m_workingSets.clear();
+    m_cpuUsages.clear();
+    m_threadCounts.clear();
+    m_creationTimes.clear();
+    m_parentProcessIds.clear();
+}
+
+ProcessInfo ProcessTable::GetRow(size_t row) const {
+    ProcessInfo info = ProcessInfo();
+    info.processId = m_processIds[row];
+    info.nameId = m_nameIds[row];
+    info.workingSetSize = m_workingSets[row];
+    info.cpuUsage = m_cpuUsages[row];
+    info.threadCount = m_threadCounts[row];
+    info.creationTime = m_creationTimes[row];
+    info.parentProcessId = m_parentProcessIds[row];
+    return info;
+}
+
+void ProcessTable::Gather(const std::vector<uint32_t>& order, std::vector<ProcessInfo>& processes) const {
+    processes.resize(order.size());
+    for (size_t i = 0; i < order.size(); i++) processes[i] = GetRow(order[i]);
+}
+
+// LSD radix sort of (m_keys[i], i) pairs, one byte per pass; m_keys ends up sorted too
+void ProcessSorter::RadixSort(std::vector<uint32_t>& order) {
+    std::vector<uint64_t>& keys = m_keys;
+    size_t count = keys.size();
+    order.resize(count);
+    for (size_t i = 0; i < count; i++) order[i] = (uint32_t)i;
+    if (count < 2) return;
+    m_keyScratch.resize(count);
+    m_orderScratch.resize(count);
+
+    // All eight histograms in one read of the keys
+    memset(m_histograms, 0, sizeof(m_histograms));
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = keys[i];
+        for (int digit = 0; digit < 8; digit++) m_histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+    }
+
+    for (int digit = 0; digit < 8; digit++) {
+        uint32_t* histogram = m_histograms[digit];
+        int shift = digit * 8;
+        if (histogram[(keys[0] >> shift) & 0xFF] == count) continue;     // every key has this byte
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint64_t key = keys[i];
+            uint32_t target = histogram[(key >> shift) & 0xFF]++;
+            m_keyScratch[target] = key;
+            m_orderScratch[target] = order[i];
+        }
+        keys.swap(m_keyScratch);
+        order.swap(m_orderScratch);
+    }
+}
+
+void ProcessSorter::Sort(const ProcessTable& table, ProcessSortKey key, bool descending, std::vector<uint32_t>& order) {
+    size_t count = table.GetRowCount();
+    m_keys.resize(count);
+    switch (key) {
+    case PROCESS_SORT_PID:
+        for (size_t i = 0; i < count; i++) m_keys[i] = table.GetProcessIds()[i];
+        break;
+    case PROCESS_SORT_WORKINGSET:
+        memcpy(m_keys.data(), table.GetWorkingSets().data(), count * sizeof(uint64_t));
+        break;
+    case PROCESS_SORT_CPU:
+        for (size_t i = 0; i < count; i++) m_keys[i] = table.GetCpuUsages()[i];
+        break;
+    case PROCESS_SORT_THREADS:
+        for (size_t i = 0; i < count; i++) m_keys[i] = table.GetThreadCounts()[i];
+        break;
+    }
+    // Descending is ascending on the complement; equal keys still keep row order
+    if (descending) {
+        for (uint64_t& value : m_keys) value = ~value;
+    }
+    RadixSort(order);
+}
+
+void ProcessSorter::SortKeys(const uint64_t* keys, size_t count, std::vector<uint32_t>& order) {
+    m_keys.assign(keys, keys + count);
+    RadixSort(order);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+
+// Minux Process Table
+// Columnar copy of a process snapshot: one array per field, so a sort or a
+// filter over one metric streams 4 or 8 bytes per process instead of whole
+// records. Sorting never moves rows; ProcessSorter produces a permutation
+// (order[i] is the row shown i-th) with an LSD radix sort over 64-bit keys.
+// Byte positions where every key agrees are skipped, so 32-bit columns take
+// at most four passes, and the sort is stable: ties keep snapshot order.
+
+// Sortable columns
+enum ProcessSortKey {
+    PROCESS_SORT_PID,
+    PROCESS_SORT_WORKINGSET,
+    PROCESS_SORT_CPU,
+    PROCESS_SORT_THREADS
+};
+
+class ProcessTable {
+public:
+    // Replace the contents with a snapshot's records (keeps capacity)
+    void Assign(const std::vector<ProcessInfo>& processes);
+    void Clear();
+
+    size_t GetRowCount() const { return m_processIds.size(); }
+    ProcessInfo GetRow(size_t row) const;
+
+    // Records in the given row order, e.g. a sorted permutation
+    void Gather(const std::vector<uint32_t>& order, std::vector<ProcessInfo>& processes) const;
+
+    const std::vector<uint32_t>& GetProcessIds() const { return m_processIds; }
+    const std::vector<NameId>& GetNameIds() const { return m_nameIds; }
+    const std::vector<uint64_t>& GetWorkingSets() const { return m_workingSets; }
+    const std::vector<uint32_t>& GetCpuUsages() const { return m_cpuUsages; }
+    const std::vector<uint32_t>& GetThreadCounts() const { return m_threadCounts; }
+    const std::vector<uint64_t>& GetCreationTimes() const { return m_creationTimes; }
+    const std::vector<uint32_t>& GetParentProcessIds() const { return m_parentProcessIds; }
+
+private:
+    std::vector<uint32_t> m_processIds;
+    std::vector<NameId> m_nameIds;
+    std::vector<uint64_t> m_workingSets;
+    std::vector<uint32_t> m_cpuUsages;
+    std::vector<uint32_t> m_threadCounts;
+    std::vector<uint64_t> m_creationTimes;
+    std::vector<uint32_t> m_parentProcessIds;
+};
+
+class ProcessSorter {
+public:
+    // Stable permutation of the table's rows by one column
+    void Sort(const ProcessTable& table, ProcessSortKey key, bool descending, std::vector<uint32_t>& order);
+
+    // Stable ascending permutation of keys[0..count-1]
+    void SortKeys(const uint64_t* keys, size_t count, std::vector<uint32_t>& order);
+
+private:
+    void RadixSort(std::vector<uint32_t>& order);
+
+    // Scratch kept between calls so steady-state sorting does not allocate
+    uint32_t m_histograms[8][256];
+    std::vector<uint64_t> m_keys;
+    std::vector<uint64_t> m_keyScratch;
+    std::vector<uint32_t> m_orderScratch;
+};
@@ -0,0 +1,242 @@
+#include "minux_proctree.h"
+#include <algorithm>
+
+// One process on its own
+static ProcessTreeTotals GetOwnTotals(const ProcessInfo& info) {
+    ProcessTreeTotals totals = { info.workingSetSize, info.cpuUsage, info.threadCount, 1 };
+    return totals;
+}
+
+// Unsigned wrap-around turns a subtraction into the addition of a negated delta
+static ProcessTreeTotals Negate(const ProcessTreeTotals& totals) {
+    ProcessTreeTotals negated = { 0 - totals.workingSetSize, 0 - totals.cpuUsage, 0 - totals.threadCount, 0 - totals.processCount };
+    return negated;
+}
+
+ProcessTree::ProcessTree() : m_rowsDirty(false) {
+    Clear();
+}
+
+void ProcessTree::Clear() {
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_byProcessId.clear();
+    m_rows.clear();
+    m_rowsDirty = false;
+    m_diff.Reset();
+
+    Node root = {};
+    root.parent = -1;
+    root.firstChild = root.lastChild = -1;
+    root.previousSibling = root.nextSibling = -1;
+    root.depth = -1;
+    root.expanded = true;
+    m_nodes.push_back(root);
+}
+
+int ProcessTree::AllocateNode(const ProcessInfo& info) {
+    int node;
+    if (!m_freeNodes.empty()) {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    } else {
+        node = (int)m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+
+    Node& entry = m_nodes[node];
+    entry.info = info;
+    entry.totals = GetOwnTotals(info);
+    entry.parent = -1;
+    entry.firstChild = entry.lastChild = -1;
+    entry.previousSibling = entry.nextSibling = -1;
+    entry.depth = 0;
+    entry.expanded = true;
+    return node;
+}
+
+void ProcessTree::FreeNode(int node) {
+    m_nodes[node].parent = -1;
+    m_freeNodes.push_back(node);
+}
+
+// Add the delta to the node and every ancestor above it
+void ProcessTree::AddToChain(int node, const ProcessTreeTotals& delta) {
+    while (node >= 0) {
+        ProcessTreeTotals& totals = m_nodes[node].totals;
+        totals.workingSetSize += delta.workingSetSize;
+        totals.cpuUsage += delta.cpuUsage;
+        totals.threadCount += delta.threadCount;
+        totals.processCount += delta.processCount;
+        node = m_nodes[node].parent;
+    }
+}
+
+// Append an unlinked subtree under parent and roll its totals up
+void ProcessTree::Attach(int node, int parent) {
+    Node& child = m_nodes[node];
+    Node& owner = m_nodes[parent];
+    child.parent = parent;
+    child.nextSibling = -1;
+    child.previousSibling = owner.lastChild;
+    if (owner.lastChild >= 0) m_nodes[owner.lastChild].nextSibling = node;
+    else owner.firstChild = node;
+    owner.lastChild = node;
+
+    AddToChain(parent, child.totals);
+    m_rowsDirty = true;
+}
+
+// Unlink a subtree from its parent and take its totals back out
+void ProcessTree::Detach(int node) {
+    Node& child = m_nodes[node];
+    if (child.parent < 0) return;
+
+    AddToChain(child.parent, Negate(child.totals));
+    Node& owner = m_nodes[child.parent];
+    if (child.previousSibling >= 0) m_nodes[child.previousSibling].nextSibling = child.nextSibling;
+    else owner.firstChild = child.nextSibling;
+    if (child.nextSibling >= 0) m_nodes[child.nextSibling].previousSibling = child.previousSibling;
+    else owner.lastChild = child.previousSibling;
+
+    child.parent = -1;
+    child.previousSibling = child.nextSibling = -1;
+    m_rowsDirty = true;
+}
+
+// A parent must have started no later than the child and must not sit below it
+bool ProcessTree::CanAdopt(int parent, int child) const {
+    if (parent == child || m_nodes[parent].info.creationTime > m_nodes[child].info.creationTime) return false;
+    for (int node = m_nodes[parent].parent; node > 0; node = m_nodes[node].parent) {
+        if (node == child) return false;
+    }
+    return true;
+}
+
+void ProcessTree::LinkToParent(int node) {
+    const ProcessInfo& info = m_nodes[node].info;
+    uint32_t parentId = info.parentProcessId;
+    if (parentId != 0 && parentId != info.processId) {
+        auto found = m_byProcessId.find(parentId);
+        if (found != m_byProcessId.end() && CanAdopt(found->second, node)) {
+            Attach(node, found->second);
+            return;
+        }
+    }
+    Attach(node, 0);
+}
+
+// Drop a process; its children keep their subtrees and become roots
+void ProcessTree::RemoveNode(int node) {
+    Detach(node);
+
+    int child = m_nodes[node].firstChild;
+    while (child >= 0) {
+        int next = m_nodes[child].nextSibling;
+        m_nodes[child].parent = -1;
+        m_nodes[child].previousSibling = m_nodes[child].nextSibling = -1;
+        Attach(child, 0);
+        child = next;
+    }
+    m_nodes[node].firstChild = m_nodes[node].lastChild = -1;
+
+    auto found = m_byProcessId.find(m_nodes[node].info.processId);
+    if (found != m_byProcessId.end() && found->second == node) m_byProcessId.erase(found);
+    FreeNode(node);
+}
+
+void ProcessTree::Update(const std::vector<ProcessInfo>& processes) {
+    m_diff.Diff(processes, m_changes);
+
+    // Exits first, so a reused PID maps to the new process below
+    for (const ProcessChange& change : m_changes) {
+        if (change.type == PROCESS_REMOVED && change.tag > 0) RemoveNode(change.tag);
+    }
+
+    m_added.clear();
+    for (const ProcessChange& change : m_changes) {
+        if (change.type == PROCESS_REMOVED) continue;
+        const ProcessInfo& info = processes[change.index];
+        if (change.type == PROCESS_CHANGED && change.tag > 0) {
+            Node& node = m_nodes[change.tag];
+            ProcessTreeTotals delta = {
+                info.workingSetSize - node.info.workingSetSize,
+                (uint64_t)info.cpuUsage - node.info.cpuUsage,
+                (uint64_t)info.threadCount - node.info.threadCount,
+                0
+            };
+            node.info = info;
+            AddToChain(change.tag, delta);
+        } else if (change.type == PROCESS_ADDED) {
+            int node = AllocateNode(info);
+            m_diff.SetTag(change.key, node);
+            m_byProcessId[info.processId] = node;
+            m_added.push_back(node);
+        }
+    }
+
+    // Link the newcomers once all of them are known: a parent may come later in the snapshot
+    for (int node : m_added) {
+        LinkToParent(node);
+    }
+    if (m_rowsDirty) RebuildRows();
+}
+
+// A collapse or expand splices the node's visible subtree out of or into the rows
+void ProcessTree::SetExpanded(int node, bool expanded) {
+    Node& entry = m_nodes[node];
+    if (entry.expanded == expanded) return;
+    entry.expanded = expanded;
+    if (entry.firstChild < 0) return;
+    if (m_rowsDirty) {
+        RebuildRows();
+        return;
+    }
+
+    auto row = std::find(m_rows.begin(), m_rows.end(), node);
+    if (row == m_rows.end()) return;      // under a collapsed ancestor
+    ++row;
+    if (expanded) {
+        m_added.clear();
+        AppendRows(node, m_added);
+        m_rows.insert(row, m_added.begin(), m_added.end());
+    } else {
+        auto end = row;
+        while (end != m_rows.end() && m_nodes[*end].depth > entry.depth) ++end;
+        m_rows.erase(row, end);
+    }
+}
+
+void ProcessTree::SetAllExpanded(bool expanded) {
+    for (size_t node = 1; node < m_nodes.size(); node++) {
+        m_nodes[node].expanded = expanded;
+    }
+    RebuildRows();
+}
+
+// Pre-order walk of the expanded nodes below 'top', without recursion
+void ProcessTree::AppendRows(int top, std::vector<int>& rows) {
+    int node = m_nodes[top].firstChild;
+    int depth = m_nodes[top].depth + 1;
+    while (node >= 0 && node != top) {
+        Node& entry = m_nodes[node];
+        entry.depth = depth;
+        rows.push_back(node);
+        if (entry.expanded && entry.firstChild >= 0) {
+            node = entry.firstChild;
+            depth++;
+            continue;
+        }
+        while (node != top && m_nodes[node].nextSibling < 0) {
+            node = m_nodes[node].parent;
+            depth--;
+        }
+        if (node != top) node = m_nodes[node].nextSibling;
+    }
+}
+
+void ProcessTree::RebuildRows() {
+    m_rows.clear();
+    m_rowsDirty = false;
+    AppendRows(0, m_rows);
+}
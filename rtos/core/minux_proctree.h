@@ -0,0 +1,88 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include "minux_types.h"
+#include "minux_procdiff.h"
+
+// Minux Process Tree
+// Parent/child view of the process list with CPU, working set and thread
+// totals rolled up over every subtree. The tree follows the snapshots
+// through a ProcessDiffEngine: only added, exited and changed processes are
+// touched, and a change is pushed up the node's ancestors (O(depth)) rather
+// than recomputing any sum. A parent is the live process with the child's
+// parent PID that started no later than the child, so a reused PID never
+// adopts another process's children. Children of an exited process become
+// roots with their subtrees intact; so does a process whose parent is not
+// in the same snapshot, as a later parent cannot have started before it.
+//
+// Display rows are the expanded part of the tree in pre-order. A snapshot
+// that adds or removes processes rebuilds them in one walk of the visible
+// nodes; collapsing or expanding a node only splices its visible subtree
+// out of or into the row list.
+
+struct ProcessTreeTotals {
+    uint64_t workingSetSize;    // bytes
+    uint64_t cpuUsage;          // hundredths of a percent
+    uint64_t threadCount;
+    uint32_t processCount;      // the process itself included
+};
+
+class ProcessTree {
+public:
+    ProcessTree();
+
+    // Bring the tree to a new snapshot
+    void Update(const std::vector<ProcessInfo>& processes);
+    void Clear();
+
+    size_t GetProcessCount() const { return m_byProcessId.size(); }
+    const ProcessTreeTotals& GetTotals() const { return m_nodes[0].totals; }     // every process
+
+    // Nodes on screen, top to bottom
+    const std::vector<int>& GetRows() const { return m_rows; }
+
+    // Node queries; 'node' is a value from GetRows or FindNode
+    const ProcessInfo& GetProcess(int node) const { return m_nodes[node].info; }
+    const ProcessTreeTotals& GetTotals(int node) const { return m_nodes[node].totals; }
+    int GetDepth(int node) const { return m_nodes[node].depth; }    // as of the last row rebuild
+    int GetParent(int node) const { return m_nodes[node].parent > 0 ? m_nodes[node].parent : -1; }
+    bool HasChildren(int node) const { return m_nodes[node].firstChild >= 0; }
+    bool IsExpanded(int node) const { return m_nodes[node].expanded; }
+    int FindNode(const ProcessKey& key) const { return m_diff.GetTag(key); }
+
+    void SetExpanded(int node, bool expanded);
+    void SetAllExpanded(bool expanded);
+
+private:
+    struct Node {
+        ProcessInfo info;
+        ProcessTreeTotals totals;   // this process and all its descendants
+        int parent;                 // 0 for roots, -1 while unlinked or free
+        int firstChild;
+        int lastChild;
+        int previousSibling;
+        int nextSibling;
+        int depth;
+        bool expanded;
+    };
+
+    int AllocateNode(const ProcessInfo& info);
+    void FreeNode(int node);
+    void AddToChain(int node, const ProcessTreeTotals& delta);
+    void Attach(int node, int parent);
+    void Detach(int node);
+    bool CanAdopt(int parent, int child) const;
+    void LinkToParent(int node);
+    void RemoveNode(int node);
+    void AppendRows(int top, std::vector<int>& rows);
+    void RebuildRows();
+
+    std::vector<Node> m_nodes;                  // m_nodes[0] is the hidden root above every tree
+    std::vector<int> m_freeNodes;
+    std::unordered_map<uint32_t, int> m_byProcessId;
+    std::vector<int> m_added;                   // scratch for new nodes and spliced rows
+    std::vector<int> m_rows;
+    bool m_rowsDirty;
+    ProcessDiffEngine m_diff;                   // tags are node indices
+    std::vector<ProcessChange> m_changes;
+};
@@ -0,0 +1,292 @@
+#include "minux_procview.h"
+#include "minux_names.h"
+#include <algorithm>
+#include <cwchar>
+#include <cstring>
+
+ProcessTableModel::ProcessTableModel()
+    : m_processes(NULL), m_orderedCount(0), m_sortColumn(PROCESS_COLUMN_COUNT), m_sortDescending(false),
+      m_rankTarget(kRankHeadroom), m_rankedRows(0), m_direct(true), m_treeMode(false) {
+    memset(m_cache, 0, sizeof(m_cache));
+}
+
+void ProcessTableModel::SetProcesses(const std::vector<ProcessInfo>* processes, size_t orderedCount) {
+    // Cached rows stay usable: each slot re-validates against its record on access
+    m_processes = processes;
+    m_orderedCount = orderedCount;
+    if (m_treeMode) {
+        if (processes) m_tree.Update(*processes);
+        else m_tree.Clear();
+    }
+    ApplyFilter(false);
+    Rank(m_rankTarget);
+}
+
+bool ProcessTableModel::SetFilter(const wchar_t* query, size_t* errorOffset) {
+    if (!m_filter.SetQuery(query, errorOffset)) return false;
+    ApplyFilter(m_filter.LastQueryNarrowed());      // a narrower query keeps a subset of the rows shown
+    Rank(m_rankTarget);
+    return true;
+}
+
+void ProcessTableModel::ApplyFilter(bool refine) {
+    if (!m_filter.IsActive() || !m_processes) {
+        m_filterRows.clear();
+        m_filteredTree.clear();
+    } else if (m_treeMode) {
+        FilterTreeRows();
+    } else if (refine) {
+        m_filter.Refine(*m_processes, m_filterRows);
+    } else {
+        m_filter.Apply(*m_processes, m_filterRows);
+    }
+}
+
+// Matching tree rows, each preceded by whichever of its ancestors are not shown yet
+void ProcessTableModel::FilterTreeRows() {
+    m_filteredTree.clear();
+    m_treePath.clear();
+    size_t shown = 0;       // m_treePath[0..shown) are rows already
+    for (int node : m_tree.GetRows()) {
+        size_t depth = (size_t)m_tree.GetDepth(node);
+        m_treePath.resize(depth);
+        if (shown > depth) shown = depth;
+        m_treePath.push_back(node);
+        if (m_filter.Matches(m_tree.GetProcess(node))) {
+            m_filteredTree.insert(m_filteredTree.end(), m_treePath.begin() + shown, m_treePath.end());
+            shown = m_treePath.size();
+        }
+    }
+}
+
+void ProcessTableModel::SetTreeMode(bool treeMode) {
+    if (treeMode == m_treeMode) return;
+    m_treeMode = treeMode;
+    m_tree.Clear();
+    if (treeMode && m_processes) m_tree.Update(*m_processes);
+    ApplyFilter(false);
+    for (CachedRow& slot : m_cache) slot.valid = false;     // same keys, different rows
+    Rank(m_rankTarget);
+}
+
+bool ProcessTableModel::IsRowExpandable(size_t row) const {
+    return m_treeMode && row < GetRowCount() && m_tree.HasChildren(GetTreeRows()[row]);
+}
+
+bool ProcessTableModel::IsRowExpanded(size_t row) const {
+    return IsRowExpandable(row) && m_tree.IsExpanded(GetTreeRows()[row]);
+}
+
+bool ProcessTableModel::SetRowExpanded(size_t row, bool expanded) {
+    if (!IsRowExpandable(row) || IsRowExpanded(row) == expanded) return false;
+    m_tree.SetExpanded(GetTreeRows()[row], expanded);
+    if (m_filter.IsActive()) FilterTreeRows();
+    for (CachedRow& slot : m_cache) slot.valid = false;
+    Rank(m_rankTarget);
+    return true;
+}
+
+void ProcessTableModel::SetAllExpanded(bool expanded) {
+    if (!m_treeMode) return;
+    m_tree.SetAllExpanded(expanded);
+    if (m_filter.IsActive()) FilterTreeRows();
+    for (CachedRow& slot : m_cache) slot.valid = false;
+    Rank(m_rankTarget);
+}
+
+// The nearest row above with a smaller depth
+ptrdiff_t ProcessTableModel::GetParentRow(size_t row) const {
+    if (!m_treeMode || row >= GetRowCount()) return -1;
+    const std::vector<int>& rows = GetTreeRows();
+    int depth = m_tree.GetDepth(rows[row]);
+    while (row-- > 0) {
+        if (m_tree.GetDepth(rows[row]) < depth) return (ptrdiff_t)row;
+    }
+    return -1;
+}
+
+void ProcessTableModel::SetWindow(size_t first, size_t last) {
+    if (first > last) last = first;
+    size_t target = last + 1 + kRankHeadroom;
+    if (target != m_rankTarget) Rank(target);
+}
+
+void ProcessTableModel::SetSort(int column, bool descending) {
+    m_sortColumn = column;
+    m_sortDescending = descending;
+    m_selector.Reset();
+    Rank(m_rankTarget);
+}
+
+ProcessInfo ProcessTableModel::GetRecord(size_t row) const {
+    if (!m_treeMode) return (*m_processes)[m_direct ? GetSnapshotRow(row) : m_order[row]];
+
+    // A collapsed parent stands for its whole subtree
+    int node = GetTreeRows()[row];
+    ProcessInfo info = m_tree.GetProcess(node);
+    if (m_tree.HasChildren(node) && !m_tree.IsExpanded(node)) {
+        const ProcessTreeTotals& totals = m_tree.GetTotals(node);
+        info.workingSetSize = totals.workingSetSize;
+        info.cpuUsage = (uint32_t)std::min<uint64_t>(totals.cpuUsage, 0xFFFFFFFFu);
+        info.threadCount = (uint32_t)std::min<uint64_t>(totals.threadCount, 0xFFFFFFFFu);
+    }
+    return info;
+}
+
+// "  - name" for an expanded parent, "  + name (12)" for a collapsed one
+const wchar_t* ProcessTableModel::GetTreeName(size_t row) {
+    int node = GetTreeRows()[row];
+    size_t indent = (size_t)std::min(m_tree.GetDepth(node), 32) * 2;
+    wchar_t* p = m_treeName;
+    wmemset(p, L' ', indent);
+    p += indent;
+
+    bool parent = m_tree.HasChildren(node);
+    bool collapsed = parent && !m_tree.IsExpanded(node);
+    *p++ = !parent ? L' ' : collapsed ? L'+' : L'-';
+    *p++ = L' ';
+
+    const wchar_t* name = GetName(m_tree.GetProcess(node).nameId);
+    size_t length = std::min(wcslen(name), (size_t)MINUX_MAX_NAME - 1);
+    wmemcpy(p, name, length);
+    p += length;
+    if (collapsed) {
+        *p++ = L' ';
+        *p++ = L'(';
+        p += FormatUnsigned(m_tree.GetTotals(node).processCount, p);
+        *p++ = L')';
+    }
+    *p = L'\0';
+    return m_treeName;
+}
+
+// Put the first 'rows' view rows in order; the rest stay unranked until asked for
+void ProcessTableModel::Rank(size_t rows) {
+    m_rankTarget = rows;
+    m_order.clear();
+    m_direct = true;
+    m_rankedRows = 0;
+    size_t count = GetRowCount();
+    if (count == 0) return;
+    if (m_treeMode) {
+        m_rankedRows = count;     // the tree's rows are already in display order
+        return;
+    }
+    if (rows > count) rows = count;
+
+    // Matches inside the collector's ranked prefix are the heaviest matches, in order
+    size_t ordered = m_orderedCount;
+    if (m_filter.IsActive()) {
+        ordered = std::lower_bound(m_filterRows.begin(), m_filterRows.end(), m_orderedCount) - m_filterRows.begin();
+    }
+    bool byWorkingSet = m_sortColumn < 0 || m_sortColumn >= PROCESS_COLUMN_COUNT;
+    if (byWorkingSet && rows <= ordered) {
+        m_rankedRows = ordered < count ? ordered : count;
+        return;
+    }
+
+    const std::vector<ProcessInfo>& processes = *m_processes;
+    m_direct = false;
+    if (m_sortColumn == PROCESS_COLUMN_NAME) {
+        // Names are IDs in first-seen order, so this one compares text
+        bool descending = m_sortDescending;
+        m_order.resize(count);
+        for (size_t i = 0; i < count; i++) m_order[i] = (uint32_t)GetSnapshotRow(i);
+        std::partial_sort(m_order.begin(), m_order.begin() + rows, m_order.end(),
+                          [&processes, descending](uint32_t a, uint32_t b) {
+            NameId nameA = processes[a].nameId, nameB = processes[b].nameId;
+            int compare = nameA == nameB ? 0 : wcscmp(GetName(nameA), GetName(nameB));
+            if (compare == 0) return a < b;
+            return descending ? compare > 0 : compare < 0;
+        });
+        m_order.resize(rows);
+    } else {
+        // Largest key first; ascending sorts select on the complement
+        bool complement = !byWorkingSet && !m_sortDescending;
+        m_keys.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            const ProcessInfo& info = processes[GetSnapshotRow(i)];
+            uint64_t key = m_sortColumn == PROCESS_COLUMN_PID ? info.processId :
+                           m_sortColumn == PROCESS_COLUMN_CPU ? info.cpuUsage : info.workingSetSize;
+            m_keys[i] = complement ? ~key : key;
+        }
+        m_selector.Select(m_keys.data(), count, rows, m_order);
+        if (m_filter.IsActive()) {
+            for (uint32_t& row : m_order) row = m_filterRows[row];
+        }
+    }
+    m_rankedRows = m_order.size();
+}
+
+void ProcessTableModel::EnsureRanked(size_t row) {
+    if (row >= m_rankedRows && row < GetRowCount()) Rank(row + 1 + kRankHeadroom);
+}
+
+bool ProcessTableModel::SlotMatches(const CachedRow& slot, size_t row) const {
+    if (!slot.valid || slot.row != row || row >= m_rankedRows) return false;
+    ProcessInfo info = GetRecord(row);
+    return slot.key == MakeProcessKey(info) &&
+           slot.memory.value == info.workingSetSize &&
+           slot.cpu.value == info.cpuUsage;
+}
+
+ProcessTableModel::CachedRow& ProcessTableModel::FormatRow(size_t row) {
+    EnsureRanked(row);
+    CachedRow& slot = m_cache[row & (kCacheRows - 1)];
+    if (SlotMatches(slot, row)) return slot;
+
+    ProcessInfo info = GetRecord(row);
+    slot.row = row;
+    slot.key = MakeProcessKey(info);
+    slot.valid = true;
+    // Only the cells whose value moved are formatted again
+    FormatCellText(slot.pid, info.processId, FormatUnsigned);
+    FormatCellText(slot.memory, info.workingSetSize, FormatMegabytes);
+    FormatCellText(slot.cpu, info.cpuUsage, FormatHundredths);
+    return slot;
+}
+
+const wchar_t* ProcessTableModel::GetCellText(size_t row, int column) {
+    if (row >= GetRowCount()) return L"";
+
+    if (column == PROCESS_COLUMN_NAME) {
+        if (m_treeMode) return GetTreeName(row);
+        EnsureRanked(row);
+        return GetName(GetRecord(row).nameId);
+    }
+
+    CachedRow& slot = FormatRow(row);
+    switch (column) {
+    case PROCESS_COLUMN_PID:    return slot.pid.text;
+    case PROCESS_COLUMN_MEMORY: return slot.memory.text;
+    case PROCESS_COLUMN_CPU:    return slot.cpu.text;
+    default:                    return L"";
+    }
+}
+
+size_t ProcessTableModel::CopyCellText(size_t row, int column, wchar_t* buffer, size_t capacity) {
+    if (!buffer || capacity == 0) return 0;
+
+    const wchar_t* text = GetCellText(row, column);
+    size_t length = wcslen(text);
+    if (length >= capacity) length = capacity - 1;
+    wmemcpy(buffer, text, length);
+    buffer[length] = L'\0';
+    return length;
+}
+
+void ProcessTableModel::PrepareRows(size_t first, size_t last) {
+    size_t count = GetRowCount();
+    if (count == 0 || first >= count || first > last) return;
+    if (last >= count) last = count - 1;
+    if (last - first >= kCacheRows) last = first + kCacheRows - 1;
+
+    for (size_t row = first; row <= last; row++) {
+        FormatRow(row);
+    }
+}
+
+bool ProcessTableModel::IsRowCurrent(size_t row) const {
+    if (row >= GetRowCount()) return false;
+    return SlotMatches(m_cache[row & (kCacheRows - 1)], row);
+}
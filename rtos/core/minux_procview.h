@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+#include "minux_procdiff.h"
+#include "minux_format.h"
+#include "minux_topk.h"
+#include "minux_proctree.h"
+#include "minux_filter.h"
+
+// Minux Process Table Model
+// Data provider for the owner-data (virtual) process list. The control only
+// stores the row count; cell text is produced on demand from the current
+// snapshot, with a small direct-mapped cache of formatted rows whose cells
+// are re-formatted only when their value changes.
+//
+// Rows are ordered by working set, descending, or by the column sort, but
+// only as far down as the view has looked: the model ranks the top rows up
+// to the visible window plus some headroom with a top-K selection and
+// extends the ranking when a lower row is asked for. Rows the collector
+// already ranked in the snapshot are used as they are.
+//
+// In tree mode the rows are the expanded part of a ProcessTree instead,
+// parents above their children, and a collapsed parent shows the memory
+// and CPU of its whole subtree. Column sorting does not apply there.
+//
+// A filter query (see minux_filter.h) limits the rows to the matching
+// processes; in tree mode the ancestors of a match stay as its context.
+// Each snapshot is filtered in one pass over its records, and a query that
+// narrows the previous one only re-tests the rows already shown.
+
+// Process list columns
+enum ProcessColumn {
+    PROCESS_COLUMN_NAME,
+    PROCESS_COLUMN_PID,
+    PROCESS_COLUMN_MEMORY,
+    PROCESS_COLUMN_CPU,
+    PROCESS_COLUMN_COUNT
+};
+
+class ProcessTableModel {
+public:
+    ProcessTableModel();
+
+    // Show a new snapshot whose first 'orderedCount' records are by working
+    // set, descending. The vector must stay alive until the next call.
+    void SetProcesses(const std::vector<ProcessInfo>* processes, size_t orderedCount = (size_t)-1);
+
+    // Rows on screen; rows down to 'last' plus headroom are kept ranked
+    void SetWindow(size_t first, size_t last);
+
+    size_t GetRowCount() const {
+        return m_treeMode ? GetTreeRows().size() : m_filter.IsActive() ? m_filterRows.size() : m_processes ? m_processes->size() : 0;
+    }
+
+    // Show only processes matching the query; false (and the filter unchanged) if it does not parse
+    bool SetFilter(const wchar_t* query, size_t* errorOffset = NULL);
+    bool IsFiltered() const { return m_filter.IsActive(); }
+
+    // Order rows by a column; PROCESS_COLUMN_COUNT restores working-set order
+    void SetSort(int column, bool descending);
+    int GetSortColumn() const { return m_sortColumn; }
+    bool IsSortDescending() const { return m_sortDescending; }
+
+    // Parent/child rows; the tree is kept up to date only while this is on
+    void SetTreeMode(bool treeMode);
+    bool IsTreeMode() const { return m_treeMode; }
+    const ProcessTree& GetTree() const { return m_tree; }
+
+    // Tree rows; these return false (or -1) for rows that are not tree rows
+    bool IsRowExpandable(size_t row) const;
+    bool IsRowExpanded(size_t row) const;
+    bool SetRowExpanded(size_t row, bool expanded);     // true if the rows changed
+    void SetAllExpanded(bool expanded);
+    ptrdiff_t GetParentRow(size_t row) const;
+
+    // Cell text for the current snapshot; the pointer is valid until the
+    // row's cache slot is reused or the snapshot changes
+    const wchar_t* GetCellText(size_t row, int column);
+
+    // Copy cell text into a caller buffer (LVN_GETDISPINFO); returns the length written
+    size_t CopyCellText(size_t row, int column, wchar_t* buffer, size_t capacity);
+
+    // Format rows ahead of painting (LVN_ODCACHEHINT)
+    void PrepareRows(size_t first, size_t last);
+
+    // False when the row shows a different process or different values than
+    // the cached text, i.e. it needs repainting after SetProcesses
+    bool IsRowCurrent(size_t row) const;
+
+private:
+    static const size_t kCacheRows = 128;   // power of two, larger than any visible page
+    static const size_t kRankHeadroom = 64; // rows ranked below the window, for scrolling
+
+    struct CachedRow {
+        size_t row;
+        ProcessKey key;
+        bool valid;
+        FormatCell pid;
+        FormatCell memory;
+        FormatCell cpu;
+    };
+
+    const std::vector<int>& GetTreeRows() const { return m_filter.IsActive() ? m_filteredTree : m_tree.GetRows(); }
+    size_t GetSnapshotRow(size_t row) const { return m_filter.IsActive() ? m_filterRows[row] : row; }
+    void ApplyFilter(bool refine);
+    void FilterTreeRows();
+    ProcessInfo GetRecord(size_t row) const;
+    const wchar_t* GetTreeName(size_t row);
+    void Rank(size_t rows);
+    void EnsureRanked(size_t row);
+    bool SlotMatches(const CachedRow& slot, size_t row) const;
+    CachedRow& FormatRow(size_t row);
+
+    const std::vector<ProcessInfo>* m_processes;
+    size_t m_orderedCount;
+    int m_sortColumn;
+    bool m_sortDescending;
+    size_t m_rankTarget;                    // rows the view wants ranked
+    size_t m_rankedRows;                    // view rows with a known record
+    bool m_direct;                          // view row == snapshot row
+    std::vector<uint32_t> m_order;          // view row -> snapshot row, unless m_direct
+    std::vector<uint64_t> m_keys;
+    TopKSelector m_selector;
+    bool m_treeMode;
+    ProcessTree m_tree;
+    wchar_t m_treeName[MINUX_MAX_NAME + 96];    // indent, marker, name and subtree size
+    ProcessFilter m_filter;
+    std::vector<uint32_t> m_filterRows;     // matching snapshot rows, in snapshot order
+    std::vector<int> m_filteredTree;        // matching tree rows and their ancestors
+    std::vector<int> m_treePath;
+    CachedRow m_cache[kCacheRows];
+};
@@ -0,0 +1,600 @@
+#include "minux_recording.h"
+#include "minux_names.h"
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// File layout (little-endian):
+//   segment header  magic "MXRS", version, segment number, reserved
+//   record          magic "MXRR", payload length, payload CRC-32, reserved, payload
+//   index           (timestamp, offset) pairs
+//   index trailer   index offset, entry count, index CRC-32, magic "MXRI", reserved
+#define RECORDING_SEGMENT_MAGIC 0x5352584D     // "MXRS"
+#define RECORDING_RECORD_MAGIC  0x5252584D     // "MXRR"
+#define RECORDING_INDEX_MAGIC   0x4952584D     // "MXRI"
+#define RECORDING_VERSION       1
+#define RECORDING_HEADER_BYTES  16
+#define RECORDING_TRAILER_BYTES 24
+#define RECORDING_ENTRY_BYTES   16
+
+// CRC-32 (IEEE), table built on first use
+static uint32_t Crc32(const uint8_t* data, size_t size) {
+    static const struct CrcTable {
+        uint32_t entries[256];
+        CrcTable() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+                entries[i] = crc;
+            }
+        }
+    } table;
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static inline void Put32(std::vector<uint8_t>& out, uint32_t value) {
+    uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+static inline void Put16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back((uint8_t)value);
+    out.push_back((uint8_t)(value >> 8));
+}
+
+static inline void Put64(std::vector<uint8_t>& out, uint64_t value) {
+    Put32(out, (uint32_t)value);
+    Put32(out, (uint32_t)(value >> 32));
+}
+
+static inline uint32_t Get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t Get64(const uint8_t* p) {
+    return (uint64_t)Get32(p) | ((uint64_t)Get32(p + 4) << 32);
+}
+
+// Length-prefixed UTF-16; wchar_t is UTF-16 on Windows and UTF-32 elsewhere
+static void PutString(std::vector<uint8_t>& out, const wchar_t* text, size_t capacity) {
+    size_t lengthAt = out.size();
+    out.push_back(0);
+    out.push_back(0);
+
+    uint32_t units = 0;
+    for (size_t i = 0; i < capacity && text[i]; i++) {
+        uint32_t codepoint = (uint32_t)text[i];
+        if (sizeof(wchar_t) == 4 && codepoint >= 0x10000) {
+            codepoint -= 0x10000;
+            uint16_t high = (uint16_t)(0xD800 + (codepoint >> 10));
+            uint16_t low = (uint16_t)(0xDC00 + (codepoint & 0x3FF));
+            out.push_back((uint8_t)high);
+            out.push_back((uint8_t)(high >> 8));
+            out.push_back((uint8_t)low);
+            out.push_back((uint8_t)(low >> 8));
+            units += 2;
+        } else {
+            out.push_back((uint8_t)codepoint);
+            out.push_back((uint8_t)(codepoint >> 8));
+            units++;
+        }
+    }
+    out[lengthAt] = (uint8_t)units;
+    out[lengthAt + 1] = (uint8_t)(units >> 8);
+}
+
+// Bounds-checked payload reader
+struct PayloadReader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool failed;
+
+    bool Has(size_t bytes) {
+        if ((size_t)(end - pos) < bytes) failed = true;
+        return !failed;
+    }
+    uint32_t Read32() {
+        if (!Has(4)) return 0;
+        uint32_t value = Get32(pos);
+        pos += 4;
+        return value;
+    }
+    uint64_t Read64() {
+        if (!Has(8)) return 0;
+        uint64_t value = Get64(pos);
+        pos += 8;
+        return value;
+    }
+    uint16_t Read16() {
+        if (!Has(2)) return 0;
+        uint16_t value = (uint16_t)(pos[0] | (pos[1] << 8));
+        pos += 2;
+        return value;
+    }
+    uint8_t Read8() {
+        if (!Has(1)) return 0;
+        return *pos++;
+    }
+    void ReadString(wchar_t* text, size_t capacity) {
+        size_t written = 0;
+        if (Has(2)) {
+            uint32_t units = (uint32_t)pos[0] | ((uint32_t)pos[1] << 8);
+            pos += 2;
+            if (Has((size_t)units * 2)) {
+                for (uint32_t i = 0; i < units; i++) {
+                    uint32_t unit = (uint32_t)pos[i * 2] | ((uint32_t)pos[i * 2 + 1] << 8);
+                    if (sizeof(wchar_t) == 4 && unit >= 0xD800 && unit < 0xDC00 && i + 1 < units) {
+                        uint32_t low = (uint32_t)pos[i * 2 + 2] | ((uint32_t)pos[i * 2 + 3] << 8);
+                        if (low >= 0xDC00 && low < 0xE000) {
+                            unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                            i++;
+                        }
+                    }
+                    if (written + 1 < capacity) text[written++] = (wchar_t)unit;
+                }
+                pos += (size_t)units * 2;
+            }
+        }
+        text[written] = L'\0';
+    }
+};
+
+static void EncodeSnapshot(const MinuxSnapshot& snapshot, std::vector<uint8_t>& out) {
+    Put64(out, snapshot.timestamp);
+    Put64(out, snapshot.sequence);
+
+    const SystemInfo& system = snapshot.system;
+    Put32(out, system.cpuUsage);
+    Put32(out, system.memoryUsage);
+    Put32(out, system.processCount);
+    Put32(out, system.threadCount);
+    Put64(out, system.uptime);
+    PutString(out, system.computerName, MINUX_MAX_COMPUTER_NAME);
+    PutString(out, system.osVersion, 256);
+
+    Put32(out, (uint32_t)snapshot.processes.size());
+    for (const ProcessInfo& info : snapshot.processes) {
+        Put32(out, info.processId);
+        PutString(out, GetName(info.nameId), MINUX_MAX_NAME);
+        Put64(out, info.workingSetSize);
+        Put32(out, info.cpuUsage);
+        Put32(out, info.threadCount);
+        Put64(out, info.creationTime);
+        Put32(out, info.parentProcessId);
+    }
+
+    Put32(out, (uint32_t)snapshot.interfaces.size());
+    for (const NetworkInfo& info : snapshot.interfaces) {
+        PutString(out, info.adapterName, 256);
+        PutString(out, info.ipAddress, 16);
+        PutString(out, info.macAddress, 18);
+        Put64(out, info.bytesReceived);
+        Put64(out, info.bytesSent);
+        Put64(out, info.packetsReceived);
+        Put64(out, info.packetsSent);
+        Put64(out, info.errorsReceived);
+        Put64(out, info.errorsSent);
+        Put64(out, info.dropsReceived);
+        Put64(out, info.dropsSent);
+        Put64(out, info.bytesReceivedPerSecond);
+        Put64(out, info.bytesSentPerSecond);
+        Put64(out, info.packetsReceivedPerSecond);
+        Put64(out, info.packetsSentPerSecond);
+        Put32(out, info.rateIntervalMs);
+        out.push_back(info.isConnected ? 1 : 0);
+    }
+
+    Put32(out, (uint32_t)snapshot.cores.size());
+    for (const CpuCoreInfo& core : snapshot.cores) {
+        Put16(out, core.user);
+        Put16(out, core.kernel);
+        Put16(out, core.idle);
+    }
+}
+
+static bool DecodeSnapshot(const uint8_t* data, size_t size, MinuxSnapshot& snapshot) {
+    PayloadReader reader = { data, data + size, false };
+    snapshot.timestamp = reader.Read64();
+    snapshot.sequence = reader.Read64();
+
+    SystemInfo& system = snapshot.system;
+    system.cpuUsage = reader.Read32();
+    system.memoryUsage = reader.Read32();
+    system.processCount = reader.Read32();
+    system.threadCount = reader.Read32();
+    system.uptime = reader.Read64();
+    reader.ReadString(system.computerName, MINUX_MAX_COMPUTER_NAME);
+    reader.ReadString(system.osVersion, 256);
+
+    // Each process takes at least 34 bytes, so a damaged count cannot force a huge resize
+    uint32_t processCount = reader.Read32();
+    if (!reader.Has((size_t)processCount * 34)) return false;
+    snapshot.processes.resize(processCount);
+    snapshot.orderedProcessCount = 0;       // not recorded; views order what they show
+    wchar_t name[MINUX_MAX_NAME];
+    for (ProcessInfo& info : snapshot.processes) {
+        info.processId = reader.Read32();
+        reader.ReadString(name, MINUX_MAX_NAME);
+        info.nameId = InternName(name);
+        info.workingSetSize = reader.Read64();
+        info.cpuUsage = reader.Read32();
+        info.threadCount = reader.Read32();
+        info.creationTime = reader.Read64();
+        info.parentProcessId = reader.Read32();
+    }
+
+    // Each interface takes at least 107
+    uint32_t interfaceCount = reader.Read32();
+    if (!reader.Has((size_t)interfaceCount * 107)) return false;
+    snapshot.interfaces.resize(interfaceCount);
+    for (NetworkInfo& info : snapshot.interfaces) {
+        info = NetworkInfo();
+        reader.ReadString(info.adapterName, 256);
+        reader.ReadString(info.ipAddress, 16);
+        reader.ReadString(info.macAddress, 18);
+        info.bytesReceived = reader.Read64();
+        info.bytesSent = reader.Read64();
+        info.packetsReceived = reader.Read64();
+        info.packetsSent = reader.Read64();
+        info.errorsReceived = reader.Read64();
+        info.errorsSent = reader.Read64();
+        info.dropsReceived = reader.Read64();
+        info.dropsSent = reader.Read64();
+        info.bytesReceivedPerSecond = reader.Read64();
+        info.bytesSentPerSecond = reader.Read64();
+        info.packetsReceivedPerSecond = reader.Read64();
+        info.packetsSentPerSecond = reader.Read64();
+        info.rateIntervalMs = reader.Read32();
+        info.isConnected = reader.Read8() != 0;
+    }
+
+    uint32_t coreCount = reader.Read32();
+    if (!reader.Has((size_t)coreCount * 6)) return false;
+    snapshot.cores.resize(coreCount);
+    for (CpuCoreInfo& core : snapshot.cores) {
+        core.user = reader.Read16();
+        core.kernel = reader.Read16();
+        core.idle = reader.Read16();
+    }
+    return !reader.failed;
+}
+
+#ifndef _WIN32
+static std::string WideToUtf8(const std::wstring& text) {
+    std::string out;
+    for (wchar_t c : text) {
+        uint32_t codepoint = (uint32_t)c;
+        if (codepoint < 0x80) {
+            out.push_back((char)codepoint);
+        } else if (codepoint < 0x800) {
+            out.push_back((char)(0xC0 | (codepoint >> 6)));
+            out.push_back((char)(0x80 | (codepoint & 0x3F)));
+        } else if (codepoint < 0x10000) {
+            out.push_back((char)(0xE0 | (codepoint >> 12)));
+            out.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (codepoint & 0x3F)));
+        } else {
+            out.push_back((char)(0xF0 | (codepoint >> 18)));
+            out.push_back((char)(0x80 | ((codepoint >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (codepoint & 0x3F)));
+        }
+    }
+    return out;
+}
+#endif
+
+static FILE* CreateRecordingFile(const std::wstring& path) {
+#ifdef _WIN32
+    FILE* file = NULL;
+    if (_wfopen_s(&file, path.c_str(), L"wb") != 0) return NULL;
+    return file;
+#else
+    return fopen(WideToUtf8(path).c_str(), "wb");
+#endif
+}
+
+static std::wstring GetSegmentPath(const std::wstring& prefix, uint32_t segment) {
+    wchar_t suffix[16];
+    swprintf(suffix, 16, L".%03u", segment);
+    return prefix + suffix + RECORDING_EXTENSION;
+}
+
+RecordingWriter::RecordingWriter()
+    : m_file(NULL), m_segmentBytes(RECORDING_SEGMENT_BYTES), m_segment(0), m_offset(0), m_bytesWritten(0) {
+}
+
+RecordingWriter::~RecordingWriter() {
+    Close();
+}
+
+bool RecordingWriter::Open(const wchar_t* prefix, uint64_t segmentBytes) {
+    Close();
+    m_prefix = prefix;
+    m_segmentBytes = segmentBytes;
+    m_segment = 0;
+    m_bytesWritten = 0;
+    return OpenSegment();
+}
+
+bool RecordingWriter::OpenSegment() {
+    m_file = CreateRecordingFile(GetSegmentPath(m_prefix, m_segment));
+    if (!m_file) return false;
+
+    m_indexBuffer.clear();
+    Put32(m_indexBuffer, RECORDING_SEGMENT_MAGIC);
+    Put32(m_indexBuffer, RECORDING_VERSION);
+    Put32(m_indexBuffer, m_segment);
+    Put32(m_indexBuffer, 0);
+    if (fwrite(m_indexBuffer.data(), 1, m_indexBuffer.size(), m_file) != m_indexBuffer.size()) {
+        fclose(m_file);
+        m_file = NULL;
+        return false;
+    }
+    m_offset = RECORDING_HEADER_BYTES;
+    m_bytesWritten += RECORDING_HEADER_BYTES;
+    m_index.clear();
+    return true;
+}
+
+// Index and trailer; without them the reader falls back to scanning
+void RecordingWriter::CloseSegment() {
+    m_indexBuffer.clear();
+    for (const IndexEntry& entry : m_index) {
+        Put64(m_indexBuffer, entry.timestamp);
+        Put64(m_indexBuffer, entry.offset);
+    }
+    uint32_t crc = Crc32(m_indexBuffer.data(), m_indexBuffer.size());
+    Put64(m_indexBuffer, m_offset);
+    Put32(m_indexBuffer, (uint32_t)m_index.size());
+    Put32(m_indexBuffer, crc);
+    Put32(m_indexBuffer, RECORDING_INDEX_MAGIC);
+    Put32(m_indexBuffer, 0);
+    fwrite(m_indexBuffer.data(), 1, m_indexBuffer.size(), m_file);
+    m_bytesWritten += m_indexBuffer.size();
+
+    fclose(m_file);
+    m_file = NULL;
+}
+
+void RecordingWriter::Close() {
+    if (m_file) CloseSegment();
+}
+
+bool RecordingWriter::Append(const MinuxSnapshot& snapshot) {
+    if (!m_file) return false;
+
+    m_buffer.assign(RECORDING_HEADER_BYTES, 0);
+    EncodeSnapshot(snapshot, m_buffer);
+    uint32_t length = (uint32_t)(m_buffer.size() - RECORDING_HEADER_BYTES);
+    uint32_t crc = Crc32(m_buffer.data() + RECORDING_HEADER_BYTES, length);
+
+    // Roll over before the segment would pass its size limit
+    uint64_t indexBytes = (m_index.size() + 1) * RECORDING_ENTRY_BYTES + RECORDING_TRAILER_BYTES;
+    if (!m_index.empty() && m_offset + m_buffer.size() + indexBytes > m_segmentBytes) {
+        CloseSegment();
+        m_segment++;
+        if (!OpenSegment()) return false;
+    }
+
+    uint8_t* header = m_buffer.data();
+    uint32_t fields[4] = { RECORDING_RECORD_MAGIC, length, crc, 0 };
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 4; b++) header[i * 4 + b] = (uint8_t)(fields[i] >> (b * 8));
+    }
+
+    if (fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size()) return false;
+    fflush(m_file);
+
+    IndexEntry entry = { snapshot.timestamp, m_offset };
+    m_index.push_back(entry);
+    m_offset += m_buffer.size();
+    m_bytesWritten += m_buffer.size();
+    return true;
+}
+
+RecordingReader::RecordingReader() : m_recoveredSegments(0) {
+}
+
+RecordingReader::~RecordingReader() {
+    Close();
+}
+
+void RecordingReader::Close() {
+    for (Segment& segment : m_segments) UnmapSegment(segment);
+    m_segments.clear();
+    m_records.clear();
+    m_recoveredSegments = 0;
+}
+
+bool RecordingReader::MapSegment(const wchar_t* path, Segment& segment) {
+    memset(&segment, 0, sizeof(segment));
+#ifdef _WIN32
+    // Share writes so a recording that is still growing can be opened
+    HANDLE file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < RECORDING_HEADER_BYTES) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    segment.data = (const uint8_t*)view;
+    segment.size = (size_t)size.QuadPart;
+    segment.file = file;
+    segment.mapping = mapping;
+#else
+    int fd = open(WideToUtf8(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < RECORDING_HEADER_BYTES) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+    segment.data = (const uint8_t*)view;
+    segment.size = (size_t)info.st_size;
+#endif
+
+    if (Get32(segment.data) != RECORDING_SEGMENT_MAGIC || Get32(segment.data + 4) != RECORDING_VERSION) {
+        UnmapSegment(segment);
+        return false;
+    }
+    return true;
+}
+
+void RecordingReader::UnmapSegment(Segment& segment) {
+    if (!segment.data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(segment.data);
+    CloseHandle((HANDLE)segment.mapping);
+    CloseHandle((HANDLE)segment.file);
+#else
+    munmap((void*)segment.data, segment.size);
+#endif
+    segment.data = NULL;
+}
+
+// Read the index at the end of a closed segment; false if there is none
+bool RecordingReader::LoadIndex(uint32_t segmentNumber) {
+    const Segment& segment = m_segments[segmentNumber];
+    if (segment.size < RECORDING_HEADER_BYTES + RECORDING_TRAILER_BYTES) return false;
+
+    const uint8_t* trailer = segment.data + segment.size - RECORDING_TRAILER_BYTES;
+    if (Get32(trailer + 16) != RECORDING_INDEX_MAGIC) return false;
+    uint64_t indexOffset = Get64(trailer);
+    uint64_t count = Get32(trailer + 8);
+    if (indexOffset < RECORDING_HEADER_BYTES ||
+        indexOffset + count * RECORDING_ENTRY_BYTES + RECORDING_TRAILER_BYTES != segment.size) return false;
+
+    const uint8_t* entries = segment.data + indexOffset;
+    if (Crc32(entries, (size_t)count * RECORDING_ENTRY_BYTES) != Get32(trailer + 12)) return false;
+
+    for (uint64_t i = 0; i < count; i++) {
+        RecordRef ref;
+        ref.timestamp = Get64(entries + i * RECORDING_ENTRY_BYTES);
+        ref.segment = segmentNumber;
+        ref.offset = Get64(entries + i * RECORDING_ENTRY_BYTES + 8);
+        if (ref.offset + RECORDING_HEADER_BYTES > indexOffset) return false;
+        m_records.push_back(ref);
+    }
+    return true;
+}
+
+// Recover the records of a segment without an index, stopping at the first damaged one
+void RecordingReader::ScanSegment(uint32_t segmentNumber) {
+    const Segment& segment = m_segments[segmentNumber];
+    uint64_t offset = RECORDING_HEADER_BYTES;
+    while (offset + RECORDING_HEADER_BYTES + 8 <= segment.size) {
+        const uint8_t* header = segment.data + offset;
+        uint64_t length = Get32(header + 4);
+        if (Get32(header) != RECORDING_RECORD_MAGIC || length < 8) break;
+        if (offset + RECORDING_HEADER_BYTES + length > segment.size) break;
+
+        const uint8_t* payload = header + RECORDING_HEADER_BYTES;
+        if (Crc32(payload, (size_t)length) != Get32(header + 8)) break;
+
+        RecordRef ref = { Get64(payload), segmentNumber, offset };
+        m_records.push_back(ref);
+        offset += RECORDING_HEADER_BYTES + length;
+    }
+}
+
+bool RecordingReader::Open(const wchar_t* path) {
+    Close();
+
+    // <prefix>.NNN.mxr -> prefix and segment number
+    std::wstring prefix = path;
+    size_t extensionLength = wcslen(RECORDING_EXTENSION);
+    uint32_t dropped = 0;
+    bool numbered = false;
+    if (prefix.size() > extensionLength && prefix.compare(prefix.size() - extensionLength, extensionLength, RECORDING_EXTENSION) == 0) {
+        prefix.resize(prefix.size() - extensionLength);
+        size_t dot = prefix.rfind(L'.');
+        if (dot != std::wstring::npos && dot + 1 < prefix.size()) {
+            numbered = true;
+            for (size_t i = dot + 1; i < prefix.size(); i++) {
+                if (prefix[i] < L'0' || prefix[i] > L'9') numbered = false;
+                else dropped = dropped * 10 + (uint32_t)(prefix[i] - L'0');
+            }
+            if (numbered) prefix.resize(dot);
+        }
+    }
+
+    if (numbered) {
+        // Start at the first segment still present, then take every following one
+        uint32_t first = 0;
+        Segment segment;
+        if (!MapSegment(GetSegmentPath(prefix, 0).c_str(), segment)) first = dropped;
+        else UnmapSegment(segment);
+
+        for (uint32_t number = first; MapSegment(GetSegmentPath(prefix, number).c_str(), segment); number++) {
+            m_segments.push_back(segment);
+        }
+    } else {
+        Segment segment;
+        if (MapSegment(path, segment)) m_segments.push_back(segment);
+    }
+    if (m_segments.empty()) return false;
+
+    for (uint32_t i = 0; i < (uint32_t)m_segments.size(); i++) {
+        size_t before = m_records.size();
+        if (!LoadIndex(i)) {
+            m_records.resize(before);
+            ScanSegment(i);
+            m_recoveredSegments++;
+        }
+    }
+    return true;
+}
+
+uint64_t RecordingReader::GetStartTime() const {
+    return m_records.empty() ? 0 : m_records.front().timestamp;
+}
+
+uint64_t RecordingReader::GetEndTime() const {
+    return m_records.empty() ? 0 : m_records.back().timestamp;
+}
+
+size_t RecordingReader::Seek(uint64_t timestamp) const {
+    auto it = std::lower_bound(m_records.begin(), m_records.end(), timestamp,
+                               [](const RecordRef& ref, uint64_t value) { return ref.timestamp < value; });
+    return (size_t)(it - m_records.begin());
+}
+
+bool RecordingReader::ReadRecord(size_t record, MinuxSnapshot& snapshot) const {
+    if (record >= m_records.size()) return false;
+    const RecordRef& ref = m_records[record];
+    const Segment& segment = m_segments[ref.segment];
+
+    const uint8_t* header = segment.data + ref.offset;
+    uint64_t length = Get32(header + 4);
+    if (Get32(header) != RECORDING_RECORD_MAGIC || ref.offset + RECORDING_HEADER_BYTES + length > segment.size) return false;
+
+    const uint8_t* payload = header + RECORDING_HEADER_BYTES;
+    if (Crc32(payload, (size_t)length) != Get32(header + 8)) return false;
+    return DecodeSnapshot(payload, (size_t)length, snapshot);
+}
+
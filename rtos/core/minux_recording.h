@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "minux_types.h"
+#include "minux_snapshot.h"
+
+// Minux Recording
+// Append-only recording of snapshots in segment files <prefix>.NNN.mxr.
+// Every record carries its length and a CRC, so a crash loses at most the
+// record being written. A closed segment ends with an index of (timestamp,
+// offset) pairs; segments without one (e.g. after a crash) are recovered by
+// scanning. Readers memory-map the segments and seek through the index.
+// Strings are stored as UTF-16 so recordings move between platforms.
+
+#define RECORDING_SEGMENT_BYTES (256ULL * 1024 * 1024)
+#define RECORDING_EXTENSION     L".mxr"
+
+class RecordingWriter {
+public:
+    RecordingWriter();
+    ~RecordingWriter();
+
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    // Start a recording; segments are <prefix>.000.mxr, <prefix>.001.mxr, ...
+    bool Open(const wchar_t* prefix, uint64_t segmentBytes = RECORDING_SEGMENT_BYTES);
+
+    // Write one snapshot and flush it to the OS
+    bool Append(const MinuxSnapshot& snapshot);
+
+    // Write the index of the open segment and close it
+    void Close();
+
+    bool IsOpen() const { return m_file != NULL; }
+    uint64_t GetBytesWritten() const { return m_bytesWritten; }
+
+private:
+    struct IndexEntry {
+        uint64_t timestamp;
+        uint64_t offset;
+    };
+
+    bool OpenSegment();
+    void CloseSegment();
+
+    FILE* m_file;
+    std::wstring m_prefix;
+    uint64_t m_segmentBytes;
+    uint32_t m_segment;
+    uint64_t m_offset;                  // write position in the open segment
+    uint64_t m_bytesWritten;
+    std::vector<IndexEntry> m_index;    // records of the open segment
+    std::vector<uint8_t> m_buffer;      // reused record encoding buffer
+    std::vector<uint8_t> m_indexBuffer; // segment header and index; m_buffer may hold a pending record
+};
+
+class RecordingReader {
+public:
+    RecordingReader();
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    // Open every segment of the recording that 'path' (any segment) belongs to
+    bool Open(const wchar_t* path);
+    void Close();
+
+    size_t GetRecordCount() const { return m_records.size(); }
+    size_t GetSegmentCount() const { return m_segments.size(); }
+    uint64_t GetStartTime() const;
+    uint64_t GetEndTime() const;
+    uint64_t GetRecordTime(size_t record) const { return m_records[record].timestamp; }
+
+    // First record at or after 'timestamp' (GetRecordCount() if none)
+    size_t Seek(uint64_t timestamp) const;
+
+    // Decode one record into 'snapshot', reusing its vectors; false if damaged
+    bool ReadRecord(size_t record, MinuxSnapshot& snapshot) const;
+
+    // Segments that had no valid index and were recovered by scanning
+    size_t GetRecoveredSegmentCount() const { return m_recoveredSegments; }
+
+private:
+    struct Segment {
+        const uint8_t* data;
+        size_t size;
+        void* file;                     // platform handles for unmapping
+        void* mapping;
+    };
+
+    struct RecordRef {
+        uint64_t timestamp;
+        uint32_t segment;
+        uint64_t offset;
+    };
+
+    bool MapSegment(const wchar_t* path, Segment& segment);
+    void UnmapSegment(Segment& segment);
+    bool LoadIndex(uint32_t segment);
+    void ScanSegment(uint32_t segment);
+
+    std::vector<Segment> m_segments;
+    std::vector<RecordRef> m_records;
+    size_t m_recoveredSegments;
+};
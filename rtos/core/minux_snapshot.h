@@ -0,0 +1,16 @@
+#pragma once
+#include <vector>
+#include "minux_types.h"
+
+// Minux Snapshot
+// One complete, timestamped sample of the system.
+
+struct MinuxSnapshot {
+    uint64_t timestamp = 0;     // milliseconds since the Unix epoch
+    uint64_t sequence = 0;      // increments with every published snapshot
+    SystemInfo system = {};
+    std::vector<CpuCoreInfo> cores;     // one per logical processor, across all processor groups
+    std::vector<ProcessInfo> processes;
+    size_t orderedProcessCount = 0;     // processes[0..n) are by working set, descending; the rest unordered
+    std::vector<NetworkInfo> interfaces;
+};
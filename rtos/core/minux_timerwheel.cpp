@@ -0,0 +1,251 @@
+#include "minux_timerwheel.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define TIMER_WHEEL_SLOT_MASK ((uint64_t)TIMER_WHEEL_SLOTS - 1)
+
+// Level 1 slots searched for open windows after advancing: the next 128 to 192 ticks
+#define TIMER_WHEEL_OPEN_WINDOW_SLOTS 3
+
+// Farthest a task can be scheduled ahead; later deadlines are clamped
+#define TIMER_WHEEL_RANGE (1ULL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))
+
+static int LowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// Occupancy mask turned so that bit 0 is slot 'first'
+static uint64_t RotateMask(uint64_t bits, int first) {
+    return first ? (bits >> first) | (bits << (TIMER_WHEEL_SLOTS - first)) : bits;
+}
+
+static int GetLevelIndex(uint64_t tick, int level) {
+    return (int)((tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+}
+
+TimerWheel::TimerWheel(uint64_t now) : m_current(now), m_count(0) {
+    for (int slot = 0; slot <= FIRING_SLOT; slot++) m_slots[slot] = NULL;
+    for (int slot = 0; slot < FIRING_SLOT; slot++) {
+        m_minimum[slot] = TIMER_NEVER;
+        m_minimumCount[slot] = 0;
+    }
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) m_occupied[level] = 0;
+}
+
+uint64_t TimerWheel::Coalesce(uint64_t deadline, uint64_t slack) const {
+    if (deadline < m_current) deadline = m_current;
+    if (slack == 0) return deadline;
+    if (slack > TIMER_WHEEL_RANGE) slack = TIMER_WHEEL_RANGE;
+    uint64_t latest = deadline + slack;
+
+    // Join a tick that already fires inside the window; level 0 holds the exact near ticks
+    if (latest - m_current < TIMER_WHEEL_SLOTS && m_occupied[0]) {
+        uint64_t near = RotateMask(m_occupied[0], GetLevelIndex(m_current, 0));
+        int first = (int)(deadline - m_current);
+        int last = (int)(latest - m_current);
+        uint64_t window = (last == TIMER_WHEEL_SLOTS - 1 ? ~0ULL : (2ULL << last) - 1) & ~((1ULL << first) - 1);
+        if (near & window) return m_current + LowestBit(near & window);
+    }
+
+    // Otherwise the end of the window, rounded down to the coarsest power of two that keeps it open
+    uint64_t granularity = 1;
+    while (granularity * 2 <= slack + 1) granularity *= 2;
+    return latest & ~(granularity - 1);
+}
+
+void TimerWheel::Link(TimerTask* task) {
+    if (task->m_expiry < m_current) task->m_expiry = m_current;
+    uint64_t delta = task->m_expiry - m_current;
+    if (delta >= TIMER_WHEEL_RANGE) {
+        task->m_expiry = m_current + TIMER_WHEEL_RANGE - 1;
+        delta = TIMER_WHEEL_RANGE - 1;
+    }
+
+    int level = 0;
+    while (delta >> (TIMER_WHEEL_SLOT_BITS * (level + 1))) level++;
+    int index = GetLevelIndex(task->m_expiry, level);
+    int slot = level * TIMER_WHEEL_SLOTS + index;
+
+    task->m_slot = slot;
+    task->m_prev = NULL;
+    task->m_next = m_slots[slot];
+    if (task->m_next) task->m_next->m_prev = task;
+    m_slots[slot] = task;
+    m_occupied[level] |= 1ULL << index;
+    if (task->m_expiry < m_minimum[slot]) {
+        m_minimum[slot] = task->m_expiry;
+        m_minimumCount[slot] = 1;
+    } else if (task->m_expiry == m_minimum[slot]) {
+        m_minimumCount[slot]++;
+    }
+}
+
+void TimerWheel::Unlink(TimerTask* task) {
+    int slot = task->m_slot;
+    if (task->m_prev) task->m_prev->m_next = task->m_next;
+    else m_slots[slot] = task->m_next;
+    if (task->m_next) task->m_next->m_prev = task->m_prev;
+
+    if (slot < FIRING_SLOT) {
+        if (!m_slots[slot]) {
+            m_occupied[slot / TIMER_WHEEL_SLOTS] &= ~(1ULL << (slot % TIMER_WHEEL_SLOTS));
+            m_minimum[slot] = TIMER_NEVER;
+            m_minimumCount[slot] = 0;
+        } else if (task->m_expiry == m_minimum[slot] && --m_minimumCount[slot] == 0) {
+            RefreshMinimum(slot);       // expected O(1): rare, the slot's last earliest task left
+        }
+    }
+    task->m_next = NULL;
+    task->m_prev = NULL;
+    task->m_slot = -1;
+}
+
+void TimerWheel::Schedule(TimerTask* task, uint64_t deadline, uint64_t slack) {
+    Cancel(task);
+    task->m_deadline = deadline;
+    task->m_expiry = Coalesce(deadline, slack);
+    Link(task);
+    m_count++;
+}
+
+void TimerWheel::Cancel(TimerTask* task) {
+    if (!task->IsScheduled()) return;
+    Unlink(task);
+    m_count--;
+}
+
+// At a level 0 boundary, spread the slots of the higher levels that just came into range
+void TimerWheel::Cascade() {
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        int index = GetLevelIndex(m_current, level);
+        int slot = level * TIMER_WHEEL_SLOTS + index;
+        TimerTask* task = m_slots[slot];
+        m_slots[slot] = NULL;
+        m_occupied[level] &= ~(1ULL << index);
+        m_minimum[slot] = TIMER_NEVER;
+        m_minimumCount[slot] = 0;
+        while (task) {
+            TimerTask* next = task->m_next;
+            Link(task);
+            task = next;
+        }
+        if (index != 0) break;      // the next level only turns when this one wraps
+    }
+}
+
+// With level 0 empty, the first tick after m_current where a level 1 slot comes down
+uint64_t TimerWheel::GetNextCascade() const {
+    const uint64_t turn = 1ULL << (TIMER_WHEEL_SLOT_BITS * 2);
+    uint64_t turnStart = m_current & ~(turn - 1);
+    int index = GetLevelIndex(m_current, 1);
+    uint64_t later = index + 1 < TIMER_WHEEL_SLOTS ? m_occupied[1] >> (index + 1) : 0;
+    if (later) return turnStart + ((uint64_t)(index + 1 + LowestBit(later)) << TIMER_WHEEL_SLOT_BITS);
+    return turnStart + turn;        // level 1 wraps and the levels above turn
+}
+
+void TimerWheel::MoveToFiring(TimerTask* task) {
+    Unlink(task);
+    task->m_slot = FIRING_SLOT;
+    task->m_next = m_slots[FIRING_SLOT];
+    if (task->m_next) task->m_next->m_prev = task;
+    m_slots[FIRING_SLOT] = task;
+}
+
+void TimerWheel::RunFiring(uint64_t now) {
+    while (TimerTask* task = m_slots[FIRING_SLOT]) {
+        Unlink(task);
+        m_count--;
+        task->OnTimer(*this, now);
+    }
+}
+
+void TimerWheel::CollectOpenWindows(int level, int index, uint64_t now) {
+    TimerTask* task = m_slots[level * TIMER_WHEEL_SLOTS + index];
+    while (task) {
+        TimerTask* next = task->m_next;
+        if (task->m_deadline <= now) MoveToFiring(task);
+        task = next;
+    }
+}
+
+void TimerWheel::Advance(uint64_t now) {
+    while (m_current <= now) {
+        if ((m_current & TIMER_WHEEL_SLOT_MASK) == 0) Cascade();
+
+        // Next occupied tick before the end of this level 0 turn
+        int index = GetLevelIndex(m_current, 0);
+        uint64_t ahead = m_occupied[0] >> index;
+        if (!ahead) {
+            uint64_t next = m_occupied[0] ? (m_current | TIMER_WHEEL_SLOT_MASK) + 1 : GetNextCascade();
+            m_current = next <= now ? next : now + 1;
+            continue;
+        }
+        uint64_t tick = m_current + LowestBit(ahead);
+        if (tick > now) {
+            m_current = now + 1;
+            break;
+        }
+
+        // Move the tick's tasks aside so rescheduling into the same slot waits a full turn
+        int slot = GetLevelIndex(tick, 0);
+        while (m_slots[slot]) MoveToFiring(m_slots[slot]);
+        m_current = tick + 1;
+        RunFiring(now);
+    }
+
+    // The thread is awake anyway: run near tasks whose window has opened instead of waking for them later
+    for (uint64_t bits = m_occupied[0]; bits; bits &= bits - 1) CollectOpenWindows(0, LowestBit(bits), now);
+    int index = GetLevelIndex(m_current, 1);
+    for (int slot = 0; slot < TIMER_WHEEL_OPEN_WINDOW_SLOTS; slot++) {
+        CollectOpenWindows(1, (index + slot) & (int)TIMER_WHEEL_SLOT_MASK, now);
+    }
+    RunFiring(now);
+}
+
+void TimerWheel::RefreshMinimum(int slot) {
+    m_minimum[slot] = TIMER_NEVER;
+    m_minimumCount[slot] = 0;
+    for (TimerTask* task = m_slots[slot]; task; task = task->m_next) {
+        if (task->m_expiry < m_minimum[slot]) {
+            m_minimum[slot] = task->m_expiry;
+            m_minimumCount[slot] = 1;
+        } else if (task->m_expiry == m_minimum[slot]) {
+            m_minimumCount[slot]++;
+        }
+    }
+}
+
+uint64_t TimerWheel::GetNextExpiry() const {
+    if (m_count == 0) return TIMER_NEVER;
+
+    // Level 0 slots are exact ticks
+    uint64_t next = TIMER_NEVER;
+    if (m_occupied[0]) {
+        next = m_current + LowestBit(RotateMask(m_occupied[0], GetLevelIndex(m_current, 0)));
+    }
+
+    // A higher level's earliest task is in its current slot (not yet cascaded) or the next occupied one
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        uint64_t bits = m_occupied[level];
+        if (!bits) continue;
+        int index = GetLevelIndex(m_current, level);
+        if (bits & (1ULL << index)) {
+            uint64_t minimum = m_minimum[level * TIMER_WHEEL_SLOTS + index];
+            if (minimum < next) next = minimum;
+        }
+        uint64_t later = RotateMask(bits & ~(1ULL << index), (index + 1) & (int)TIMER_WHEEL_SLOT_MASK);
+        if (later) {
+            int slot = (index + 1 + LowestBit(later)) & (int)TIMER_WHEEL_SLOT_MASK;
+            uint64_t minimum = m_minimum[level * TIMER_WHEEL_SLOTS + slot];
+            if (minimum < next) next = minimum;
+        }
+    }
+    return next;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Minux Timer Wheel
+// Hashed hierarchical timer wheel that owns a thread's periodic and one-shot
+// jobs, so the thread has a single place to sleep. Time is a millisecond tick
+// the caller passes in (GetTickCount64 in the app, a virtual clock in the
+// benches).
+//
+// Each level has 64 slots; level 0 slots are one tick wide and every level up
+// is 64 times coarser. Scheduling and cancelling are O(1): a task is linked
+// into the slot of its expiry, and slots of higher levels are redistributed
+// downwards as time reaches them. Empty stretches are skipped through a
+// per-level occupancy mask, so a long sleep costs a few steps per 4096 ticks.
+//
+// A task may be late by up to its slack. The wheel only wakes for the end of
+// that window, rounded to a coarse power of two other tasks share, and runs
+// any task whose window is already open whenever it is advanced anyway, so
+// jobs with tolerance ride along with each other and the thread wakes as
+// rarely as possible.
+
+#define TIMER_WHEEL_LEVELS    6                         // 64^6 ticks, about 2 years at 1 ms
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS     (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_NEVER           UINT64_MAX
+
+class TimerWheel;
+
+// A job the wheel can run. The owner keeps it alive while it is scheduled;
+// OnTimer may reschedule or cancel any task, including itself.
+class TimerTask {
+public:
+    TimerTask() : m_next(NULL), m_prev(NULL), m_deadline(0), m_expiry(0), m_slot(-1) {}
+    virtual ~TimerTask() {}
+
+    virtual void OnTimer(TimerWheel& wheel, uint64_t now) = 0;
+
+    bool IsScheduled() const { return m_slot >= 0; }
+    uint64_t GetDeadline() const { return m_deadline; }    // earliest tick it may run
+    uint64_t GetExpiry() const { return m_expiry; }        // latest tick, after coalescing
+
+private:
+    friend class TimerWheel;
+
+    TimerTask* m_next;
+    TimerTask* m_prev;
+    uint64_t m_deadline;
+    uint64_t m_expiry;
+    int m_slot;                 // level * TIMER_WHEEL_SLOTS + index, -1 when not scheduled
+};
+
+class TimerWheel {
+public:
+    explicit TimerWheel(uint64_t now = 0);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Run 'task' no earlier than 'deadline' and no later than deadline + slack;
+    // a scheduled task is moved. Deadlines in the past fire on the next Advance.
+    void Schedule(TimerTask* task, uint64_t deadline, uint64_t slack = 0);
+    void Cancel(TimerTask* task);
+
+    // Run every task whose expiry is at or before 'now', in expiry order, then
+    // every task whose deadline has passed
+    void Advance(uint64_t now);
+
+    // Earliest expiry of any scheduled task, TIMER_NEVER when idle; sleep until then
+    uint64_t GetNextExpiry() const;
+
+    size_t GetCount() const { return m_count; }
+    uint64_t GetTime() const { return m_current; }     // next tick Advance will process
+
+private:
+    uint64_t Coalesce(uint64_t deadline, uint64_t slack) const;
+    void Link(TimerTask* task);
+    void Unlink(TimerTask* task);
+    void Cascade();
+    uint64_t GetNextCascade() const;
+    void MoveToFiring(TimerTask* task);
+    void RunFiring(uint64_t now);
+    void CollectOpenWindows(int level, int index, uint64_t now);
+    void RefreshMinimum(int slot);
+
+    // One extra list holds the tasks of the tick being run, so callbacks can cancel them
+    enum { FIRING_SLOT = TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS };
+
+    TimerTask* m_slots[FIRING_SLOT + 1];
+    uint64_t m_occupied[TIMER_WHEEL_LEVELS];            // bit per non-empty slot
+    uint64_t m_minimum[FIRING_SLOT];                    // earliest expiry per slot above level 0
+    uint32_t m_minimumCount[FIRING_SLOT];               // tasks sharing that expiry
+    uint64_t m_current;
+    size_t m_count;
+};
@@ -0,0 +1,72 @@
+#include "minux_topk.h"
+#include <algorithm>
+
+// Larger key first; equal keys in index order
+static bool IsHeavier(uint64_t keyA, uint32_t indexA, uint64_t keyB, uint32_t indexB) {
+    return keyA != keyB ? keyA > keyB : indexA < indexB;
+}
+
+TopKSelector::TopKSelector() : m_threshold(0), m_hasThreshold(false), m_fallbacks(0) {
+}
+
+void TopKSelector::Reset() {
+    m_hasThreshold = false;
+}
+
+void TopKSelector::Select(const uint64_t* keys, size_t count, size_t k, std::vector<uint32_t>& order) {
+    order.clear();
+    if (k > count) k = count;
+    if (k == 0) return;
+
+    // Streaming pass: keep what reaches last time's K-th key
+    m_candidates.clear();
+    if (m_hasThreshold) {
+        uint64_t threshold = m_threshold;
+        for (size_t i = 0; i < count; i++) {
+            if (keys[i] >= threshold) {
+                Candidate candidate = { keys[i], (uint32_t)i };
+                m_candidates.push_back(candidate);
+            }
+        }
+    }
+
+    auto heavier = [](const Candidate& a, const Candidate& b) { return IsHeavier(a.key, a.index, b.key, b.index); };
+
+    // Too few: the K-th key may lie below the threshold, so every key is a candidate.
+    // For a short list that is one pass keeping the K heaviest in a heap (lightest
+    // on top), so most keys cost a single compare; otherwise nth_element over all.
+    if (m_candidates.size() < k) {
+        m_fallbacks++;
+        if (k * 16 <= count) {
+            m_candidates.resize(k);
+            for (size_t i = 0; i < k; i++) {
+                m_candidates[i].key = keys[i];
+                m_candidates[i].index = (uint32_t)i;
+            }
+            std::make_heap(m_candidates.begin(), m_candidates.end(), heavier);
+            for (size_t i = k; i < count; i++) {
+                if (keys[i] <= m_candidates.front().key) continue;     // ties keep the lower index
+                std::pop_heap(m_candidates.begin(), m_candidates.end(), heavier);
+                m_candidates.back().key = keys[i];
+                m_candidates.back().index = (uint32_t)i;
+                std::push_heap(m_candidates.begin(), m_candidates.end(), heavier);
+            }
+        } else {
+            m_candidates.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                m_candidates[i].key = keys[i];
+                m_candidates[i].index = (uint32_t)i;
+            }
+        }
+    }
+
+    if (m_candidates.size() > k) {
+        std::nth_element(m_candidates.begin(), m_candidates.begin() + (k - 1), m_candidates.end(), heavier);
+    }
+    std::sort(m_candidates.begin(), m_candidates.begin() + k, heavier);
+
+    order.resize(k);
+    for (size_t i = 0; i < k; i++) order[i] = m_candidates[i].index;
+    m_threshold = m_candidates[k - 1].key;
+    m_hasThreshold = true;
+}
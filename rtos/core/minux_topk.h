@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minux Top-K Selection
+// Picks the K largest of n keys, largest first, without ordering the rest:
+// one streaming pass, then a sort of K. Successive calls are usually made
+// on successive samples of the same processes, so the selector carries the
+// K-th key over as a threshold: the pass only keeps keys at or above it
+// (about K of them, plus whatever rose past it) and the selection runs on
+// that short list. When too few keys reach the threshold (the K heaviest
+// shrank, K grew, or a filter dropped them), it falls back to a pass over
+// every key: a K-entry heap when K is small next to n, nth_element
+// otherwise. Either way the result is exact: ties go to the lower index, as
+// in a stable sort.
+//
+// Refresh cost is one compare per key plus O(K log K), instead of a full
+// sort of n.
+
+class TopKSelector {
+public:
+    TopKSelector();
+
+    // order = indices of the min(k, count) largest keys, largest first
+    void Select(const uint64_t* keys, size_t count, size_t k, std::vector<uint32_t>& order);
+
+    // Forget the threshold, e.g. when the keys come from a different metric
+    void Reset();
+
+    size_t GetFallbackCount() const { return m_fallbacks; }   // selections that scanned every key
+
+private:
+    struct Candidate {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    uint64_t m_threshold;
+    bool m_hasThreshold;
+    size_t m_fallbacks;
+    std::vector<Candidate> m_candidates;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Minux Triple Buffer
+// Lock-free single-producer / single-consumer hand-off of the newest value.
+//
+// The writer fills BackBuffer() and calls Publish(); the reader calls
+// Acquire() and then reads FrontBuffer(). Neither side ever blocks: the
+// three slots are only ever swapped through one atomic byte, so the writer
+// always has a free slot and the reader always sees a complete value.
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : m_middle(1), m_back(0), m_front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side: slot to fill before the next Publish()
+    T& BackBuffer() { return m_slots[m_back]; }
+
+    // Writer side: hand the back slot to the reader and take the stale one
+    void Publish() {
+        uint8_t previous = m_middle.exchange((uint8_t)(m_back | kDirtyBit), std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+    }
+
+    // Reader side: returns true when a newer value was swapped into the front slot
+    bool Acquire() {
+        if ((m_middle.load(std::memory_order_acquire) & kDirtyBit) == 0) return false;
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & kIndexMask;
+        return true;
+    }
+
+    // Reader side: most recently acquired value
+    const T& FrontBuffer() const { return m_slots[m_front]; }
+
+private:
+    static const uint8_t kIndexMask = 0x3;
+    static const uint8_t kDirtyBit = 0x4;
+
+    T m_slots[3];
+    std::atomic<uint8_t> m_middle;  // index of the shared slot | kDirtyBit when unread
+    uint8_t m_back;                 // owned by the writer
+    uint8_t m_front;                // owned by the reader
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Minux Core Types
+// Snapshot records shared by the collector, the views and the headless tools.
+// Platform-neutral: backends translate OS-specific values into these fields.
+
+#define MINUX_MAX_NAME          260     // process names and paths (MAX_PATH)
+#define MINUX_MAX_COMPUTER_NAME 64
+
+typedef uint32_t NameId;        // interned string, see minux_names.h
+
+// System information structure
+typedef struct {
+    uint32_t cpuUsage;          // percent
+    uint32_t memoryUsage;       // percent of physical memory in use
+    uint32_t processCount;
+    uint32_t threadCount;
+    uint64_t uptime;            // milliseconds since boot
+    wchar_t computerName[MINUX_MAX_COMPUTER_NAME];
+    wchar_t osVersion[256];
+} SystemInfo;
+
+// Process information structure
+typedef struct {
+    uint32_t processId;
+    NameId nameId;              // executable name; GetName() for the text
+    uint64_t workingSetSize;    // bytes
+    uint32_t cpuUsage;          // hundredths of a percent of all logical processors
+    uint32_t threadCount;
+    uint64_t creationTime;      // backend-defined start stamp; with the PID it identifies a process
+    uint32_t parentProcessId;   // creator's PID, 0 if none; the PID may since have been reused
+} ProcessInfo;
+
+// Share of one logical processor's time over the last sample interval
+typedef struct {
+    uint16_t user;              // hundredths of a percent
+    uint16_t kernel;            // hundredths of a percent, excluding idle time
+    uint16_t idle;              // hundredths of a percent
+} CpuCoreInfo;
+
+// Network interface information
+typedef struct {
+    wchar_t adapterName[256];
+    wchar_t ipAddress[16];
+    wchar_t macAddress[18];
+    uint64_t bytesReceived;     // counters since the interface came up
+    uint64_t bytesSent;
+    uint64_t packetsReceived;
+    uint64_t packetsSent;
+    uint64_t errorsReceived;
+    uint64_t errorsSent;
+    uint64_t dropsReceived;     // packets discarded without an error, e.g. no buffer space
+    uint64_t dropsSent;
+    uint64_t bytesReceivedPerSecond;    // over the last sample interval, see minux_netrates.h
+    uint64_t bytesSentPerSecond;
+    uint64_t packetsReceivedPerSecond;
+    uint64_t packetsSentPerSecond;
+    uint32_t rateIntervalMs;    // span the rates cover; 0 on an interface's first reading
+    bool isConnected;
+} NetworkInfo;
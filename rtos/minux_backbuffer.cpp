@@ -0,0 +1,75 @@
+#include "framework.h"
+#include "minux_backbuffer.h"
+
+// Bitmap sizes are rounded up to this many pixels to absorb drag-resizing
+#define BACKBUFFER_GROWTH 64
+
+BackBuffer::BackBuffer()
+    : m_hdc(NULL), m_hBitmap(NULL), m_hOldBitmap(NULL), m_bitmapWidth(0), m_bitmapHeight(0),
+      m_width(0), m_height(0), m_chromeValid(false) {
+}
+
+BackBuffer::~BackBuffer() {
+    Release();
+}
+
+bool BackBuffer::Prepare(HWND hWnd, HDC hdcWindow) {
+    RECT client;
+    GetClientRect(hWnd, &client);
+    int width = client.right > 1 ? client.right : 1;
+    int height = client.bottom > 1 ? client.bottom : 1;
+
+    if (width > m_bitmapWidth || height > m_bitmapHeight || !m_hdc) {
+        int bitmapWidth = (width + BACKBUFFER_GROWTH - 1) / BACKBUFFER_GROWTH * BACKBUFFER_GROWTH;
+        int bitmapHeight = (height + BACKBUFFER_GROWTH - 1) / BACKBUFFER_GROWTH * BACKBUFFER_GROWTH;
+        if (bitmapWidth < m_bitmapWidth) bitmapWidth = m_bitmapWidth;
+        if (bitmapHeight < m_bitmapHeight) bitmapHeight = m_bitmapHeight;
+
+        Release();
+        m_hdc = CreateCompatibleDC(hdcWindow);
+        m_hBitmap = m_hdc ? CreateCompatibleBitmapWithAlpha(hdcWindow, bitmapWidth, bitmapHeight) : NULL;
+        if (!m_hBitmap) {
+            Release();
+            return false;
+        }
+        m_hOldBitmap = SelectObject(m_hdc, m_hBitmap);
+        m_bitmapWidth = bitmapWidth;
+        m_bitmapHeight = bitmapHeight;
+    }
+
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        m_chromeValid = false;
+    }
+    return true;
+}
+
+bool BackBuffer::GetSurface(PixelSurface* surface) const {
+    if (!m_hBitmap || !GetBitmapSurface(m_hBitmap, surface)) return false;
+    GdiFlush();
+    surface->width = m_width;       // the part the window shows
+    surface->height = m_height;
+    return true;
+}
+
+void BackBuffer::Present(HDC hdcWindow, const RECT& area) const {
+    BitBlt(hdcWindow, area.left, area.top, area.right - area.left, area.bottom - area.top,
+           m_hdc, area.left, area.top, SRCCOPY);
+}
+
+void BackBuffer::Release() {
+    if (m_hdc) {
+        if (m_hOldBitmap) SelectObject(m_hdc, m_hOldBitmap);
+        DeleteDC(m_hdc);
+    }
+    if (m_hBitmap) DeleteObject(m_hBitmap);
+    m_hdc = NULL;
+    m_hBitmap = NULL;
+    m_hOldBitmap = NULL;
+    m_bitmapWidth = 0;
+    m_bitmapHeight = 0;
+    m_width = 0;
+    m_height = 0;
+    m_chromeValid = false;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "minux_ui.h"
+
+// Minux Back Buffer
+// Persistent off-screen copy of a window's client area, held in a 32-bit DIB
+// so GDI and the pixel kernels can both draw into it. Static chrome is
+// drawn into it once and kept until the size, theme or DPI changes; each
+// WM_PAINT redraws only the dynamic parts inside the update region and
+// copies just that region to the screen, so frequent refreshes neither
+// flicker nor repaint what did not change.
+
+class BackBuffer {
+public:
+    BackBuffer();
+    ~BackBuffer();
+
+    BackBuffer(const BackBuffer&) = delete;
+    BackBuffer& operator=(const BackBuffer&) = delete;
+
+    // Match the client size of 'hWnd'; false when GDI cannot provide the surface.
+    // The bitmap only grows, so resizing does not reallocate on every step.
+    bool Prepare(HWND hWnd, HDC hdcWindow);
+
+    HDC GetDC() const { return m_hdc; }
+
+    // Pixels of the surface for the pixel kernels, after pending GDI drawing lands
+    bool GetSurface(PixelSurface* surface) const;
+
+    // Chrome is stale after a resize, theme or DPI change
+    bool IsChromeValid() const { return m_chromeValid; }
+    void SetChromeValid() { m_chromeValid = true; }
+    void InvalidateChrome() { m_chromeValid = false; }
+
+    // Copy 'area' of the surface to the window
+    void Present(HDC hdcWindow, const RECT& area) const;
+
+    void Release();
+
+private:
+    HDC m_hdc;
+    HBITMAP m_hBitmap;
+    HGDIOBJ m_hOldBitmap;
+    int m_bitmapWidth;          // allocated size
+    int m_bitmapHeight;
+    int m_width;                // client size the chrome was drawn for
+    int m_height;
+    bool m_chromeValid;
+};
@@ -0,0 +1,581 @@
+#include "framework.h"
+#include "minux_collector.h"
+#include "core/minux_triple_buffer.h"
+#include "core/minux_recording.h"
+#include "core/minux_timerwheel.h"
+#include <memory>
+
+// Collector state
+static TripleBuffer<MinuxSnapshot> g_snapshots;
+static std::atomic<bool> g_notifyPending(false);
+static HANDLE g_hCollectorThread = NULL;
+static HANDLE g_hStopEvent = NULL;
+static HANDLE g_hWakeEvent = NULL;              // seek during playback, view change while live
+static HWND g_hNotifyWnd = NULL;
+static bool g_hasSnapshot = false;
+
+// Sampling cadence: the UI reports the view, the collector thread owns the controller
+static const CadenceRates g_cadenceRates[CADENCE_STREAM_COUNT] = {
+    { FAST_UPDATE_INTERVAL, FAST_UPDATE_INTERVAL, 5 * SYSTEM_UPDATE_INTERVAL, 10 },
+    { SYSTEM_UPDATE_INTERVAL, 2 * SYSTEM_UPDATE_INTERVAL, 10 * SYSTEM_UPDATE_INTERVAL, 4 },
+    { SYSTEM_UPDATE_INTERVAL, 5 * SYSTEM_UPDATE_INTERVAL, 10 * SYSTEM_UPDATE_INTERVAL, 4 },
+};
+// A stream may run this share of its interval late so it can share a wakeup with another
+#define COLLECTOR_SLACK_DIVISOR 8
+
+static std::atomic<bool> g_viewVisible(true);
+static std::atomic<int> g_viewFocus(CADENCE_STREAM_BIT(CADENCE_SYSTEM) | CADENCE_STREAM_BIT(CADENCE_PROCESSES));
+
+// Rows the process list needs in working-set order; only those (plus headroom) are ranked per sample
+static std::atomic<size_t> g_processWindow(0);
+#define COLLECTOR_PROCESS_HEADROOM 64
+
+// System samples of one second, averaged into a single detail point
+struct SystemDetailBucket {
+    uint64_t second;            // timestamp / 1000
+    uint64_t lastTime;          // ms of the newest sample, where the point is drawn
+    double cpu;                 // sums
+    double memory;
+    uint32_t count;
+};
+
+// History is written by the collector and read by any thread under the lock
+static HistoryStore g_history;
+static LodSeries g_historyDetail[HISTORY_SYSTEM_MEMORY + 1];      // one point a second, for zoomable graphs
+static LodSeries g_networkDetail[HISTORY_INTERFACE_TX_BYTES + 1];  // bytes per second over all interfaces
+static SystemDetailBucket g_detailBucket;                           // system samples of the second being filled
+static SRWLOCK g_historyLock = SRWLOCK_INIT;
+
+// Recording is written by the collector and opened or closed by the UI under the lock
+static RecordingWriter g_recorder;
+static SRWLOCK g_recordingLock = SRWLOCK_INIT;
+static ULONGLONG g_lastRecordedTime = 0;        // collector thread only
+
+// Export is written by the collector and opened or closed by the UI under the lock
+static FILE* g_exportFile = NULL;
+static std::unique_ptr<FileExportSink> g_exportSink;
+static std::unique_ptr<SnapshotExporter> g_exporter;
+static SRWLOCK g_exportLock = SRWLOCK_INIT;
+
+// Playback; the reader is only touched while the collector thread is stopped or by that thread
+static RecordingReader g_player;
+static bool g_playbackActive = false;
+static std::atomic<UINT> g_playbackSpeed(1);
+static std::atomic<ULONGLONG> g_seekTarget(0);
+
+// Longest pause between two played snapshots, e.g. where recording was paused
+#define PLAYBACK_MAX_GAP_MS 2000
+
+// Wall-clock time in milliseconds since the Unix epoch
+static ULONGLONG GetUnixTimeMs() {
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    ULARGE_INTEGER t;
+    t.LowPart = ft.dwLowDateTime;
+    t.HighPart = ft.dwHighDateTime;
+    return (t.QuadPart - 116444736000000000ULL) / 10000;
+}
+
+// The 100 ms CPU stream would fill a week's ring in a day; its samples are
+// averaged into one detail point a second, written when the next second starts
+static void AppendSystemDetail(const MinuxSnapshot& snapshot) {
+    SystemDetailBucket& bucket = g_detailBucket;
+    uint64_t second = snapshot.timestamp / 1000;
+    if (bucket.count && second != bucket.second) {
+        g_historyDetail[HISTORY_SYSTEM_CPU].Append(bucket.lastTime, (float)(bucket.cpu / bucket.count));
+        g_historyDetail[HISTORY_SYSTEM_MEMORY].Append(bucket.lastTime, (float)(bucket.memory / bucket.count));
+        bucket = SystemDetailBucket();
+    }
+    bucket.second = second;
+    bucket.lastTime = snapshot.timestamp;
+    bucket.cpu += snapshot.system.cpuUsage;
+    bucket.memory += snapshot.system.memoryUsage;
+    bucket.count++;
+}
+
+// Throughput of every interface together; nothing until some interface has rates
+static void AppendNetworkDetail(const MinuxSnapshot& snapshot) {
+    uint64_t received = 0, sent = 0;
+    bool rated = false;
+    for (const NetworkInfo& info : snapshot.interfaces) {
+        if (!info.rateIntervalMs) continue;
+        received += info.bytesReceivedPerSecond;
+        sent += info.bytesSentPerSecond;
+        rated = true;
+    }
+    if (!rated) return;
+    g_networkDetail[HISTORY_INTERFACE_RX_BYTES].Append(snapshot.timestamp, (float)received);
+    g_networkDetail[HISTORY_INTERFACE_TX_BYTES].Append(snapshot.timestamp, (float)sent);
+}
+
+// History parts freshly sampled by the CADENCE_STREAM_BIT 'streams'
+static int GetHistoryParts(int streams) {
+    int parts = 0;
+    if (streams & CADENCE_STREAM_BIT(CADENCE_SYSTEM)) parts |= HISTORY_SAMPLE_SYSTEM;
+    if (streams & CADENCE_STREAM_BIT(CADENCE_PROCESSES)) parts |= HISTORY_SAMPLE_PROCESSES;
+    if (streams & CADENCE_STREAM_BIT(CADENCE_NETWORK)) parts |= HISTORY_SAMPLE_INTERFACES;
+    return parts;
+}
+
+// Flush and close the export file (export lock held)
+static void CloseExport() {
+    if (!g_exporter) return;
+    g_exporter->Flush();
+    fclose(g_exportFile);
+    g_exporter.reset();
+    g_exportSink.reset();
+    g_exportFile = NULL;
+}
+
+// Record the back buffer and hand it to the UI; 'streams' were sampled for it, the rest carried over
+static void PublishSnapshot(const MinuxSnapshot& snapshot, int streams) {
+    AcquireSRWLockExclusive(&g_historyLock);
+    g_history.Append(snapshot, GetHistoryParts(streams));
+    if (streams & CADENCE_STREAM_BIT(CADENCE_SYSTEM)) AppendSystemDetail(snapshot);
+    if (streams & CADENCE_STREAM_BIT(CADENCE_NETWORK)) AppendNetworkDetail(snapshot);   // at most once a second
+    ReleaseSRWLockExclusive(&g_historyLock);
+
+    // Fast CPU sampling while visible should not multiply the size of recordings
+    if (snapshot.timestamp >= g_lastRecordedTime + RECORDING_INTERVAL || snapshot.timestamp < g_lastRecordedTime) {
+        AcquireSRWLockExclusive(&g_recordingLock);
+        if (g_recorder.IsOpen()) {
+            if (!g_recorder.Append(snapshot)) g_recorder.Close();   // disk full or removed; keep what was written
+            g_lastRecordedTime = snapshot.timestamp;
+        }
+        ReleaseSRWLockExclusive(&g_recordingLock);
+    }
+
+    // Rows of the streams sampled for this snapshot; carried-over rows were exported already
+    int rows = (streams & CADENCE_STREAM_BIT(CADENCE_PROCESSES) ? EXPORT_PROCESSES : 0) |
+               (streams & CADENCE_STREAM_BIT(CADENCE_NETWORK) ? EXPORT_INTERFACES : 0);
+    if (rows) {
+        AcquireSRWLockExclusive(&g_exportLock);
+        if (g_exporter && !g_exporter->Write(snapshot, rows)) CloseExport();   // disk full; keep what was written
+        ReleaseSRWLockExclusive(&g_exportLock);
+    }
+
+    g_snapshots.Publish();
+
+    // Only one wake-up message in flight; the UI always reads the newest snapshot
+    if (!g_notifyPending.exchange(true)) {
+        if (!PostMessage(g_hNotifyWnd, WM_MINUX_SNAPSHOT, 0, 0)) {
+            g_notifyPending = false;
+        }
+    }
+}
+
+static void ClearHistory() {
+    AcquireSRWLockExclusive(&g_historyLock);
+    g_history.Clear();
+    for (LodSeries& series : g_historyDetail) series.Clear();
+    for (LodSeries& series : g_networkDetail) series.Clear();
+    g_detailBucket = SystemDetailBucket();
+    ReleaseSRWLockExclusive(&g_historyLock);
+}
+
+// The collector thread's one wait point: sleep until the next timer or an event.
+// Due timers have run when this returns WAIT_TIMEOUT.
+static DWORD WaitForTimers(TimerWheel& timers) {
+    HANDLE events[2] = { g_hStopEvent, g_hWakeEvent };
+    ULONGLONG next = timers.GetNextExpiry();
+    ULONGLONG now = GetTickCount64();
+    DWORD waitMs = INFINITE;
+    if (next != TIMER_NEVER) {
+        ULONGLONG delay = next > now ? next - now : 0;
+        waitMs = (DWORD)(delay < INFINITE ? delay : INFINITE - 1);
+    }
+    DWORD result = WaitForMultipleObjects(2, events, FALSE, waitMs);
+    if (result == WAIT_TIMEOUT) timers.Advance(GetTickCount64());
+    return result;
+}
+
+// Marks its stream for the next snapshot; streams that fire together share one
+class StreamTask : public TimerTask {
+public:
+    StreamTask() : m_stream(0), m_pending(NULL) {}
+    void Bind(int stream, int* pending) { m_stream = stream; m_pending = pending; }
+    void OnTimer(TimerWheel&, uint64_t) override { *m_pending |= CADENCE_STREAM_BIT(m_stream); }
+
+private:
+    int m_stream;
+    int* m_pending;
+};
+
+// Hands buffered export rows to the file; between flushes they stay in memory
+class ExportFlushTask : public TimerTask {
+public:
+    void OnTimer(TimerWheel& wheel, uint64_t now) override {
+        AcquireSRWLockExclusive(&g_exportLock);
+        if (g_exporter && (!g_exporter->Flush() || fflush(g_exportFile) != 0)) CloseExport();
+        ReleaseSRWLockExclusive(&g_exportLock);
+        wheel.Schedule(this, now + EXPORT_FLUSH_INTERVAL, EXPORT_FLUSH_INTERVAL / 4);
+    }
+};
+
+// Stream versions a triple-buffer slot holds; 0 for a slot this state has not filled
+struct SlotVersions {
+    const MinuxSnapshot* slot;
+    uint64_t versions[CADENCE_STREAM_COUNT];
+};
+
+// Newest value of every stream; the back buffer is two publishes old, so it is
+// refilled from here, copying only the streams sampled since that slot was filled
+struct CollectorState {
+    MinuxSnapshot latest;
+    std::vector<ProcessInfo> previousProcesses;
+    std::vector<NetworkInfo> previousInterfaces;
+    uint64_t versions[CADENCE_STREAM_COUNT];    // bumped on every sample of the stream
+    SlotVersions slots[3];
+    CadenceController cadence;
+    TimerWheel timers;
+    StreamTask streams[CADENCE_STREAM_COUNT];
+    ExportFlushTask exportFlush;
+    int pending;
+
+    CollectorState() : slots(), cadence(g_cadenceRates), timers(GetTickCount64()), pending(0) {
+        for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+            streams[stream].Bind(stream, &pending);
+            versions[stream] = 1;
+        }
+    }
+
+    SlotVersions& GetSlot(const MinuxSnapshot* slot) {
+        for (SlotVersions& entry : slots) {
+            if (entry.slot == slot) return entry;
+        }
+        for (SlotVersions& entry : slots) {
+            if (!entry.slot) {
+                entry.slot = slot;
+                return entry;
+            }
+        }
+        return slots[0];    // unreachable: the triple buffer has three slots
+    }
+};
+
+// Put the streams' timers where the cadence wants them
+static void ArmStreams(CollectorState& state, int mask) {
+    for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+        if (!(mask & CADENCE_STREAM_BIT(stream))) continue;
+        state.timers.Schedule(&state.streams[stream], state.cadence.GetDueTime(stream),
+                              state.cadence.GetInterval(stream) / COLLECTOR_SLACK_DIVISOR);
+    }
+}
+
+// Sample the due streams and publish them with the others carried over
+static void CollectSnapshot(CollectorState& state, int due, ULONGLONG sequence, ULONGLONG now) {
+    MinuxSnapshot& latest = state.latest;
+    if (due & CADENCE_STREAM_BIT(CADENCE_SYSTEM)) {
+        SystemInfo previous = latest.system;
+        GetSystemInformation(latest.system, latest.cores);
+        state.cadence.Complete(CADENCE_SYSTEM, now, HasSystemChanged(previous, latest.system));
+    }
+    if (due & CADENCE_STREAM_BIT(CADENCE_PROCESSES)) {
+        state.previousProcesses.swap(latest.processes);
+        latest.orderedProcessCount = GetProcessList(latest.processes, g_processWindow + COLLECTOR_PROCESS_HEADROOM);
+        state.cadence.Complete(CADENCE_PROCESSES, now, HaveProcessesChanged(state.previousProcesses, latest.processes));
+    }
+    if (due & CADENCE_STREAM_BIT(CADENCE_NETWORK)) {
+        state.previousInterfaces.swap(latest.interfaces);
+        GetNetworkInterfaces(latest.interfaces);
+        state.cadence.Complete(CADENCE_NETWORK, now, HaveInterfacesChanged(state.previousInterfaces, latest.interfaces));
+    }
+    for (int stream = 0; stream < CADENCE_STREAM_COUNT; stream++) {
+        if (due & CADENCE_STREAM_BIT(stream)) state.versions[stream]++;
+    }
+
+    // A 100 ms CPU tick copies the system figures, not the process and interface lists
+    MinuxSnapshot& snapshot = g_snapshots.BackBuffer();
+    SlotVersions& slot = state.GetSlot(&snapshot);
+    snapshot.timestamp = GetUnixTimeMs();
+    snapshot.sequence = sequence;
+    if (slot.versions[CADENCE_SYSTEM] != state.versions[CADENCE_SYSTEM]) {
+        snapshot.system = latest.system;
+        snapshot.cores = latest.cores;
+    }
+    if (slot.versions[CADENCE_PROCESSES] != state.versions[CADENCE_PROCESSES]) {
+        snapshot.processes = latest.processes;
+        snapshot.orderedProcessCount = latest.orderedProcessCount;
+    }
+    if (slot.versions[CADENCE_NETWORK] != state.versions[CADENCE_NETWORK]) {
+        snapshot.interfaces = latest.interfaces;
+    }
+    memcpy(slot.versions, state.versions, sizeof(slot.versions));
+    PublishSnapshot(snapshot, due);
+}
+
+// Every stream is a timer; a view change wakes the thread to move them
+static DWORD WINAPI CollectorThreadProc(LPVOID) {
+    StartPerformanceCounters();
+
+    CollectorState state;
+    ULONGLONG sequence = 0;
+    state.cadence.SetView(g_viewVisible, g_viewFocus, GetTickCount64());
+    ArmStreams(state, CADENCE_ALL_STREAMS);
+    state.timers.Schedule(&state.exportFlush, state.timers.GetTime() + EXPORT_FLUSH_INTERVAL, EXPORT_FLUSH_INTERVAL / 4);
+    for (;;) {
+        DWORD result = WaitForTimers(state.timers);
+        if (result == WAIT_OBJECT_0 + 1) {
+            state.cadence.SetView(g_viewVisible, g_viewFocus, GetTickCount64());
+            ArmStreams(state, CADENCE_ALL_STREAMS);
+            continue;
+        }
+        if (result != WAIT_TIMEOUT) break;
+
+        if (state.pending) {
+            int due = state.pending;
+            state.pending = 0;
+            CollectSnapshot(state, due, ++sequence, GetTickCount64());
+            ArmStreams(state, due);
+        }
+    }
+
+    StopPerformanceCounters();
+    return 0;
+}
+
+// Replays one record, then waits out the original spacing divided by the speed
+class PlaybackTask : public TimerTask {
+public:
+    PlaybackTask() : m_record(0) {}
+    size_t GetRecord() const { return m_record; }
+    void SetRecord(size_t record) { m_record = record; }
+
+    void OnTimer(TimerWheel& wheel, uint64_t now) override {
+        size_t count = g_player.GetRecordCount();
+        if (m_record >= count) return;      // hold the last snapshot
+
+        MinuxSnapshot& snapshot = g_snapshots.BackBuffer();
+        if (g_player.ReadRecord(m_record, snapshot)) PublishSnapshot(snapshot, CADENCE_ALL_STREAMS);
+        m_record++;
+        if (m_record < count) {
+            ULONGLONG previous = g_player.GetRecordTime(m_record - 1);
+            ULONGLONG next = g_player.GetRecordTime(m_record);
+            ULONGLONG gap = next > previous ? (next - previous) / g_playbackSpeed : 0;
+            wheel.Schedule(this, now + (gap < PLAYBACK_MAX_GAP_MS ? gap : PLAYBACK_MAX_GAP_MS));
+        }
+    }
+
+private:
+    size_t m_record;
+};
+
+static DWORD WINAPI PlaybackThreadProc(LPVOID) {
+    TimerWheel timers(GetTickCount64());
+    PlaybackTask playback;
+    ExportFlushTask exportFlush;
+    size_t count = g_player.GetRecordCount();
+    timers.Schedule(&playback, timers.GetTime());
+    timers.Schedule(&exportFlush, timers.GetTime() + EXPORT_FLUSH_INTERVAL, EXPORT_FLUSH_INTERVAL / 4);
+
+    for (;;) {
+        DWORD result = WaitForTimers(timers);
+        if (result == WAIT_OBJECT_0 + 1) {
+            size_t target = g_player.Seek(g_seekTarget);
+            if (target >= count && count > 0) target = count - 1;
+
+            // History only moves forward; going back starts it over
+            if (target < playback.GetRecord()) ClearHistory();
+            playback.SetRecord(target);
+            timers.Schedule(&playback, GetTickCount64());
+        } else if (result != WAIT_TIMEOUT) {
+            break;
+        }
+    }
+    return 0;
+}
+
+static bool StartCollectorThread(LPTHREAD_START_ROUTINE threadProc) {
+    g_hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    g_hWakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (g_hStopEvent && g_hWakeEvent) {
+        g_hCollectorThread = CreateThread(NULL, 0, threadProc, NULL, 0, NULL);
+    }
+    if (!g_hCollectorThread) {
+        if (g_hStopEvent) CloseHandle(g_hStopEvent);
+        if (g_hWakeEvent) CloseHandle(g_hWakeEvent);
+        g_hStopEvent = NULL;
+        g_hWakeEvent = NULL;
+        return false;
+    }
+    SetThreadPriority(g_hCollectorThread, THREAD_PRIORITY_BELOW_NORMAL);
+    return true;
+}
+
+// Start the background collector
+bool StartCollector(HWND hNotify) {
+    if (g_hCollectorThread) return true;
+
+    g_hNotifyWnd = hNotify;
+    return StartCollectorThread(CollectorThreadProc);
+}
+
+// Stop the collector and wait for the in-progress sample to finish
+void StopCollector() {
+    if (!g_hCollectorThread) return;
+
+    SetEvent(g_hStopEvent);
+    WaitForSingleObject(g_hCollectorThread, INFINITE);
+    CloseHandle(g_hCollectorThread);
+    CloseHandle(g_hStopEvent);
+    CloseHandle(g_hWakeEvent);
+    g_hCollectorThread = NULL;
+    g_hStopEvent = NULL;
+    g_hWakeEvent = NULL;
+}
+
+// Re-plan the live cadence; playback keeps the recording's own pace
+void SetCollectorView(bool visible, int focusedStreams) {
+    if (g_viewVisible == visible && g_viewFocus == focusedStreams) return;
+    g_viewVisible = visible;
+    g_viewFocus = focusedStreams;
+    if (g_hWakeEvent && !g_playbackActive) SetEvent(g_hWakeEvent);
+}
+
+// Takes effect from the next process sample
+void SetProcessListWindow(size_t rows) {
+    g_processWindow = rows;
+}
+
+// Pick up the newest published snapshot
+bool AcquireSnapshot() {
+    g_notifyPending = false;
+    if (!g_snapshots.Acquire()) return false;
+    g_hasSnapshot = true;
+    return true;
+}
+
+const MinuxSnapshot* GetCurrentSnapshot() {
+    return g_hasSnapshot ? &g_snapshots.FrontBuffer() : NULL;
+}
+
+// Shared read access to the history; pair every call with UnlockHistory
+const HistoryStore& LockHistory() {
+    AcquireSRWLockShared(&g_historyLock);
+    return g_history;
+}
+
+void UnlockHistory() {
+    ReleaseSRWLockShared(&g_historyLock);
+}
+
+const LodSeries& GetHistoryDetail(int field) {
+    return g_historyDetail[field];
+}
+
+const LodSeries& GetNetworkDetail(int field) {
+    return g_networkDetail[field];
+}
+
+// Start writing every live snapshot to <prefix>.NNN.mxr
+bool StartRecording(const wchar_t* prefix) {
+    if (g_playbackActive) return false;
+
+    AcquireSRWLockExclusive(&g_recordingLock);
+    bool opened = g_recorder.Open(prefix);
+    ReleaseSRWLockExclusive(&g_recordingLock);
+    return opened;
+}
+
+// Close the recording; this writes the index of its last segment
+void StopRecording() {
+    AcquireSRWLockExclusive(&g_recordingLock);
+    g_recorder.Close();
+    ReleaseSRWLockExclusive(&g_recordingLock);
+}
+
+bool IsRecording() {
+    AcquireSRWLockShared(&g_recordingLock);
+    bool open = g_recorder.IsOpen();
+    ReleaseSRWLockShared(&g_recordingLock);
+    return open;
+}
+
+// Start writing the rows of every sampled snapshot to 'path', replacing it
+bool StartExport(const wchar_t* path, ExportFormat format) {
+    FILE* file = NULL;
+    if (_wfopen_s(&file, path, L"wb") != 0 || !file) return false;
+
+    AcquireSRWLockExclusive(&g_exportLock);
+    CloseExport();
+    g_exportFile = file;
+    g_exportSink.reset(new FileExportSink(file));
+    g_exporter.reset(new SnapshotExporter(format, g_exportSink.get()));
+    ReleaseSRWLockExclusive(&g_exportLock);
+    return true;
+}
+
+void StopExport() {
+    AcquireSRWLockExclusive(&g_exportLock);
+    CloseExport();
+    ReleaseSRWLockExclusive(&g_exportLock);
+}
+
+bool IsExporting() {
+    AcquireSRWLockShared(&g_exportLock);
+    bool open = g_exporter.get() != NULL;
+    ReleaseSRWLockShared(&g_exportLock);
+    return open;
+}
+
+// Replace live collection with playback of a recording from its start
+bool StartPlayback(const wchar_t* path) {
+    StopRecording();
+    StopCollector();
+
+    if (!g_player.Open(path) || g_player.GetRecordCount() == 0) {
+        g_player.Close();
+        if (g_playbackActive) {
+            g_playbackActive = false;
+            ClearHistory();
+        }
+        StartCollectorThread(CollectorThreadProc);
+        return false;
+    }
+
+    g_playbackActive = true;
+    ClearHistory();
+    if (!StartCollectorThread(PlaybackThreadProc)) {
+        StopPlayback();
+        return false;
+    }
+    return true;
+}
+
+// Return to live collection
+void StopPlayback() {
+    if (!g_playbackActive) return;
+
+    StopCollector();
+    g_player.Close();
+    g_playbackActive = false;
+    ClearHistory();
+    StartCollectorThread(CollectorThreadProc);
+}
+
+bool IsPlaybackActive() {
+    return g_playbackActive;
+}
+
+bool GetPlaybackRange(ULONGLONG* start, ULONGLONG* end) {
+    if (!g_playbackActive) return false;
+    *start = g_player.GetStartTime();
+    *end = g_player.GetEndTime();
+    return true;
+}
+
+void SeekPlayback(ULONGLONG timestamp) {
+    if (!g_playbackActive || !g_hWakeEvent) return;
+    g_seekTarget = timestamp;
+    SetEvent(g_hWakeEvent);
+}
+
+void SetPlaybackSpeed(UINT speed) {
+    if (speed < 1) speed = 1;
+    if (speed > PLAYBACK_MAX_SPEED) speed = PLAYBACK_MAX_SPEED;
+    g_playbackSpeed = speed;
+}
+
+UINT GetPlaybackSpeed() {
+    return g_playbackSpeed;
+}
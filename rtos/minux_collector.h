@@ -0,0 +1,74 @@
+#pragma once
+#include "minux_ui.h"
+#include "core/minux_snapshot.h"
+#include "core/minux_history.h"
+#include "core/minux_lod.h"
+#include "core/minux_cadence.h"
+#include "core/minux_export.h"
+
+// Minux Collector
+// Background thread that samples the system into one timestamped snapshot
+// and publishes it to the UI thread through a lock-free triple buffer. Each
+// part of the snapshot is refreshed at its own cadence, set by what the
+// window currently shows; parts not due are carried over from the last sample.
+// All of the thread's periodic work runs from one timer wheel and one wait.
+// Live snapshots can be recorded to disk or exported as rows; a recording
+// can be played back in place of live collection and drives the same views
+// and history.
+
+// Posted to the notify window when a new snapshot is ready. At most one is
+// in flight; the UI picks up the newest snapshot whenever it handles it.
+#define WM_MINUX_SNAPSHOT (WM_APP + 1)
+
+// Collector lifetime (UI thread)
+bool StartCollector(HWND hNotify);
+void StopCollector();
+
+// What the user can see; 'focusedStreams' is a CADENCE_STREAM_BIT mask of the active view (UI thread)
+void SetCollectorView(bool visible, int focusedStreams);
+
+// Rows at the top of the process list the UI needs ranked by working set (UI thread)
+void SetProcessListWindow(size_t rows);
+
+// Snapshot access (UI thread only)
+bool AcquireSnapshot();                         // true when a newer snapshot was picked up
+const MinuxSnapshot* GetCurrentSnapshot();      // NULL until the first snapshot arrives
+
+// History of every collected snapshot (any thread; hold the lock briefly)
+const HistoryStore& LockHistory();
+void UnlockHistory();
+
+// HISTORY_SYSTEM_CPU or _MEMORY, one point a second (the mean of that second's
+// samples) for the last 7 days, for graphs at any zoom (hold the history lock)
+const LodSeries& GetHistoryDetail(int field);
+
+// HISTORY_INTERFACE_RX_BYTES or _TX_BYTES summed over all interfaces, one point
+// per network sample (at most one a second) (hold the history lock)
+const LodSeries& GetNetworkDetail(int field);
+
+// Recording of live snapshots, at most one per RECORDING_INTERVAL (UI thread)
+#define RECORDING_INTERVAL SYSTEM_UPDATE_INTERVAL
+
+bool StartRecording(const wchar_t* prefix);    // segments <prefix>.NNN.mxr
+void StopRecording();
+bool IsRecording();
+
+// Export of process and interface rows as they are sampled, live or played
+// back; a collector timer hands buffered rows to the file every
+// EXPORT_FLUSH_INTERVAL, so a crash loses at most that much (UI thread)
+#define EXPORT_FLUSH_INTERVAL (5 * SYSTEM_UPDATE_INTERVAL)
+
+bool StartExport(const wchar_t* path, ExportFormat format);
+void StopExport();                              // flushes and closes the file
+bool IsExporting();
+
+// Offline playback; the collector thread replays the recording instead of sampling (UI thread)
+#define PLAYBACK_MAX_SPEED 64
+
+bool StartPlayback(const wchar_t* path);       // any segment of a recording
+void StopPlayback();                            // back to live collection
+bool IsPlaybackActive();
+bool GetPlaybackRange(ULONGLONG* start, ULONGLONG* end);
+void SeekPlayback(ULONGLONG timestamp);         // ms since the Unix epoch
+void SetPlaybackSpeed(UINT speed);              // times real time, 1..PLAYBACK_MAX_SPEED
+UINT GetPlaybackSpeed();
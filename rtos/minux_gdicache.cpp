@@ -0,0 +1,110 @@
+#include "framework.h"
+#include "minux_gdicache.h"
+
+GdiCache g_gdiCache;
+
+GdiCache::GdiCache() : m_theme(0), m_dpi(96), m_hits(0), m_misses(0), m_created(0), m_deleted(0) {
+}
+
+GdiCache::~GdiCache() {
+    for (auto& item : m_entries) {
+        if (item.second.handle) DeleteObject(item.second.handle);
+    }
+}
+
+void GdiCache::SetContext(int theme, UINT dpi) {
+    if (dpi == 0) dpi = 96;
+    if (theme == m_theme && dpi == m_dpi) return;
+    m_theme = theme;
+    m_dpi = dpi;
+
+    // Everything made so far belongs to the old theme or DPI
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        GdiCacheEntry& entry = it->second;
+        if (entry.refs > 0) {
+            entry.stale = true;
+            ++it;
+            continue;
+        }
+        if (entry.handle) {
+            DeleteObject(entry.handle);
+            m_deleted++;
+        }
+        it = m_entries.erase(it);
+    }
+}
+
+GdiCacheEntry* GdiCache::Lookup(const GdiKey& key) {
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_hits++;
+        it->second.stale = false;       // back to the theme and DPI it was made for
+        return &it->second;
+    }
+
+    m_misses++;
+    GdiCacheEntry entry = { key, Create(key), 0, false };
+    if (!entry.handle) return NULL;
+    m_created++;
+    return &m_entries.emplace(key, entry).first->second;
+}
+
+HGDIOBJ GdiCache::Create(const GdiKey& key) const {
+    switch (key.kind) {
+    case GDI_BRUSH:
+        return CreateSolidBrush(key.color);
+    case GDI_PEN:
+        return CreatePen(key.style, Scale(key.size), key.color);
+    case GDI_FONT:
+        return CreateFont(Scale(key.size), 0, 0, 0, key.weight, FALSE, FALSE, FALSE,
+                          DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
+                          CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
+    case GDI_ROUND_REGION:
+        return CreateRoundRectRgn(0, 0, key.size, key.weight, Scale(key.style), Scale(key.style));
+    }
+    return NULL;
+}
+
+GdiRef<HBRUSH> GdiCache::GetBrush(COLORREF color) {
+    GdiKey key = { GDI_BRUSH, m_theme, m_dpi, color, 0, 0, 0 };
+    return GdiRef<HBRUSH>(this, Lookup(key));
+}
+
+GdiRef<HPEN> GdiCache::GetPen(COLORREF color, int width, int style) {
+    GdiKey key = { GDI_PEN, m_theme, m_dpi, color, width, 0, style };
+    return GdiRef<HPEN>(this, Lookup(key));
+}
+
+GdiRef<HFONT> GdiCache::GetFont(int height, int weight) {
+    GdiKey key = { GDI_FONT, m_theme, m_dpi, 0, height, weight, 0 };
+    return GdiRef<HFONT>(this, Lookup(key));
+}
+
+GdiRef<HRGN> GdiCache::GetRoundRegion(int width, int height, int radius) {
+    GdiKey key = { GDI_ROUND_REGION, m_theme, m_dpi, 0, width, height, radius };
+    return GdiRef<HRGN>(this, Lookup(key));
+}
+
+void GdiCache::Release(GdiCacheEntry* entry) {
+    if (--entry->refs > 0 || !entry->stale) return;
+    DeleteObject(entry->handle);
+    m_deleted++;
+    m_entries.erase(entry->key);
+}
+
+void GdiCache::Trim() {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.refs > 0) {
+            ++it;
+            continue;
+        }
+        DeleteObject(it->second.handle);
+        m_deleted++;
+        it = m_entries.erase(it);
+    }
+}
+
+GdiCacheStats GdiCache::GetStats() const {
+    GdiCacheStats stats = { m_hits, m_misses, m_created, m_deleted, m_entries.size() };
+    return stats;
+}
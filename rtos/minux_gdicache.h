@@ -0,0 +1,154 @@
+#pragma once
+#include <unordered_map>
+#include "minux_ui.h"
+
+// Minux GDI Cache
+// Shared fonts, brushes, pens and rounded clip regions for the painting code.
+// Objects are keyed by the active theme, the window DPI and their style, are
+// created on first use and then handed out again on every frame. A theme or
+// DPI change starts a new generation: unused objects of the old one are
+// deleted at once, objects still held are deleted when their last reference
+// goes. Colours that change every frame (gradients, heat cells) should use
+// the stock DC brush and pen instead of filling the cache.
+//
+// UI thread only.
+
+enum GdiKind {
+    GDI_BRUSH,
+    GDI_PEN,
+    GDI_FONT,
+    GDI_ROUND_REGION            // rounded rectangle at the origin; offset the clip to place it
+};
+
+struct GdiKey {
+    int kind;
+    int theme;
+    UINT dpi;
+    COLORREF color;
+    int size;                   // pen width and font height at 96 dpi, region width in pixels
+    int weight;                 // font weight, region height in pixels
+    int style;                  // pen style, region corner radius at 96 dpi
+
+    bool operator==(const GdiKey& other) const {
+        return kind == other.kind && theme == other.theme && dpi == other.dpi && color == other.color &&
+               size == other.size && weight == other.weight && style == other.style;
+    }
+};
+
+struct GdiKeyHash {
+    size_t operator()(const GdiKey& key) const {
+        size_t hash = (size_t)key.kind * 0x9E3779B1u;
+        hash = (hash ^ key.theme) * 0x01000193u;
+        hash = (hash ^ key.dpi) * 0x01000193u;
+        hash = (hash ^ key.color) * 0x01000193u;
+        hash = (hash ^ (size_t)key.size) * 0x01000193u;
+        hash = (hash ^ (size_t)key.weight) * 0x01000193u;
+        return (hash ^ (size_t)key.style) * 0x01000193u;
+    }
+};
+
+struct GdiCacheEntry {
+    GdiKey key;
+    HGDIOBJ handle;
+    int refs;
+    bool stale;                 // from another theme or DPI; deleted on last release
+};
+
+struct GdiCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t created;
+    uint64_t deleted;
+    size_t live;                // GDI objects owned by the cache right now
+};
+
+class GdiCache;
+
+// Counted reference to a cached object; the handle stays valid while any copy lives
+template <class T>
+class GdiRef {
+public:
+    GdiRef() : m_cache(NULL), m_entry(NULL) {}
+    GdiRef(GdiCache* cache, GdiCacheEntry* entry);
+    GdiRef(const GdiRef& other);
+    GdiRef& operator=(const GdiRef& other);
+    ~GdiRef() { Reset(); }
+
+    T Get() const { return m_entry ? (T)m_entry->handle : NULL; }
+    void Reset();
+
+private:
+    GdiCache* m_cache;
+    GdiCacheEntry* m_entry;
+};
+
+class GdiCache {
+public:
+    GdiCache();
+    ~GdiCache();
+
+    GdiCache(const GdiCache&) = delete;
+    GdiCache& operator=(const GdiCache&) = delete;
+
+    // Theme index (0 dark, 1 light) and DPI the following objects are made for
+    void SetContext(int theme, UINT dpi);
+    int GetTheme() const { return m_theme; }
+    UINT GetDpi() const { return m_dpi; }
+
+    GdiRef<HBRUSH> GetBrush(COLORREF color);
+    GdiRef<HPEN> GetPen(COLORREF color, int width = 1, int style = PS_SOLID);
+    GdiRef<HFONT> GetFont(int height, int weight = FW_NORMAL);     // Segoe UI, 96 dpi pixels
+    GdiRef<HRGN> GetRoundRegion(int width, int height, int radius);  // device pixels, radius at 96 dpi
+
+    // Scale a 96 dpi length to the current DPI
+    int Scale(int value) const { return MulDiv(value, (int)m_dpi, 96); }
+
+    GdiCacheStats GetStats() const;
+
+    // Delete every object no one holds
+    void Trim();
+
+    void AddRef(GdiCacheEntry* entry) { entry->refs++; }
+    void Release(GdiCacheEntry* entry);
+
+private:
+    GdiCacheEntry* Lookup(const GdiKey& key);
+    HGDIOBJ Create(const GdiKey& key) const;
+
+    std::unordered_map<GdiKey, GdiCacheEntry, GdiKeyHash> m_entries;  // nodes never move
+    int m_theme;
+    UINT m_dpi;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_created;
+    uint64_t m_deleted;
+};
+
+// The application's cache, kept in step with the theme and the main window's DPI
+extern GdiCache g_gdiCache;
+
+template <class T>
+GdiRef<T>::GdiRef(GdiCache* cache, GdiCacheEntry* entry) : m_cache(cache), m_entry(entry) {
+    if (m_entry) m_cache->AddRef(m_entry);
+}
+
+template <class T>
+GdiRef<T>::GdiRef(const GdiRef& other) : m_cache(other.m_cache), m_entry(other.m_entry) {
+    if (m_entry) m_cache->AddRef(m_entry);
+}
+
+template <class T>
+GdiRef<T>& GdiRef<T>::operator=(const GdiRef& other) {
+    if (other.m_entry) other.m_cache->AddRef(other.m_entry);
+    Reset();
+    m_cache = other.m_cache;
+    m_entry = other.m_entry;
+    return *this;
+}
+
+template <class T>
+void GdiRef<T>::Reset() {
+    if (m_entry) m_cache->Release(m_entry);
+    m_cache = NULL;
+    m_entry = NULL;
+}
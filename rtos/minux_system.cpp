@@ -1,14 +1,7 @@
 #include "framework.h"
 #include "minux_ui.h"
-
-#pragma comment(lib, "psapi.lib")
-#pragma comment(lib, "pdh.lib")
-#pragma comment(lib, "iphlpapi.lib")
-
-// Global performance counters
-PerformanceCounters g_perfCounters = {0};
-static PDH_HQUERY g_hQuery = NULL;
-static PDH_HCOUNTER g_hCpuCounter = NULL;
+#include "minux_gdicache.h"
+#include "core/minux_effects.h"
 
 // Theme definitions
 MinuxTheme g_darkTheme = {
@@ -44,224 +37,155 @@ MinuxTheme GetCurrentTheme() {
 
 void SetDarkTheme() {
     g_isDarkTheme = true;
+    g_gdiCache.SetContext(0, g_gdiCache.GetDpi());
 }
 
 void SetLightTheme() {
     g_isDarkTheme = false;
+    g_gdiCache.SetContext(1, g_gdiCache.GetDpi());
 }
 
-// Initialize performance counters
-void StartPerformanceCounters() {
-    PdhOpenQuery(NULL, 0, &g_hQuery);
-    PdhAddEnglishCounter(g_hQuery, L"\\Processor(_Total)\\% Processor Time", 0, &g_hCpuCounter);
-    PdhCollectQueryData(g_hQuery);
+// 32-bit top-down DIB section; its pixels are premultiplied BGRA for the pixel kernels
+HBITMAP CreateCompatibleBitmapWithAlpha(HDC hdc, int width, int height) {
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
     
-    QueryPerformanceFrequency(&g_perfCounters.frequency);
+    void* bits = NULL;
+    return CreateDIBSection(hdc, &info, DIB_RGB_COLORS, &bits, NULL, 0);
 }
 
-void StopPerformanceCounters() {
-    if (g_hQuery) {
-        PdhCloseQuery(g_hQuery);
-        g_hQuery = NULL;
+// Pixels of a bitmap made by CreateCompatibleBitmapWithAlpha; call GdiFlush before touching them
+bool GetBitmapSurface(HBITMAP hBitmap, PixelSurface* surface) {
+    DIBSECTION dib;
+    if (GetObject(hBitmap, sizeof(dib), &dib) != sizeof(dib) || !dib.dsBm.bmBits || dib.dsBm.bmBitsPixel != 32) {
+        return false;
     }
+    surface->pixels = (uint32_t*)dib.dsBm.bmBits;
+    surface->width = dib.dsBm.bmWidth;
+    surface->height = dib.dsBm.bmHeight;
+    surface->stride = dib.dsBm.bmWidthBytes / 4;
+    return true;
 }
 
-// Get system information
-SystemInfo GetSystemInformation() {
-    SystemInfo info = {0};
-    
-    // Get CPU usage
-    if (g_hQuery && g_hCpuCounter) {
-        PdhCollectQueryData(g_hQuery);
-        PDH_FMT_COUNTERVALUE cpuValue;
-        if (PdhGetFormattedCounterValue(g_hCpuCounter, PDH_FMT_DOUBLE, NULL, &cpuValue) == ERROR_SUCCESS) {
-            info.cpuUsage = (DWORD)cpuValue.doubleValue;
-        }
-    }
-    
-    // Get memory usage
-    MEMORYSTATUSEX memStatus = {0};
-    memStatus.dwLength = sizeof(memStatus);
-    if (GlobalMemoryStatusEx(&memStatus)) {
-        info.memoryUsage = memStatus.dwMemoryLoad;
-    }
-    
-    // Get process and thread count
-    PERFORMANCE_INFORMATION perfInfo = {0};
-    perfInfo.cb = sizeof(perfInfo);
-    if (GetPerformanceInfo(&perfInfo, sizeof(perfInfo))) {
-        info.processCount = perfInfo.ProcessCount;
-        info.threadCount = perfInfo.ThreadCount;
-    }
-    
-    // Get uptime
-    info.uptime = GetTickCount64();
-    
-    // Get computer name
-    DWORD nameSize = sizeof(info.computerName)/sizeof(wchar_t);
-    GetComputerNameW(info.computerName, &nameSize);
-    
-    // Get OS version using RtlGetVersion (recommended replacement for GetVersionEx)
-    typedef NTSTATUS (WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
-    HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
-    if (hMod) {
-        RtlGetVersionPtr fxPtr = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
-        if (fxPtr) {
-            RTL_OSVERSIONINFOW rovi = {0};
-            rovi.dwOSVersionInfoSize = sizeof(rovi);
-            if (fxPtr(&rovi) == 0) {
-                swprintf_s(info.osVersion, L"Windows %d.%d Build %d", 
-                         rovi.dwMajorVersion, rovi.dwMinorVersion, rovi.dwBuildNumber);
-            }
-        }
-    }
-    
-    // Fallback to generic version if RtlGetVersion fails
-    if (wcslen(info.osVersion) == 0) {
-        wcscpy_s(info.osVersion, L"Windows 10+");
-    }
-    
-    return info;
+uint32_t ColorToPixel(COLORREF color, BYTE alpha) {
+    return PixelPremultiply(PIXEL_ARGB(alpha, GetRValue(color), GetGValue(color), GetBValue(color)));
 }
 
-// Get process list
-std::vector<ProcessInfo> GetProcessList() {
-    std::vector<ProcessInfo> processes;
-    
-    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (hSnapshot == INVALID_HANDLE_VALUE) return processes;
-    
-    PROCESSENTRY32W pe32 = {0};
-    pe32.dwSize = sizeof(pe32);
-    
-    if (Process32FirstW(hSnapshot, &pe32)) {
-        do {
-            ProcessInfo info = {0};
-            info.processId = pe32.th32ProcessID;
-            wcscpy_s(info.processName, pe32.szExeFile);
-            info.threadCount = pe32.cntThreads;
-            
-            // Get memory usage
-            HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pe32.th32ProcessID);
-            if (hProcess) {
-                PROCESS_MEMORY_COUNTERS pmc = {0};
-                if (GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc))) {
-                    info.workingSetSize = pmc.WorkingSetSize;
-                }
-                
-                // Get creation time
-                FILETIME createTime, exitTime, kernelTime, userTime;
-                if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime)) {
-                    info.creationTime = createTime;
-                }
-                
-                CloseHandle(hProcess);
-            }
-            
-            processes.push_back(info);
-        } while (Process32NextW(hSnapshot, &pe32));
-    }
-    
-    CloseHandle(hSnapshot);
-    
-    // Sort by memory usage (descending)
-    std::sort(processes.begin(), processes.end(), 
-              [](const ProcessInfo& a, const ProcessInfo& b) {
-                  return a.workingSetSize > b.workingSetSize;
-              });
-    
-    return processes;
-}
+// Scratch DIB the drawing helpers render into before one blit; kept for the life of the process
+static HDC g_scratchDC = NULL;
+static HBITMAP g_scratchBitmap = NULL;
+static HGDIOBJ g_scratchOldBitmap = NULL;
+static PixelSurface g_scratchSurface;
 
-// Get network interfaces
-std::vector<NetworkInfo> GetNetworkInterfaces() {
-    std::vector<NetworkInfo> interfaces;
-    
-    DWORD dwSize = 0;
-    if (GetAdaptersInfo(NULL, &dwSize) == ERROR_BUFFER_OVERFLOW) {
-        IP_ADAPTER_INFO* pAdapterInfo = (IP_ADAPTER_INFO*)malloc(dwSize);
-        if (pAdapterInfo && GetAdaptersInfo(pAdapterInfo, &dwSize) == NO_ERROR) {
-            IP_ADAPTER_INFO* pAdapter = pAdapterInfo;
-            while (pAdapter) {
-                NetworkInfo info = {0};
-                MultiByteToWideChar(CP_ACP, 0, pAdapter->AdapterName, -1, info.adapterName, 256);
-                MultiByteToWideChar(CP_ACP, 0, pAdapter->IpAddressList.IpAddress.String, -1, info.ipAddress, 16);
-                
-                // Format MAC address
-                swprintf_s(info.macAddress, L"%02X-%02X-%02X-%02X-%02X-%02X",
-                         pAdapter->Address[0], pAdapter->Address[1], pAdapter->Address[2],
-                         pAdapter->Address[3], pAdapter->Address[4], pAdapter->Address[5]);
-                
-                info.isConnected = (wcscmp(info.ipAddress, L"0.0.0.0") != 0);
-                
-                interfaces.push_back(info);
-                pAdapter = pAdapter->Next;
-            }
+static HDC GetScratchSurface(HDC hdc, int width, int height, PixelSurface* surface) {
+    if (!g_scratchDC || width > g_scratchSurface.width || height > g_scratchSurface.height) {
+        int scratchWidth = g_scratchDC && g_scratchSurface.width > width ? g_scratchSurface.width : width;
+        int scratchHeight = g_scratchDC && g_scratchSurface.height > height ? g_scratchSurface.height : height;
+        if (g_scratchDC) {
+            SelectObject(g_scratchDC, g_scratchOldBitmap);
+            DeleteObject(g_scratchBitmap);
+        } else {
+            g_scratchDC = CreateCompatibleDC(hdc);
+            if (!g_scratchDC) return NULL;
+        }
+        g_scratchBitmap = CreateCompatibleBitmapWithAlpha(hdc, scratchWidth, scratchHeight);
+        if (!g_scratchBitmap || !GetBitmapSurface(g_scratchBitmap, &g_scratchSurface)) {
+            if (g_scratchBitmap) DeleteObject(g_scratchBitmap);
+            DeleteDC(g_scratchDC);
+            g_scratchDC = NULL;
+            g_scratchBitmap = NULL;
+            return NULL;
         }
-        free(pAdapterInfo);
+        g_scratchOldBitmap = SelectObject(g_scratchDC, g_scratchBitmap);
     }
-    
-    return interfaces;
+    GdiFlush();
+    *surface = g_scratchSurface;
+    return g_scratchDC;
 }
 
-// Draw gradient rectangle
+// Draw gradient rectangle: rendered by the pixel kernels, then blitted in one call
 void DrawGradientRect(HDC hdc, RECT rect, COLORREF color1, COLORREF color2, bool vertical) {
     int width = rect.right - rect.left;
     int height = rect.bottom - rect.top;
+    if (width <= 0 || height <= 0) return;
     
-    if (vertical) {
-        for (int y = 0; y < height; y++) {
-            float ratio = (float)y / height;
-            COLORREF color = RGB(
-                GetRValue(color1) + (GetRValue(color2) - GetRValue(color1)) * ratio,
-                GetGValue(color1) + (GetGValue(color2) - GetGValue(color1)) * ratio,
-                GetBValue(color1) + (GetBValue(color2) - GetBValue(color1)) * ratio
-            );
-            
-            HPEN hPen = CreatePen(PS_SOLID, 1, color);
-            HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
-            
-            MoveToEx(hdc, rect.left, rect.top + y, NULL);
-            LineTo(hdc, rect.right, rect.top + y);
-            
-            SelectObject(hdc, hOldPen);
-            DeleteObject(hPen);
-        }
-    } else {
-        for (int x = 0; x < width; x++) {
-            float ratio = (float)x / width;
-            COLORREF color = RGB(
-                GetRValue(color1) + (GetRValue(color2) - GetRValue(color1)) * ratio,
-                GetGValue(color1) + (GetGValue(color2) - GetGValue(color1)) * ratio,
-                GetBValue(color1) + (GetBValue(color2) - GetBValue(color1)) * ratio
-            );
-            
-            HPEN hPen = CreatePen(PS_SOLID, 1, color);
-            HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
-            
-            MoveToEx(hdc, rect.left + x, rect.top, NULL);
-            LineTo(hdc, rect.left + x, rect.bottom);
-            
-            SelectObject(hdc, hOldPen);
-            DeleteObject(hPen);
-        }
-    }
+    PixelSurface surface;
+    HDC hdcScratch = GetScratchSurface(hdc, width, height, &surface);
+    if (!hdcScratch) return;
+    
+    PixelRect area = {0, 0, width, height};
+    PixelGradient(surface, area, ColorToPixel(color1, 255), ColorToPixel(color2, 255), vertical);
+    BitBlt(hdc, rect.left, rect.top, width, height, hdcScratch, 0, 0, SRCCOPY);
 }
 
 // Draw rounded rectangle
 void DrawRoundedRect(HDC hdc, RECT rect, int radius, COLORREF color, COLORREF borderColor) {
-    HBRUSH hBrush = CreateSolidBrush(color);
-    HPEN hPen = CreatePen(PS_SOLID, 1, borderColor);
+    GdiRef<HBRUSH> brush = g_gdiCache.GetBrush(color);
+    GdiRef<HPEN> pen = g_gdiCache.GetPen(borderColor);
     
-    HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hBrush);
-    HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
+    HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, brush.Get());
+    HPEN hOldPen = (HPEN)SelectObject(hdc, pen.Get());
     
     RoundRect(hdc, rect.left, rect.top, rect.right, rect.bottom, radius, radius);
     
     SelectObject(hdc, hOldBrush);
     SelectObject(hdc, hOldPen);
-    DeleteObject(hBrush);
-    DeleteObject(hPen);
+}
+
+// Shadow and glow textures, shared by every window of the process
+static EffectsCompositor g_effects;
+
+// Copy what lies under 'area' (clipped to the DC) into the scratch surface for the compositor
+static HDC BeginEffect(HDC hdc, RECT* area, PixelSurface* surface) {
+    RECT bounds;
+    if (GetClipBox(hdc, &bounds) == ERROR || !IntersectRect(area, area, &bounds)) return NULL;
+    int width = area->right - area->left;
+    int height = area->bottom - area->top;
+    
+    HDC hdcScratch = GetScratchSurface(hdc, width, height, surface);
+    if (!hdcScratch) return NULL;
+    BitBlt(hdcScratch, 0, 0, width, height, hdc, area->left, area->top, SRCCOPY);
+    GdiFlush();
+    surface->width = width;
+    surface->height = height;
+    return hdcScratch;
+}
+
+static void EndEffect(HDC hdc, HDC hdcScratch, const RECT& area) {
+    BitBlt(hdc, area.left, area.top, area.right - area.left, area.bottom - area.top, hdcScratch, 0, 0, SRCCOPY);
+}
+
+// Draw a soft glow around 'rect'; 'intensity' is how far it reaches, in pixels
+void DrawGlowEffect(HDC hdc, RECT rect, COLORREF color, int intensity) {
+    if (intensity <= 0) return;
+    int spread = intensity / 3;
+    int pad = 3 * intensity + spread;
+    RECT area = {rect.left - pad, rect.top - pad, rect.right + pad, rect.bottom + pad};
+    
+    PixelSurface surface;
+    HDC hdcScratch = BeginEffect(hdc, &area, &surface);
+    if (!hdcScratch) return;
+    PixelRect shape = {rect.left - area.left, rect.top - area.top, rect.right - area.left, rect.bottom - area.top};
+    g_effects.DrawGlow(surface, shape, 8, intensity, spread, ColorToPixel(color, 160));
+    EndEffect(hdc, hdcScratch, area);
+}
+
+// Draw the soft shadow a rounded rectangle casts 'offset' pixels below it
+void DrawShadowEffect(HDC hdc, RECT rect, int radius, int blur, int offset) {
+    int pad = 3 * (blur > 0 ? blur : 0);
+    RECT area = {rect.left - pad, rect.top + offset - pad, rect.right + pad, rect.bottom + offset + pad};
+    
+    PixelSurface surface;
+    HDC hdcScratch = BeginEffect(hdc, &area, &surface);
+    if (!hdcScratch) return;
+    PixelRect shape = {rect.left - area.left, rect.top - area.top, rect.right - area.left, rect.bottom - area.top};
+    g_effects.DrawShadow(surface, shape, radius, blur, 0, offset, ColorToPixel(RGB(0, 0, 0), 110));
+    EndEffect(hdc, hdcScratch, area);
 }
 
 // Show notification
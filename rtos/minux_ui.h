@@ -3,15 +3,13 @@
 #include <windowsx.h>
 #include <dwmapi.h>
 #include <shellapi.h>
+#include <commdlg.h>
 #include <commctrl.h>
 #include <uxtheme.h>
-#include <psapi.h>
-#include <pdh.h>
-#include <iphlpapi.h>
-#include <tlhelp32.h>
-#include <winternl.h>  // For RTL_OSVERSIONINFOW
 #include <vector>
 #include <algorithm>
+#include "core/minux_monitor.h"
+#include "core/minux_pixels.h"
 
 // Minux RTOS UI Components Header
 // Advanced UI elements and system integration
@@ -39,6 +37,11 @@
 #define ID_PROGRESSBAR_CPU     2009
 #define ID_PROGRESSBAR_MEMORY  2010
 #define ID_STATIC_STATUS       2011
+#define ID_TRAY_ICON           2012
+#define ID_EDIT_PROCESS_FILTER 2013
+
+// Notification area icon callback; WM_APP + 1 is the collector's snapshot message
+#define WM_MINUX_TRAY (WM_APP + 2)
 
 // Modern Colors
 #define COLOR_PRIMARY     RGB(41, 128, 185)   // Modern blue
@@ -84,53 +87,12 @@ struct UIState {
     int currentTab = 0;
     HWND hButtons[7] = {0};
     HWND hListView = 0;
+    HWND hFilterEdit = 0;
     HWND hProgressCPU = 0;
     HWND hProgressMemory = 0;
     HWND hStatusText = 0;
 };
 
-// System information structure
-typedef struct {
-    DWORD cpuUsage;
-    DWORD memoryUsage;
-    DWORD processCount;
-    DWORD threadCount;
-    ULONGLONG uptime;
-    wchar_t computerName[MAX_COMPUTERNAME_LENGTH + 1];
-    wchar_t osVersion[256];
-} SystemInfo;
-
-// Process information structure
-typedef struct {
-    DWORD processId;
-    wchar_t processName[MAX_PATH];
-    SIZE_T workingSetSize;
-    DWORD cpuUsage;
-    DWORD threadCount;
-    FILETIME creationTime;
-} ProcessInfo;
-
-// Network interface information
-typedef struct {
-    wchar_t adapterName[256];
-    wchar_t ipAddress[16];
-    wchar_t macAddress[18];
-    DWORD bytesReceived;
-    DWORD bytesSent;
-    DWORD packetsReceived;
-    DWORD packetsSent;
-    bool isConnected;
-} NetworkInfo;
-
-// Performance monitoring
-typedef struct {
-    LARGE_INTEGER frequency;
-    LARGE_INTEGER lastCpuTime;
-    LARGE_INTEGER lastIdleTime;
-    LARGE_INTEGER lastKernelTime;
-    LARGE_INTEGER lastUserTime;
-} PerformanceCounters;
-
 // Function declarations for UI components
 MinuxTheme GetCurrentTheme();
 void SetDarkTheme();
@@ -142,13 +104,6 @@ HWND CreateModernButton(HWND hParent, const wchar_t* text, int x, int y, int wid
 HWND CreateProcessListView(HWND hParent, int x, int y, int width, int height);
 HWND CreateProgressBar(HWND hParent, int x, int y, int width, int height, int id);
 
-// System monitoring functions
-SystemInfo GetSystemInformation();
-std::vector<ProcessInfo> GetProcessList();
-std::vector<NetworkInfo> GetNetworkInterfaces();
-void StartPerformanceCounters();
-void StopPerformanceCounters();
-
 // UI functions
 void UpdateSystemInfo();
 void PopulateProcessList();
@@ -170,8 +125,10 @@ void ProcessSwipeGesture(int direction, int velocity);
 void DrawGradientRect(HDC hdc, RECT rect, COLORREF color1, COLORREF color2, bool vertical);
 void DrawRoundedRect(HDC hdc, RECT rect, int radius, COLORREF color, COLORREF borderColor);
 void DrawGlowEffect(HDC hdc, RECT rect, COLORREF color, int intensity);
+void DrawShadowEffect(HDC hdc, RECT rect, int radius, int blur, int offset);
 HBITMAP CreateCompatibleBitmapWithAlpha(HDC hdc, int width, int height);
+bool GetBitmapSurface(HBITMAP hBitmap, PixelSurface* surface);
+uint32_t ColorToPixel(COLORREF color, BYTE alpha);
 
 // Global state
 extern UIState g_uiState;
-extern PerformanceCounters g_perfCounters;
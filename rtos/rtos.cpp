@@ -2,7 +2,14 @@
 // Features: Touch Support, Modern UI, System Monitoring, Process Control
 
 #include "framework.h"
+#include <cmath>
 #include "rtos.h"
+#include "minux_collector.h"
+#include "minux_backbuffer.h"
+#include "minux_gdicache.h"
+#include "core/minux_procview.h"
+#include "core/minux_format.h"
+#include "core/minux_names.h"
 
 #define MAX_LOADSTRING 100
 
@@ -13,6 +20,13 @@ WCHAR szWindowClass[MAX_LOADSTRING];            // the main window class name
 // Global UI state
 UIState g_uiState;
 
+// Off-screen copy of the main window; chrome is drawn once per size, theme or DPI change
+static BackBuffer g_backBuffer;
+
+// Notification area icon while the window is minimized to the tray
+static NOTIFYICONDATAW g_trayIcon;
+static bool g_inTray = false;
+
 // Touch and gesture support
 void EnableTouchSupport(HWND hwnd) {
     RegisterTouchWindow(hwnd, 0);
@@ -45,12 +59,14 @@ HWND CreateProgressBar(HWND hParent, int x, int y, int width, int height, int id
 // Create list view for processes
 HWND CreateProcessListView(HWND hParent, int x, int y, int width, int height) {
     InitCommonControls();
+    // Owner-data: the control stores only the item count
     HWND hListView = CreateWindow(
         WC_LISTVIEW, NULL,
-        WS_VISIBLE | WS_CHILD | LVS_REPORT | LVS_SINGLESEL,
+        WS_VISIBLE | WS_CHILD | LVS_REPORT | LVS_SINGLESEL | LVS_OWNERDATA,
         x, y, width, height,
         hParent, (HMENU)(UINT_PTR)ID_LISTVIEW_PROCESSES, GetModuleHandle(NULL), NULL
     );
+    ListView_SetExtendedListViewStyle(hListView, LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
     
     // Add columns
     LVCOLUMN lvc = {0};
@@ -76,9 +92,10 @@ HWND CreateProcessListView(HWND hParent, int x, int y, int width, int height) {
 
 // Draw modern button with gradient and rounded corners
 void DrawModernButton(HDC hdc, RECT rect, const wchar_t* text, bool isPressed, bool isHovered, COLORREF color) {
-    // Create rounded rectangle path
-    HRGN hRgn = CreateRoundRectRgn(rect.left, rect.top, rect.right, rect.bottom, 8, 8);
-    SelectClipRgn(hdc, hRgn);
+    // Rounded clip shared by every button of this size
+    GdiRef<HRGN> region = g_gdiCache.GetRoundRegion(rect.right - rect.left, rect.bottom - rect.top, 8);
+    SelectClipRgn(hdc, region.Get());
+    OffsetClipRgn(hdc, rect.left, rect.top);
     
     // Gradient background
     COLORREF topColor = isPressed ? RGB(GetRValue(color) - 20, GetGValue(color) - 20, GetBValue(color) - 20) : color;
@@ -89,97 +106,819 @@ void DrawModernButton(HDC hdc, RECT rect, const wchar_t* text, bool isPressed, b
     }
     
     // Simple gradient simulation
-    HBRUSH hBrush = CreateSolidBrush(topColor);
-    FillRect(hdc, &rect, hBrush);
-    DeleteObject(hBrush);
+    GdiRef<HBRUSH> brush = g_gdiCache.GetBrush(topColor);
+    FillRect(hdc, &rect, brush.Get());
+    
+    // Hover: a glow from the inside edge, kept to the button by the clip
+    if (isHovered && !isPressed) {
+        RECT inner = rect;
+        InflateRect(&inner, -6, -6);
+        DrawGlowEffect(hdc, inner, RGB(GetRValue(color) + 40, GetGValue(color) + 40, GetBValue(color) + 40), 4);
+    }
     
     // Border
-    HPEN hPen = CreatePen(PS_SOLID, 1, RGB(GetRValue(color) - 40, GetGValue(color) - 40, GetBValue(color) - 40));
-    HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
+    GdiRef<HPEN> pen = g_gdiCache.GetPen(RGB(GetRValue(color) - 40, GetGValue(color) - 40, GetBValue(color) - 40));
+    HPEN hOldPen = (HPEN)SelectObject(hdc, pen.Get());
     
     MoveToEx(hdc, rect.left + 8, rect.top, NULL);
     LineTo(hdc, rect.right - 8, rect.top);
     
     SelectObject(hdc, hOldPen);
-    DeleteObject(hPen);
     
     // Text
     SetBkMode(hdc, TRANSPARENT);
     SetTextColor(hdc, COLOR_TEXT);
-    HFONT hFont = CreateFont(14, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, 
-                            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                            CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-    HFONT hOldFont = (HFONT)SelectObject(hdc, hFont);
+    GdiRef<HFONT> font = g_gdiCache.GetFont(14);
+    HFONT hOldFont = (HFONT)SelectObject(hdc, font.Get());
     
     DrawText(hdc, text, -1, &rect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
     
     SelectObject(hdc, hOldFont);
-    DeleteObject(hFont);
     SelectClipRgn(hdc, NULL);
-    DeleteObject(hRgn);
 }
 
-// Update system information
+// Per-core heat strip shown in the System tab, in place of the process list
+static const RECT g_coreStripRect = {10, 100, 580, 190};
+
+// Green through orange to red as a core gets busier (share in hundredths of a percent)
+static COLORREF GetHeatColor(uint32_t share) {
+    COLORREF from = COLOR_SUCCESS, to = COLOR_WARNING;
+    uint32_t t = share * 2;
+    if (share > 5000) {
+        from = COLOR_WARNING;
+        to = COLOR_DANGER;
+        t = (share - 5000) * 2;
+    }
+    return RGB(GetRValue(from) + ((int)GetRValue(to) - (int)GetRValue(from)) * (int)t / 10000,
+               GetGValue(from) + ((int)GetGValue(to) - (int)GetGValue(from)) * (int)t / 10000,
+               GetBValue(from) + ((int)GetBValue(to) - (int)GetBValue(from)) * (int)t / 10000);
+}
+
+// Heat strip layout: up to 32 cells per row, at most 48 pixels tall
+static void GetCoreCellRect(size_t index, size_t count, RECT* cell) {
+    const RECT& area = g_coreStripRect;
+    int left = area.left + 6, top = area.top + 26;
+    int width = area.right - area.left - 12, height = area.bottom - top - 6;
+    int columns = count < 32 ? (int)count : 32;
+    int rows = (int)((count + columns - 1) / columns);
+    int cellWidth = width / columns;
+    int cellHeight = height / rows < 48 ? height / rows : 48;
+    
+    cell->left = left + (int)(index % columns) * cellWidth;
+    cell->top = top + (int)(index / columns) * cellHeight;
+    cell->right = cell->left + cellWidth - 2;
+    cell->bottom = cell->top + cellHeight - 2;
+}
+
+// One cell per logical processor, wrapping into rows on large machines; the
+// darker band at the bottom of a cell is its kernel share. Only the part
+// inside 'clip' is drawn; the back buffer keeps the rest.
+static void DrawCoreHeatStrip(HDC hdc, const RECT& clip) {
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    RECT area;
+    if (!IntersectRect(&area, &g_coreStripRect, &clip)) return;
+    
+    GdiRef<HBRUSH> surface = g_gdiCache.GetBrush(COLOR_SURFACE);
+    FillRect(hdc, &area, surface.Get());
+    
+    SetBkMode(hdc, TRANSPARENT);
+    SetTextColor(hdc, COLOR_TEXT);
+    size_t count = snapshot ? snapshot->cores.size() : 0;
+    wchar_t text[64];
+    swprintf_s(text, L"CPU per logical processor (%zu)", count);
+    RECT titleRect = {g_coreStripRect.left + 6, g_coreStripRect.top + 4, g_coreStripRect.right, g_coreStripRect.top + 22};
+    DrawText(hdc, text, -1, &titleRect, DT_LEFT | DT_SINGLELINE);
+    if (count == 0) return;
+    
+    // Heat colours are continuous, so cells recolour the stock DC brush
+    GdiRef<HBRUSH> kernelBrush = g_gdiCache.GetBrush(COLOR_SECONDARY);
+    HBRUSH hCellBrush = (HBRUSH)GetStockObject(DC_BRUSH);
+    for (size_t i = 0; i < count; i++) {
+        RECT cell, visible;
+        GetCoreCellRect(i, count, &cell);
+        if (!IntersectRect(&visible, &cell, &clip)) continue;
+        
+        const CpuCoreInfo& core = snapshot->cores[i];
+        uint32_t busy = core.user + core.kernel;
+        SetDCBrushColor(hdc, GetHeatColor(busy));
+        FillRect(hdc, &cell, hCellBrush);
+        
+        RECT kernelRect = cell;
+        kernelRect.top = cell.bottom - (cell.bottom - cell.top) * (int)core.kernel / 10000;
+        FillRect(hdc, &kernelRect, kernelBrush.Get());
+        
+        if (cell.right - cell.left >= 26 && cell.bottom - cell.top >= 14) {
+            FormatUnsigned((busy + 50) / 100, text);
+            DrawText(hdc, text, -1, &cell, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+        }
+    }
+}
+
+// Core values as last handed to the strip; a cell is repainted when its whole percentages move
+static std::vector<CpuCoreInfo> g_shownCores;
+
+static bool IsCoreShownDifferently(const CpuCoreInfo& a, const CpuCoreInfo& b) {
+    return (a.user + a.kernel + 50) / 100 != (b.user + b.kernel + 50) / 100 ||
+           (a.kernel + 50) / 100 != (b.kernel + 50) / 100;
+}
+
+// Invalidate only the heat strip cells whose shown values changed
+static void InvalidateChangedCores(HWND hWnd, bool all) {
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    if (!snapshot) return;
+    const std::vector<CpuCoreInfo>& cores = snapshot->cores;
+    if (all || cores.size() != g_shownCores.size()) {
+        InvalidateRect(hWnd, &g_coreStripRect, FALSE);
+    } else {
+        for (size_t i = 0; i < cores.size(); i++) {
+            if (!IsCoreShownDifferently(cores[i], g_shownCores[i])) continue;
+            RECT cell;
+            GetCoreCellRect(i, cores.size(), &cell);
+            InvalidateRect(hWnd, &cell, FALSE);
+        }
+    }
+    g_shownCores = cores;
+}
+
+// Interface table shown in the Network tab, where the System tab has its heat strip
+static const RECT g_interfaceTableRect = {10, 100, 580, 190};
+#define INTERFACE_TABLE_ROWS 4
+
+// "12.3 MB/s"
+static void FormatRate(uint64_t bytesPerSecond, wchar_t* out, size_t capacity) {
+    wchar_t size[FORMAT_MAX_TEXT];
+    FormatByteSize(bytesPerSecond, size);
+    swprintf_s(out, capacity, L"%s/s", size);
+}
+
+// One row per interface: name, address, current rates and error/drop totals
+static void DrawInterfaceTable(HDC hdc, const RECT& clip) {
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    RECT area;
+    if (!IntersectRect(&area, &g_interfaceTableRect, &clip)) return;
+    
+    GdiRef<HBRUSH> surface = g_gdiCache.GetBrush(COLOR_SURFACE);
+    FillRect(hdc, &area, surface.Get());
+    
+    SetBkMode(hdc, TRANSPARENT);
+    SetTextColor(hdc, COLOR_TEXT);
+    size_t count = snapshot ? snapshot->interfaces.size() : 0;
+    wchar_t text[128], received[32], sent[32];
+    swprintf_s(text, L"Network interfaces (%zu)", count);
+    RECT titleRect = {g_interfaceTableRect.left + 6, g_interfaceTableRect.top + 4, g_interfaceTableRect.right, g_interfaceTableRect.top + 22};
+    DrawText(hdc, text, -1, &titleRect, DT_LEFT | DT_SINGLELINE);
+    
+    static const int columns[] = {6, 190, 300, 470};    // name, address, rates, errors; from the left edge
+    for (size_t i = 0; i < count && i < INTERFACE_TABLE_ROWS; i++) {
+        const NetworkInfo& info = snapshot->interfaces[i];
+        int top = g_interfaceTableRect.top + 22 + (int)i * 16;
+        if (i + 1 == INTERFACE_TABLE_ROWS && count > INTERFACE_TABLE_ROWS) {
+            swprintf_s(text, L"and %zu more", count - i);
+            RECT rowRect = {g_interfaceTableRect.left + columns[0], top, g_interfaceTableRect.right - 6, top + 16};
+            DrawText(hdc, text, -1, &rowRect, DT_LEFT | DT_SINGLELINE);
+            break;
+        }
+        
+        if (info.rateIntervalMs) {
+            FormatRate(info.bytesReceivedPerSecond, received, 32);
+            FormatRate(info.bytesSentPerSecond, sent, 32);
+        } else {
+            wcscpy_s(received, L"-");
+            wcscpy_s(sent, L"-");
+        }
+        swprintf_s(text, 64, L"in %s, out %s", received, sent);
+        swprintf_s(text + 64, 64, L"%llu errors, %llu drops", info.errorsReceived + info.errorsSent, info.dropsReceived + info.dropsSent);
+        const wchar_t* cells[4] = {info.adapterName, info.isConnected ? info.ipAddress : L"not connected", text, text + 64};
+        for (int column = 0; column < 4; column++) {
+            int right = column < 3 ? g_interfaceTableRect.left + columns[column + 1] - 6 : g_interfaceTableRect.right - 6;
+            RECT cellRect = {g_interfaceTableRect.left + columns[column], top, right, top + 16};
+            DrawText(hdc, cells[column], -1, &cellRect, DT_LEFT | DT_SINGLELINE | DT_END_ELLIPSIS);
+        }
+    }
+}
+
+// History graph under the heat strip: CPU and memory over a span that pinch
+// and swipe (or the wheel and a drag) zoom and pan across the detail series.
+// The Network tab shows receive and send throughput in the same place.
+static const RECT g_historyGraphRect = {10, 196, 580, 300};
+#define GRAPH_MIN_SPAN_MS       (60 * 1000ULL)
+#define GRAPH_MAX_SPAN_MS       (7 * 24 * 3600 * 1000ULL)
+#define GRAPH_DEFAULT_SPAN_MS   (15 * 60 * 1000ULL)
+
+static HWND g_hGraphWnd = NULL;                 // main window, redrawn by gestures
+static ULONGLONG g_graphSpan = GRAPH_DEFAULT_SPAN_MS;
+static ULONGLONG g_graphEnd = 0;                // ms since the Unix epoch
+static bool g_graphLive = true;                 // end follows the newest sample until panned back
+static bool g_graphDragging = false;
+static int g_graphDragX = 0;
+static std::vector<LodColumn> g_graphColumns;   // both series, reused every frame
+static std::vector<POINT> g_graphPoints;
+
+static void GetGraphPlotRect(RECT* plot) {
+    plot->left = g_historyGraphRect.left + 6;
+    plot->top = g_historyGraphRect.top + 22;
+    plot->right = g_historyGraphRect.right - 6;
+    plot->bottom = g_historyGraphRect.bottom - 6;
+}
+
+// The Network and System tabs show the graph in place of the process list
+static bool IsGraphTab() {
+    return g_uiState.currentTab == 2 || g_uiState.currentTab == 3;
+}
+
+// Series the graph's time axis follows (hold the history lock)
+static const LodSeries& GetGraphTimeSeries() {
+    return g_uiState.currentTab == 2 ? GetNetworkDetail(HISTORY_INTERFACE_RX_BYTES) : GetHistoryDetail(HISTORY_SYSTEM_CPU);
+}
+
+static void InvalidateHistoryGraph() {
+    if (g_hGraphWnd && IsGraphTab()) InvalidateRect(g_hGraphWnd, &g_historyGraphRect, FALSE);
+}
+
+static int GetGraphY(const RECT& plot, float percent) {
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    return plot.bottom - 1 - (int)(percent * (plot.bottom - plot.top - 1) / 100);
+}
+
+// Min-max band per pixel column with the average drawn through it; gaps stay empty
+static void DrawGraphSeries(HDC hdc, const RECT& plot, const LodColumn* columns, COLORREF color) {
+    int width = plot.right - plot.left;
+    HBRUSH hBandBrush = (HBRUSH)GetStockObject(DC_BRUSH);
+    SetDCBrushColor(hdc, RGB((GetRValue(color) + GetRValue(COLOR_SURFACE)) / 2,
+                             (GetGValue(color) + GetGValue(COLOR_SURFACE)) / 2,
+                             (GetBValue(color) + GetBValue(COLOR_SURFACE)) / 2));
+    for (int x = 0; x < width; x++) {
+        if (!columns[x].count) continue;
+        RECT band = {plot.left + x, GetGraphY(plot, columns[x].max), plot.left + x + 1, GetGraphY(plot, columns[x].min) + 1};
+        FillRect(hdc, &band, hBandBrush);
+    }
+    
+    HPEN hOldPen = (HPEN)SelectObject(hdc, GetStockObject(DC_PEN));
+    SetDCPenColor(hdc, color);
+    g_graphPoints.clear();
+    for (int x = 0; x <= width; x++) {
+        if (x < width && columns[x].count) {
+            POINT point = {plot.left + x, GetGraphY(plot, columns[x].average)};
+            g_graphPoints.push_back(point);
+        } else if (!g_graphPoints.empty()) {
+            if (g_graphPoints.size() > 1) Polyline(hdc, g_graphPoints.data(), (int)g_graphPoints.size());
+            g_graphPoints.clear();
+        }
+    }
+    SelectObject(hdc, hOldPen);
+}
+
+// Cost is one pass over the plot's columns, whatever span is shown
+static void DrawHistoryGraph(HDC hdc, const RECT& clip) {
+    RECT area;
+    if (!IntersectRect(&area, &g_historyGraphRect, &clip)) return;
+    
+    GdiRef<HBRUSH> surface = g_gdiCache.GetBrush(COLOR_SURFACE);
+    FillRect(hdc, &g_historyGraphRect, surface.Get());
+    
+    RECT plot;
+    GetGraphPlotRect(&plot);
+    int width = plot.right - plot.left;
+    g_graphColumns.resize((size_t)width * 2);
+    
+    bool network = g_uiState.currentTab == 2;
+    LockHistory();
+    const LodSeries& first = network ? GetNetworkDetail(HISTORY_INTERFACE_RX_BYTES) : GetHistoryDetail(HISTORY_SYSTEM_CPU);
+    const LodSeries& second = network ? GetNetworkDetail(HISTORY_INTERFACE_TX_BYTES) : GetHistoryDetail(HISTORY_SYSTEM_MEMORY);
+    if (g_graphLive) g_graphEnd = first.GetLastTime();
+    ULONGLONG from = g_graphEnd > g_graphSpan ? g_graphEnd - g_graphSpan : 0;
+    first.Render(from, g_graphEnd, width, &g_graphColumns[0]);
+    second.Render(from, g_graphEnd, width, &g_graphColumns[width]);
+    UnlockHistory();
+    
+    // Throughput is drawn as a share of the highest rate in view
+    float peak = 0;
+    if (network) {
+        for (const LodColumn& column : g_graphColumns) {
+            if (column.count && column.max > peak) peak = column.max;
+        }
+        float scale = peak > 0 ? 100 / peak : 0;
+        for (LodColumn& column : g_graphColumns) {
+            column.min *= scale;
+            column.max *= scale;
+            column.average *= scale;
+        }
+    }
+    
+    DrawGraphSeries(hdc, plot, &g_graphColumns[width], COLOR_SUCCESS);
+    DrawGraphSeries(hdc, plot, &g_graphColumns[0], COLOR_PRIMARY);
+    
+    wchar_t span[32], rate[32], text[128];
+    if (g_graphSpan < 3600 * 1000ULL) swprintf_s(span, L"%llu min", g_graphSpan / 60000);
+    else if (g_graphSpan < 2 * 24 * 3600 * 1000ULL) swprintf_s(span, L"%.1f h", g_graphSpan / 3600000.0);
+    else swprintf_s(span, L"%.1f days", g_graphSpan / 86400000.0);
+    const wchar_t* panned = g_graphLive ? L"" : L" (panned; swipe left to return)";
+    if (network) {
+        FormatRate((uint64_t)peak, rate, 32);
+        swprintf_s(text, L"Received and sent, peak %s, %s%s", rate, span, panned);
+    } else {
+        swprintf_s(text, L"CPU and memory, %s%s", span, panned);
+    }
+    SetBkMode(hdc, TRANSPARENT);
+    SetTextColor(hdc, COLOR_TEXT);
+    RECT titleRect = {g_historyGraphRect.left + 6, g_historyGraphRect.top + 4, g_historyGraphRect.right, plot.top};
+    DrawText(hdc, text, -1, &titleRect, DT_LEFT | DT_SINGLELINE);
+}
+
+// Pinch: 'scale' above 1 zooms in. A live graph keeps its right edge on the newest sample,
+// a panned one zooms about its centre.
+void ProcessPinchGesture(float scale) {
+    if (scale <= 0) return;
+    ULONGLONG span = (ULONGLONG)(g_graphSpan / scale);
+    if (span < GRAPH_MIN_SPAN_MS) span = GRAPH_MIN_SPAN_MS;
+    if (span > GRAPH_MAX_SPAN_MS) span = GRAPH_MAX_SPAN_MS;
+    if (!g_graphLive) {
+        ULONGLONG centre = g_graphEnd > g_graphSpan / 2 ? g_graphEnd - g_graphSpan / 2 : 0;
+        g_graphEnd = centre + span / 2;
+    }
+    g_graphSpan = span;
+    InvalidateHistoryGraph();
+}
+
+// Swipe: 'direction' above 0 pans toward older samples, below 0 toward newer;
+// 'velocity' is how far the finger moved, in pixels. Reaching the newest sample goes live again.
+void ProcessSwipeGesture(int direction, int velocity) {
+    RECT plot;
+    GetGraphPlotRect(&plot);
+    ULONGLONG shift = g_graphSpan * (ULONGLONG)velocity / (ULONGLONG)(plot.right - plot.left);
+    if (direction > 0) {
+        g_graphEnd = g_graphEnd > shift ? g_graphEnd - shift : 0;
+        g_graphLive = false;
+    } else if (direction < 0) {
+        LockHistory();
+        ULONGLONG newest = GetGraphTimeSeries().GetLastTime();
+        UnlockHistory();
+        g_graphEnd += shift;
+        if (g_graphEnd >= newest) g_graphLive = true;
+    }
+    InvalidateHistoryGraph();
+}
+
+static bool IsInHistoryGraph(int x, int y) {
+    POINT point = {x, y};
+    return IsGraphTab() && PtInRect(&g_historyGraphRect, point);
+}
+
+// Two-finger pinch tracking; true while two fingers are down
+struct TouchContact {
+    DWORD id;
+    POINT point;
+};
+static TouchContact g_touchContacts[2];
+static int g_touchContactCount = 0;
+
+static double GetTouchContactDistance() {
+    double dx = g_touchContacts[1].point.x - g_touchContacts[0].point.x;
+    double dy = g_touchContacts[1].point.y - g_touchContacts[0].point.y;
+    return sqrt(dx * dx + dy * dy);
+}
+
+static bool TrackPinch(const TOUCHINPUT& input, POINT point) {
+    int index = -1;
+    for (int i = 0; i < g_touchContactCount; i++) {
+        if (g_touchContacts[i].id == input.dwID) index = i;
+    }
+    
+    if (input.dwFlags & TOUCHEVENTF_DOWN) {
+        if (index < 0 && g_touchContactCount < 2) {
+            g_touchContacts[g_touchContactCount].id = input.dwID;
+            g_touchContacts[g_touchContactCount].point = point;
+            g_touchContactCount++;
+        }
+    } else if (input.dwFlags & TOUCHEVENTF_MOVE) {
+        if (index >= 0) {
+            double before = g_touchContactCount == 2 ? GetTouchContactDistance() : 0;
+            g_touchContacts[index].point = point;
+            if (before > 0 && IsInHistoryGraph(point.x, point.y)) {
+                ProcessPinchGesture((float)(GetTouchContactDistance() / before));
+            }
+        }
+    } else if (input.dwFlags & TOUCHEVENTF_UP) {
+        if (index >= 0) g_touchContacts[index] = g_touchContacts[--g_touchContactCount];
+    }
+    return g_touchContactCount == 2;
+}
+
+// Static parts of the window, drawn into the back buffer once per size, theme or DPI change
+static void DrawWindowChrome(HDC hdc, const RECT& clientRect) {
+    GdiRef<HBRUSH> background = g_gdiCache.GetBrush(MINUX_COLOR_BACKGROUND);
+    FillRect(hdc, &clientRect, background.Get());
+    
+    // Title bar, lifted off the content by its shadow
+    RECT titleRect = {0, 0, clientRect.right, 40};
+    DrawShadowEffect(hdc, titleRect, 0, 4, 2);
+    GdiRef<HBRUSH> titleBrush = g_gdiCache.GetBrush(COLOR_SECONDARY);
+    FillRect(hdc, &titleRect, titleBrush.Get());
+    
+    // Title text
+    SetBkMode(hdc, TRANSPARENT);
+    SetTextColor(hdc, COLOR_TEXT);
+    GdiRef<HFONT> titleFont = g_gdiCache.GetFont(16, FW_BOLD);
+    HFONT hOldFont = (HFONT)SelectObject(hdc, titleFont.Get());
+    
+    TextOut(hdc, 15, 12, L"Minux RTOS Control Center", 25);
+    
+    // Version info
+    GdiRef<HFONT> smallFont = g_gdiCache.GetFont(12);
+    SelectObject(hdc, smallFont.Get());
+    SetTextColor(hdc, RGB(180, 180, 180));
+    TextOut(hdc, 250, 15, L"v2.1.0 - Real-time OS", 21);
+    
+    SelectObject(hdc, hOldFont);
+}
+
+// Paint the update region from the back buffer, redrawing only what lies inside it
+static void PaintMainWindow(HWND hWnd, HDC hdc, const RECT& dirty) {
+    RECT clientRect;
+    GetClientRect(hWnd, &clientRect);
+    
+    if (!g_backBuffer.Prepare(hWnd, hdc)) {
+        // No off-screen surface: draw straight to the window
+        DrawWindowChrome(hdc, clientRect);
+        if (g_uiState.currentTab == 2) DrawInterfaceTable(hdc, dirty);
+        if (g_uiState.currentTab == 3) DrawCoreHeatStrip(hdc, dirty);
+        if (IsGraphTab()) DrawHistoryGraph(hdc, dirty);
+        return;
+    }
+    
+    HDC hdcBuffer = g_backBuffer.GetDC();
+    if (!g_backBuffer.IsChromeValid()) {
+        DrawWindowChrome(hdcBuffer, clientRect);
+        g_backBuffer.SetChromeValid();
+    }
+    if (g_uiState.currentTab == 2) DrawInterfaceTable(hdcBuffer, dirty);
+    if (g_uiState.currentTab == 3) DrawCoreHeatStrip(hdcBuffer, dirty);
+    if (IsGraphTab()) DrawHistoryGraph(hdcBuffer, dirty);
+    g_backBuffer.Present(hdc, dirty);
+}
+
+// Tell the collector what is on screen so it samples only what someone can see
+static void UpdateCollectorView(HWND hWnd) {
+    int focused = CADENCE_STREAM_BIT(CADENCE_SYSTEM);      // CPU and memory bars are on every tab
+    if (g_uiState.currentTab == 0) focused |= CADENCE_STREAM_BIT(CADENCE_PROCESSES);
+    if (g_uiState.currentTab == 2) focused |= CADENCE_STREAM_BIT(CADENCE_NETWORK);
+    SetCollectorView(!g_inTray && !IsIconic(hWnd), focused);
+}
+
+// Switch tabs; the Network and System tabs draw their views where the process list sits
+static void SetCurrentTab(HWND hWnd, int tab) {
+    g_uiState.currentTab = tab;
+    bool graph = IsGraphTab();
+    ShowWindow(g_uiState.hListView, graph ? SW_HIDE : SW_SHOW);
+    if (g_uiState.hFilterEdit) ShowWindow(g_uiState.hFilterEdit, graph ? SW_HIDE : SW_SHOW);
+    if (tab == 2) InvalidateRect(hWnd, &g_interfaceTableRect, FALSE);
+    if (tab == 3) InvalidateChangedCores(hWnd, true);
+    if (graph) InvalidateHistoryGraph();
+    UpdateCollectorView(hWnd);
+}
+
+// Hide the window behind a notification area icon; sampling drops to the tray rates
+static void MinimizeToTray(HWND hWnd) {
+    ZeroMemory(&g_trayIcon, sizeof(g_trayIcon));
+    g_trayIcon.cbSize = sizeof(g_trayIcon);
+    g_trayIcon.hWnd = hWnd;
+    g_trayIcon.uID = ID_TRAY_ICON;
+    g_trayIcon.uFlags = NIF_ICON | NIF_MESSAGE | NIF_TIP;
+    g_trayIcon.uCallbackMessage = WM_MINUX_TRAY;
+    g_trayIcon.hIcon = LoadIcon(hInst, MAKEINTRESOURCE(IDI_SMALL));
+    swprintf_s(g_trayIcon.szTip, L"%ls", szTitle);
+    if (!Shell_NotifyIconW(NIM_ADD, &g_trayIcon)) {
+        ShowWindow(hWnd, SW_MINIMIZE);      // no notification area, e.g. Explorer not running
+        return;
+    }
+    g_inTray = true;
+    ShowWindow(hWnd, SW_HIDE);
+    UpdateCollectorView(hWnd);
+}
+
+static void RestoreFromTray(HWND hWnd) {
+    if (!g_inTray) return;
+    Shell_NotifyIconW(NIM_DELETE, &g_trayIcon);
+    g_inTray = false;
+    ShowWindow(hWnd, SW_SHOW);
+    SetForegroundWindow(hWnd);
+    UpdateCollectorView(hWnd);
+}
+
+// The tray tooltip is the only view while hidden
+static void UpdateTrayTip() {
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    if (!g_inTray || !snapshot) return;
+    swprintf_s(g_trayIcon.szTip, L"%ls\nCPU: %u%% | Memory: %u%%",
+               szTitle, snapshot->system.cpuUsage, snapshot->system.memoryUsage);
+    g_trayIcon.uFlags = NIF_TIP;
+    Shell_NotifyIconW(NIM_MODIFY, &g_trayIcon);
+}
+
+// Local date and time of a snapshot timestamp (ms since the Unix epoch)
+static void FormatRecordingTime(ULONGLONG timestamp, wchar_t* text, size_t capacity) {
+    ULARGE_INTEGER t;
+    t.QuadPart = timestamp * 10000 + 116444736000000000ULL;
+    FILETIME ft;
+    ft.dwLowDateTime = t.LowPart;
+    ft.dwHighDateTime = t.HighPart;
+    SYSTEMTIME utc, local;
+    FileTimeToSystemTime(&ft, &utc);
+    SystemTimeToTzSpecificLocalTime(NULL, &utc, &local);
+    swprintf_s(text, capacity, L"%04u-%02u-%02u %02u:%02u:%02u",
+               local.wYear, local.wMonth, local.wDay, local.wHour, local.wMinute, local.wSecond);
+}
+
+// Update system information from the current snapshot
 void UpdateSystemInfo() {
     if (!g_uiState.hProgressCPU || !g_uiState.hProgressMemory) return;
     
-    // Simulate CPU usage (in real implementation, use GetSystemTimes)
-    static int cpuUsage = 25;
-    cpuUsage = (cpuUsage + rand() % 20 - 10);
-    if (cpuUsage < 0) cpuUsage = 0;
-    if (cpuUsage > 100) cpuUsage = 100;
-    
-    SendMessage(g_uiState.hProgressCPU, PBM_SETPOS, cpuUsage, 0);
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    if (!snapshot) return;
     
-    // Get real memory usage
-    MEMORYSTATUSEX memInfo = {0};
-    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-    GlobalMemoryStatusEx(&memInfo);
+    // Each update repaints the control, so only send values that changed
+    static DWORD shownCpu = (DWORD)-1, shownMemory = (DWORD)-1;
+    DWORD cpuUsage = snapshot->system.cpuUsage;
+    if (cpuUsage != shownCpu) {
+        SendMessage(g_uiState.hProgressCPU, PBM_SETPOS, cpuUsage, 0);
+        shownCpu = cpuUsage;
+    }
     
-    DWORD memUsage = memInfo.dwMemoryLoad;
-    SendMessage(g_uiState.hProgressMemory, PBM_SETPOS, memUsage, 0);
+    DWORD memUsage = snapshot->system.memoryUsage;
+    if (memUsage != shownMemory) {
+        SendMessage(g_uiState.hProgressMemory, PBM_SETPOS, memUsage, 0);
+        shownMemory = memUsage;
+    }
     
     // Update status text
     if (g_uiState.hStatusText) {
+        ULONGLONG uptimeMinutes = snapshot->system.uptime / 60000;
         wchar_t statusText[256];
-        swprintf_s(statusText, L"CPU: %d%% | Memory: %d%% | Processes: 156 | Uptime: 2h 45m", 
-                 cpuUsage, memUsage);
-        SetWindowText(g_uiState.hStatusText, statusText);
+        wchar_t modeText[64] = L"";
+        if (IsPlaybackActive()) {
+            wchar_t timeText[32];
+            FormatRecordingTime(snapshot->timestamp, timeText, 32);
+            swprintf_s(modeText, L"Playback %ux %ls | ", GetPlaybackSpeed(), timeText);
+        } else if (IsRecording()) {
+            swprintf_s(modeText, L"REC | ");
+        }
+        if (IsExporting()) wcscat_s(modeText, L"EXP | ");
+        swprintf_s(statusText, L"%lsCPU: %u%% | Memory: %u%% | Processes: %u | Uptime: %lluh %llum", 
+                 modeText, cpuUsage, memUsage, snapshot->system.processCount,
+                 uptimeMinutes / 60, uptimeMinutes % 60);
+        wchar_t shownText[256];
+        if (!GetWindowText(g_uiState.hStatusText, shownText, 256) || wcscmp(shownText, statusText) != 0) {
+            SetWindowText(g_uiState.hStatusText, statusText);
+        }
     }
 }
 
-// Populate process list (placeholder data)
+// Play a dropped or chosen recording in place of live data
+static void OpenRecording(HWND hWnd, const wchar_t* path) {
+    if (!StartPlayback(path)) {
+        MessageBox(hWnd, L"The file is not a Minux recording or could not be opened.", L"Open Recording", MB_OK | MB_ICONWARNING);
+        return;
+    }
+    SetPlaybackSpeed(1);
+    SetWindowText(g_uiState.hStatusText, L"Playback - loading recording");
+}
+
+static void ChooseRecording(HWND hWnd) {
+    wchar_t path[MAX_PATH] = L"";
+    OPENFILENAMEW ofn = {0};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = hWnd;
+    ofn.lpstrFilter = L"Minux Recordings (*.mxr)\0*.mxr\0All Files (*.*)\0*.*\0";
+    ofn.lpstrFile = path;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST;
+    if (GetOpenFileNameW(&ofn)) OpenRecording(hWnd, path);
+}
+
+// Start recording to %LOCALAPPDATA%\Minux\Recordings\minux-YYYYMMDD-HHMMSS, or stop
+static void ToggleRecording(HWND hWnd) {
+    if (IsRecording()) {
+        StopRecording();
+        SetWindowText(g_uiState.hStatusText, L"Recording stopped");
+        return;
+    }
+    if (IsPlaybackActive()) return;
+
+    wchar_t directory[MAX_PATH];
+    DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", directory, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH - 64) {
+        MessageBox(hWnd, L"Could not find the local application data folder.", L"Record", MB_OK | MB_ICONWARNING);
+        return;
+    }
+    wcscat_s(directory, L"\\Minux");
+    CreateDirectoryW(directory, NULL);
+    wcscat_s(directory, L"\\Recordings");
+    CreateDirectoryW(directory, NULL);
+
+    SYSTEMTIME now;
+    GetLocalTime(&now);
+    wchar_t prefix[MAX_PATH];
+    swprintf_s(prefix, L"%ls\\minux-%04u%02u%02u-%02u%02u%02u", directory,
+               now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond);
+    if (!StartRecording(prefix)) {
+        MessageBox(hWnd, L"Could not create the recording file.", L"Record", MB_OK | MB_ICONWARNING);
+        return;
+    }
+    SetWindowText(g_uiState.hStatusText, L"Recording");
+}
+
+// Choose a file and export the rows of every sampled snapshot to it, or stop
+static void ToggleExport(HWND hWnd) {
+    if (IsExporting()) {
+        StopExport();
+        SetWindowText(g_uiState.hStatusText, L"Export stopped");
+        return;
+    }
+
+    // Filter order matches ExportFormat
+    static const wchar_t* kExtensions[] = { L"csv", L"ndjson", L"bin" };
+    wchar_t path[MAX_PATH] = L"minux-export";
+    OPENFILENAMEW ofn = {0};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = hWnd;
+    ofn.lpstrFilter = L"CSV (*.csv)\0*.csv\0NDJSON (*.ndjson)\0*.ndjson\0Binary records (*.bin)\0*.bin\0";
+    ofn.nFilterIndex = 1;
+    ofn.lpstrFile = path;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrDefExt = kExtensions[0];
+    ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST;
+    if (!GetSaveFileNameW(&ofn)) return;
+
+    ExportFormat format = ofn.nFilterIndex >= 1 && ofn.nFilterIndex <= 3 ? (ExportFormat)(ofn.nFilterIndex - 1) : EXPORT_CSV;
+    if (!StartExport(path, format)) {
+        MessageBox(hWnd, L"Could not create the export file.", L"Export", MB_OK | MB_ICONWARNING);
+        return;
+    }
+    SetWindowText(g_uiState.hStatusText, L"Exporting");
+}
+
+// Move playback relative to the snapshot on screen
+static void SkipPlayback(LONGLONG deltaMs) {
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    if (!snapshot) return;
+    LONGLONG target = (LONGLONG)snapshot->timestamp + deltaMs;
+    SeekPlayback(target > 0 ? (ULONGLONG)target : 0);
+}
+
+// Owner-data list provider; cell text comes from the current snapshot on demand
+static ProcessTableModel g_processModel;
+
+// Point the virtual list at the current snapshot and repaint only stale visible rows
 void PopulateProcessList() {
     if (!g_uiState.hListView) return;
     
-    ListView_DeleteAllItems(g_uiState.hListView);
-    
-    // Sample process data
-    const wchar_t* processes[][4] = {
-        {L"minux-kernel.exe", L"1", L"45.2", L"12.5"},
-        {L"minux-scheduler.exe", L"156", L"23.1", L"8.2"},
-        {L"minux-driver-mgr.exe", L"234", L"18.7", L"5.1"},
-        {L"minux-fs-service.exe", L"445", L"34.5", L"15.3"},
-        {L"minux-net-stack.exe", L"567", L"28.9", L"9.7"},
-        {L"minux-ui-compositor.exe", L"678", L"52.3", L"18.9"},
-        {L"minux-power-mgr.exe", L"789", L"12.4", L"3.2"},
-        {L"minux-security.exe", L"890", L"19.8", L"6.4"}
-    };
-    
-    for (int i = 0; i < 8; i++) {
-        LVITEM lvi = {0};
-        lvi.mask = LVIF_TEXT;
-        lvi.iItem = i;
-        lvi.iSubItem = 0;
-        lvi.pszText = (LPWSTR)processes[i][0];
-        ListView_InsertItem(g_uiState.hListView, &lvi);
-        
-        for (int j = 1; j < 4; j++) {
-            ListView_SetItemText(g_uiState.hListView, i, j, (LPWSTR)processes[i][j]);
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    if (!snapshot) return;
+    
+    g_processModel.SetProcesses(&snapshot->processes, snapshot->orderedProcessCount);
+    int count = (int)g_processModel.GetRowCount();
+    if (ListView_GetItemCount(g_uiState.hListView) != count) {
+        ListView_SetItemCountEx(g_uiState.hListView, count, LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
+    }
+    
+    int top = ListView_GetTopIndex(g_uiState.hListView);
+    int bottom = top + ListView_GetCountPerPage(g_uiState.hListView);
+    if (bottom >= count) bottom = count - 1;
+    
+    // Only the rows down to the window get ranked, here and (for the default order) by the collector
+    g_processModel.SetWindow(top, bottom > top ? bottom : top);
+    bool collectorOrder = !g_processModel.IsTreeMode() && g_processModel.GetSortColumn() >= PROCESS_COLUMN_COUNT;
+    SetProcessListWindow(collectorOrder ? (size_t)(bottom + 1) : 0);
+    
+    // Coalesce runs of stale rows into one RedrawItems call each
+    int runStart = -1;
+    for (int row = top; row <= bottom + 1; row++) {
+        bool stale = row <= bottom && !g_processModel.IsRowCurrent(row);
+        if (stale && runStart < 0) {
+            runStart = row;
+        } else if (!stale && runStart >= 0) {
+            ListView_RedrawItems(g_uiState.hListView, runStart, row - 1);
+            runStart = -1;
         }
     }
 }
 
+// Mark the sorted column in the list header
+static void ShowProcessSortArrow(int sortColumn, bool descending) {
+    HWND hHeader = ListView_GetHeader(g_uiState.hListView);
+    for (int column = 0; column < PROCESS_COLUMN_COUNT; column++) {
+        HDITEM item = {0};
+        item.mask = HDI_FORMAT;
+        Header_GetItem(hHeader, column, &item);
+        item.fmt &= ~(HDF_SORTUP | HDF_SORTDOWN);
+        if (column == sortColumn) item.fmt |= descending ? HDF_SORTDOWN : HDF_SORTUP;
+        Header_SetItem(hHeader, column, &item);
+    }
+}
+
+// Rows were added or removed in place: recount and repaint the whole list
+static void RefreshProcessRows() {
+    ListView_SetItemCountEx(g_uiState.hListView, (int)g_processModel.GetRowCount(), LVSICF_NOSCROLL);
+    InvalidateRect(g_uiState.hListView, NULL, FALSE);
+}
+
+// Switch between the ranked list and the parent/child tree; the tree has no column sort
+static void SetProcessTreeMode(bool treeMode) {
+    g_processModel.SetTreeMode(treeMode);
+    ShowProcessSortArrow(treeMode ? PROCESS_COLUMN_COUNT : g_processModel.GetSortColumn(), g_processModel.IsSortDescending());
+    RefreshProcessRows();
+}
+
+static void SelectProcessRow(int row) {
+    ListView_SetItemState(g_uiState.hListView, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_SetItemState(g_uiState.hListView, row, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_EnsureVisible(g_uiState.hListView, row, FALSE);
+}
+
+// Re-filter on every keystroke in the filter box
+static void ApplyProcessFilter() {
+    wchar_t query[256];
+    GetWindowText(g_uiState.hFilterEdit, query, 256);
+    size_t errorOffset = 0;
+    wchar_t status[320];
+    if (!g_processModel.SetFilter(query, &errorOffset)) {
+        swprintf_s(status, L"Filter: cannot read \"%s\"", query + errorOffset);
+        SetWindowText(g_uiState.hStatusText, status);
+        return;
+    }
+    RefreshProcessRows();
+
+    const MinuxSnapshot* snapshot = GetCurrentSnapshot();
+    if (g_processModel.IsFiltered() && snapshot) {
+        swprintf_s(status, L"Filter: %zu of %zu processes", g_processModel.GetRowCount(), snapshot->processes.size());
+        SetWindowText(g_uiState.hStatusText, status);
+    } else {
+        SetWindowText(g_uiState.hStatusText, L"Processes view - Real-time process monitoring");
+    }
+}
+
+// Tree keys as in a tree view: Left collapses or moves to the parent, Right expands
+static void HandleProcessTreeKey(WORD key) {
+    int row = ListView_GetNextItem(g_uiState.hListView, -1, LVNI_FOCUSED);
+    if (row < 0) return;
+    switch (key) {
+    case VK_LEFT:
+    case VK_SUBTRACT:
+        if (g_processModel.SetRowExpanded(row, false)) {
+            RefreshProcessRows();
+        } else if (key == VK_LEFT) {
+            ptrdiff_t parent = g_processModel.GetParentRow(row);
+            if (parent >= 0) SelectProcessRow((int)parent);
+        }
+        break;
+    case VK_RIGHT:
+    case VK_ADD:
+        if (g_processModel.SetRowExpanded(row, true)) RefreshProcessRows();
+        break;
+    }
+}
+
+// Answer the virtual list's requests for cell text
+static LRESULT HandleProcessListNotify(NMHDR* header) {
+    switch (header->code) {
+    case LVN_GETDISPINFO: {
+        NMLVDISPINFO* info = (NMLVDISPINFO*)header;
+        if (info->item.mask & LVIF_TEXT) {
+            g_processModel.CopyCellText(info->item.iItem, info->item.iSubItem,
+                                        info->item.pszText, info->item.cchTextMax);
+        }
+        return 0;
+    }
+    case LVN_ODCACHEHINT: {
+        NMLVCACHEHINT* hint = (NMLVCACHEHINT*)header;
+        g_processModel.PrepareRows(hint->iFrom, hint->iTo);
+        return 0;
+    }
+    case LVN_COLUMNCLICK: {
+        // Same column flips the direction; numbers start heaviest first, names A to Z
+        if (g_processModel.IsTreeMode()) return 0;
+        int column = ((NMLISTVIEW*)header)->iSubItem;
+        bool descending = column == g_processModel.GetSortColumn() ? !g_processModel.IsSortDescending()
+                                                                   : column != PROCESS_COLUMN_NAME;
+        g_processModel.SetSort(column, descending);
+        ShowProcessSortArrow(column, descending);
+        InvalidateRect(g_uiState.hListView, NULL, FALSE);
+        return 0;
+    }
+    case NM_DBLCLK: {
+        // Double-click opens or closes a parent in the tree
+        int row = ((NMITEMACTIVATE*)header)->iItem;
+        if (row >= 0 && g_processModel.SetRowExpanded(row, !g_processModel.IsRowExpanded(row))) RefreshProcessRows();
+        return 0;
+    }
+    case LVN_KEYDOWN:
+        if (g_processModel.IsTreeMode()) HandleProcessTreeKey(((NMLVKEYDOWN*)header)->wVKey);
+        return 0;
+    }
+    return 0;
+}
+
 // Forward declarations of functions included in this code module:
 ATOM                MyRegisterClass(HINSTANCE hInstance);
 BOOL                InitInstance(HINSTANCE, int);
@@ -239,7 +978,7 @@ ATOM MyRegisterClass(HINSTANCE hInstance)
 
     wcex.cbSize = sizeof(WNDCLASSEX);
 
-    wcex.style          = CS_HREDRAW | CS_VREDRAW;
+    wcex.style          = 0;        // resizing repaints only the exposed area; see PaintMainWindow
     wcex.lpfnWndProc    = WndProc;
     wcex.cbClsExtra     = 0;
     wcex.cbWndExtra     = 0;
@@ -269,7 +1008,7 @@ BOOL InitInstance(HINSTANCE hInstance, int nCmdShow)
    hInst = hInstance; // Store instance handle in our global variable
 
    HWND hWnd = CreateWindowW(szWindowClass, szTitle, 
-      WS_OVERLAPPEDWINDOW | WS_VISIBLE,
+      WS_OVERLAPPEDWINDOW | WS_VISIBLE | WS_CLIPCHILDREN,
       CW_USEDEFAULT, 0, WINDOW_WIDTH, WINDOW_HEIGHT, 
       nullptr, nullptr, hInstance, nullptr);
 
@@ -323,6 +1062,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         
         // Enable touch support
         EnableTouchSupport(hWnd);
+        g_hGraphWnd = hWnd;
+        
+        // Fonts and pens follow the DPI of the screen the window starts on
+        HDC hdcScreen = GetDC(hWnd);
+        g_gdiCache.SetContext(g_gdiCache.GetTheme(), (UINT)GetDeviceCaps(hdcScreen, LOGPIXELSY));
+        ReleaseDC(hWnd, hdcScreen);
         
         // Create modern UI elements
         int buttonWidth = 100;
@@ -340,8 +1085,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         g_uiState.hButtons[3] = CreateModernButton(hWnd, L"System", margin + (buttonWidth + 5) * 3, 50, buttonWidth, buttonHeight, ID_BUTTON_SYSTEM);
         g_uiState.hButtons[4] = CreateModernButton(hWnd, L"Settings", margin + (buttonWidth + 5) * 4, 50, buttonWidth, buttonHeight, ID_BUTTON_SETTINGS);
         
-        // Process list view
-        g_uiState.hListView = CreateProcessListView(hWnd, margin, 100, 570, 200);
+        // Process filter box, with the process list view under it
+        g_uiState.hFilterEdit = CreateWindowEx(0, L"EDIT", L"", WS_VISIBLE | WS_CHILD | WS_BORDER | ES_AUTOHSCROLL,
+                                               margin, 100, 570, 22, hWnd, (HMENU)(UINT_PTR)ID_EDIT_PROCESS_FILTER,
+                                               GetModuleHandle(NULL), NULL);
+        SendMessage(g_uiState.hFilterEdit, EM_SETCUEBANNER, FALSE, (LPARAM)L"Filter: name or pattern*, mem>200MB, cpu>5, threads>50");
+        g_uiState.hListView = CreateProcessListView(hWnd, margin, 126, 570, 174);
         
         // Progress bars for system monitoring
         CreateWindow(L"STATIC", L"CPU Usage:", WS_VISIBLE | WS_CHILD,
@@ -357,21 +1106,70 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                                            WS_VISIBLE | WS_CHILD | SS_LEFT,
                                            margin, 360, 570, 20, hWnd, (HMENU)(UINT_PTR)ID_STATIC_STATUS, GetModuleHandle(NULL), NULL);
         
-        // Initialize data
-        PopulateProcessList();
+        // Recordings dropped on the window open for playback
+        DragAcceptFiles(hWnd, TRUE);
         
-        // Start system monitoring timer
-        SetTimer(hWnd, 1, 1000, NULL); // Update every second
+        // Start background system monitoring; snapshots arrive as WM_MINUX_SNAPSHOT
+        StartCollector(hWnd);
         
         return 0;
     }
     
-    case WM_TIMER:
-        if (wParam == 1) {
+    case WM_MINUX_SNAPSHOT:
+        if (AcquireSnapshot()) {
+            // Repoint the virtual list first: the previous snapshot's memory is now the collector's
+            PopulateProcessList();
+            if (g_inTray || IsIconic(hWnd)) {
+                UpdateTrayTip();    // the rest refreshes from the sample taken on restore
+                return 0;
+            }
             UpdateSystemInfo();
+            if (g_uiState.currentTab == 2) InvalidateRect(hWnd, &g_interfaceTableRect, FALSE);
+            if (g_uiState.currentTab == 3) InvalidateChangedCores(hWnd, false);
+            if (g_graphLive) InvalidateHistoryGraph();
+        }
+        return 0;
+    
+    case WM_MINUX_TRAY:
+        if (LOWORD(lParam) == WM_LBUTTONUP || LOWORD(lParam) == WM_LBUTTONDBLCLK) {
+            RestoreFromTray(hWnd);
         }
         return 0;
     
+    case WM_SIZE:
+        // Taskbar minimize and restore change what is visible too
+        UpdateCollectorView(hWnd);
+        break;
+    
+    case WM_DROPFILES: {
+        HDROP hDrop = (HDROP)wParam;
+        wchar_t path[MAX_PATH];
+        if (DragQueryFileW(hDrop, 0, path, MAX_PATH)) {
+            OpenRecording(hWnd, path);
+        }
+        DragFinish(hDrop);
+        return 0;
+    }
+    
+    case WM_INITMENUPOPUP: {
+        HMENU hMenu = (HMENU)wParam;
+        bool playback = IsPlaybackActive();
+        CheckMenuItem(hMenu, IDM_RECORD, IsRecording() ? MF_CHECKED : MF_UNCHECKED);
+        EnableMenuItem(hMenu, IDM_RECORD, playback ? MF_GRAYED : MF_ENABLED);
+        CheckMenuItem(hMenu, IDM_EXPORT, IsExporting() ? MF_CHECKED : MF_UNCHECKED);
+        UINT playbackState = playback ? MF_ENABLED : MF_GRAYED;
+        EnableMenuItem(hMenu, IDM_RETURN_TO_LIVE, playbackState);
+        EnableMenuItem(hMenu, IDM_PLAYBACK_FASTER, playbackState);
+        EnableMenuItem(hMenu, IDM_PLAYBACK_SLOWER, playbackState);
+        EnableMenuItem(hMenu, IDM_PLAYBACK_BACK, playbackState);
+        EnableMenuItem(hMenu, IDM_PLAYBACK_FORWARD, playbackState);
+        bool treeMode = g_processModel.IsTreeMode();
+        CheckMenuItem(hMenu, IDM_PROCESS_TREE, treeMode ? MF_CHECKED : MF_UNCHECKED);
+        EnableMenuItem(hMenu, IDM_TREE_EXPAND_ALL, treeMode ? MF_ENABLED : MF_GRAYED);
+        EnableMenuItem(hMenu, IDM_TREE_COLLAPSE_ALL, treeMode ? MF_ENABLED : MF_GRAYED);
+        return 0;
+    }
+    
     case WM_TOUCH: {
         // Handle touch input
         UINT cInputs = LOWORD(wParam);
@@ -382,10 +1180,20 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 POINT pt = {TOUCH_COORD_TO_PIXEL(pInputs[i].x), TOUCH_COORD_TO_PIXEL(pInputs[i].y)};
                 ScreenToClient(hWnd, &pt);
                 
+                // Two fingers pinch the history graph instead of dragging
+                if (TrackPinch(pInputs[i], pt)) {
+                    if (g_graphDragging) SendMessage(hWnd, WM_LBUTTONUP, 0, MAKELPARAM(pt.x, pt.y));
+                    continue;
+                }
+                
                 if (pInputs[i].dwFlags & TOUCHEVENTF_DOWN) {
                     // Touch down - similar to mouse down
                     SendMessage(hWnd, WM_LBUTTONDOWN, 0, MAKELPARAM(pt.x, pt.y));
                 }
+                else if (pInputs[i].dwFlags & TOUCHEVENTF_MOVE) {
+                    // One finger swipes the history graph or drags the window
+                    SendMessage(hWnd, WM_MOUSEMOVE, MK_LBUTTON, MAKELPARAM(pt.x, pt.y));
+                }
                 else if (pInputs[i].dwFlags & TOUCHEVENTF_UP) {
                     // Touch up - similar to mouse up
                     SendMessage(hWnd, WM_LBUTTONUP, 0, MAKELPARAM(pt.x, pt.y));
@@ -398,6 +1206,14 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         return 0;
     }
     
+    case WM_NOTIFY: {
+        NMHDR* header = (NMHDR*)lParam;
+        if (header->idFrom == ID_LISTVIEW_PROCESSES) {
+            return HandleProcessListNotify(header);
+        }
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    
     case WM_DRAWITEM: {
         DRAWITEMSTRUCT* dis = (DRAWITEMSTRUCT*)lParam;
         if (dis->CtlType == ODT_BUTTON) {
@@ -424,31 +1240,80 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             {
             case ID_BUTTON_PROCESSES:
                 PopulateProcessList();
-                g_uiState.currentTab = 0;
+                SetCurrentTab(hWnd, 0);
                 SetWindowText(g_uiState.hStatusText, L"Processes view - Real-time process monitoring");
                 break;
             case ID_BUTTON_MEMORY:
-                g_uiState.currentTab = 1;
+                SetCurrentTab(hWnd, 1);
                 SetWindowText(g_uiState.hStatusText, L"Memory view - System memory analysis");
                 break;
             case ID_BUTTON_NETWORK:
-                g_uiState.currentTab = 2;
+                SetCurrentTab(hWnd, 2);
                 SetWindowText(g_uiState.hStatusText, L"Network view - Network interface monitoring");
                 break;
             case ID_BUTTON_SYSTEM:
-                g_uiState.currentTab = 3;
+                SetCurrentTab(hWnd, 3);
                 SetWindowText(g_uiState.hStatusText, L"System view - Hardware and kernel information");
                 break;
             case ID_BUTTON_SETTINGS:
-                g_uiState.currentTab = 4;
-                SetWindowText(g_uiState.hStatusText, L"Settings - Configure Minux RTOS parameters");
+                {
+                    SetCurrentTab(hWnd, 4);
+                    GdiCacheStats stats = g_gdiCache.GetStats();
+                    wchar_t statusText[256];
+                    swprintf_s(statusText, L"Settings - Configure Minux RTOS parameters | GDI cache: %zu live, %llu hits, %llu misses",
+                               stats.live, stats.hits, stats.misses);
+                    SetWindowText(g_uiState.hStatusText, statusText);
+                }
                 break;
             case ID_BUTTON_MINIMIZE:
-                ShowWindow(hWnd, SW_MINIMIZE);
+                MinimizeToTray(hWnd);
                 break;
             case ID_BUTTON_CLOSE:
                 PostQuitMessage(0);
                 break;
+            case IDM_OPEN_RECORDING:
+                ChooseRecording(hWnd);
+                break;
+            case IDM_RECORD:
+                ToggleRecording(hWnd);
+                break;
+            case IDM_EXPORT:
+                ToggleExport(hWnd);
+                break;
+            case IDM_RETURN_TO_LIVE:
+                if (IsPlaybackActive()) {
+                    StopPlayback();
+                    SetWindowText(g_uiState.hStatusText, L"Live monitoring");
+                }
+                break;
+            case IDM_PLAYBACK_FASTER:
+                SetPlaybackSpeed(GetPlaybackSpeed() * 2);
+                break;
+            case IDM_PLAYBACK_SLOWER:
+                SetPlaybackSpeed(GetPlaybackSpeed() / 2);
+                break;
+            case IDM_PLAYBACK_BACK:
+                SkipPlayback(-60000);
+                break;
+            case IDM_PLAYBACK_FORWARD:
+                SkipPlayback(60000);
+                break;
+            case IDM_PROCESS_TREE:
+                SetProcessTreeMode(!g_processModel.IsTreeMode());
+                break;
+            case IDM_TREE_EXPAND_ALL:
+            case IDM_TREE_COLLAPSE_ALL:
+                g_processModel.SetAllExpanded(wmId == IDM_TREE_EXPAND_ALL);
+                RefreshProcessRows();
+                break;
+            case IDM_FIND_PROCESS:
+                if (IsGraphTab()) SetCurrentTab(hWnd, 0);
+                SetFocus(g_uiState.hFilterEdit);
+                SendMessage(g_uiState.hFilterEdit, EM_SETSEL, 0, -1);
+                break;
+            case ID_EDIT_PROCESS_FILTER:
+                if (HIWORD(wParam) == EN_CHANGE) ApplyProcessFilter();
+                break;
             case IDM_ABOUT:
                 DialogBox(hInst, MAKEINTRESOURCE(IDD_ABOUTBOX), hWnd, About);
                 break;
@@ -462,6 +1327,14 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         return 0;
         
     case WM_LBUTTONDOWN: {
+        // Dragging the history graph pans it
+        if (IsInHistoryGraph(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam))) {
+            g_graphDragging = true;
+            g_graphDragX = GET_X_LPARAM(lParam);
+            SetCapture(hWnd);
+            return 0;
+        }
+        
         // Enable window dragging
         if (HIWORD(lParam) < 40) { // Title bar area
             g_uiState.isDragging = true;
@@ -473,6 +1346,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     }
     
     case WM_MOUSEMOVE: {
+        if (g_graphDragging) {
+            int deltaX = GET_X_LPARAM(lParam) - g_graphDragX;
+            if (deltaX != 0) ProcessSwipeGesture(deltaX > 0 ? 1 : -1, abs(deltaX));
+            g_graphDragX = GET_X_LPARAM(lParam);
+            return 0;
+        }
         if (g_uiState.isDragging) {
             RECT rect;
             GetWindowRect(hWnd, &rect);
@@ -484,6 +1363,10 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     }
     
     case WM_LBUTTONUP: {
+        if (g_graphDragging) {
+            g_graphDragging = false;
+            ReleaseCapture();
+        }
         if (g_uiState.isDragging) {
             g_uiState.isDragging = false;
             ReleaseCapture();
@@ -491,53 +1374,41 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         return 0;
     }
         
+    case WM_MOUSEWHEEL: {
+        // The wheel zooms the history graph like a pinch
+        POINT pt = {GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam)};
+        ScreenToClient(hWnd, &pt);
+        if (!IsInHistoryGraph(pt.x, pt.y)) return DefWindowProc(hWnd, message, wParam, lParam);
+        ProcessPinchGesture(GET_WHEEL_DELTA_WPARAM(wParam) > 0 ? 1.25f : 0.8f);
+        return 0;
+    }
+    
+    case WM_ERASEBKGND:
+        return 1;   // WM_PAINT covers every pixel from the back buffer
+    
+    case WM_THEMECHANGED:
+    case WM_SYSCOLORCHANGE:
+    case WM_DISPLAYCHANGE:
+    case WM_DPICHANGED:
+        if (message == WM_DPICHANGED) g_gdiCache.SetContext(g_gdiCache.GetTheme(), HIWORD(wParam));
+        g_backBuffer.InvalidateChrome();
+        InvalidateRect(hWnd, NULL, FALSE);
+        return DefWindowProc(hWnd, message, wParam, lParam);
+        
     case WM_PAINT:
         {
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hWnd, &ps);
-            
-            // Modern gradient background
-            RECT clientRect;
-            GetClientRect(hWnd, &clientRect);
-            
-            // Create gradient brush
-            HBRUSH hBrush = CreateSolidBrush(MINUX_COLOR_BACKGROUND);
-            FillRect(hdc, &clientRect, hBrush);
-            DeleteObject(hBrush);
-            
-            // Title bar
-            RECT titleRect = {0, 0, clientRect.right, 40};
-            HBRUSH hTitleBrush = CreateSolidBrush(COLOR_SECONDARY);
-            FillRect(hdc, &titleRect, hTitleBrush);
-            DeleteObject(hTitleBrush);
-            
-            // Title text
-            SetBkMode(hdc, TRANSPARENT);
-            SetTextColor(hdc, COLOR_TEXT);
-            HFONT hTitleFont = CreateFont(16, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE,
-                                         DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                                         CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-            HFONT hOldFont = (HFONT)SelectObject(hdc, hTitleFont);
-            
-            TextOut(hdc, 15, 12, L"Minux RTOS Control Center", 25);
-            
-            // Version info
-            HFONT hSmallFont = CreateFont(12, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-                                         DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                                         CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-            SelectObject(hdc, hSmallFont);
-            SetTextColor(hdc, RGB(180, 180, 180));
-            TextOut(hdc, 250, 15, L"v2.1.0 - Real-time OS", 21);
-            
-            SelectObject(hdc, hOldFont);
-            DeleteObject(hTitleFont);
-            DeleteObject(hSmallFont);
-            
+            PaintMainWindow(hWnd, hdc, ps.rcPaint);
             EndPaint(hWnd, &ps);
         }
         break;
     case WM_DESTROY:
-        KillTimer(hWnd, 1);
+        if (g_inTray) Shell_NotifyIconW(NIM_DELETE, &g_trayIcon);
+        StopRecording();
+        StopExport();
+        StopCollector();
+        g_backBuffer.Release();
         PostQuitMessage(0);
         break;
     default:
@@ -7,4 +7,5 @@
 #pragma comment(lib, "dwmapi.lib")
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "uxtheme.lib")
-#pragma comment(lib, "shell32.lib")
\ No newline at end of file
+#pragma comment(lib, "shell32.lib")
+#pragma comment(lib, "comdlg32.lib")
\ No newline at end of file